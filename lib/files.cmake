@@ -20,21 +20,35 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/application/io/wiegand/Wiegand.cpp
         ${smooth_dir}/application/network/http/HTTPProtocol.cpp
         ${smooth_dir}/application/network/http/HTTPServerClient.cpp
+        ${smooth_dir}/application/network/http/ResponseBudget.cpp
         ${smooth_dir}/application/network/http/http_utils.cpp
+        ${smooth_dir}/application/network/http/regular/AssetCache.cpp
+        ${smooth_dir}/application/network/http/regular/ChunkedDecoder.cpp
+        ${smooth_dir}/application/network/http/regular/CompiledTemplate.cpp
         ${smooth_dir}/application/network/http/regular/HTTPHeaderDef.cpp
+        ${smooth_dir}/application/network/http/regular/HTTPHeaderParser.cpp
         ${smooth_dir}/application/network/http/regular/HTTPPacket.cpp
         ${smooth_dir}/application/network/http/regular/HTTPRequestHandler.cpp
         ${smooth_dir}/application/network/http/regular/MIMEParser.cpp
         ${smooth_dir}/application/network/http/regular/RegularHTTPProtocol.cpp
+        ${smooth_dir}/application/network/http/regular/Router.cpp
+        ${smooth_dir}/application/network/http/regular/responses/AssetResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/ErrorResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/EventStreamResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/FileContentResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/HeaderOnlyResponse.cpp
         ${smooth_dir}/application/network/http/regular/responses/StringResponse.cpp
+        ${smooth_dir}/application/network/http/regular/responses/TemplateResponse.cpp
         ${smooth_dir}/application/network/http/regular/TemplateProcessor.cpp
+        ${smooth_dir}/application/network/http/regular/WebRootLookupCache.cpp
         ${smooth_dir}/application/network/http/URLEncoding.cpp
+        ${smooth_dir}/application/network/http/websocket/responses/WSBroadcastResponse.cpp
         ${smooth_dir}/application/network/http/websocket/responses/WSResponse.cpp
         ${smooth_dir}/application/network/http/websocket/WebsocketProtocol.cpp
+        ${smooth_dir}/application/network/http/websocket/frame_utils.cpp
+        ${smooth_dir}/application/network/http/websocket/PerMessageDeflate.cpp
         ${smooth_dir}/application/network/http/websocket/WebSocketServer.cpp
+        ${smooth_dir}/application/network/http/websocket/WebsocketGroup.cpp
         ${smooth_dir}/application/network/mqtt/MqttClient.cpp
         ${smooth_dir}/application/network/mqtt/packet/ConnAck.cpp
         ${smooth_dir}/application/network/mqtt/packet/Connect.cpp
@@ -69,6 +83,7 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/core/filesystem/filesystem.cpp
         ${smooth_dir}/core/filesystem/FSLock.cpp
         ${smooth_dir}/core/filesystem/MMCSDCard.cpp
+        ${smooth_dir}/core/filesystem/MemoryMappedFile.cpp
         ${smooth_dir}/core/filesystem/Path.cpp
         ${smooth_dir}/core/filesystem/SDCard.cpp
         ${smooth_dir}/core/filesystem/SPIFlash.cpp
@@ -86,10 +101,14 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/core/json/JsonFile.cpp
         ${smooth_dir}/core/logging/log.cpp
         ${smooth_dir}/core/network/CommonSocket.cpp
+        ${smooth_dir}/core/network/EpollReadinessBackend.cpp
         ${smooth_dir}/core/network/IPv4.cpp
         ${smooth_dir}/core/network/IPv6.cpp
         ${smooth_dir}/core/network/MbedTLSContext.cpp
+        ${smooth_dir}/core/network/PollReadinessBackend.cpp
+        ${smooth_dir}/core/network/SelectReadinessBackend.cpp
         ${smooth_dir}/core/network/SocketDispatcher.cpp
+        ${smooth_dir}/core/network/WakeUpSignal.cpp
         ${smooth_dir}/core/network/Wifi.cpp
         ${smooth_dir}/core/sntp/Sntp.cpp
         ${smooth_dir}/core/SystemStatistics.cpp
@@ -97,6 +116,7 @@ set(SMOOTH_SOURCES
         ${smooth_dir}/core/timer/ElapsedTime.cpp
         ${smooth_dir}/core/timer/Timer.cpp
         ${smooth_dir}/core/timer/TimerService.cpp
+        ${smooth_dir}/core/timer/TimerWheel.cpp
         ${smooth_dir}/core/util/string_util.cpp
         ${smooth_inc_dir}/application/display/DisplayPin.h
         ${smooth_inc_dir}/application/display/LCDSpi.h
@@ -119,15 +139,29 @@ set(SMOOTH_SOURCES
         ${smooth_inc_dir}/application/network/http/HTTPServerConfig.h
         ${smooth_inc_dir}/application/network/http/http_utils.h
         ${smooth_inc_dir}/application/network/http/IResponseOperation.h
+        ${smooth_inc_dir}/application/network/http/ResponseBudget.h
+        ${smooth_inc_dir}/application/network/http/regular/AssetCache.h
+        ${smooth_inc_dir}/application/network/http/regular/ChunkedDecoder.h
+        ${smooth_inc_dir}/application/network/http/regular/CompiledTemplate.h
+        ${smooth_inc_dir}/application/network/http/regular/HTTPHeaderParser.h
         ${smooth_inc_dir}/application/network/http/regular/ITemplateDataRetriever.h
         ${smooth_inc_dir}/application/network/http/regular/RegularHTTPProtocol.h
+        ${smooth_inc_dir}/application/network/http/regular/Router.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/AssetResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/ErrorResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/EventStreamResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/FileContentResponse.h
         ${smooth_inc_dir}/application/network/http/regular/responses/StringResponse.h
+        ${smooth_inc_dir}/application/network/http/regular/responses/TemplateResponse.h
         ${smooth_inc_dir}/application/network/http/regular/TemplateProcessor.h
+        ${smooth_inc_dir}/application/network/http/regular/WebRootLookupCache.h
         ${smooth_inc_dir}/application/network/http/URLEncoding.h
         ${smooth_inc_dir}/application/network/http/websocket/WebsocketProtocol.h
         ${smooth_inc_dir}/application/network/http/websocket/WebsocketServer.h
+        ${smooth_inc_dir}/application/network/http/websocket/frame_utils.h
+        ${smooth_inc_dir}/application/network/http/websocket/PerMessageDeflate.h
+        ${smooth_inc_dir}/application/network/http/websocket/WebsocketGroup.h
+        ${smooth_inc_dir}/application/network/http/websocket/responses/WSBroadcastResponse.h
         ${smooth_inc_dir}/application/network/mqtt/event/BaseEvent.h
         ${smooth_inc_dir}/application/network/mqtt/event/ConnectEvent.h
         ${smooth_inc_dir}/application/network/mqtt/event/DisconnectEvent.h
@@ -169,6 +203,7 @@ set(SMOOTH_SOURCES
         ${smooth_inc_dir}/application/network/mqtt/Subscription.h
         ${smooth_inc_dir}/application/security/PasswordHash.h
         ${smooth_inc_dir}/core/filesystem/MMCSDCard.h
+        ${smooth_inc_dir}/core/filesystem/MemoryMappedFile.h
         ${smooth_inc_dir}/core/filesystem/MountPoint.h
         ${smooth_inc_dir}/core/filesystem/Path.h
         ${smooth_inc_dir}/core/filesystem/SDCard.h
@@ -184,6 +219,12 @@ set(SMOOTH_SOURCES
         ${smooth_inc_dir}/core/io/InterruptInput.h
         ${smooth_inc_dir}/core/io/InterruptInputCB.h
         ${smooth_inc_dir}/core/io/Output.h
+        ${smooth_inc_dir}/core/network/EpollReadinessBackend.h
+        ${smooth_inc_dir}/core/network/IReadinessBackend.h
+        ${smooth_inc_dir}/core/network/PollReadinessBackend.h
+        ${smooth_inc_dir}/core/network/PoolExhaustionPolicy.h
+        ${smooth_inc_dir}/core/network/SelectReadinessBackend.h
+        ${smooth_inc_dir}/core/network/WakeUpSignal.h
         ${smooth_inc_dir}/core/network/Wifi.h
         ${smooth_inc_dir}/core/sntp/Sntp.h
         ${smooth_inc_dir}/core/sntp/TimeSyncEvent.h
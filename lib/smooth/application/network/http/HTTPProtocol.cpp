@@ -70,6 +70,14 @@ namespace smooth::application::network::http
         return regular ? regular->is_error() : websocket->is_error();
     }
 
+    void HTTPProtocol::take_excess_data(std::vector<uint8_t>& target)
+    {
+        if (regular)
+        {
+            regular->take_excess_data(target);
+        }
+    }
+
     void HTTPProtocol::packet_consumed()
     {
         if (regular)
@@ -100,4 +108,12 @@ namespace smooth::application::network::http
         regular.reset();
         websocket = std::make_unique<websocket::WebsocketProtocol>(content_chunk_size, response);
     }
+
+    void HTTPProtocol::enable_websocket_compression()
+    {
+        if (websocket)
+        {
+            websocket->enable_compression();
+        }
+    }
 }
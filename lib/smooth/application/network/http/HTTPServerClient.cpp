@@ -25,6 +25,14 @@ namespace smooth::application::network::http
     using namespace websocket::responses;
     using namespace websocket;
 
+    static void add_shared_content(HTTPPacket& packet, SharedContent& shared)
+    {
+        if (shared.owner)
+        {
+            packet.set_shared_body(std::move(shared.owner), shared.data, shared.length);
+        }
+    }
+
     void HTTPServerClient::event(
         const core::network::event::DataAvailableEvent<HTTPProtocol>& event)
     {
@@ -41,35 +49,14 @@ namespace smooth::application::network::http
     void HTTPServerClient::event(
         const smooth::core::network::event::TransmitBufferEmptyEvent&)
     {
-        if (current_operation)
-        {
-            std::vector<uint8_t> data;
-            auto res = current_operation->get_data(content_chunk_size, data);
-
-            if (res == ResponseStatus::Error)
-            {
-                Log::error(tag, "Current operation reported error, closing server client.");
-                this->close();
-            }
-            else if (res == ResponseStatus::NoData)
-            {
-                current_operation.reset();
+        fill_tx_buffer();
+    }
 
-                // Immediately send next
-                send_first_part();
-            }
-            else if (res == ResponseStatus::HasMoreData
-                     || res == ResponseStatus::LastData)
-            {
-                HTTPPacket p{ data };
-                auto& tx = this->container->get_tx_buffer();
-                tx.put(p);
-            }
-        }
-        else
-        {
-            send_first_part();
-        }
+    ResponseStatus HTTPServerClient::get_next_part(std::vector<uint8_t>& data, SharedContent& shared)
+    {
+        return current_operation->has_shared_data()
+               ? current_operation->get_shared_data(content_chunk_size, shared)
+               : current_operation->get_data(content_chunk_size, data);
     }
 
     void HTTPServerClient::disconnected()
@@ -83,10 +70,26 @@ namespace smooth::application::network::http
 
     void HTTPServerClient::reset_client()
     {
-        operations.clear();
+        clear_operations();
         current_operation.reset();
+
+        if (budget)
+        {
+            budget->stop_waiting(*this);
+        }
+
+        receive_paused = false;
+        idle = false;
+        unanswered_requests = 0;
+        http_responses_queued = 0;
+        http_response = false;
+        chunked_response = false;
+        chunked_allowed = true;
+        close_after_response = false;
+        closing = false;
         mode = Mode::HTTP;
         ws_server.reset();
+        message_deflate.reset();
     }
 
     bool HTTPServerClient::parse_url(std::string& raw_url)
@@ -153,99 +156,297 @@ namespace smooth::application::network::http
             using namespace std::chrono;
             const auto timeout = duration_cast<seconds>(this->socket->get_receive_timeout());
 
-            if (timeout.count() > 0)
+            // Decided now, while the request the response belongs to is known, rather than when it is sent.
+            if (!select_transfer_coding(*response))
+            {
+                // The client can only tell where the response ends by the connection being closed.
+                response->set_header(CONNECTION, "close");
+            }
+            else if (timeout.count() > 0)
             {
                 response->add_header(CONNECTION, "keep-alive");
                 response->set_header(KEEP_ALIVE, "timeout=" + std::to_string(timeout.count()));
             }
+
+            ++http_responses_queued;
         }
 
-        if (operations.size() >= max_enqueued_responses)
+        operation_enqueued(*response);
+
+        if (place_first)
         {
-            // To prevent a build up of unsent responses, which all consume a bit of memory
-            // (f.ex. echoing incoming data) we don't let the total amount of operations grow beyond
-            // the set number.
-            Log::error(tag, "Overflow protection triggered.");
-            close();
+            operations.insert(operations.begin(), std::move(response));
         }
         else
         {
-            if (place_first)
-            {
-                operations.insert(operations.begin(), std::move(response));
-            }
-            else
-            {
-                operations.emplace_back(std::move(response));
-            }
+            operations.emplace_back(std::move(response));
+        }
 
-            if (!current_operation)
-            {
-                send_first_part();
-            }
+        if (!current_operation && !handling_requests)
+        {
+            fill_tx_buffer();
         }
+
+        // To prevent a build up of unsent responses, which all consume a bit of memory (f.ex. echoing
+        // incoming data), no more requests are read while too many are waiting to be sent.
+        update_flow_control();
     }
 
     void HTTPServerClient::reply_error(std::unique_ptr<IResponseOperation> response)
     {
-        operations.clear();
+        clear_operations();
+        http_responses_queued = mode == Mode::HTTP ? 1 : 0;
         response->add_header(CONNECTION, "close");
+        operation_enqueued(*response);
         operations.emplace_back(std::move(response));
 
-        if (!current_operation)
+        if (!current_operation && !handling_requests)
         {
-            send_first_part();
+            fill_tx_buffer();
         }
     }
 
-    void HTTPServerClient::send_first_part()
+    void HTTPServerClient::disconnect()
+    {
+        clear_operations();
+        http_responses_queued = 0;
+        this->close();
+    }
+
+    void HTTPServerClient::fill_tx_buffer()
     {
-        ResponseStatus res = ResponseStatus::Error;
+        auto& tx = this->container->get_tx_buffer();
+        std::size_t queued = 0;
 
-        do
+        if (closing)
         {
-            if (!operations.empty())
+            // Nothing more is sent, the connection is closed once the response promising so has been sent.
+            if (tx.is_empty() && this->socket->is_active())
+            {
+                this->close();
+            }
+
+            return;
+        }
+
+        // Keep queuing packets, continuing with the responses that follow, until the transmit buffer is full or
+        // holds a chunk worth of data. As the socket sends everything queued using a single vectored write, the
+        // responses to pipelined requests are combined instead of each waiting for the previous one to be sent.
+        while (queued < content_chunk_size
+               && !tx.is_full()
+               && (current_operation || !operations.empty()))
+        {
+            auto first_part = !current_operation;
+
+            if (first_part)
             {
                 current_operation = std::move(operations.front());
                 operations.pop_front();
+                operation_dequeued(*current_operation);
+                set_wake_up(*current_operation);
 
-                const auto& headers = current_operation->get_headers();
+                if (message_deflate)
+                {
+                    current_operation->set_message_compression(*message_deflate);
+                }
 
-                std::vector<uint8_t> data{};
-                res = current_operation->get_data(content_chunk_size, data);
+                // Responses queued before an upgrade to websocket are still sent as HTTP responses.
+                http_response = http_responses_queued > 0;
 
-                if (res == ResponseStatus::Error)
+                if (http_response)
                 {
-                    Log::error(tag, "Current operation reported error, closing server client.");
-                    this->close();
+                    --http_responses_queued;
                 }
-                else
+
+                chunked_response = http_response && is_chunked(*current_operation);
+                close_after_response = http_response && closes_connection(*current_operation);
+            }
+
+            std::vector<uint8_t> data{};
+            SharedContent shared{};
+            auto res = get_next_part(data, shared);
+
+            if (res == ResponseStatus::Error)
+            {
+                Log::error(tag, "Current operation reported error, closing server client.");
+                current_operation.reset();
+                this->close();
+                break;
+            }
+
+            HTTPPacket p{};
+
+            if (first_part && http_response)
+            {
+                // Whether or not there is any content, the headers are always sent.
+                p = HTTPPacket{ current_operation->get_response_code(),
+                                "1.1",
+                                current_operation->get_headers(),
+                                std::move(data) };
+            }
+            else if (res == ResponseStatus::HasMoreData || res == ResponseStatus::LastData)
+            {
+                p = HTTPPacket{ data };
+            }
+
+            add_shared_content(p, shared);
+
+            const auto more = res == ResponseStatus::HasMoreData || res == ResponseStatus::Pending;
+
+            if (chunked_response)
+            {
+                p.frame_as_chunk(!more);
+            }
+
+            if (p.get_send_size() > 0)
+            {
+                queued += p.get_send_size();
+                tx.put(std::move(p));
+            }
+
+            if (!more)
+            {
+                if (http_response && unanswered_requests > 0)
                 {
-                    auto& tx = this->container->get_tx_buffer();
-                    auto buffer_consumed_data = false;
+                    --unanswered_requests;
+                }
 
-                    if (mode == Mode::HTTP)
-                    {
-                        // Whether or not everything is sent, send the current (possibly header-only) packet.
-                        HTTPPacket p{ current_operation->get_response_code(), "1.1", headers, data };
-                        buffer_consumed_data = tx.put(p);
-                    }
-                    else
-                    {
-                        HTTPPacket p{ data };
-                        buffer_consumed_data = tx.put(p);
-                    }
+                current_operation.reset();
 
-                    if (!buffer_consumed_data
-                        || res == ResponseStatus::NoData)
-                    {
-                        current_operation.reset();
-                    }
+                if (close_after_response)
+                {
+                    // https://tools.ietf.org/html/rfc7230#section-6.6
+                    closing = true;
+                    break;
                 }
             }
+            else if (res == ResponseStatus::Pending)
+            {
+                // Continued once the operation has more data.
+                break;
+            }
+        }
+
+        update_flow_control();
+
+        idle = mode == Mode::HTTP
+               && unanswered_requests == 0
+               && !current_operation
+               && operations.empty();
+    }
+
+    void HTTPServerClient::set_wake_up(IResponseOperation& operation)
+    {
+        std::weak_ptr<core::network::BufferContainer<HTTPProtocol>> weak_container = container;
+        std::weak_ptr<core::network::ISocket> weak_socket = socket;
+
+        // Pretending that the transmit buffer has been emptied makes the client continue sending on its own task.
+        operation.set_wake_up([weak_container, weak_socket]() {
+                                  auto c = weak_container.lock();
+                                  auto s = weak_socket.lock();
+
+                                  if (c && s)
+                                  {
+                                      c->get_tx_empty()->push(core::network::event::TransmitBufferEmptyEvent(s));
+                                  }
+                              });
+    }
+
+    void HTTPServerClient::operation_enqueued(const IResponseOperation& operation)
+    {
+        const auto size = operation.get_buffered_size();
+        enqueued_bytes += size;
+
+        if (budget)
+        {
+            budget->reserve(size);
+        }
+    }
+
+    void HTTPServerClient::operation_dequeued(const IResponseOperation& operation)
+    {
+        // The content is still held until sent, but is from now on limited by the size of the transmit buffer.
+        const auto size = operation.get_buffered_size();
+        enqueued_bytes -= std::min(enqueued_bytes, size);
+
+        if (budget)
+        {
+            budget->release(size);
+        }
+    }
+
+    void HTTPServerClient::clear_operations()
+    {
+        for (const auto& op : operations)
+        {
+            operation_dequeued(*op);
+        }
+
+        operations.clear();
+    }
+
+    void HTTPServerClient::update_flow_control()
+    {
+        const auto budget_exhausted = budget && budget->is_exhausted();
+
+        const auto pause = operations.size() >= max_enqueued_responses
+                           || (max_enqueued_bytes > 0 && enqueued_bytes >= max_enqueued_bytes)
+                           || budget_exhausted;
+
+        if (budget_exhausted)
+        {
+            budget->wait(*this);
+        }
+
+        if (pause != receive_paused && socket)
+        {
+            receive_paused = pause;
+            socket->pause_receive(pause);
+        }
+    }
+
+    void HTTPServerClient::response_budget_available()
+    {
+        update_flow_control();
+    }
+
+    bool HTTPServerClient::select_transfer_coding(IResponseOperation& operation) const
+    {
+        const auto& headers = operation.get_headers();
+        const auto code = static_cast<int>(operation.get_response_code());
+
+        // Informational, 204 and 304 responses never have a body: https://tools.ietf.org/html/rfc7230#section-3.3.3
+        const auto has_body = code >= 200
+                              && code != static_cast<int>(ResponseCode::No_Content)
+                              && code != static_cast<int>(ResponseCode::Not_Modified);
+
+        const auto unknown_length = has_body
+                                    && headers.find(CONTENT_LENGTH) == headers.end()
+                                    && headers.find(TRANSFER_ENCODING) == headers.end();
+
+        if (unknown_length && chunked_allowed)
+        {
+            // The length of the response is unknown, send it in chunks as it is produced.
+            operation.set_header(TRANSFER_ENCODING, "chunked");
         }
-        while (!operations.empty()
-               && res == ResponseStatus::NoData); // Process next operation as long as no data is sent.
+
+        return !unknown_length || chunked_allowed;
+    }
+
+    bool HTTPServerClient::is_chunked(const IResponseOperation& operation)
+    {
+        const auto& headers = operation.get_headers();
+        auto transfer_encoding = headers.find(TRANSFER_ENCODING);
+
+        return transfer_encoding != headers.end() && transfer_encoding->second == "chunked";
+    }
+
+    bool HTTPServerClient::closes_connection(const IResponseOperation& operation)
+    {
+        const auto& headers = operation.get_headers();
+        auto connection = headers.find(CONNECTION);
+
+        return connection != headers.end() && string_util::icontains(connection->second, "close");
     }
 
     bool HTTPServerClient::translate_method(
@@ -302,49 +503,71 @@ namespace smooth::application::network::http
     {
         typename HTTPProtocol::packet_type packet;
 
-        if (event.get(packet))
+        // Handle all requests received so far, such as pipelined requests, before sending any of the
+        // responses so that they can be sent together.
+        handling_requests = true;
+        idle = false;
+
+        while (mode == Mode::HTTP && event.get(packet))
         {
-            bool first_packet = !packet.is_continuation();
-            bool last_packet = !packet.is_continued();
+            handle_request(packet);
+        }
 
-            bool res = true;
+        handling_requests = false;
 
-            if (first_packet)
-            {
-                // First packet, parse URL etc.
-                request_headers.clear();
-                std::swap(request_headers, packet.headers());
-                requested_url = packet.get_request_url();
-                res = parse_url(requested_url);
-                set_keep_alive();
-            }
+        if (!current_operation)
+        {
+            fill_tx_buffer();
+        }
+    }
+
+    void HTTPServerClient::handle_request(HTTPPacket& packet)
+    {
+        bool first_packet = !packet.is_continuation();
+        bool last_packet = !packet.is_continued();
+
+        bool res = true;
+
+        if (first_packet)
+        {
+            ++unanswered_requests;
+
+            // First packet, parse URL etc.
+            request_headers.clear();
+            std::swap(request_headers, packet.headers());
+            requested_url = packet.get_request_url();
+            res = parse_url(requested_url);
+
+            // HTTP/1.0 clients do not understand chunked responses.
+            chunked_allowed = packet.get_request_version() != "1.0";
+            set_keep_alive();
+        }
 
-            if (res)
+        if (res)
+        {
+            auto* context = this->get_client_context();
+
+            if (context)
             {
-                auto* context = this->get_client_context();
+                HTTPMethod method{};
 
-                if (context)
+                if (translate_method(packet, method))
                 {
-                    HTTPMethod method{};
-
-                    if (translate_method(packet, method))
-                    {
-                        context->handle(method,
-                                        *this,
-                                        *this,
-                                        requested_url,
-                                        request_headers,
-                                        request_parameters,
-                                        packet.get_buffer(),
-                                        first_packet,
-                                        last_packet);
-                    }
-                    else
-                    {
-                        // Unsupported method.
-                        reply(std::make_unique<regular::responses::StringResponse>(ResponseCode::Method_Not_Allowed),
-                              false);
-                    }
+                    context->handle(method,
+                                    *this,
+                                    *this,
+                                    requested_url,
+                                    request_headers,
+                                    request_parameters,
+                                    packet.get_buffer(),
+                                    first_packet,
+                                    last_packet);
+                }
+                else
+                {
+                    // Unsupported method.
+                    reply(std::make_unique<regular::responses::StringResponse>(ResponseCode::Method_Not_Allowed),
+                          false);
                 }
             }
         }
@@ -372,7 +595,11 @@ namespace smooth::application::network::http
             }
             else
             {
-                if (ws_server)
+                if (packet.is_ws_compressed())
+                {
+                    receive_compressed(packet);
+                }
+                else if (ws_server)
                 {
                     bool first_part = !packet.is_continuation();
                     bool last_part = !packet.is_continued();
@@ -382,4 +609,30 @@ namespace smooth::application::network::http
             }
         }
     }
+
+    void HTTPServerClient::receive_compressed(HTTPPacket& packet)
+    {
+        // Fragments following the first are sent as continuations, so the type is taken from the first.
+        if (packet.ws_control_code() != OpCode::Continuation)
+        {
+            compressed_text = packet.ws_control_code() == OpCode::Text;
+        }
+
+        auto receiver = [this](bool first_part, bool last_part, const std::vector<uint8_t>& part) {
+                            if (ws_server)
+                            {
+                                ws_server->data_received(first_part, last_part, compressed_text, part);
+                            }
+                        };
+
+        auto ok = message_deflate
+                  && message_deflate->decompress(packet.data(), packet.is_ws_message_end(), content_chunk_size,
+                                                 receiver);
+
+        if (!ok)
+        {
+            Log::error(tag, "Received websocket data that could not be decompressed");
+            close();
+        }
+    }
 }
@@ -0,0 +1,53 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <algorithm>
+#include "smooth/application/network/http/ResponseBudget.h"
+
+namespace smooth::application::network::http
+{
+    void ResponseBudget::release(std::size_t amount)
+    {
+        used -= std::min(used, amount);
+
+        if (!is_exhausted() && !waiting.empty())
+        {
+            // Listeners may start waiting again from within the notification.
+            auto to_notify = std::move(waiting);
+            waiting.clear();
+
+            for (auto* listener : to_notify)
+            {
+                listener->response_budget_available();
+            }
+        }
+    }
+
+    void ResponseBudget::wait(IResponseBudgetListener& listener)
+    {
+        if (std::find(waiting.begin(), waiting.end(), &listener) == waiting.end())
+        {
+            waiting.push_back(&listener);
+        }
+    }
+
+    void ResponseBudget::stop_waiting(IResponseBudgetListener& listener)
+    {
+        waiting.erase(std::remove(waiting.begin(), waiting.end(), &listener), waiting.end());
+    }
+}
@@ -18,7 +18,11 @@ limitations under the License.
 #include "smooth/application/network/http/http_utils.h"
 #include "smooth/core/util/string_util.h"
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <charconv>
+#include <string_view>
 #include <sstream>
 #include <iomanip>
 #include <mutex>
@@ -182,4 +186,188 @@ namespace smooth::application::network::http::utils
 
         return "";
     }
+
+    static std::string_view trim(std::string_view s)
+    {
+        auto begin = s.find_first_not_of(" \t");
+        auto end = s.find_last_not_of(" \t");
+
+        return begin == std::string_view::npos ? std::string_view{} : s.substr(begin, end - begin + 1);
+    }
+
+    /// Calls f with each trimmed, non-empty element of a comma separated header value until f returns false.
+    template<typename Func>
+    static void for_each_element(std::string_view list, Func f)
+    {
+        bool more = true;
+
+        while (more && !list.empty())
+        {
+            auto comma = list.find(',');
+            auto element = trim(list.substr(0, comma));
+            list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+            if (!element.empty())
+            {
+                more = f(element);
+            }
+        }
+    }
+
+    static bool iequals(std::string_view a, std::string_view b)
+    {
+        return a.size() == b.size()
+               && std::equal(a.begin(), a.end(), b.begin(), [](char c1, char c2) {
+                                 return std::tolower(static_cast<unsigned char>(c1))
+                                        == std::tolower(static_cast<unsigned char>(c2));
+                             });
+    }
+
+    bool accepts_encoding(const std::string& accept_encoding, const std::string& coding)
+    {
+        bool explicitly = false;
+        bool wildcard = false;
+        bool res = false;
+
+        for_each_element(accept_encoding, [&](std::string_view element) {
+                             auto semicolon = element.find(';');
+                             auto name = trim(element.substr(0, semicolon));
+                             bool acceptable = true;
+
+                             if (semicolon != std::string_view::npos)
+                             {
+                                 // A quality value of zero means "not acceptable", e.g. "gzip;q=0" or "gzip; q=0.000"
+                                 auto q = trim(element.substr(semicolon + 1));
+
+                                 if (q.size() > 2 && (q[0] == 'q' || q[0] == 'Q') && q[1] == '=')
+                                 {
+                                     acceptable = q.find_first_not_of("0.", 2) != std::string_view::npos;
+                                 }
+                             }
+
+                             if (iequals(name, coding))
+                             {
+                                 explicitly = true;
+                                 res = acceptable;
+                             }
+                             else if (name == "*")
+                             {
+                                 wildcard = acceptable;
+                             }
+
+                             return !explicitly;
+                         });
+
+        return explicitly ? res : wildcard;
+    }
+
+    bool matches_etag(const std::string& if_none_match, const std::string& etag)
+    {
+        auto opaque = [](std::string_view tag) {
+                          return tag.compare(0, 2, "W/") == 0 ? tag.substr(2) : tag;
+                      };
+
+        bool res = false;
+
+        for_each_element(if_none_match, [&](std::string_view element) {
+                             res = element == "*" || opaque(element) == opaque(etag);
+
+                             return !res;
+                         });
+
+        return res;
+    }
+
+    RangeStatus parse_byte_ranges(const std::string& range,
+                                  std::size_t size,
+                                  std::vector<ByteRange>& ranges,
+                                  std::size_t max_ranges)
+    {
+        auto parse_number = [](std::string_view s, std::size_t& n) {
+                                auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), n);
+
+                                return !s.empty() && ec == std::errc{} && end == s.data() + s.size();
+                            };
+
+        ranges.clear();
+
+        std::string_view value{ range };
+        auto equal_sign = value.find('=');
+        bool valid = equal_sign != std::string_view::npos && iequals(trim(value.substr(0, equal_sign)), "bytes");
+        std::size_t count = 0;
+
+        if (valid)
+        {
+            for_each_element(value.substr(equal_sign + 1), [&](std::string_view element) {
+                                 auto dash = element.find('-');
+                                 valid = dash != std::string_view::npos && ++count <= max_ranges;
+
+                                 if (valid)
+                                 {
+                                     auto first_pos = trim(element.substr(0, dash));
+                                     auto last_pos = trim(element.substr(dash + 1));
+                                     std::size_t first = 0;
+                                     std::size_t last = 0;
+
+                                     if (first_pos.empty())
+                                     {
+                                         // Suffix range, i.e. the last N bytes, e.g. "-500"
+                                         valid = parse_number(last_pos, last);
+
+                                         if (valid && last > 0 && size > 0)
+                                         {
+                                             auto length = std::min(last, size);
+                                             ranges.push_back({ size - length, length });
+                                         }
+                                     }
+                                     else
+                                     {
+                                         // "500-999" or "500-"
+                                         valid = parse_number(first_pos, first)
+                                                 && (last_pos.empty()
+                                                     || (parse_number(last_pos, last) && last >= first));
+
+                                         if (valid && first < size)
+                                         {
+                                             last = last_pos.empty() ? size - 1 : std::min(last, size - 1);
+                                             ranges.push_back({ first, last - first + 1 });
+                                         }
+                                     }
+                                 }
+
+                                 return valid;
+                             });
+        }
+
+        auto res = RangeStatus::Ignore;
+
+        if (!valid || count == 0)
+        {
+            ranges.clear();
+        }
+        else
+        {
+            res = ranges.empty() ? RangeStatus::Unsatisfiable : RangeStatus::Satisfiable;
+        }
+
+        return res;
+    }
+
+    bool matches_if_range(const std::string& if_range, const std::string& etag, time_t last_modified)
+    {
+        auto value = trim(if_range);
+        bool res;
+
+        if (!value.empty() && (value.front() == '"' || value.compare(0, 2, "W/") == 0))
+        {
+            // Weak entity tags never match.
+            res = value.front() == '"' && value == etag;
+        }
+        else
+        {
+            res = parse_http_time(std::string{ value }) == system_clock::from_time_t(last_modified);
+        }
+
+        return res;
+    }
 }
@@ -0,0 +1,166 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/AssetCache.h"
+#include <vector>
+#include <fmt/format.h>
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/filesystem/MemoryMappedFile.h"
+
+using namespace smooth::core::filesystem;
+
+namespace smooth::application::network::http::regular
+{
+    static time_t last_modified_of(const FileInfo& info)
+    {
+        return info.is_regular_file() ? info.last_modified() : 0;
+    }
+
+    std::shared_ptr<const AssetCache::Asset> AssetCache::get(const Path& path, time_t last_modified)
+    {
+        std::shared_ptr<const Asset> res{};
+        std::string key{ static_cast<const char*>(path) };
+        auto gzip_name = key + ".gz";
+        Path gzip_path{ gzip_name.c_str() };
+        FileInfo gzip_info{ gzip_path };
+
+        auto existing = by_path.find(key);
+
+        if (existing != by_path.end())
+        {
+            const auto& cached = *existing->second->second;
+
+            // The precompressed sibling may have been rebuilt, or added, without the file changing. A mapped
+            // file that has been truncated must not be used either, it is reloaded as it is now.
+            if (cached.last_modified == last_modified
+                && cached.gzip_last_modified == last_modified_of(gzip_info)
+                && cached.identity.is_intact()
+                && cached.gzip.is_intact())
+            {
+                // Move to front, as the most recently used.
+                entries.splice(entries.begin(), entries, existing->second);
+                res = entries.front().second;
+            }
+            else
+            {
+                erase(existing->second);
+            }
+        }
+
+        if (!res && budget > 0)
+        {
+            FileInfo info{ path };
+
+            // Only use the compressed variant if it is at least as new as the file it is made from.
+            auto use_gzip = gzip_info.is_regular_file() && gzip_info.last_modified() >= last_modified;
+            const auto limit = budget / 4;
+
+            // Find out if the file fits before loading and hashing it, which would otherwise be done
+            // on every request for a file that is then discarded.
+            if (info.is_regular_file() && info.size() + (use_gzip ? gzip_info.size() : 0) <= limit)
+            {
+                auto asset = std::make_shared<Asset>();
+                asset->identity = load(path, "");
+                asset->content_type = utils::get_content_type(path);
+                asset->last_modified = last_modified;
+                asset->gzip_last_modified = last_modified_of(gzip_info);
+
+                if (use_gzip)
+                {
+                    asset->gzip = load(gzip_path, "-gz");
+                }
+
+                // The files may have changed since they were looked at.
+                auto size = size_of(*asset);
+
+                if (asset->identity.exists() && size <= limit)
+                {
+                    while (!entries.empty() && used + size > budget)
+                    {
+                        erase(std::prev(entries.end()));
+                    }
+
+                    used += size;
+                    entries.emplace_front(key, asset);
+                    by_path[key] = entries.begin();
+                    res = std::move(asset);
+                }
+            }
+        }
+
+        return res;
+    }
+
+    void AssetCache::clear()
+    {
+        by_path.clear();
+        entries.clear();
+        used = 0;
+    }
+
+    AssetCache::Variant AssetCache::load(const Path& path, const char* etag_suffix)
+    {
+        Variant res{};
+
+        auto mapping = std::make_shared<MemoryMappedFile>(path);
+
+        if (mapping->is_mapped())
+        {
+            res.data = mapping->data();
+            res.size = mapping->size();
+            res.mapping = mapping;
+            res.owner = std::move(mapping);
+        }
+        else
+        {
+            // Not mapped, either because mmap() isn't available or because the file is empty.
+            auto content = std::make_shared<std::vector<uint8_t>>();
+
+            if (File{ static_cast<const char*>(path) }.read(*content))
+            {
+                res.data = content->data();
+                res.size = content->size();
+                res.owner = std::move(content);
+            }
+        }
+
+        if (res.exists())
+        {
+            // FNV-1a of the content makes a strong validator that is the same across restarts.
+            uint64_t hash = 14695981039346656037ULL;
+
+            for (std::size_t i = 0; i < res.size; ++i)
+            {
+                hash = (hash ^ res.data[i]) * 1099511628211ULL;
+            }
+
+            res.etag = fmt::format("\"{:016x}{}\"", hash, etag_suffix);
+        }
+
+        return res;
+    }
+
+    void AssetCache::erase(std::list<Entry>::iterator entry)
+    {
+        used -= size_of(*entry->second);
+        by_path.erase(entry->first);
+        entries.erase(entry);
+    }
+}
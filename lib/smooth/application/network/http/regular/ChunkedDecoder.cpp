@@ -0,0 +1,186 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/ChunkedDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace smooth::application::network::http::regular
+{
+    static int hex_value(uint8_t c)
+    {
+        int res = -1;
+
+        if (c >= '0' && c <= '9')
+        {
+            res = c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            res = c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            res = c - 'A' + 10;
+        }
+
+        return res;
+    }
+
+    void ChunkedDecoder::reset()
+    {
+        state = State::Size;
+        chunk_remaining = 0;
+        line_length = 0;
+        size_digits = 0;
+        last_consumed = 0;
+    }
+
+    std::size_t ChunkedDecoder::decode(uint8_t* data, std::size_t length)
+    {
+        std::size_t decoded = 0;
+        std::size_t pos = 0;
+
+        while (pos < length && state != State::Done && state != State::Error)
+        {
+            if (state == State::Data)
+            {
+                const auto amount = std::min(chunk_remaining, length - pos);
+
+                if (decoded != pos)
+                {
+                    std::memmove(data + decoded, data + pos, amount);
+                }
+
+                decoded += amount;
+                pos += amount;
+                chunk_remaining -= amount;
+
+                if (chunk_remaining == 0)
+                {
+                    state = State::DataCR;
+                }
+            }
+            else
+            {
+                const auto c = data[pos++];
+
+                // Guard against never-ending chunk extensions or trailers.
+                if (++line_length > max_line_length)
+                {
+                    state = State::Error;
+                }
+                else if (state == State::Size)
+                {
+                    size_digit(c);
+                }
+                else if (state == State::Extension)
+                {
+                    if (c == '\r')
+                    {
+                        state = State::SizeLF;
+                    }
+                }
+                else if (state == State::SizeLF)
+                {
+                    if (c == '\n')
+                    {
+                        size_line_end();
+                    }
+                    else
+                    {
+                        state = State::Error;
+                    }
+                }
+                else if (state == State::DataCR)
+                {
+                    state = c == '\r' ? State::DataLF : State::Error;
+                }
+                else if (state == State::DataLF)
+                {
+                    state = c == '\n' ? State::Size : State::Error;
+                    line_length = 0;
+                    size_digits = 0;
+                }
+                else if (state == State::LineStart)
+                {
+                    // Either the empty line ending the message, or a trailer field.
+                    state = c == '\r' ? State::EndLF : State::Trailer;
+                }
+                else if (state == State::Trailer)
+                {
+                    if (c == '\n')
+                    {
+                        state = State::LineStart;
+                        line_length = 0;
+                    }
+                }
+                else if (state == State::EndLF)
+                {
+                    state = c == '\n' ? State::Done : State::Error;
+                }
+            }
+        }
+
+        last_consumed = pos;
+
+        return decoded;
+    }
+
+    void ChunkedDecoder::size_digit(uint8_t c)
+    {
+        const auto value = hex_value(c);
+
+        if (value >= 0)
+        {
+            if (++size_digits > max_size_digits)
+            {
+                state = State::Error;
+            }
+            else
+            {
+                chunk_remaining = chunk_remaining * 16 + static_cast<std::size_t>(value);
+            }
+        }
+        else if (size_digits == 0)
+        {
+            state = State::Error;
+        }
+        else if (c == '\r')
+        {
+            state = State::SizeLF;
+        }
+        else if (c == ';' || c == ' ' || c == '\t')
+        {
+            // Chunk extensions are not used, skip them.
+            state = State::Extension;
+        }
+        else
+        {
+            state = State::Error;
+        }
+    }
+
+    void ChunkedDecoder::size_line_end()
+    {
+        line_length = 0;
+
+        // A chunk of size zero is the last one and is followed by optional trailers.
+        state = chunk_remaining > 0 ? State::Data : State::LineStart;
+    }
+}
@@ -0,0 +1,113 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/CompiledTemplate.h"
+#include <algorithm>
+#include <cctype>
+
+namespace smooth::application::network::http::regular
+{
+    CompiledTemplate::CompiledTemplate(std::string text)
+            : data(std::move(text))
+    {
+        compile();
+    }
+
+    void CompiledTemplate::compile()
+    {
+        std::size_t literal_start = 0;
+        std::size_t pos = data.find("{{");
+
+        while (pos != std::string::npos)
+        {
+            auto length = token_length(data, pos);
+
+            if (length > 0)
+            {
+                add_literal(literal_start, pos - literal_start);
+
+                auto token = data.substr(pos, length);
+                auto existing = std::find(key_names.begin(), key_names.end(), token);
+                auto index = static_cast<std::size_t>(std::distance(key_names.begin(), existing));
+
+                if (existing == key_names.end())
+                {
+                    key_names.emplace_back(std::move(token));
+                }
+
+                parts.push_back({ pos, length, index });
+
+                literal_start = pos + length;
+                pos = data.find("{{", literal_start);
+            }
+            else
+            {
+                // Not a key, but a key may still start at the next brace, as in "{{{key}}".
+                pos = data.find("{{", pos + 1);
+            }
+        }
+
+        add_literal(literal_start, data.size() - literal_start);
+    }
+
+    void CompiledTemplate::add_literal(std::size_t offset, std::size_t length)
+    {
+        if (length > 0)
+        {
+            parts.push_back({ offset, length, no_key });
+            literal_length += length;
+        }
+    }
+
+    std::size_t CompiledTemplate::token_length(const std::string& text, std::size_t offset)
+    {
+        // Expects text[offset] to be the start of "{{"
+        auto pos = offset + 2;
+
+        while (pos < text.size()
+               && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_' || text[pos] == '-'))
+        {
+            ++pos;
+        }
+
+        auto has_name = pos > offset + 2;
+        auto closed = text.compare(pos, 2, "}}") == 0;
+
+        return has_name && closed ? pos + 2 - offset : 0;
+    }
+
+    std::string CompiledTemplate::render(const std::vector<std::string>& values) const
+    {
+        std::string res{};
+        res.reserve(literal_length);
+
+        for (const auto& s : parts)
+        {
+            if (s.is_key())
+            {
+                res.append(values[s.key]);
+            }
+            else
+            {
+                res.append(data, s.offset, s.length);
+            }
+        }
+
+        return res;
+    }
+}
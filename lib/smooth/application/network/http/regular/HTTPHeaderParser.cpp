@@ -0,0 +1,178 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+#include <cstring>
+
+namespace smooth::application::network::http::regular
+{
+    static constexpr std::string_view version_prefix{ "HTTP/" };
+
+    static bool is_whitespace(uint8_t c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    static HTTPHeaderParser::Span make_span(std::size_t begin, std::size_t end)
+    {
+        return { static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin) };
+    }
+
+    HTTPHeaderParser::Result HTTPHeaderParser::parse(const uint8_t* data, std::size_t length)
+    {
+        while (result == Result::NeedMoreData && scan_pos < length)
+        {
+            const auto* line_feed = static_cast<const uint8_t*>(std::memchr(data + scan_pos, '\n', length - scan_pos));
+
+            if (line_feed)
+            {
+                auto end = static_cast<std::size_t>(line_feed - data);
+                scan_pos = end + 1;
+                result = parse_line(data, line_start, end);
+                line_start = scan_pos;
+            }
+            else
+            {
+                scan_pos = length;
+            }
+        }
+
+        return result;
+    }
+
+    void HTTPHeaderParser::reset()
+    {
+        count = 0;
+        line_start = 0;
+        scan_pos = 0;
+        end_of_headers = 0;
+        start_line_parsed = false;
+        request = false;
+        result = Result::NeedMoreData;
+    }
+
+    HTTPHeaderParser::Result HTTPHeaderParser::parse_line(const uint8_t* data, std::size_t begin, std::size_t end)
+    {
+        auto res = Result::NeedMoreData;
+        auto line_end = end;
+
+        // Lines end with CRLF, but a single LF is also accepted: https://tools.ietf.org/html/rfc7230#section-3.5
+        if (line_end > begin && data[line_end - 1] == '\r')
+        {
+            --line_end;
+        }
+
+        if (begin == line_end)
+        {
+            // Empty lines before the start line are ignored, after it they end the headers.
+            if (start_line_parsed)
+            {
+                end_of_headers = end + 1;
+                res = Result::Complete;
+            }
+        }
+        else if (!start_line_parsed)
+        {
+            start_line_parsed = parse_start_line(data, begin, line_end);
+            res = start_line_parsed ? Result::NeedMoreData : Result::Malformed;
+        }
+        else
+        {
+            res = parse_header(data, begin, line_end);
+        }
+
+        return res;
+    }
+
+    bool HTTPHeaderParser::parse_start_line(const uint8_t* data, std::size_t begin, std::size_t end)
+    {
+        // "GET / HTTP/1.1" or "HTTP/1.1 200 OK"; the reason phrase may contain spaces, or be empty.
+        auto line = view(data, make_span(begin, end));
+        auto first = line.find(' ');
+        auto second = first == std::string_view::npos ? first : line.find(' ', first + 1);
+
+        bool res = second != std::string_view::npos && first > 0 && second > first + 1;
+
+        if (res)
+        {
+            start[0] = make_span(begin, begin + first);
+            start[1] = make_span(begin + first + 1, begin + second);
+            start[2] = make_span(begin + second + 1, end);
+
+            if (line.compare(0, version_prefix.size(), version_prefix) == 0)
+            {
+                request = false;
+                start[0] = make_span(begin + version_prefix.size(), begin + first);
+            }
+            else
+            {
+                request = true;
+                res = line.compare(second + 1, version_prefix.size(), version_prefix) == 0;
+                start[2] = make_span(begin + second + 1 + version_prefix.size(), end);
+            }
+
+            // A request must have a version, a response may lack the reason phrase.
+            res = res && start[0].length > 0 && (start[2].length > 0 || !request);
+        }
+
+        return res;
+    }
+
+    HTTPHeaderParser::Result HTTPHeaderParser::parse_header(const uint8_t* data, std::size_t begin, std::size_t end)
+    {
+        auto res = Result::NeedMoreData;
+
+        const auto* colon = static_cast<const uint8_t*>(std::memchr(data + begin, ':', end - begin));
+
+        // Obsolete line folding is rejected, as is whitespace between the name and the colon:
+        // https://tools.ietf.org/html/rfc7230#section-3.2.4
+        if (colon == nullptr
+            || colon == data + begin
+            || is_whitespace(data[begin])
+            || is_whitespace(*(colon - 1)))
+        {
+            res = Result::Malformed;
+        }
+        else if (count == headers.size())
+        {
+            res = Result::TooManyHeaders;
+        }
+        else
+        {
+            auto name_end = static_cast<std::size_t>(colon - data);
+            auto value_begin = name_end + 1;
+            auto value_end = end;
+
+            while (value_begin < value_end && is_whitespace(data[value_begin]))
+            {
+                ++value_begin;
+            }
+
+            while (value_end > value_begin && is_whitespace(data[value_end - 1]))
+            {
+                --value_end;
+            }
+
+            auto& header = headers[count++];
+            header.name = make_span(begin, name_end);
+            header.value = make_span(value_begin, value_end);
+        }
+
+        return res;
+    }
+}
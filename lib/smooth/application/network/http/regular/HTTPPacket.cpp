@@ -20,6 +20,8 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <algorithm>
+#include <utility>
+#include <cstdio>
 #include "smooth/application/network/http/http_utils.h"
 
 namespace smooth::application::network::http
@@ -28,7 +30,8 @@ namespace smooth::application::network::http
 
     HTTPPacket::HTTPPacket(ResponseCode code, const std::string& version,
                            const std::unordered_map<std::string, std::string>& new_headers,
-                           const std::vector<uint8_t>& response_content)
+                           std::vector<uint8_t> response_content)
+        : body(std::move(response_content))
     {
         append("HTTP/");
         append(version);
@@ -48,17 +51,14 @@ namespace smooth::application::network::http
 
         // Add required ending CRLF
         append("\r\n");
-
-        if (!response_content.empty())
-        {
-            std::copy(response_content.begin(), response_content.end(), std::back_inserter(content));
-        }
+        head_length = content.size();
     }
 
     HTTPPacket::HTTPPacket(HTTPMethod method,
                            const std::string& url,
                            const std::unordered_map<std::string, std::string>& new_headers,
-                           const std::vector<uint8_t>& response_content)
+                           std::vector<uint8_t> response_content)
+        : body(std::move(response_content))
     {
         append(utils::http_method_to_string(method));
         append(" ");
@@ -76,10 +76,34 @@ namespace smooth::application::network::http
 
         // Add required ending CRLF
         append("\r\n");
+        head_length = content.size();
+    }
 
-        if (!response_content.empty())
+    void HTTPPacket::frame_as_chunk(bool last_chunk)
+    {
+        static constexpr std::array<uint8_t, 2> crlf{ '\r', '\n' };
+        static constexpr std::array<uint8_t, 7> crlf_last_chunk{ '\r', '\n', '0', '\r', '\n', '\r', '\n' };
+
+        if (head_length == 0 && body.empty())
+        {
+            // Packets continuing a response hold the body in content; move it to where the chunk data goes.
+            body.swap(content);
+        }
+
+        const auto size = body_size();
+
+        if (size > 0)
+        {
+            std::array<char, 20> chunk_size{};
+            auto length = std::snprintf(chunk_size.data(), chunk_size.size(), "%zx\r\n", size);
+            content.insert(content.end(), chunk_size.data(), chunk_size.data() + length);
+
+            chunk_trailer = last_chunk ? crlf_last_chunk.data() : crlf.data();
+            chunk_trailer_length = last_chunk ? crlf_last_chunk.size() : crlf.size();
+        }
+        else if (last_chunk)
         {
-            std::copy(response_content.begin(), response_content.end(), std::back_inserter(content));
+            append("0\r\n\r\n");
         }
     }
 
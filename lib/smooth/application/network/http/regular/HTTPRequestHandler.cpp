@@ -10,8 +10,11 @@ namespace smooth::application::network::http::regular
         // In case the expected headers don't exist, catch any exceptions.
         try
         {
+            // Chunked requests have no Content-Length, their length is unknown until the last part.
+            auto content_length = headers().find(CONTENT_LENGTH);
+
             mime.detect_mode(headers().at(CONTENT_TYPE),
-                            std::stoul(headers().at(CONTENT_LENGTH)));
+                             content_length == headers().end() ? 0 : std::stoul(content_length->second));
         }
         catch (...)
         {
@@ -23,12 +26,14 @@ namespace smooth::application::network::http::regular
                                                 bool last_part,
                                                 IServerResponse& response,
                                                 const std::unordered_map<std::string, std::string>& headers,
-                                                const std::unordered_map<std::string, std::string>& request_parameters)
+                                                const std::unordered_map<std::string, std::string>& request_parameters,
+                                                const std::unordered_map<std::string, std::string>& path_parameters)
     {
         request_params.first_part = first_part;
         request_params.last_part = last_part;
         request_params.response = &response;
         request_params.headers = &headers;
         request_params.request_parameters = &request_parameters;
+        request_params.path_parameters = &path_parameters;
     }
 }
@@ -16,6 +16,8 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/regular/MIMEParser.h"
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include "smooth/core/util/split.h"
 #include "smooth/core/util/string_util.h"
@@ -31,15 +33,23 @@ using namespace smooth::core;
 
 namespace smooth::application::network::http::regular
 {
+    static constexpr const char* tag = "MIMEParser";
+
+    // Limits for the headers of each part and the line following a boundary.
+    static constexpr std::size_t max_part_header_size = 4096;
+    static constexpr std::size_t max_delimiter_line_size = 256;
+
     void MIMEParser::reset() noexcept
     {
-        boundary.clear();
-        end_boundary.clear();
+        delimiter = BoyerMooreHorspool{};
+        held_back.clear();
+        staged.clear();
+        header_block.clear();
         form_url_encoded_data.clear();
         data.clear();
         expected_content_length = 0;
         mode = Mode::None;
-        end_of_transmission = false;
+        first_part = false;
         parse_status = ParseStatus::Begin;
     }
 
@@ -57,19 +67,14 @@ namespace smooth::application::network::http::regular
             // of the preceding part. The boundary must be followed immediately either by another CRLF and the header
             // fields for the next part, or by two CRLFs, in which case there are no header fields for the next part
             // (and it is therefore assumed to be of Content-Type text/plain).
+            std::vector<uint8_t> pattern{ '\r', '\n', '-', '-' };
+            pattern.insert(pattern.end(), b.begin(), b.end());
+            delimiter = BoyerMooreHorspool{ std::move(pattern) };
 
-            // Note that we don't include the leading CRLF in the boundary pattern - that is handled separately
-            // so that we also match the very first boundary after the HTTP-headers.
-            boundary = { b.begin(), b.end() };
-            boundary.insert(boundary.begin(), '-');
-            boundary.insert(boundary.begin(), '-');
-            end_boundary = boundary;
-
-            // The ending boundary is the same as the normal one, but suffixed by "--\r\n" instead of just \r\n
-            end_boundary.emplace_back('-');
-            end_boundary.emplace_back('-');
-            end_boundary.emplace_back('\r');
-            end_boundary.emplace_back('\n');
+            // The very first boundary may directly follow the HTTP headers, without a preceding CRLF.
+            // Pretend there was one so that it is found just like the others.
+            held_back = { '\r', '\n' };
+            parse_status = ParseStatus::Begin;
 
             mode = Mode::FormData;
         }
@@ -83,245 +88,344 @@ namespace smooth::application::network::http::regular
         return mode != Mode::None;
     }
 
-    auto MIMEParser::find_boundary() const
+    void MIMEParser::parse(const uint8_t* p, std::size_t length, IFormData& form_data, IURLEncodedData& url_data,
+                           const uint16_t chunksize)
     {
-        BoundaryIterator p = data.cend();
+        if (mode == Mode::FormData)
+        {
+            std::size_t consumed = 0;
+
+            while (consumed < length && parse_status != ParseStatus::End)
+            {
+                const auto* current = p + consumed;
+                const auto remaining = length - consumed;
 
-        if (data.size() > boundary.size() + LEN_OF_CRLF)
+                if (parse_status == ParseStatus::Headers)
+                {
+                    consumed += parse_headers(current, remaining);
+                }
+                else if (parse_status == ParseStatus::Delimiter)
+                {
+                    consumed += parse_delimiter(current, remaining);
+                }
+                else
+                {
+                    consumed += parse_body(current, remaining, form_data, chunksize);
+                }
+            }
+        }
+        else if (mode == Mode::FormURLEncoded)
         {
-            p = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
+            data.insert(data.end(), p, p + length);
+            parse_url_encoded(url_data);
         }
-
-        return p;
     }
 
-    auto MIMEParser::find_end_boundary() const
+    std::size_t MIMEParser::parse_body(const uint8_t* p, std::size_t length, IFormData& form_data,
+                                       uint16_t chunksize)
     {
-        BoundaryIterator p = data.cend();
+        // Before the first boundary, the preamble is searched through the same way as part data, but discarded.
+        auto consumed = match_held_back(p, length, form_data, chunksize);
 
-        if (data.size() >= end_boundary.size())
+        if (parse_status != ParseStatus::Delimiter && consumed < length)
         {
-            p = std::search(data.cbegin(), data.cend(), end_boundary.cbegin(), end_boundary.cend());
+            const auto* begin = p + consumed;
+            const auto* end = p + length;
+            const auto* found = delimiter.find(begin, end);
+
+            if (found != end)
+            {
+                deliver(begin, static_cast<std::size_t>(found - begin), true, form_data, chunksize);
+                parse_status = ParseStatus::Delimiter;
+                consumed = static_cast<std::size_t>(found - p) + delimiter.size();
+            }
+            else
+            {
+                // Hold back what may be the start of a delimiter and hand over the rest.
+                const auto size = static_cast<std::size_t>(end - begin);
+                const auto keep = partial_delimiter_at_end(begin, size);
+                deliver(begin, size - keep, false, form_data, chunksize);
+                held_back.assign(end - keep, end);
+                consumed = length;
+            }
         }
 
-        return p;
+        return consumed;
     }
 
-    void MIMEParser::parse(const uint8_t* p, std::size_t length, IFormData& form_data, IURLEncodedData& url_data,
-                           const uint16_t chunksize)
+    std::size_t MIMEParser::match_held_back(const uint8_t* p, std::size_t length, IFormData& form_data,
+                                            uint16_t chunksize)
     {
-        BoundaryIterator begin{};
-        BoundaryIterator end{};
-        bool get_more_data = false;
+        std::size_t consumed = 0;
 
-        for (std::size_t i = 0; i < length; ++i)
+        if (!held_back.empty())
         {
-            data.emplace_back(p[i]);
-        }
-
-        // data.reserve(data.size()+length+1);
-        // std::copy(&p[0], &p[length], data.end());
-        // Log::info("MIMEParser::myparse", "length={}; data.size()={}", length, data.size());
+            const auto& pattern = delimiter.pattern();
+            bool resolved = false;
 
-        if (mode == Mode::FormData)
-        {
-            while (!end_of_transmission && !get_more_data)
+            // The held back bytes are shorter than the delimiter, so a delimiter starting within them
+            // must continue at the start of the new data.
+            for (std::size_t start = 0; !resolved && start < held_back.size(); ++start)
             {
-                if (parse_status == ParseStatus::Begin)
-                {
-                    begin = find_boundary();
-
-                    if (begin != data.cend())  // begin boundary found
-                    {
-                        parse_status = ParseStatus::Headers;
+                const auto held = held_back.size() - start;
+                const auto needed = pattern.size() - held;
+                const auto available = std::min(needed, length);
 
-                        // "+LEN_OF_CRLF": also delete trailing crlf
-                        data.erase(data.begin(), get_end_of_boundary(begin) + LEN_OF_CRLF);
-                    }
-                    else
-                    {
-                        get_more_data = true;
-                    }
-                }
-                else if (parse_status == ParseStatus::Headers)
+                if (std::memcmp(held_back.data() + start, pattern.data(), held) == 0
+                    && std::memcmp(p, pattern.data() + held, available) == 0)
                 {
-                    auto p = std::search(data.cbegin(), data.cend(), crlf_double.cbegin(), crlf_double.cend());
+                    resolved = true;
 
-                    if (p != data.cend())  // end of headers found
+                    if (available == needed)
                     {
-                        auto [new_start_of_content, headers,
-                              content_disposition] = consume_headers(data.cbegin(), p + 2 * LEN_OF_CRLF);
-                        id = content_disposition["name"];
-                        filename = content_disposition["filename"];
-
-                        // Delete two CRLF
-                        data.erase(data.begin(), p + 2 * LEN_OF_CRLF);
-                        parse_status = ParseStatus::Data;
-                        first_part = true;
+                        deliver(held_back.data(), start, true, form_data, chunksize);
+                        held_back.clear();
+                        parse_status = ParseStatus::Delimiter;
+                        consumed = needed;
                     }
                     else
                     {
-                        get_more_data = true;
+                        // Still undecided, wait for more data.
+                        deliver(held_back.data(), start, false, form_data, chunksize);
+                        held_back.erase(held_back.begin(),
+                                        held_back.begin() + static_cast<MimeData::difference_type>(start));
+                        held_back.insert(held_back.end(), p, p + length);
+                        consumed = length;
                     }
                 }
-                else if (parse_status == ParseStatus::Data)
-                {
-                    auto b = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
+            }
 
-                    if ((data.size() > chunksize + end_boundary.size()) || (b != data.cend()))  // got something to
-                                                                                                // write
-                    {
-                        while (std::distance(data.cbegin(), b - LEN_OF_CRLF) > chunksize)
-                        {
-                            form_data.form_data(id,
-                            filename,
-                            data.cbegin(),
-                            data.cbegin() + chunksize,
-                            first_part,
-                            false);
-                            data.erase(data.begin(), data.begin() + chunksize);
-                            first_part = false;
-                            b = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
-                        }
+            if (!resolved)
+            {
+                deliver(held_back.data(), held_back.size(), false, form_data, chunksize);
+                held_back.clear();
+            }
+        }
 
-                        if (b != data.cend())
-                        {
-                            form_data.form_data(id, filename, data.cbegin(), b - LEN_OF_CRLF, first_part, true);  // first_b-2
-                                                                                                                  // to
-                            // avoid additional
-                            // crlf in file end
-                            parse_status = ParseStatus::Headers;
-                            data.erase(data.begin(), b - LEN_OF_CRLF);
-                            first_part = false;
-
-                            if (std::distance(data.cbegin(), find_end_boundary()) <= 2 * LEN_OF_CRLF)
-                            {
-                                end_of_transmission = true;
-                                data.clear();
-                            }
-                        }
-                    }
-                    else
-                    {
-                        get_more_data = true;
-                    }
-                }
-            }  // while(!end_of_transmission && !get_more_data)
+        return consumed;
+    }
 
-            end_of_transmission = false;
-        }
-        else if (mode == Mode::FormURLEncoded)
+    std::size_t MIMEParser::partial_delimiter_at_end(const uint8_t* p, std::size_t length) const
+    {
+        // Finds the longest tail of the data that is also the beginning of the delimiter.
+        const auto& pattern = delimiter.pattern();
+        std::size_t res = 0;
+
+        for (auto size = std::min(pattern.size() - 1, length); res == 0 && size > 0; --size)
         {
-            // URL encoded data can't be parsed in chunks, so wait until all data is received
-            if (data.size() >= expected_content_length)
+            const auto* tail = p + length - size;
+
+            if (*tail == pattern[0] && std::memcmp(tail, pattern.data(), size) == 0)
             {
-                // Split data on '&' as it comes in. Each part is then expected to contain X=Y, so split on '='.
-                // If a part doesn't contain a '=', put it back in the buffer to be used next time.
-                // The way this works is that split() places any leftovers last in the returned vector
-                // which means that it will be encountered last, thus the loops end at the same time.
+                res = size;
+            }
+        }
 
-                auto parts = split(data, std::vector<uint8_t>{ '&' });
+        return res;
+    }
 
-                if (!parts.empty())
-                {
-                    data.clear();
-                }
+    std::size_t MIMEParser::parse_delimiter(const uint8_t* p, std::size_t length)
+    {
+        // The delimiter is followed by either "--", ending the multipart content, or by optional
+        // whitespace and a CRLF, after which the headers of the next part follow.
+        std::size_t consumed = 0;
 
-                URLEncoding encoding{};
+        while (consumed < length && parse_status == ParseStatus::Delimiter)
+        {
+            const auto c = static_cast<char>(p[consumed++]);
+            header_block.push_back(c);
 
-                for (const auto& part : parts)
-                {
-                    auto equal_sign = std::find(part.cbegin(), part.cend(), '=');
+            if (header_block.size() == 2 && header_block == "--")
+            {
+                parse_status = ParseStatus::End;
+            }
+            else if (c == '\n')
+            {
+                // Keep the CRLF so that a part without headers is found by the same search as the end of headers.
+                header_block = "\r\n";
+                parse_status = ParseStatus::Headers;
+            }
+            else if (header_block.size() > max_delimiter_line_size)
+            {
+                Log::error(tag, "Malformed multipart boundary");
+                parse_status = ParseStatus::End;
+            }
+        }
 
-                    if (equal_sign == part.cend())
-                    {
-                        std::copy(std::make_move_iterator(part.begin()),
-                                  std::make_move_iterator(part.end()),
-                                  std::back_inserter(data));
-                    }
-                    else
-                    {
-                        auto key_value = split(part, std::vector<uint8_t>{ '=' });
+        return consumed;
+    }
 
-                        if (!key_value.empty())
-                        {
-                            std::string key{ key_value[0].begin(), key_value[0].end() };
-                            auto key_res = encoding.decode(key, key.begin(), key.end());
+    std::size_t MIMEParser::parse_headers(const uint8_t* p, std::size_t length)
+    {
+        std::size_t consumed = 0;
 
-                            std::string value{ key_value[1].begin(), key_value[1].end() };
-                            auto value_res = encoding.decode(value, value.begin(), value.end());
+        while (consumed < length && parse_status == ParseStatus::Headers)
+        {
+            const auto* start = p + consumed;
+            const auto* new_line = static_cast<const uint8_t*>(std::memchr(start, '\n', length - consumed));
+            const auto* stop = new_line ? new_line + 1 : p + length;
 
-                            if (key_res && value_res)
-                            {
-                                form_url_encoded_data.emplace(key, value);
-                            }
-                        }
-                    }
-                }
+            header_block.append(reinterpret_cast<const char*>(start), static_cast<std::size_t>(stop - start));
+            consumed = static_cast<std::size_t>(stop - p);
 
-                // Perform the callback to the response handler with the parsed and decoded data.
-                url_data.url_encoded(form_url_encoded_data);
+            if (header_block.size() > max_part_header_size)
+            {
+                Log::error(tag, "Multipart headers too large");
+                parse_status = ParseStatus::End;
+            }
+            else if (new_line
+                     && header_block.size() >= 4
+                     && header_block.compare(header_block.size() - 4, 4, "\r\n\r\n") == 0)
+            {
+                consume_headers(header_block);
+                header_block.clear();
+                first_part = true;
+                parse_status = ParseStatus::Data;
             }
         }
+
+        return consumed;
     }
 
-    BoundaryIterator MIMEParser::get_end_of_boundary(BoundaryIterator begin)
+    void MIMEParser::deliver(const uint8_t* p, std::size_t length, bool last, IFormData& form_data,
+                             uint16_t chunksize)
     {
-        // Adjust for CRLF at beginning of boundary pattern
-        auto offset = is_crlf(begin) ? LEN_OF_CRLF : 0;
+        if (parse_status == ParseStatus::Data)
+        {
+            const std::size_t chunk = std::max(chunksize, uint16_t{ 1 });
 
-        return begin + static_cast<Boundaries::difference_type>(boundary.size()) + offset;
-    }
+            // Larger pieces are handed over directly from the received data, smaller ones are
+            // collected until there is a full chunk or the part ends.
+            const bool direct = length >= std::max(chunk / 4, std::size_t{ 1 });
 
-    bool MIMEParser::is_crlf(MIMEParser::BoundaryIterator start) const
-    {
-        return *start == '\r' && *(start + 1) == '\n';
-    }
+            if (direct && !staged.empty())
+            {
+                form_data.form_data(id, filename, staged.data(), staged.data() + staged.size(), first_part, false);
+                staged.clear();
+                first_part = false;
+            }
 
-    std::tuple<MIMEParser::BoundaryIterator,
-               std::unordered_map<std::string, std::string>,
-               std::unordered_map<std::string, std::string>> MIMEParser::consume_headers(
-        MIMEParser::BoundaryIterator begin,
-        MIMEParser::BoundaryIterator end) const
-    {
-        std::unordered_map<std::string, std::string> headers{};
-        std::unordered_map<std::string, std::string> content_disp{};
-        auto start_of_actual_content = end;
+            while (direct && length > 0)
+            {
+                const auto amount = std::min(length, chunk);
+                length -= amount;
+                form_data.form_data(id, filename, p, p + amount, first_part, last && length == 0);
+                p += amount;
+                first_part = false;
+            }
+
+            while (!direct && length > 0)
+            {
+                const auto amount = std::min(length, chunk - staged.size());
+                staged.insert(staged.end(), p, p + amount);
+                p += amount;
+                length -= amount;
+
+                if (staged.size() == chunk && (length > 0 || !last))
+                {
+                    form_data.form_data(id, filename, staged.data(), staged.data() + staged.size(), first_part,
+                                        false);
+                    staged.clear();
+                    first_part = false;
+                }
+            }
 
-        auto end_of_headers = std::search(begin, end, crlf_double.begin(), crlf_double.end());
+            if (!direct && last)
+            {
+                // Always point to valid memory, even when there is no data.
+                static const uint8_t none = 0;
+                const auto* begin = staged.empty() ? &none : staged.data();
+                form_data.form_data(id, filename, begin, begin + staged.size(), first_part, true);
+                staged.clear();
+                first_part = false;
+            }
+        }
+    }
 
-        if (end_of_headers != end)
+    void MIMEParser::parse_url_encoded(IURLEncodedData& url_data)
+    {
+        // URL encoded data can't be parsed in chunks, so wait until all data is received
+        if (data.size() >= expected_content_length)
         {
-            start_of_actual_content = end_of_headers + static_cast<long>(crlf_double.size());
+            // Split data on '&' as it comes in. Each part is then expected to contain X=Y, so split on '='.
+            // If a part doesn't contain a '=', put it back in the buffer to be used next time.
+            // The way this works is that split() places any leftovers last in the returned vector
+            // which means that it will be encountered last, thus the loops end at the same time.
 
-            std::stringstream ss;
+            auto parts = split(data, std::vector<uint8_t>{ '&' });
 
-            std::for_each(begin, end_of_headers, [&ss](auto& c) {
-                              if (c != '\n')
-                              {
-                                  ss << static_cast<char>(c);
-                              }
-            });
+            if (!parts.empty())
+            {
+                data.clear();
+            }
 
-            std::string s;
+            URLEncoding encoding{};
 
-            while (std::getline(ss, s, '\r'))
+            for (const auto& part : parts)
             {
-                auto colon = std::find(s.begin(), s.end(), ':');
+                auto equal_sign = std::find(part.cbegin(), part.cend(), '=');
 
-                if (colon != s.end() && !s.empty())
+                if (equal_sign == part.cend())
+                {
+                    std::copy(std::make_move_iterator(part.begin()),
+                              std::make_move_iterator(part.end()),
+                              std::back_inserter(data));
+                }
+                else
                 {
-                    if (std::distance(colon, s.end()) > 2)
+                    auto key_value = split(part, std::vector<uint8_t>{ '=' });
+
+                    if (!key_value.empty())
                     {
-                        headers[string_util::to_lower_copy({ s.begin(), colon })] = { colon + 2, s.end() };
+                        std::string key{ key_value[0].begin(), key_value[0].end() };
+                        auto key_res = encoding.decode(key, key.begin(), key.end());
+
+                        std::string value{ key_value[1].begin(), key_value[1].end() };
+                        auto value_res = encoding.decode(value, value.begin(), value.end());
+
+                        if (key_res && value_res)
+                        {
+                            form_url_encoded_data.emplace(key, value);
+                        }
                     }
                 }
             }
 
-            parse_content_disposition(headers, content_disp);
+            // Perform the callback to the response handler with the parsed and decoded data.
+            url_data.url_encoded(form_url_encoded_data);
+        }
+    }
+
+    void MIMEParser::consume_headers(const std::string& header_block)
+    {
+        std::unordered_map<std::string, std::string> headers{};
+        std::unordered_map<std::string, std::string> content_disposition{};
+
+        std::size_t start = 0;
+
+        while (start < header_block.size())
+        {
+            auto end = header_block.find("\r\n", start);
+
+            if (end == std::string::npos)
+            {
+                end = header_block.size();
+            }
+
+            auto colon = header_block.find(':', start);
+
+            if (colon < end && end - colon > 2)
+            {
+                headers[string_util::to_lower_copy(header_block.substr(start, colon - start))] =
+                    header_block.substr(colon + 2, end - colon - 2);
+            }
+
+            start = end + LEN_OF_CRLF;
         }
 
-        return std::make_tuple(start_of_actual_content, std::move(headers), std::move(content_disp));
+        parse_content_disposition(headers, content_disposition);
+        id = content_disposition["name"];
+        filename = content_disposition["filename"];
     }
 
     void MIMEParser::parse_content_disposition(const std::unordered_map<std::string, std::string>& headers,
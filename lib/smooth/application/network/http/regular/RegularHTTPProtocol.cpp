@@ -16,6 +16,7 @@ limitations under the License.
 */
 
 #include <algorithm>
+#include <charconv>
 #include "smooth/core/util/string_util.h"
 #include "smooth/application/network/http/regular/HTTPHeaderDef.h"
 #include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
@@ -39,6 +40,17 @@ namespace smooth::application::network::http
             // Make sure there is room for what he have received and what we ask for.
             packet.expand_by(amount_to_request);
         }
+        else if (chunked)
+        {
+            // Chunk content is read directly into the packet, but the framing around it only a byte at a time
+            // so that nothing beyond the end of the request is consumed.
+            amount_to_request = chunk_decoder.in_content()
+                                ? static_cast<int>(std::min(static_cast<std::size_t>(content_chunk_size),
+                                                            chunk_decoder.content_remaining()))
+                                : 1;
+
+            packet.expand_by(amount_to_request);
+        }
         else
         {
             // Never ask for more than content_chunk_size
@@ -57,34 +69,86 @@ namespace smooth::application::network::http
 
         if (state == State::reading_headers)
         {
-            const auto end_of_header = packet.find_header_ending();
+            const auto parse_result = header_parser.parse(packet.data().data(),
+                                                          static_cast<std::size_t>(total_bytes_received));
 
-            if (end_of_header != packet.data().end())
+            if (parse_result == HTTPHeaderParser::Result::Complete)
             {
                 // End of header found
                 state = State::reading_content;
-                actual_header_size = consume_headers(packet, end_of_header);
+                actual_header_size = consume_headers(packet);
                 total_content_bytes_received = total_bytes_received - actual_header_size;
 
                 // content_bytes_received_in_current_part may be larger than content_chunk_size
                 content_bytes_received_in_current_part = total_content_bytes_received;
 
-                try
-                {
-                    incoming_content_length = packet.headers()[CONTENT_LENGTH].empty() ? 0 : std::stoi(
-                            packet.headers()[CONTENT_LENGTH]);
+                const auto& transfer_encoding = packet.headers()[TRANSFER_ENCODING];
 
-                    if (incoming_content_length < 0)
+                if (!transfer_encoding.empty())
+                {
+                    // When a transfer coding is used, Content-Length is to be ignored.
+                    // https://tools.ietf.org/html/rfc7230#section-3.3.3
+                    if (string_util::to_lower_copy(transfer_encoding) == "chunked")
                     {
-                        error = true;
-                        Log::error("HTTPProtocol", "{} is < 0: {}.", CONTENT_LENGTH, incoming_content_length);
+                        // Decode what was received beyond the headers.
+                        chunked = true;
+                        auto over_read = content_bytes_received_in_current_part;
+                        content_bytes_received_in_current_part = 0;
+                        total_content_bytes_received = 0;
+                        decode_chunks(packet, over_read);
+                    }
+                    else
+                    {
+                        response.reply_error(
+                                std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Implemented));
+
+                        Log::error("HTTPProtocol", "Unsupported transfer encoding: {}", transfer_encoding);
+                        reset();
                     }
                 }
-                catch (...)
+                else
                 {
-                    incoming_content_length = 0;
+                    try
+                    {
+                        incoming_content_length = packet.headers()[CONTENT_LENGTH].empty() ? 0 : std::stoi(
+                                packet.headers()[CONTENT_LENGTH]);
+
+                        if (incoming_content_length < 0)
+                        {
+                            error = true;
+                            Log::error("HTTPProtocol", "{} is < 0: {}.", CONTENT_LENGTH, incoming_content_length);
+                        }
+                    }
+                    catch (...)
+                    {
+                        incoming_content_length = 0;
+                    }
+
+                    if (!error && total_content_bytes_received > incoming_content_length)
+                    {
+                        // What follows the content belongs to the next request.
+                        using size_type = std::vector<uint8_t>::size_type;
+                        keep_excess_data(&packet.data()[static_cast<size_type>(incoming_content_length)],
+                                         static_cast<std::size_t>(total_content_bytes_received
+                                                                  - incoming_content_length));
+
+                        total_content_bytes_received = incoming_content_length;
+                        content_bytes_received_in_current_part = incoming_content_length;
+                    }
                 }
             }
+            else if (parse_result != HTTPHeaderParser::Result::NeedMoreData)
+            {
+                auto too_many = parse_result == HTTPHeaderParser::Result::TooManyHeaders;
+
+                response.reply_error(
+                        std::make_unique<responses::ErrorResponse>(too_many
+                                                                   ? ResponseCode::Request_Header_Fields_Too_Large
+                                                                   : ResponseCode::Bad_Request));
+
+                Log::error("HTTPProtocol", too_many ? "Too many headers." : "Malformed headers.");
+                reset();
+            }
             else if (total_bytes_received >= max_header_size)
             {
                 // Headers are too large
@@ -98,6 +162,10 @@ namespace smooth::application::network::http
                 reset();
             }
         }
+        else if (chunked)
+        {
+            decode_chunks(packet, length);
+        }
         else
         {
             total_content_bytes_received += length;
@@ -113,7 +181,7 @@ namespace smooth::application::network::http
             packet.set_request_data(last_method, last_url, last_request_version);
 
             // When there are more data expected, then this packet is "to be continued"
-            if (total_content_bytes_received < incoming_content_length)
+            if (chunked ? !chunk_decoder.is_complete() : total_content_bytes_received < incoming_content_length)
             {
                 packet.set_continued();
             }
@@ -121,9 +189,9 @@ namespace smooth::application::network::http
             // When still reading the headers, the packet can never be a continuation.
             if (state != State::reading_headers)
             {
-                // If we've already received more data than what fits in a single chunk, then this packet
+                // If content has already been delivered in earlier packets, then this packet
                 // is a continuation of an earlier packet.
-                if (total_content_bytes_received - content_bytes_received_in_current_part > content_chunk_size)
+                if (total_content_bytes_received > content_bytes_received_in_current_part)
                 {
                     // Packet continues a previous packet.
                     packet.set_continuation();
@@ -152,6 +220,12 @@ namespace smooth::application::network::http
     {
         auto complete = state != State::reading_headers;
 
+        if (chunked)
+        {
+            return complete
+                   && (chunk_decoder.is_complete() || content_bytes_received_in_current_part >= content_chunk_size);
+        }
+
         bool content_received =
             incoming_content_length == 0 // No content to read.
             || total_content_bytes_received == incoming_content_length // All content received
@@ -166,94 +240,116 @@ namespace smooth::application::network::http
         return error;
     }
 
-    int RegularHTTPProtocol::consume_headers(HTTPPacket& packet,
-                                             std::vector<uint8_t>::const_iterator header_ending)
+    int RegularHTTPProtocol::consume_headers(HTTPPacket& packet)
     {
-        std::stringstream ss;
-
-        std::for_each(packet.data().cbegin(),
-                      header_ending,
-                      [&ss](auto& c) {
-                          if (c != '\n')
-                          {
-                              ss << static_cast<char>(c);
-                          }
-        });
+        const auto* data = packet.data().data();
+        const auto& start_line = header_parser.start_line();
 
-        // Get actual end of header
-        header_ending += HTTPPacket::ending.size();
+        if (header_parser.is_request())
+        {
+            // Store method for use in continued packets.
+            last_method = HTTPHeaderParser::view(data, start_line[0]);
+            last_url = HTTPHeaderParser::view(data, start_line[1]);
+            last_request_version = HTTPHeaderParser::view(data, start_line[2]);
+            packet.set_request_data(last_method, last_url, last_request_version);
+        }
+        else
+        {
+            // Store response data for later use
+            auto code = HTTPHeaderParser::view(data, start_line[1]);
+            int response_code = 0;
+            auto [end, ec] = std::from_chars(code.data(), code.data() + code.size(), response_code);
 
-        // Update actual header size
-        auto actual_header_bytes_received = static_cast<int>(std::distance(packet.data().cbegin(), header_ending));
+            if (ec == std::errc{} && end == code.data() + code.size())
+            {
+                packet.set_response_data(static_cast<ResponseCode>(response_code));
+            }
+            else
+            {
+                error = true;
 
-        // Erase headers from buffer
-        packet.data().erase(packet.data().begin(), header_ending);
+                Log::error("HTTPProtocol", "Invalid response code: {}", code);
+            }
+        }
 
-        std::string s;
+        auto& headers = packet.headers();
 
-        while (std::getline(ss, s, '\r'))
+        for (std::size_t i = 0; i < header_parser.header_count(); ++i)
         {
-            if (!s.empty())
+            const auto& header = header_parser.header(i);
+            auto value = HTTPHeaderParser::view(data, header.value);
+
+            // Headers are case-insensitive: https://tools.ietf.org/html/rfc7230#section-3.2
+            // Headers may be repeated, so append data if header isn't empty.
+            auto& curr_header =
+                headers[string_util::to_lower_copy(std::string{ HTTPHeaderParser::view(data, header.name) })];
+
+            if (curr_header.empty())
+            {
+                curr_header = value;
+            }
+            else
             {
-                auto colon = std::find(s.begin(), s.end(), ':');
+                curr_header.append(", ").append(value);
+            }
+        }
 
-                if (colon == s.end() && !s.empty())
-                {
-                    std::smatch m;
+        auto header_size = header_parser.header_size();
 
-                    if (std::regex_match(s, m, request_line))
-                    {
-                        // Store method for use in continued packets.
-                        last_method = m[1].str();
-                        last_url = m[2].str();
-                        last_request_version = m[3].str();
-                        packet.set_request_data(last_method, last_url, last_request_version);
-                    }
-                    else if (std::regex_match(s, m, response_line))
-                    {
-                        // Store response data for later use
-                        try
-                        {
-                            auto response_code = std::stoi(m[2].str());
-                            packet.set_response_data(static_cast<ResponseCode>(response_code));
-                        }
-                        catch (...)
-                        {
-                            error = true;
+        // Erase headers from buffer
+        packet.data().erase(packet.data().begin(),
+                            packet.data().begin() + static_cast<std::vector<uint8_t>::difference_type>(header_size));
 
-                            Log::error("HTTPProtocol", "Invalid response code: {}", m[2].str());
-                        }
-                    }
-                }
-                else
-                {
-                    if (std::distance(colon, s.end()) > 2)
-                    {
-                        // Headers are case-insensitive: https://tools.ietf.org/html/rfc7230#section-3.2
-                        // Headers may be split on several lines, so append data if header isn't empty.
-                        auto& curr_header = packet.headers()[string_util::to_lower_copy({ s.begin(), colon })];
+        return static_cast<int>(header_size);
+    }
 
-                        if (curr_header.empty())
-                        {
-                            curr_header = { colon + 2, s.end() };
-                        }
-                        else
-                        {
-                            curr_header.append(", ").append({ colon + 2, s.end() });
-                        }
-                    }
-                }
-            }
+    void RegularHTTPProtocol::decode_chunks(HTTPPacket& packet, int length)
+    {
+        using size_type = std::vector<uint8_t>::size_type;
+        auto* pos = &packet.data()[static_cast<size_type>(content_bytes_received_in_current_part)];
+
+        // The received data is replaced by its content, so content_bytes_received_in_current_part
+        // only advances by the amount of actual content.
+        auto decoded = static_cast<int>(chunk_decoder.decode(pos, static_cast<std::size_t>(length)));
+        content_bytes_received_in_current_part += decoded;
+        total_content_bytes_received += decoded;
+
+        const auto unused = static_cast<std::size_t>(length) - chunk_decoder.consumed();
+
+        if (chunk_decoder.is_complete() && unused > 0)
+        {
+            // Bytes after the last chunk belong to the next request.
+            keep_excess_data(pos + chunk_decoder.consumed(), unused);
         }
 
-        return actual_header_bytes_received;
+        if (chunk_decoder.is_error())
+        {
+            response.reply_error(std::make_unique<responses::ErrorResponse>(ResponseCode::Bad_Request));
+            Log::error("HTTPProtocol", "Malformed chunked content.");
+            reset();
+        }
+    }
+
+    void RegularHTTPProtocol::keep_excess_data(const uint8_t* data, std::size_t length)
+    {
+        excess.assign(data, data + length);
+    }
+
+    void RegularHTTPProtocol::take_excess_data(std::vector<uint8_t>& target)
+    {
+        target.swap(excess);
+        excess.clear();
     }
 
     void RegularHTTPProtocol::packet_consumed()
     {
         content_bytes_received_in_current_part = 0;
 
-        if (error || total_content_bytes_received >= incoming_content_length)
+        auto request_done = chunked
+                            ? chunk_decoder.is_complete()
+                            : total_content_bytes_received >= incoming_content_length;
+
+        if (error || request_done)
         {
             // All chunks of the current request has been received.
             total_bytes_received = 0;
@@ -261,6 +357,10 @@ namespace smooth::application::network::http
             total_content_bytes_received = 0;
             actual_header_size = 0;
             state = State::reading_headers;
+            header_parser.reset();
+            chunked = false;
+            chunk_decoder.reset();
+            excess.clear();
         }
 
         error = false;
@@ -0,0 +1,180 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/Router.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace smooth::application::network::http::regular
+{
+    void Router::add(HTTPMethod method, const std::string& path, Handler handler)
+    {
+        insert(method, path).handler = std::move(handler);
+    }
+
+    void Router::mount(HTTPMethod method, const std::string& prefix, Handler handler)
+    {
+        // Mounting on "/files/" is the same as on "/files".
+        auto end = prefix.find_last_not_of('/');
+        insert(method, prefix.substr(0, end == std::string::npos ? 0 : end + 1)).mounted = std::move(handler);
+    }
+
+    Router::Handler Router::find(HTTPMethod method, const std::string& path, Parameters& parameters) const
+    {
+        Handler res{};
+        parameters.clear();
+
+        auto root = roots.find(method);
+
+        if (root != roots.end())
+        {
+            match(root->second, path, parameters, res);
+        }
+
+        return res;
+    }
+
+    Router::Node& Router::insert(HTTPMethod method, const std::string& path)
+    {
+        Node* node = &roots[method];
+        std::string_view remaining{ path };
+
+        while (!remaining.empty())
+        {
+            auto open = remaining.find('{');
+            node = &insert_literal(*node, remaining.substr(0, open));
+
+            if (open == std::string_view::npos)
+            {
+                remaining = {};
+            }
+            else
+            {
+                auto close = remaining.find('}', open);
+
+                if (close == std::string_view::npos || close == open + 1)
+                {
+                    throw std::invalid_argument("Invalid path parameter in route: " + path);
+                }
+
+                std::string name{ remaining.substr(open + 1, close - open - 1) };
+
+                if (!node->parameter)
+                {
+                    node->parameter = std::make_unique<Node>();
+                    node->parameter_name = name;
+                }
+                else if (node->parameter_name != name)
+                {
+                    throw std::invalid_argument("Conflicting path parameter names in route: " + path);
+                }
+
+                node = node->parameter.get();
+                remaining.remove_prefix(close + 1);
+            }
+        }
+
+        return *node;
+    }
+
+    Router::Node& Router::insert_literal(Node& node, std::string_view literal)
+    {
+        Node* current = &node;
+
+        while (!literal.empty())
+        {
+            auto child = std::find_if(current->children.begin(), current->children.end(),
+                                      [&literal](const auto& c) { return c->prefix[0] == literal[0]; });
+
+            if (child == current->children.end())
+            {
+                auto& added = current->children.emplace_back(std::make_unique<Node>());
+                added->prefix = literal;
+                current = added.get();
+                literal = {};
+            }
+            else
+            {
+                auto& existing = *child;
+                auto common = static_cast<std::size_t>(
+                    std::mismatch(existing->prefix.begin(), existing->prefix.end(),
+                                  literal.begin(), literal.end()).first - existing->prefix.begin());
+
+                if (common < existing->prefix.size())
+                {
+                    // Split the edge, the existing node becomes a child of the common part.
+                    auto split = std::make_unique<Node>();
+                    split->prefix = existing->prefix.substr(0, common);
+                    existing->prefix.erase(0, common);
+                    split->children.emplace_back(std::move(existing));
+                    existing = std::move(split);
+                }
+
+                current = existing.get();
+                literal.remove_prefix(common);
+            }
+        }
+
+        return *current;
+    }
+
+    bool Router::match(const Node& node, std::string_view path, Parameters& parameters, Handler& result)
+    {
+        bool found = false;
+
+        if (path.empty())
+        {
+            found = node.handler != nullptr;
+            result = node.handler;
+        }
+        else
+        {
+            auto child = std::find_if(node.children.begin(), node.children.end(),
+                                      [&path](const auto& c) { return c->prefix[0] == path[0]; });
+
+            if (child != node.children.end() && path.compare(0, (*child)->prefix.size(), (*child)->prefix) == 0)
+            {
+                found = match(**child, path.substr((*child)->prefix.size()), parameters, result);
+            }
+
+            if (!found && node.parameter)
+            {
+                auto value = path.substr(0, path.find('/'));
+
+                if (!value.empty())
+                {
+                    found = match(*node.parameter, path.substr(value.size()), parameters, result);
+
+                    if (found)
+                    {
+                        parameters[node.parameter_name] = value;
+                    }
+                }
+            }
+        }
+
+        // A mount handles the path it is mounted on and everything beneath it.
+        if (!found && node.mounted && (path.empty() || path[0] == '/'))
+        {
+            found = true;
+            result = node.mounted;
+        }
+
+        return found;
+    }
+}
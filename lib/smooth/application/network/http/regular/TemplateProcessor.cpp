@@ -16,15 +16,12 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
-#include <regex>
-#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/regular/responses/TemplateResponse.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 #include "smooth/core/filesystem/File.h"
-#include "smooth/core/util/string_util.h"
 
 using namespace smooth::core::filesystem;
-using namespace smooth::core::string_util;
 
 namespace smooth::application::network::http::regular
 {
@@ -35,7 +32,8 @@ namespace smooth::application::network::http::regular
     {
     }
 
-    std::unique_ptr<IResponseOperation> TemplateProcessor::process_template(const smooth::core::filesystem::Path& path)
+    std::unique_ptr<IResponseOperation> TemplateProcessor::process_template(const Path& path,
+                                                                            std::time_t last_modified)
     {
         std::unique_ptr<IResponseOperation> res{};
 
@@ -44,49 +42,73 @@ namespace smooth::application::network::http::regular
 
         if (is_template_file)
         {
-            std::string data;
-            File src{ path };
+            auto compiled = compile(path, last_modified);
 
-            if (!src.read(data) || data.empty())
+            if (!compiled)
             {
                 res = std::make_unique<responses::ErrorResponse>(ResponseCode::Internal_Server_Error);
             }
             else
             {
-                process_template(data);
-                res = std::make_unique<responses::StringResponse>(ResponseCode::OK, data, false);
+                res = std::make_unique<responses::TemplateResponse>(compiled, resolve(*compiled));
             }
         }
 
         return res;
     }
 
-    void TemplateProcessor::process_template(std::string& template_data) const
+    void TemplateProcessor::clear()
     {
-        // Find keys in the form "{{alpha_num}}, then do a lookup on the alpha_num part
-        // and replace the entire found token. Continue search after the found token until end of data.
+        compiled_templates.clear();
+    }
+
+    std::shared_ptr<const CompiledTemplate> TemplateProcessor::compile(const Path& path, std::time_t last_modified)
+    {
+        std::shared_ptr<const CompiledTemplate> res{};
+
+        auto existing = compiled_templates.find(path.str());
 
-        if (data_retriever)
+        if (existing != compiled_templates.end() && existing->second.last_modified == last_modified)
         {
-            try
+            res = existing->second.compiled;
+        }
+        else
+        {
+            std::string data;
+            File src{ path };
+
+            if (src.read(data) && !data.empty())
             {
-                // Find all tokens
-                std::smatch match{};
-
-                while (std::regex_search(template_data, match, token))
-                {
-                    std::stringstream ss;
-                    const auto& found_token = match[0].str();
-
-                    // Replaces any matched token, even if no corresponding data exists, in which case empty string is
-                    // used.
-                    replace_all(template_data, found_token, data_retriever->get(found_token));
-                }
+                res = std::make_shared<const CompiledTemplate>(std::move(data));
+                compiled_templates[path.str()] = Entry{ last_modified, res };
             }
-            catch (std::regex_error& ex)
+            else if (existing != compiled_templates.end())
             {
-                Log::error("TemplateProcessor", ex.what());
+                compiled_templates.erase(existing);
             }
         }
+
+        return res;
+    }
+
+    std::vector<std::string> TemplateProcessor::resolve(const CompiledTemplate& compiled) const
+    {
+        std::vector<std::string> values{};
+        values.reserve(compiled.keys().size());
+
+        for (const auto& key : compiled.keys())
+        {
+            // Unknown keys are replaced with an empty string by the data retriever.
+            // Without a data retriever, keys are left as they are.
+            values.emplace_back(data_retriever ? data_retriever->get(key) : key);
+        }
+
+        return values;
+    }
+
+    void TemplateProcessor::process_template(std::string& template_data) const
+    {
+        CompiledTemplate compiled{ std::move(template_data) };
+        template_data = compiled.render(resolve(compiled));
     }
 }
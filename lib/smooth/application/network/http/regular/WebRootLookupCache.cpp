@@ -0,0 +1,77 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/WebRootLookupCache.h"
+
+using namespace std::chrono;
+
+namespace smooth::application::network::http::regular
+{
+    const WebRootLookupCache::Lookup* WebRootLookupCache::find(const std::string& url)
+    {
+        const Lookup* res = nullptr;
+        auto it = by_url.find(url);
+
+        if (it != by_url.end())
+        {
+            if (it->second->expires > steady_clock::now())
+            {
+                res = &it->second->lookup;
+            }
+            else
+            {
+                erase(it->second);
+            }
+        }
+
+        return res;
+    }
+
+    void WebRootLookupCache::insert(const std::string& url, Lookup lookup)
+    {
+        auto existing = by_url.find(url);
+
+        if (existing != by_url.end())
+        {
+            erase(existing->second);
+        }
+
+        while (!entries.empty() && entries.size() >= max_entries)
+        {
+            erase(entries.begin());
+        }
+
+        if (max_entries > 0)
+        {
+            entries.push_back({ url, std::move(lookup), steady_clock::now() + time_to_live });
+            by_url[url] = std::prev(entries.end());
+        }
+    }
+
+    void WebRootLookupCache::clear()
+    {
+        by_url.clear();
+        entries.clear();
+    }
+
+    void WebRootLookupCache::erase(std::list<Entry>::iterator entry)
+    {
+        by_url.erase(entry->url);
+        entries.erase(entry);
+    }
+}
@@ -0,0 +1,67 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/responses/AssetResponse.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/http_utils.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    AssetResponse::AssetResponse(std::shared_ptr<const AssetCache::Asset> asset, bool gzip)
+            : HeaderOnlyResponse(ResponseCode::OK),
+              asset(std::move(asset)),
+              variant(gzip ? this->asset->gzip : this->asset->identity)
+    {
+        headers[CONTENT_LENGTH] = std::to_string(variant.size);
+        headers[CONTENT_TYPE] = this->asset->content_type;
+        headers[LAST_MODIFIED] = utils::make_http_time(this->asset->last_modified);
+        headers[ETAG] = variant.etag;
+
+        if (gzip)
+        {
+            headers[CONTENT_ENCODING] = "gzip";
+        }
+
+        if (this->asset->gzip.exists())
+        {
+            headers[VARY] = "Accept-Encoding";
+        }
+    }
+
+    ResponseStatus AssetResponse::get_shared_data(std::size_t /*max_amount*/, SharedContent& target)
+    {
+        auto res = ResponseStatus::NoData;
+
+        if (!variant.is_intact())
+        {
+            // The file has been truncated since it was cached.
+            res = ResponseStatus::Error;
+        }
+        else if (!sent && variant.size > 0)
+        {
+            // The asset owns the variant's data, so keeping the asset keeps the data alive.
+            target.owner = asset;
+            target.data = variant.data;
+            target.length = variant.size;
+            sent = true;
+            res = ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+}
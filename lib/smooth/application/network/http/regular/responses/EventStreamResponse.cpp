@@ -0,0 +1,181 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/responses/EventStreamResponse.h"
+#include <algorithm>
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    static void append_field(std::string& target, const char* name, const std::string& value)
+    {
+        target.append(name).append(": ").append(value).push_back('\n');
+    }
+
+    bool EventStream::send(const std::string& data, const std::string& event, const std::string& id)
+    {
+        std::string formatted{};
+
+        if (!event.empty())
+        {
+            append_field(formatted, "event", event);
+        }
+
+        if (!id.empty())
+        {
+            append_field(formatted, "id", id);
+        }
+
+        // Each line of the data is sent as a field of its own.
+        std::string::size_type start = 0;
+        std::string::size_type end;
+
+        do
+        {
+            end = data.find('\n', start);
+            append_field(formatted, "data", data.substr(start, end == std::string::npos ? end : end - start));
+            start = end + 1;
+        }
+        while (end != std::string::npos);
+
+        // An empty line dispatches the event.
+        formatted.push_back('\n');
+
+        std::lock_guard<std::mutex> lock(guard);
+
+        if (!closed)
+        {
+            if (max_queued_events > 0 && events.size() >= max_queued_events)
+            {
+                events.pop_front();
+                ++dropped;
+            }
+
+            events.emplace_back(std::move(formatted));
+
+            if (waiting && wake_up)
+            {
+                waiting = false;
+                wake_up();
+            }
+        }
+
+        return !closed;
+    }
+
+    void EventStream::close()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        closed = true;
+
+        if (waiting && wake_up)
+        {
+            waiting = false;
+            wake_up();
+        }
+    }
+
+    bool EventStream::is_open() const
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        return !closed;
+    }
+
+    std::size_t EventStream::get_dropped_count() const
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        return dropped;
+    }
+
+    bool EventStream::take(std::string& target)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        for (auto& e : events)
+        {
+            target.append(e);
+        }
+
+        events.clear();
+
+        // Nothing to send, wake up the response when there is.
+        waiting = target.empty() && !closed;
+
+        return !closed || !target.empty();
+    }
+
+    void EventStream::set_wake_up(std::function<void()> wake)
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        wake_up = std::move(wake);
+    }
+
+    void EventStream::detach()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+        closed = true;
+        waiting = false;
+        wake_up = nullptr;
+        events.clear();
+    }
+
+    EventStreamResponse::EventStreamResponse(std::shared_ptr<EventStream> stream)
+            : HeaderOnlyResponse(ResponseCode::OK),
+              stream(std::move(stream))
+    {
+        headers[CONTENT_TYPE] = "text/event-stream";
+        headers[CACHE_CONTROL] = "no-cache";
+    }
+
+    EventStreamResponse::~EventStreamResponse()
+    {
+        stream->detach();
+    }
+
+    ResponseStatus EventStreamResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        if (pending_offset == pending.size())
+        {
+            pending.clear();
+            pending_offset = 0;
+            open = stream->take(pending);
+        }
+
+        auto res = open ? ResponseStatus::Pending : ResponseStatus::LastData;
+
+        if (pending_offset < pending.size())
+        {
+            const auto amount = std::min(max_amount, pending.size() - pending_offset);
+            const auto begin = pending.cbegin() + static_cast<std::string::difference_type>(pending_offset);
+            target.insert(target.end(), begin, begin + static_cast<std::string::difference_type>(amount));
+            pending_offset += amount;
+
+            // Continue with what is left, or check for more events.
+            res = open || pending_offset < pending.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    void EventStreamResponse::set_wake_up(std::function<void()> wake_up)
+    {
+        stream->set_wake_up(std::move(wake_up));
+    }
+}
@@ -15,6 +15,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <atomic>
 #include <utility>
 #include <iomanip>
 #include <sstream>
@@ -28,14 +29,113 @@ using namespace smooth::core::filesystem;
 
 namespace smooth::application::network::http::regular::responses
 {
-    FileContentResponse::FileContentResponse(smooth::core::filesystem::Path full_path)
+    static std::string make_content_range(std::size_t first, std::size_t length, std::size_t size)
+    {
+        std::stringstream ss;
+        ss << "bytes " << first << "-" << first + length - 1 << "/" << size;
+
+        return ss.str();
+    }
+
+    FileContentResponse::FileContentResponse(smooth::core::filesystem::Path full_path, const std::string& range)
             : StringResponse(ResponseCode::OK),
               path(std::move(full_path)),
-              info(path)
+              info(path),
+              mapping(std::make_shared<MemoryMappedFile>(path))
     {
-        headers[CONTENT_LENGTH] = std::to_string(info.size());
         headers[CONTENT_TYPE] = utils::get_content_type(info.path());
         headers[LAST_MODIFIED] = utils::make_http_time(info.last_modified());
+        headers[ACCEPT_RANGES] = "bytes";
+
+        std::vector<utils::ByteRange> ranges{};
+        auto status = range.empty()
+                      ? utils::RangeStatus::Ignore
+                      : utils::parse_byte_ranges(range, info.size(), ranges);
+
+        if (status == utils::RangeStatus::Satisfiable)
+        {
+            set_ranges(ranges);
+        }
+        else if (status == utils::RangeStatus::Unsatisfiable)
+        {
+            code = ResponseCode::Requested_Range_Not_Satisfiable;
+            headers[CONTENT_RANGE] = "bytes */" + std::to_string(info.size());
+        }
+        else
+        {
+            add_region(0, info.size());
+        }
+
+        headers[CONTENT_LENGTH] = std::to_string(total);
+    }
+
+    void FileContentResponse::set_ranges(const std::vector<utils::ByteRange>& ranges)
+    {
+        code = ResponseCode::Partial_Content;
+
+        if (ranges.size() == 1)
+        {
+            const auto& r = ranges.front();
+            headers[CONTENT_RANGE] = make_content_range(r.offset, r.length, info.size());
+            add_region(r.offset, r.length);
+        }
+        else
+        {
+            // https://tools.ietf.org/html/rfc7233#appendix-A
+            static std::atomic<uint32_t> response_count{ 0 };
+
+            std::stringstream boundary;
+            boundary << "byteranges_" << std::hex << info.last_modified() << "_" << ++response_count;
+
+            const auto content_type = headers[CONTENT_TYPE];
+            headers[CONTENT_TYPE] = "multipart/byteranges; boundary=" + boundary.str();
+
+            for (std::size_t i = 0; i < ranges.size(); ++i)
+            {
+                const auto& r = ranges[i];
+
+                std::stringstream part_header;
+                part_header << (i == 0 ? "" : "\r\n") << "--" << boundary.str() << "\r\n"
+                            << "Content-Type: " << content_type << "\r\n"
+                            << "Content-Range: " << make_content_range(r.offset, r.length, info.size()) << "\r\n"
+                            << "\r\n";
+
+                add_text(part_header.str());
+                add_region(r.offset, r.length);
+            }
+
+            add_text("\r\n--" + boundary.str() + "--\r\n");
+        }
+    }
+
+    void FileContentResponse::add_text(std::string text)
+    {
+        auto length = text.size();
+        total += length;
+        parts.push_back({ std::make_shared<const std::string>(std::move(text)), 0, length });
+    }
+
+    void FileContentResponse::add_region(std::size_t offset, std::size_t length)
+    {
+        if (length > 0)
+        {
+            total += length;
+            parts.push_back({ nullptr, offset, length });
+        }
+    }
+
+    ResponseStatus FileContentResponse::advance(std::size_t amount)
+    {
+        sent += amount;
+        sent_of_part += amount;
+
+        if (sent_of_part == parts[current_part].length)
+        {
+            ++current_part;
+            sent_of_part = 0;
+        }
+
+        return current_part < parts.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
     }
 
     // Called at least once when sending a response and until ResponseStatus::NoData is returned
@@ -43,16 +143,20 @@ namespace smooth::application::network::http::regular::responses
     {
         auto res = ResponseStatus::NoData;
 
-        if (sent < info.size())
+        if (current_part < parts.size())
         {
-            auto to_send = std::min(info.size() - sent, max_amount);
-
-            auto read_res = smooth::core::filesystem::File::read(path, target, sent, to_send);
+            const auto& part = parts[current_part];
+            auto to_send = std::min(part.length - sent_of_part, max_amount);
 
-            if (read_res)
+            if (part.text)
+            {
+                auto begin = part.text->begin() + static_cast<std::string::difference_type>(sent_of_part);
+                target.insert(target.end(), begin, begin + static_cast<std::string::difference_type>(to_send));
+                res = advance(to_send);
+            }
+            else if (File::read(path, target, part.offset + sent_of_part, to_send))
             {
-                sent += to_send;
-                res = sent < info.size() ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+                res = advance(to_send);
             }
             else
             {
@@ -63,8 +167,47 @@ namespace smooth::application::network::http::regular::responses
         return res;
     }
 
+    bool FileContentResponse::has_shared_data() const
+    {
+        // The mapping must match the size given in the headers, should the file have changed in between.
+        // It is checked again for each part as the file may be truncated while being sent, in which case
+        // the rest is read instead, failing the response rather than faulting on the mapping.
+        return mapping->is_mapped() && mapping->size() == info.size() && mapping->is_intact();
+    }
+
+    ResponseStatus FileContentResponse::get_shared_data(std::size_t /*max_amount*/, SharedContent& target)
+    {
+        auto res = ResponseStatus::NoData;
+
+        if (current_part < parts.size())
+        {
+            const auto& part = parts[current_part];
+
+            // Nothing is copied so the parts are larger than max_amount, but still limited so that the
+            // mapping is checked every now and then and the lengths stay well within what a packet can hold.
+            auto to_send = std::min(part.length - sent_of_part, max_shared_part);
+
+            if (part.text)
+            {
+                target.owner = part.text;
+                target.data = reinterpret_cast<const uint8_t*>(part.text->data()) + sent_of_part;
+            }
+            else
+            {
+                // Ranges are sent straight from their offset within the mapping.
+                target.owner = mapping;
+                target.data = mapping->data() + part.offset + sent_of_part;
+            }
+
+            target.length = to_send;
+            res = advance(to_send);
+        }
+
+        return res;
+    }
+
     void FileContentResponse::dump() const
     {
-        Log::debug("FileContentResponse", "Code: {}; Status: {}/{} bytes, Path: {}", code, sent, info.size(), path);
+        Log::debug("FileContentResponse", "Code: {}; Status: {}/{} bytes, Path: {}", code, sent, total, path);
     }
 }
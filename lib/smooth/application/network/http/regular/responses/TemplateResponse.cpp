@@ -0,0 +1,90 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/regular/responses/TemplateResponse.h"
+#include <algorithm>
+#include "smooth/core/logging/log.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/http_utils.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::application::network::http::regular::responses
+{
+    TemplateResponse::TemplateResponse(std::shared_ptr<const CompiledTemplate> compiled,
+                                       std::vector<std::string> values)
+            : HeaderOnlyResponse(ResponseCode::OK),
+              compiled(std::move(compiled)),
+              values(std::move(values))
+    {
+        remaining = this->compiled->literal_size();
+
+        for (const auto& s : this->compiled->segments())
+        {
+            if (s.is_key())
+            {
+                remaining += this->values[s.key].size();
+            }
+        }
+
+        headers[CONTENT_LENGTH] = std::to_string(remaining);
+        headers[CONTENT_TYPE] = "text/html";
+        headers[LAST_MODIFIED] = utils::make_http_time(std::chrono::system_clock::now());
+    }
+
+    ResponseStatus TemplateResponse::get_data(std::size_t max_amount, std::vector<uint8_t>& target)
+    {
+        auto res{ ResponseStatus::NoData };
+
+        if (remaining > 0)
+        {
+            const auto& segments = compiled->segments();
+            const auto& text = compiled->text();
+            auto to_send = std::min(remaining, max_amount);
+            target.reserve(target.size() + to_send);
+
+            while (to_send > 0)
+            {
+                const auto& s = segments[segment];
+                const char* src = s.is_key() ? values[s.key].data() : text.data() + s.offset;
+                auto length = s.is_key() ? values[s.key].size() : s.length;
+                auto amount = std::min(length - segment_offset, to_send);
+
+                target.insert(target.end(), src + segment_offset, src + segment_offset + amount);
+                segment_offset += amount;
+                to_send -= amount;
+                remaining -= amount;
+
+                if (segment_offset == length)
+                {
+                    ++segment;
+                    segment_offset = 0;
+                }
+            }
+
+            res = remaining > 0 ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    void TemplateResponse::dump() const
+    {
+        Log::debug("Response", "Code: {}; Remaining: {} bytes", static_cast<int>(code), remaining);
+    }
+}
@@ -0,0 +1,529 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/websocket/PerMessageDeflate.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include "smooth/core/util/string_util.h"
+
+#ifdef ESP_PLATFORM
+
+#include "sdkconfig.h"
+
+#endif // END ESP_PLATFORM
+
+#if !defined(ESP_PLATFORM) || defined(CONFIG_SMOOTH_WEBSOCKET_PERMESSAGE_DEFLATE)
+
+#include <zlib.h>
+
+#define SMOOTH_HAS_ZLIB
+
+#else
+
+// Without zlib the extension is never negotiated and the streams are never created.
+struct z_stream_s
+{
+};
+
+#endif
+
+namespace smooth::application::network::http::websocket
+{
+    using namespace smooth::core;
+
+    PerMessageDeflateConfig::PerMessageDeflateConfig(int server_max_window_bits,
+                                                     int client_max_window_bits,
+                                                     bool server_no_context_takeover,
+                                                     bool client_no_context_takeover,
+                                                     int memory_level,
+                                                     std::size_t memory_budget,
+                                                     int compression_level,
+                                                     std::size_t min_message_size)
+            : server_max_window_bits(std::clamp(server_max_window_bits, 9, 15)),
+              client_max_window_bits(std::clamp(client_max_window_bits, 9, 15)),
+              server_no_context_takeover(server_no_context_takeover),
+              client_no_context_takeover(client_no_context_takeover),
+              memory_level(std::clamp(memory_level, 1, 9)),
+              memory_budget(memory_budget),
+              compression_level(std::clamp(compression_level, 1, 9)),
+              min_message_size(min_message_size)
+    {
+    }
+
+    std::string DeflateParameters::to_string() const
+    {
+        std::string res{ "permessage-deflate" };
+
+        if (server_no_context_takeover)
+        {
+            res += "; server_no_context_takeover";
+        }
+
+        if (client_no_context_takeover)
+        {
+            res += "; client_no_context_takeover";
+        }
+
+        // Also announced when not asked for, to let the client decompress using a smaller window.
+        if (server_max_window_bits_offered || server_max_window_bits < 15)
+        {
+            res += "; server_max_window_bits=" + std::to_string(server_max_window_bits);
+        }
+
+        // Must not be present unless offered.
+        if (client_max_window_bits_offered)
+        {
+            res += "; client_max_window_bits=" + std::to_string(client_max_window_bits);
+        }
+
+        return res;
+    }
+
+#ifdef SMOOTH_HAS_ZLIB
+
+    // Sizes of the zlib stream states, in addition to the windows and hash tables.
+    static constexpr std::size_t inflate_state_size = 7 * 1024 + 512;
+    static constexpr std::size_t deflate_state_size = 6 * 1024;
+
+    // Removed from the end of compressed messages, https://tools.ietf.org/html/rfc7692#section-7.2.1
+    static constexpr std::array<uint8_t, 4> message_tail{ 0x00, 0x00, 0xFF, 0xFF };
+
+    // zlib compresses using a window of 9 bits when asked for 8, which can't be decompressed using a window of
+    // 8 bits. Decompressing with a larger window than the one compressed with is always possible.
+    static int inflate_window_bits(int client_max_window_bits)
+    {
+        return std::max(client_max_window_bits, 9);
+    }
+
+    static std::size_t inflate_memory_needed(int client_max_window_bits)
+    {
+        return (std::size_t{ 1 } << inflate_window_bits(client_max_window_bits)) + inflate_state_size;
+    }
+
+    static std::size_t deflate_memory_needed(int window_bits, int memory_level)
+    {
+        return (std::size_t{ 1 } << (window_bits + 2)) + (std::size_t{ 1 } << (memory_level + 9)) + deflate_state_size;
+    }
+
+    /// Splits s at each separator, trimming the parts.
+    static std::vector<std::string> tokenize(const std::string& s, char separator)
+    {
+        std::vector<std::string> res{};
+        std::size_t start = 0;
+
+        for (auto end = s.find(separator); ; end = s.find(separator, start))
+        {
+            res.emplace_back(string_util::trim(s.substr(start, end == std::string::npos ? end : end - start)));
+
+            if (end == std::string::npos)
+            {
+                break;
+            }
+
+            start = end + 1;
+        }
+
+        return res;
+    }
+
+    /// Parses the value of a window bits parameter, which may be quoted.
+    static std::optional<int> parse_window_bits(std::string value)
+    {
+        if (value.size() > 2 && value.front() == '"' && value.back() == '"')
+        {
+            value = value.substr(1, value.size() - 2);
+        }
+
+        std::optional<int> res{};
+
+        if (!value.empty() && value.size() <= 2
+            && std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); }))
+        {
+            auto bits = std::stoi(value);
+
+            if (bits >= 8 && bits <= 15)
+            {
+                res = bits;
+            }
+        }
+
+        return res;
+    }
+
+    PerMessageDeflate::PerMessageDeflate(const DeflateParameters& parameters, const PerMessageDeflateConfig& config)
+            : parameters(parameters),
+              memory_level(config.mem_level()),
+              compression_level(config.level()),
+              min_message_size(config.min_size()),
+              deflate_budget(0)
+    {
+        if (config.budget() > 0)
+        {
+            // Decompression has been provided for when negotiating, so the rest is available for compression.
+            auto needed = inflate_memory_needed(parameters.client_max_window_bits);
+            deflate_budget = config.budget() > needed ? config.budget() - needed : 0;
+            deflate_unavailable = deflate_budget == 0;
+        }
+
+        inflate_stream = std::make_unique<z_stream_s>();
+
+        if (inflateInit2(inflate_stream.get(), -inflate_window_bits(parameters.client_max_window_bits)) != Z_OK)
+        {
+            inflate_stream.reset();
+        }
+    }
+
+    PerMessageDeflate::~PerMessageDeflate()
+    {
+        if (deflate_stream)
+        {
+            deflateEnd(deflate_stream.get());
+        }
+
+        if (inflate_stream)
+        {
+            inflateEnd(inflate_stream.get());
+        }
+    }
+
+    std::optional<DeflateParameters> PerMessageDeflate::negotiate(const std::string& offers,
+                                                                  const PerMessageDeflateConfig& config)
+    {
+        for (const auto& offer : tokenize(offers, ','))
+        {
+            auto offer_parameters = tokenize(offer, ';');
+
+            if (!string_util::iequals(offer_parameters[0], "permessage-deflate"))
+            {
+                continue;
+            }
+
+            DeflateParameters res{};
+            res.server_max_window_bits = config.server_window_bits();
+            res.server_no_context_takeover = config.server_no_takeover();
+            res.client_no_context_takeover = config.client_no_takeover();
+
+            auto acceptable = true;
+            std::vector<std::string> seen{};
+
+            for (auto it = std::next(offer_parameters.begin()); acceptable && it != offer_parameters.end(); ++it)
+            {
+                auto separator = it->find('=');
+                auto has_value = separator != std::string::npos;
+                auto name = string_util::to_lower_copy(string_util::trim(it->substr(0, separator)));
+                auto value = has_value ? string_util::trim(it->substr(separator + 1)) : std::string{};
+
+                // Each parameter may only be given once.
+                acceptable = std::find(seen.begin(), seen.end(), name) == seen.end();
+                seen.push_back(name);
+
+                if (name == "server_no_context_takeover")
+                {
+                    acceptable = acceptable && !has_value;
+                    res.server_no_context_takeover = true;
+                }
+                else if (name == "client_no_context_takeover")
+                {
+                    acceptable = acceptable && !has_value;
+                    res.client_no_context_takeover = true;
+                }
+                else if (name == "server_max_window_bits")
+                {
+                    // zlib can't compress using a window of 8 bits.
+                    auto bits = parse_window_bits(value);
+                    acceptable = acceptable && bits && *bits >= 9;
+                    res.server_max_window_bits = std::min(res.server_max_window_bits, bits.value_or(15));
+                    res.server_max_window_bits_offered = true;
+                }
+                else if (name == "client_max_window_bits")
+                {
+                    auto bits = has_value ? parse_window_bits(value) : std::optional<int>{ 15 };
+                    acceptable = acceptable && bits;
+                    res.client_max_window_bits = std::min(config.client_window_bits(), bits.value_or(15));
+                    res.client_max_window_bits_offered = true;
+                }
+                else
+                {
+                    acceptable = false;
+                }
+            }
+
+            // Compression may fall back to sending messages uncompressed, but decompression must always be possible.
+            if (acceptable
+                && (config.budget() == 0 || inflate_memory_needed(res.client_max_window_bits) <= config.budget()))
+            {
+                return res;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    bool PerMessageDeflate::init_deflate()
+    {
+        if (!deflate_stream && !deflate_unavailable)
+        {
+            if (deflate_budget > 0
+                && deflate_memory_needed(parameters.server_max_window_bits, memory_level) > deflate_budget)
+            {
+                deflate_unavailable = true;
+            }
+            else
+            {
+                deflate_stream = std::make_unique<z_stream_s>();
+                deflate_stream->zalloc = &PerMessageDeflate::allocate;
+                deflate_stream->zfree = &PerMessageDeflate::release;
+                deflate_stream->opaque = this;
+
+                if (deflateInit2(deflate_stream.get(),
+                                 compression_level,
+                                 Z_DEFLATED,
+                                 -parameters.server_max_window_bits,
+                                 memory_level,
+                                 Z_DEFAULT_STRATEGY) != Z_OK)
+                {
+                    // Out of memory; try again with the next message.
+                    deflate_stream.reset();
+                }
+            }
+        }
+
+        return deflate_stream != nullptr;
+    }
+
+    bool PerMessageDeflate::compress(std::vector<uint8_t>& data, bool first_fragment, bool last_fragment)
+    {
+        if (first_fragment)
+        {
+            compressing_message = data.size() >= min_message_size;
+
+            if (compressing_message && !init_deflate())
+            {
+                compressing_message = false;
+                ++uncompressed_count;
+            }
+        }
+
+        if (compressing_message)
+        {
+            auto& z = *deflate_stream;
+            std::vector<uint8_t> out(deflateBound(&z, static_cast<uLong>(data.size())) + message_tail.size());
+
+            z.next_in = data.data();
+            z.avail_in = static_cast<uInt>(data.size());
+            std::size_t produced = 0;
+
+            for (;;)
+            {
+                z.next_out = out.data() + produced;
+                z.avail_out = static_cast<uInt>(out.size() - produced);
+                deflate(&z, Z_SYNC_FLUSH);
+                produced = out.size() - z.avail_out;
+
+                // Once there is space left, all input has been compressed and flushed.
+                if (z.avail_out > 0)
+                {
+                    break;
+                }
+
+                out.resize(out.size() * 2);
+            }
+
+            out.resize(produced);
+
+            if (last_fragment)
+            {
+                if (std::equal(message_tail.rbegin(), message_tail.rend(), out.rbegin()))
+                {
+                    out.resize(out.size() - message_tail.size());
+                }
+
+                if (parameters.server_no_context_takeover)
+                {
+                    deflateReset(&z);
+
+                    // Without history to keep in sync with the client, a message that didn't get smaller
+                    // can just as well be sent as it is.
+                    compressing_message = !first_fragment || out.size() < data.size();
+                }
+            }
+
+            if (compressing_message)
+            {
+                data.swap(out);
+            }
+        }
+
+        return compressing_message;
+    }
+
+    bool PerMessageDeflate::decompress(const std::vector<uint8_t>& data, bool message_end, std::size_t chunk_size,
+                                       const Receiver& receiver)
+    {
+        if (!inflate_stream)
+        {
+            return false;
+        }
+
+        auto& z = *inflate_stream;
+
+        // zlib does not modify the input, it just isn't declared const.
+        z.next_in = const_cast<uint8_t*>(data.data());
+        z.avail_in = static_cast<uInt>(data.size());
+
+        auto tail_added = !message_end;
+        auto res = Z_OK;
+        std::size_t pos = 0;
+        inflated.resize(chunk_size);
+
+        auto hand_over = [&](bool last_part) {
+            inflated.resize(pos);
+            receiver(!inflating_message, last_part, inflated);
+            inflating_message = !last_part;
+            inflated.resize(chunk_size);
+            pos = 0;
+        };
+
+        while (res == Z_OK || res == Z_BUF_ERROR)
+        {
+            if (z.avail_in == 0 && !tail_added)
+            {
+                z.next_in = const_cast<uint8_t*>(message_tail.data());
+                z.avail_in = static_cast<uInt>(message_tail.size());
+                tail_added = true;
+            }
+
+            z.next_out = inflated.data() + pos;
+            z.avail_out = static_cast<uInt>(chunk_size - pos);
+            res = inflate(&z, Z_SYNC_FLUSH);
+            pos = chunk_size - z.avail_out;
+
+            if (res == Z_STREAM_END)
+            {
+                // The client ended the stream with a final block; the next message starts a new one.
+                res = inflateReset(&z);
+                z.avail_in = 0;
+            }
+
+            if (z.avail_out == 0)
+            {
+                // There may be more output than fits.
+                hand_over(false);
+            }
+            else if (z.avail_in == 0 && tail_added)
+            {
+                break;
+            }
+        }
+
+        auto ok = res == Z_OK || res == Z_BUF_ERROR;
+
+        if (ok && (message_end || pos > 0))
+        {
+            hand_over(message_end);
+        }
+
+        if (message_end && parameters.client_no_context_takeover)
+        {
+            inflateReset(&z);
+        }
+
+        return ok;
+    }
+
+    void* PerMessageDeflate::allocate(void* opaque, unsigned int items, unsigned int size)
+    {
+        auto& self = *static_cast<PerMessageDeflate*>(opaque);
+        auto amount = static_cast<std::size_t>(items) * size;
+        void* res = nullptr;
+
+        if (self.deflate_budget == 0 || self.deflate_memory + amount <= self.deflate_budget)
+        {
+            // The size is kept in front of the allocation so that it can be accounted for when released.
+            auto p = static_cast<std::max_align_t*>(std::malloc(sizeof(std::max_align_t) + amount));
+
+            if (p)
+            {
+                std::memcpy(p, &amount, sizeof(amount));
+                self.deflate_memory += amount;
+                res = p + 1;
+            }
+        }
+
+        return res;
+    }
+
+    void PerMessageDeflate::release(void* opaque, void* address)
+    {
+        auto& self = *static_cast<PerMessageDeflate*>(opaque);
+        auto p = static_cast<std::max_align_t*>(address) - 1;
+        std::size_t amount;
+        std::memcpy(&amount, p, sizeof(amount));
+        self.deflate_memory -= amount;
+        std::free(p);
+    }
+
+#else
+
+    PerMessageDeflate::PerMessageDeflate(const DeflateParameters& parameters, const PerMessageDeflateConfig& config)
+            : parameters(parameters),
+              memory_level(config.mem_level()),
+              compression_level(config.level()),
+              min_message_size(config.min_size()),
+              deflate_budget(0)
+    {
+    }
+
+    PerMessageDeflate::~PerMessageDeflate() = default;
+
+    std::optional<DeflateParameters> PerMessageDeflate::negotiate(const std::string& /*offers*/,
+                                                                  const PerMessageDeflateConfig& /*config*/)
+    {
+        return std::nullopt;
+    }
+
+    bool PerMessageDeflate::init_deflate()
+    {
+        return false;
+    }
+
+    bool PerMessageDeflate::compress(std::vector<uint8_t>& /*data*/, bool /*first_fragment*/, bool /*last_fragment*/)
+    {
+        return false;
+    }
+
+    bool PerMessageDeflate::decompress(const std::vector<uint8_t>& /*data*/, bool /*message_end*/,
+                                       std::size_t /*chunk_size*/, const Receiver& /*receiver*/)
+    {
+        return false;
+    }
+
+    void* PerMessageDeflate::allocate(void* /*opaque*/, unsigned int /*items*/, unsigned int /*size*/)
+    {
+        return nullptr;
+    }
+
+    void PerMessageDeflate::release(void* /*opaque*/, void* /*address*/)
+    {
+    }
+
+#endif
+}
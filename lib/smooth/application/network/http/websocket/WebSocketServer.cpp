@@ -15,14 +15,46 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
 #include "smooth/application/network/http/websocket/WebsocketServer.h"
 #include "smooth/application/network/http/websocket/responses/WSResponse.h"
 #include "smooth/application/network/http/IServerResponse.h"
 
 namespace smooth::application::network::http::websocket
 {
+    WebsocketServer::~WebsocketServer()
+    {
+        for (auto& g : groups)
+        {
+            if (auto group = g.lock())
+            {
+                group->remove(*this);
+            }
+        }
+    }
+
     void WebsocketServer::close_connection()
     {
         response.reply(std::make_unique<responses::WSResponse>(OpCode::Close), false);
     }
+
+    void WebsocketServer::join(const std::shared_ptr<WebsocketGroup>& group, std::optional<SlowConsumerPolicy> policy)
+    {
+        if (group->add(*this, policy))
+        {
+            groups.emplace_back(group);
+        }
+    }
+
+    void WebsocketServer::leave(const std::shared_ptr<WebsocketGroup>& group)
+    {
+        group->remove(*this);
+
+        // Also forgets groups no longer in existence.
+        groups.erase(std::remove_if(groups.begin(), groups.end(), [&group](const std::weak_ptr<WebsocketGroup>& g) {
+                                        auto locked = g.lock();
+
+                                        return !locked || locked == group;
+                                    }), groups.end());
+    }
 }
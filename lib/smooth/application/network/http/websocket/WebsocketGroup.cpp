@@ -0,0 +1,126 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <algorithm>
+#include "smooth/application/network/http/websocket/WebsocketGroup.h"
+#include "smooth/application/network/http/websocket/WebsocketServer.h"
+#include "smooth/application/network/http/websocket/frame_utils.h"
+#include "smooth/application/network/http/IServerResponse.h"
+
+namespace smooth::application::network::http::websocket
+{
+    using namespace responses;
+
+    WebsocketGroup::WebsocketGroup(SlowConsumerPolicy policy, std::size_t max_waiting)
+            : policy(policy), max_waiting(std::max(max_waiting, std::size_t{ 1 }))
+    {
+    }
+
+    void WebsocketGroup::broadcast(const std::string& text)
+    {
+        broadcast(reinterpret_cast<const uint8_t*>(text.data()), text.size(), true);
+    }
+
+    void WebsocketGroup::broadcast(const std::vector<uint8_t>& data, bool is_text)
+    {
+        broadcast(data.data(), data.size(), is_text);
+    }
+
+    void WebsocketGroup::broadcast(const uint8_t* data, std::size_t length, bool is_text)
+    {
+        if (members.empty())
+        {
+            return;
+        }
+
+        auto frame = std::make_shared<std::vector<uint8_t>>(MaxFrameHeaderSize + length);
+        auto header_size = write_frame_header(frame->data(), is_text ? OpCode::Text : OpCode::Binary, true, length);
+        std::copy_n(data, length, frame->begin() + static_cast<std::ptrdiff_t>(header_size));
+        frame->resize(header_size + length);
+
+        const SharedFrame shared = std::move(frame);
+
+        // Replying may send right away, but never changes the members.
+        for (auto& m : members)
+        {
+            if (m.disconnecting)
+            {
+                continue;
+            }
+
+            if (m.backlog->waiting >= max_waiting)
+            {
+                too_slow(m, shared);
+            }
+            else
+            {
+                m.server->response.reply(std::make_unique<WSBroadcastResponse>(shared, m.backlog), false);
+            }
+        }
+    }
+
+    void WebsocketGroup::too_slow(Member& member, const SharedFrame& frame)
+    {
+        if (member.policy == SlowConsumerPolicy::Coalesce
+            && member.backlog->latest
+            && member.backlog->latest->replace(frame))
+        {
+            ++coalesced;
+        }
+        else if (member.policy == SlowConsumerPolicy::Disconnect)
+        {
+            member.disconnecting = true;
+            ++disconnected;
+            member.server->response.disconnect();
+        }
+        else
+        {
+            ++dropped;
+        }
+    }
+
+    bool WebsocketGroup::add(WebsocketServer& server, std::optional<SlowConsumerPolicy> member_policy)
+    {
+        auto found = std::find_if(members.begin(), members.end(), [&server](const Member& m) {
+                                      return m.server == &server;
+                                  });
+
+        const auto added = found == members.end();
+
+        if (added)
+        {
+            members.push_back(Member{ &server,
+                                      member_policy.value_or(policy),
+                                      std::make_shared<BroadcastBacklog>(),
+                                      false });
+        }
+        else
+        {
+            found->policy = member_policy.value_or(policy);
+        }
+
+        return added;
+    }
+
+    void WebsocketGroup::remove(WebsocketServer& server)
+    {
+        members.erase(std::remove_if(members.begin(), members.end(), [&server](const Member& m) {
+                                         return m.server == &server;
+                                     }), members.end());
+    }
+}
@@ -16,6 +16,7 @@ limitations under the License.
 */
 
 #include "smooth/application/network/http/websocket/WebsocketProtocol.h"
+#include "smooth/application/network/http/websocket/frame_utils.h"
 #include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
 #include "smooth/core/network/util.h"
 
@@ -99,6 +100,16 @@ namespace smooth::application::network::http::websocket
             {
                 op_code = static_cast<OpCode>(get_opcode());
 
+                // RSV1 marks the first frame of a compressed message, https://tools.ietf.org/html/rfc7692#section-6
+                const auto rsv1 = (frame_data.header[0] & 0x40) != 0;
+                const auto starts_message = op_code == OpCode::Text || op_code == OpCode::Binary;
+                error = rsv1 && !(compression && starts_message);
+
+                if (starts_message)
+                {
+                    message_compressed = rsv1;
+                }
+
                 payload_length = get_initial_payload_length();
 
                 if (payload_length == 126)
@@ -143,16 +154,10 @@ namespace smooth::application::network::http::websocket
                 using vector_type = std::remove_reference<decltype(packet.data())>::type;
                 packet.data().resize(static_cast<vector_type::size_type>(received_payload_in_current_package));
 
-                // De-mask data
+                // De-mask data, continuing where the previous part of the payload ended.
                 if (is_data_masked())
                 {
-                    for (decltype(packet.data().size()) i = 0; i < packet.data().size(); ++i, ++demask_ix)
-                    {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wconversion"
-                        packet.data()[i] = packet.data()[i] ^ frame_data.mask_key[demask_ix % 4];
-#pragma GCC diagnostic pop
-                    }
+                    demask_ix = apply_mask(packet.data().data(), packet.data().size(), frame_data.mask_key, demask_ix);
                 }
 
                 set_message_properties(packet);
@@ -222,6 +227,7 @@ namespace smooth::application::network::http::websocket
     {
         state = State::Header;
         error = false;
+        message_compressed = false;
         data_received_in_current_state = 0;
         payload_length = 0;
         received_payload = 0;
@@ -254,5 +260,18 @@ namespace smooth::application::network::http::websocket
         }
 
         packet.set_ws_control_code(op_code);
+
+        if (op_code < OpCode::Close)
+        {
+            if (message_compressed)
+            {
+                packet.set_ws_compressed();
+            }
+
+            if ((frame_data.header[0] & 0x80) != 0 && received_payload >= payload_length)
+            {
+                packet.set_ws_message_end();
+            }
+        }
     }
 }
@@ -0,0 +1,134 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/websocket/frame_utils.h"
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#elif defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+#endif
+
+namespace smooth::application::network::http::websocket
+{
+    // The native word size; 32 bits on the ESP32.
+    using MaskWord = std::uintptr_t;
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+    static constexpr std::size_t block_size = 16;
+#else
+    static constexpr std::size_t block_size = sizeof(MaskWord);
+#endif
+
+    std::size_t write_frame_header(uint8_t* target, OpCode op_code, bool fin, uint64_t payload_length,
+                                   bool compressed)
+    {
+        std::size_t pos = 0;
+        target[pos++] = static_cast<uint8_t>((fin ? 0x80 : 0x00)
+                                             | (compressed ? 0x40 : 0x00)
+                                             | (static_cast<uint8_t>(op_code) & 0x0F));
+
+        if (payload_length <= 125)
+        {
+            target[pos++] = static_cast<uint8_t>(payload_length);
+        }
+        else
+        {
+            // Extended payload length, in network byte order.
+            const auto length_bytes = payload_length <= UINT16_MAX ? 2 : 8;
+            target[pos++] = length_bytes == 2 ? 126 : 127;
+
+            for (auto i = length_bytes - 1; i >= 0; --i)
+            {
+                target[pos++] = static_cast<uint8_t>(payload_length >> (8 * i));
+            }
+        }
+
+        return pos;
+    }
+
+    std::size_t apply_mask(uint8_t* data, std::size_t length, const uint8_t* mask_key, std::size_t phase)
+    {
+        phase &= 3;
+        std::size_t i = 0;
+
+        // Unaligned head, byte by byte.
+        while (i < length && reinterpret_cast<std::uintptr_t>(data + i) % block_size != 0)
+        {
+            data[i++] ^= mask_key[phase];
+            phase = (phase + 1) & 3;
+        }
+
+        // The key, repeated and rotated so that it starts at the current phase. As the blocks below are
+        // multiples of four bytes, the phase is the same at the start of each of them.
+        std::array<uint8_t, 16> key{};
+
+        for (std::size_t k = 0; k < key.size(); ++k)
+        {
+            key[k] = mask_key[(phase + k) & 3];
+        }
+
+#if defined(__SSE2__)
+        const auto key_vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key.data()));
+
+        for (; i + 16 <= length; i += 16)
+        {
+            auto p = reinterpret_cast<__m128i*>(data + i);
+            _mm_store_si128(p, _mm_xor_si128(_mm_load_si128(p), key_vector));
+        }
+
+#elif defined(__ARM_NEON)
+        const auto key_vector = vld1q_u8(key.data());
+
+        for (; i + 16 <= length; i += 16)
+        {
+            vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), key_vector));
+        }
+
+#endif
+
+        MaskWord key_word;
+        std::memcpy(&key_word, key.data(), sizeof(key_word));
+
+        for (; i + sizeof(MaskWord) <= length; i += sizeof(MaskWord))
+        {
+            // Knowing that the data is aligned, the compiler turns memcpy into a plain load and store, also on
+            // platforms without support for unaligned access.
+            auto p = static_cast<uint8_t*>(__builtin_assume_aligned(data + i, sizeof(MaskWord)));
+            MaskWord word;
+            std::memcpy(&word, p, sizeof(word));
+            word ^= key_word;
+            std::memcpy(p, &word, sizeof(word));
+        }
+
+        // Tail
+        for (; i < length; ++i)
+        {
+            data[i] ^= mask_key[phase];
+            phase = (phase + 1) & 3;
+        }
+
+        return phase;
+    }
+}
@@ -0,0 +1,89 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/application/network/http/websocket/responses/WSBroadcastResponse.h"
+
+namespace smooth::application::network::http::websocket::responses
+{
+    WSBroadcastResponse::WSBroadcastResponse(SharedFrame frame, std::shared_ptr<BroadcastBacklog> backlog)
+            : frame(std::move(frame)), backlog(std::move(backlog))
+    {
+        ++this->backlog->waiting;
+        this->backlog->latest = this;
+    }
+
+    WSBroadcastResponse::~WSBroadcastResponse()
+    {
+        leave_backlog();
+    }
+
+    ResponseStatus WSBroadcastResponse::get_data(std::size_t /*max_amount*/, std::vector<uint8_t>& target)
+    {
+        // Only used by servers not supporting shared data; the frame is sent in one piece regardless.
+        auto res = ResponseStatus::NoData;
+
+        if (!started)
+        {
+            leave_backlog();
+            target.insert(target.end(), frame->begin(), frame->end());
+            res = ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    ResponseStatus WSBroadcastResponse::get_shared_data(std::size_t /*max_amount*/, SharedContent& target)
+    {
+        auto res = ResponseStatus::NoData;
+
+        if (!started)
+        {
+            leave_backlog();
+            target.owner = frame;
+            target.data = frame->data();
+            target.length = frame->size();
+            res = ResponseStatus::LastData;
+        }
+
+        return res;
+    }
+
+    bool WSBroadcastResponse::replace(SharedFrame newer)
+    {
+        if (!started)
+        {
+            frame = std::move(newer);
+        }
+
+        return !started;
+    }
+
+    void WSBroadcastResponse::leave_backlog()
+    {
+        if (!started)
+        {
+            started = true;
+            --backlog->waiting;
+
+            if (backlog->latest == this)
+            {
+                backlog->latest = nullptr;
+            }
+        }
+    }
+}
@@ -69,7 +69,7 @@ namespace smooth::application::network::mqtt::packet
         // User Name
         // Password
 
-        apply_constructed_data(variable_header);
+        apply_constructed_data(std::move(variable_header));
     }
 
     bool Connect::get_clean_session()
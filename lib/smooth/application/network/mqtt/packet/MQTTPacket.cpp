@@ -16,6 +16,7 @@ limitations under the License.
 */
 
 #include <sstream>
+#include <utility>
 #include "smooth/application/network/mqtt/packet/MQTTPacket.h"
 #include "smooth/core/logging/log.h"
 #include "smooth/application/network/mqtt/packet/IPacketReceiver.h"
@@ -27,10 +28,7 @@ namespace smooth::application::network::mqtt::packet
 {
     void MQTTPacket::append_data(const uint8_t* data, int length, std::vector<uint8_t>& target)
     {
-        for (int i = 0; i < length; ++i)
-        {
-            target.push_back(data[i]);
-        }
+        target.insert(target.end(), data, data + length);
     }
 
     std::string MQTTPacket::get_string(std::vector<uint8_t>::const_iterator offset) const
@@ -95,15 +93,14 @@ namespace smooth::application::network::mqtt::packet
         target.push_back(static_cast<uint8_t &&>(value & 0xFF));
     }
 
-    void MQTTPacket::apply_constructed_data(const std::vector<uint8_t>& variable)
+    void MQTTPacket::apply_constructed_data(std::vector<uint8_t>&& variable)
     {
         encode_remaining_length(static_cast<int>(variable.size()));
 
-        // Using move_iterator we reduce the memory foot print by actually moving
-        // instead of copying the data.
-        std::copy(std::make_move_iterator(variable.begin()),
-                  std::make_move_iterator(variable.end()),
-                  std::back_inserter(data));
+        // Rather than copying the variable part onto the fixed header, take over its
+        // buffer and only shift its content by the few bytes the fixed header occupies.
+        variable.insert(variable.begin(), data.cbegin(), data.cend());
+        data = std::move(variable);
         calculate_remaining_length_and_variable_header_offset();
     }
 
@@ -30,6 +30,9 @@ namespace smooth::application::network::mqtt::packet
 
         std::vector<uint8_t> variable_header{};
 
+        // Topic with length, packet identifier, payload and room for the fixed header.
+        variable_header.reserve(topic.length() + 2 + 2 + static_cast<size_t>(length) + 5);
+
         // Topic
         append_string(topic, variable_header);
 
@@ -42,7 +45,7 @@ namespace smooth::application::network::mqtt::packet
         // Payload
         append_data(data, length, variable_header);
 
-        apply_constructed_data(variable_header);
+        apply_constructed_data(std::move(variable_header));
     }
 
     std::string Publish::get_topic() const
@@ -27,6 +27,11 @@ limitations under the License.
 #include <freertos/task.h>
 #endif
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 using namespace smooth::core::logging;
 
 namespace smooth::core
@@ -104,6 +109,21 @@ namespace smooth::core
                                          this->exec();
                 });
 
+#ifdef __linux__
+
+                if (affinity != tskNO_AFFINITY)
+                {
+                    cpu_set_t cpus;
+                    CPU_ZERO(&cpus);
+                    CPU_SET(static_cast<size_t>(affinity), &cpus);
+
+                    if (pthread_setaffinity_np(worker.native_handle(), sizeof(cpus), &cpus) != 0)
+                    {
+                        Log::warning(name, "Could not set affinity to core {}", affinity);
+                    }
+                }
+#endif
+
                 Log::debug(name, "Waiting for worker to start");
 
                 // To avoid race conditions between tasks during start up,
@@ -160,37 +180,18 @@ namespace smooth::core
                     q->poll();
                 }
 
-                // Wait for data to become available, or a timeout to occur.
-                auto queue_ptr = notification.wait_for_notification(tick_interval);
-
-                // Check if the weak_ptr we got back is uninitialized using the defined behaviour here:
-                // https://en.cppreference.com/w/cpp/memory/weak_ptr/owner_before
-                //
-                // Quote: The order is such that two smart pointers compare equivalent only
-                // if they are both empty or if they both own the same object, even if the
-                // values of the pointers obtained by get() are different (e.g. because they
-                // point at different subobjects within the same object)
-                decltype(queue_ptr) empty_ptr{};
-
-                if (!queue_ptr.owner_before(empty_ptr) && !empty_ptr.owner_before(queue_ptr))
+                // Wait for data to become available and forward it, or a timeout to occur.
+                // Note: Do not retrieve all messages from the the queue;
+                // it will prevent messages to arrive in the same order
+                // they were sent when there are more than one receiver queue.
+                // Instead, each notification forwards exactly one event, in the order
+                // the notifications were made.
+                if (!notification.forward_events(tick_interval, event_batch_size))
                 {
                     // Timeout - no messages.
                     tick();
                     delayed.reset();
                 }
-                else
-                {
-                    // A queue has signaled an item is available.
-                    // Note: Do not retrieve all messages from the the queue;
-                    // it will prevent messages to arrive in the same order
-                    // they were sent when there are more than one receiver queue.
-                    auto queue = queue_ptr.lock();
-
-                    if (queue)
-                    {
-                        queue->forward_to_event_listener();
-                    }
-                }
             }
 
             if (status_report_timer.get_running_time() > std::chrono::seconds(60))
@@ -224,6 +225,16 @@ namespace smooth::core
         }
     }
 
+    void Task::set_event_batch_size(uint32_t max_events)
+    {
+        event_batch_size = std::max(max_events, 1U);
+    }
+
+    void Task::set_event_wake_up(std::function<void()> wake_up)
+    {
+        notification.set_wake_up(std::move(wake_up));
+    }
+
     void Task::report_stack_status()
     {
         SystemStatistics::instance().report(name, TaskStats{ stack_size });
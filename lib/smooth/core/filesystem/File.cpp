@@ -45,7 +45,7 @@ namespace smooth::core::filesystem
 
             if (fs.is_open())
             {
-                fs.seekg(static_cast<int32_t>(offset), std::ios::beg);
+                fs.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
 
                 // Reserve to ensure exact memory usage (i.e. no extra memory used)
                 data.reserve(static_cast<std::vector<uint8_t>::size_type>(length));
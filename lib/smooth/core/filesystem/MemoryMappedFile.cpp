@@ -0,0 +1,98 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/core/filesystem/MemoryMappedFile.h"
+#include "smooth/core/filesystem/FSLock.h"
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#endif
+
+namespace smooth::core::filesystem
+{
+    MemoryMappedFile::MemoryMappedFile(const Path& path)
+    {
+#ifdef __linux__
+        // The file is opened under the lock, but the descriptor kept for is_intact() is not counted as an
+        // open file; the limit is there for the file systems of platforms that don't support mapping.
+        FSLock lock;
+
+        auto file = open(static_cast<const char*>(path), O_RDONLY | O_CLOEXEC);
+
+        if (file >= 0)
+        {
+            struct stat info{};
+
+            // Empty files can't be mapped, they are simply not mapped.
+            if (fstat(file, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+            {
+                auto size = static_cast<std::size_t>(info.st_size);
+                auto res = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+                if (res != MAP_FAILED)
+                {
+                    mapped = static_cast<const uint8_t*>(res);
+                    length = size;
+                    fd = file;
+
+                    // Content is read front to back.
+                    madvise(res, size, MADV_SEQUENTIAL);
+                }
+            }
+
+            if (fd < 0)
+            {
+                close(file);
+            }
+        }
+#else
+        static_cast<void>(path);
+#endif
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+#ifdef __linux__
+        if (mapped)
+        {
+            munmap(const_cast<uint8_t*>(mapped), length);
+            close(fd);
+        }
+#endif
+    }
+
+    bool MemoryMappedFile::is_intact() const
+    {
+        bool res = false;
+
+#ifdef __linux__
+        struct stat info{};
+        res = mapped
+              && fstat(fd, &info) == 0
+              && info.st_size >= 0
+              && static_cast<std::size_t>(info.st_size) >= length;
+#endif
+
+        return res;
+    }
+}
@@ -15,64 +15,186 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
-#include <thread>
+
 #include "smooth/core/ipc/QueueNotification.h"
 #include <algorithm>
 
 namespace smooth::core::ipc
 {
-    void QueueNotification::notify(const std::weak_ptr<ITaskEventQueue>& queue)
+    int QueueNotification::register_queue(const std::weak_ptr<ITaskEventQueue>& queue, int size)
     {
-        // It might look like the queue can grow without bounds, but that is not the case
-        // as TaskEventQueues only call this method when they have successfully added the
-        // data item to their internal queue. As such, the queue can only be as large as
-        // the sum of all queues within the same Task.
         std::unique_lock<std::mutex> lock{ guard };
-        queues.emplace_back(queue);
-        cond.notify_one();
+
+        int id;
+
+        if (free_slots.empty())
+        {
+            id = static_cast<int>(slots.size());
+            slots.emplace_back();
+            slots.back().id = id;
+        }
+        else
+        {
+            id = free_slots.back();
+            free_slots.pop_back();
+        }
+
+        auto& slot = slots[static_cast<size_t>(id)];
+        slot.queue = queue;
+        slot.size = static_cast<size_t>(std::max(size, 1));
+        slot.registered = true;
+
+        // A queue can't have more notifications outstanding than it has items, so make room
+        // for all of them up front, keeping notify() free from allocations.
+        registered_size += slot.size;
+
+        if (registered_size > ring.size())
+        {
+            grow_ring(registered_size);
+        }
+
+        return id;
     }
 
-    void QueueNotification::remove_expired_queues()
+    void QueueNotification::unregister_queue(int id)
     {
         std::unique_lock<std::mutex> lock{ guard };
 
-        auto new_end = std::remove_if(queues.begin(), queues.end(),
-                                      [&](const auto& o) { return o.expired(); });
+        if (id >= 0 && static_cast<size_t>(id) < slots.size())
+        {
+            auto& slot = slots[static_cast<size_t>(id)];
+
+            if (slot.registered)
+            {
+                slot.registered = false;
+                registered_size -= slot.size;
 
-        queues.erase(new_end, queues.end());
+                if (slot.pending == 0)
+                {
+                    slot.queue.reset();
+                    free_slots.push_back(id);
+                }
+            }
+        }
     }
 
-    std::weak_ptr<ITaskEventQueue> QueueNotification::wait_for_notification(std::chrono::milliseconds timeout)
+    void QueueNotification::notify(int id)
     {
         std::unique_lock<std::mutex> lock{ guard };
-        std::weak_ptr<ITaskEventQueue> res{};
+        add_to_ring(id);
+        cond.notify_one();
 
-        if (queues.empty())
+        if (wake_up)
+        {
+            wake_up();
+        }
+    }
+
+    bool QueueNotification::forward_events(std::chrono::milliseconds timeout, size_t max_count)
+    {
         {
-            // Wait until data is available, or timeout. This will atomically release the lock.
-            auto wait_result = cond.wait_until(lock,
-                                               std::chrono::steady_clock::now() + timeout,
-                                               [this]() {
-                                                   // Stop waiting when there is data
-                                                   return !queues.empty();
-                                               });
+            std::unique_lock<std::mutex> lock{ guard };
+
+            if (ring_count == 0)
+            {
+                // Wait until data is available, or timeout. This will atomically release the lock.
+                cond.wait_until(lock,
+                                std::chrono::steady_clock::now() + timeout,
+                                [this]() {
+                                    // Stop waiting when there is data
+                                    return ring_count > 0;
+                                });
+            }
 
             // At this point we will have the lock again.
-            if (wait_result)
+            auto count = std::min(std::max(max_count, size_t{ 1 }), ring_count);
+
+            batch.clear();
+            batch.reserve(max_count);
+
+            for (size_t i = 0; i < count; ++i)
             {
-                if (!queues.empty())
-                {
-                    res = queues.front();
-                    queues.pop_front();
-                }
+                batch.push_back(&slots[static_cast<size_t>(ring[ring_head])]);
+                ring_head = (ring_head + 1) % ring.size();
             }
+
+            ring_count -= count;
         }
-        else
+
+        // Forward outside the lock so that event listeners may push to, create and destroy queues.
+        // Each slot stays valid until released, but the queue itself may be gone.
+        for (auto* slot : batch)
         {
-            res = queues.front();
-            queues.pop_front();
+            auto queue = slot->queue.lock();
+
+            if (queue)
+            {
+                queue->forward_to_event_listener();
+            }
+        }
+
+        bool res = !batch.empty();
+
+        if (res)
+        {
+            std::unique_lock<std::mutex> lock{ guard };
+
+            for (auto* slot : batch)
+            {
+                release(*slot);
+            }
         }
 
         return res;
     }
+
+    void QueueNotification::clear()
+    {
+        std::unique_lock<std::mutex> lock{ guard };
+
+        while (ring_count > 0)
+        {
+            release(slots[static_cast<size_t>(ring[ring_head])]);
+            ring_head = (ring_head + 1) % ring.size();
+            --ring_count;
+        }
+    }
+
+    void QueueNotification::add_to_ring(int id)
+    {
+        if (ring_count == ring.size())
+        {
+            // Only happens if notifications outnumber the items in the queues, such as after a queue has been
+            // cleared, so growing here is rare.
+            grow_ring(std::max(ring.size() * 2, size_t{ 8 }));
+        }
+
+        ring[(ring_head + ring_count) % ring.size()] = id;
+        ++ring_count;
+        ++slots[static_cast<size_t>(id)].pending;
+    }
+
+    void QueueNotification::grow_ring(size_t new_size)
+    {
+        std::vector<int> grown(new_size);
+
+        for (size_t i = 0; i < ring_count; ++i)
+        {
+            grown[i] = ring[(ring_head + i) % ring.size()];
+        }
+
+        ring = std::move(grown);
+        ring_head = 0;
+    }
+
+    void QueueNotification::release(Slot& slot)
+    {
+        --slot.pending;
+
+        if (slot.pending == 0 && !slot.registered)
+        {
+            slot.queue.reset();
+            free_slots.push_back(slot.id);
+        }
+    }
 }
@@ -51,7 +51,7 @@ namespace smooth::core::network
             loge("Could not get socket flags");
             res = false;
         }
-        else if (fcntl(socket_id, F_SETFL, opts | O_NONBLOCK) < 0)
+        else if ((opts & O_NONBLOCK) == 0 && fcntl(socket_id, F_SETFL, opts | O_NONBLOCK) < 0)
         {
             loge("Could not set non blocking flag");
             res = false;
@@ -85,7 +85,7 @@ namespace smooth::core::network
     {
         log(reason);
         stop_internal();
-        SocketDispatcher::instance().perform_op(SocketOperation::Op::Stop, shared_from_this());
+        get_dispatcher().perform_op(SocketOperation::Op::Stop, shared_from_this());
     }
 
     bool CommonSocket::is_active() const
@@ -93,6 +93,36 @@ namespace smooth::core::network
         return active;
     }
 
+    void CommonSocket::pause_receive(bool paused)
+    {
+        if (receive_paused.exchange(paused) && !paused)
+        {
+            // The time spent paused does not count towards the receive timeout.
+            elapsed_receive_time.start();
+
+            // Have the dispatcher start monitoring the socket for incoming data again.
+            get_dispatcher().wake_up();
+        }
+    }
+
+    SocketDispatcher& CommonSocket::get_dispatcher()
+    {
+        auto current = dispatcher.load();
+
+        if (current == nullptr)
+        {
+            auto& chosen = SocketDispatcher::least_loaded();
+
+            // Another task may have assigned the socket in the meantime, in which case that shard is kept.
+            if (dispatcher.compare_exchange_strong(current, &chosen))
+            {
+                current = &chosen;
+            }
+        }
+
+        return *current;
+    }
+
     bool CommonSocket::restart()
     {
         stop("Restarting");
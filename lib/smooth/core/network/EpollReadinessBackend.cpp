@@ -0,0 +1,166 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifdef __linux__
+
+#include "smooth/core/network/EpollReadinessBackend.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "smooth/core/logging/log.h"
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    static constexpr const char* tag = "EpollReadinessBackend";
+    static constexpr auto read_events = static_cast<uint32_t>(EPOLLIN);
+    static constexpr auto write_events = static_cast<uint32_t>(EPOLLOUT);
+    static constexpr auto failure_events = static_cast<uint32_t>(EPOLLERR | EPOLLHUP);
+
+    EpollReadinessBackend::EpollReadinessBackend()
+            : epoll_fd(epoll_create1(EPOLL_CLOEXEC))
+    {
+        if (epoll_fd < 0)
+        {
+            Log::error(tag, "Could not create epoll instance: {}", strerror(errno));
+        }
+    }
+
+    EpollReadinessBackend::~EpollReadinessBackend()
+    {
+        if (epoll_fd >= 0)
+        {
+            close(epoll_fd);
+        }
+    }
+
+    bool EpollReadinessBackend::open_wake_up()
+    {
+        if (!wake.is_open() && wake.open())
+        {
+            epoll_event ev{};
+            ev.events = read_events;
+            ev.data.fd = wake.get_fd();
+
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake.get_fd(), &ev) != 0)
+            {
+                Log::error(tag, "Could not add wake-up signal: {}", strerror(errno));
+            }
+        }
+
+        return wake.is_open();
+    }
+
+    void EpollReadinessBackend::set_interest(int socket_id, bool read, bool write)
+    {
+        // Sockets without interest must be removed since EPOLLHUP and EPOLLERR are
+        // always reported, which would otherwise result in busy-looping.
+        if (read || write)
+        {
+            uint32_t mask = (read ? read_events : 0u) | (write ? write_events : 0u);
+            auto it = interest.find(socket_id);
+
+            if (it == interest.end() || it->second != mask)
+            {
+                epoll_event ev{};
+                ev.events = mask;
+                ev.data.fd = socket_id;
+
+                auto op = it == interest.end() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+
+                if (epoll_ctl(epoll_fd, op, socket_id, &ev) == 0)
+                {
+                    interest[socket_id] = mask;
+                }
+                else
+                {
+                    Log::error(tag, "Could not update interest for socket {}: {}", socket_id, strerror(errno));
+                }
+            }
+        }
+        else
+        {
+            remove(socket_id);
+        }
+    }
+
+    void EpollReadinessBackend::remove(int socket_id)
+    {
+        auto it = interest.find(socket_id);
+
+        if (it != interest.end())
+        {
+            epoll_event ev{};
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, socket_id, &ev);
+            interest.erase(it);
+        }
+    }
+
+    bool EpollReadinessBackend::wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready)
+    {
+        ready.clear();
+
+        // Room for every monitored socket plus the wake-up signal.
+        events.resize(std::max(events.size(), interest.size() + 1));
+
+        bool res = true;
+        auto count = epoll_wait(epoll_fd,
+                                events.data(),
+                                static_cast<int>(events.size()),
+                                static_cast<int>(timeout.count()));
+
+        if (count < 0)
+        {
+            res = errno == EINTR;
+        }
+        else
+        {
+            for (auto i = 0; i < count; ++i)
+            {
+                const auto& ev = events[static_cast<std::size_t>(i)];
+
+                if (ev.data.fd == wake.get_fd())
+                {
+                    wake.clear();
+                }
+                else
+                {
+                    auto it = interest.find(ev.data.fd);
+
+                    if (it != interest.end())
+                    {
+                        // As with select(), errors are reported for whatever the socket is monitored for.
+                        auto mask = it->second;
+                        bool readable = (mask & read_events) && (ev.events & (read_events | failure_events));
+                        bool writable = (mask & write_events) && (ev.events & (write_events | failure_events));
+
+                        if (readable || writable)
+                        {
+                            ready.push_back(SocketReadiness{ ev.data.fd, readable, writable });
+                        }
+                    }
+                }
+            }
+        }
+
+        return res;
+    }
+}
+
+#endif
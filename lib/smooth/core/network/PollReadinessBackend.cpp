@@ -0,0 +1,123 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/PollReadinessBackend.h"
+#include <cerrno>
+
+namespace smooth::core::network
+{
+    PollReadinessBackend::PollReadinessBackend()
+    {
+        // Negative file descriptors are ignored by poll(), so the slot is inactive until opened.
+        fds.push_back(pollfd{ -1, POLLIN, 0 });
+    }
+
+    bool PollReadinessBackend::open_wake_up()
+    {
+        if (wake.open())
+        {
+            fds[0].fd = wake.get_fd();
+        }
+
+        return wake.is_open();
+    }
+
+    void PollReadinessBackend::set_interest(int socket_id, bool read, bool write)
+    {
+        if (read || write)
+        {
+            short events = static_cast<short>((read ? POLLIN : 0) | (write ? POLLOUT : 0));
+            auto it = index.find(socket_id);
+
+            if (it == index.end())
+            {
+                index.emplace(socket_id, fds.size());
+                fds.push_back(pollfd{ socket_id, events, 0 });
+            }
+            else
+            {
+                fds[it->second].events = events;
+            }
+        }
+        else
+        {
+            remove(socket_id);
+        }
+    }
+
+    void PollReadinessBackend::remove(int socket_id)
+    {
+        auto it = index.find(socket_id);
+
+        if (it != index.end())
+        {
+            // Move the last entry into the free slot to keep the array packed.
+            auto pos = it->second;
+            index.erase(it);
+
+            if (pos != fds.size() - 1)
+            {
+                fds[pos] = fds.back();
+                index[fds[pos].fd] = pos;
+            }
+
+            fds.pop_back();
+        }
+    }
+
+    bool PollReadinessBackend::wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready)
+    {
+        ready.clear();
+
+        bool res = true;
+        auto count = poll(fds.data(), static_cast<nfds_t>(fds.size()), static_cast<int>(timeout.count()));
+
+        if (count < 0)
+        {
+            res = errno == EINTR;
+        }
+        else if (count > 0)
+        {
+            if (fds[0].revents != 0)
+            {
+                wake.clear();
+            }
+
+            constexpr int failure = POLLERR | POLLHUP | POLLNVAL;
+
+            for (std::size_t i = 1; i < fds.size(); ++i)
+            {
+                const auto& p = fds[i];
+
+                if (p.revents != 0)
+                {
+                    // Errors are reported for whatever the socket is monitored for, just like select() does,
+                    // so that the socket detects the error when it tries to read or write.
+                    bool readable = (p.events & POLLIN) && (p.revents & (POLLIN | failure));
+                    bool writable = (p.events & POLLOUT) && (p.revents & (POLLOUT | failure));
+
+                    if (readable || writable)
+                    {
+                        ready.push_back(SocketReadiness{ p.fd, readable, writable });
+                    }
+                }
+            }
+        }
+
+        return res;
+    }
+}
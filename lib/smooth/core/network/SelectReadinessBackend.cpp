@@ -0,0 +1,135 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/SelectReadinessBackend.h"
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+
+namespace smooth::core::network
+{
+    void SelectReadinessBackend::set_interest(int socket_id, bool read, bool write)
+    {
+        if (read || write)
+        {
+            interest[socket_id] = Interest{ read, write };
+        }
+        else
+        {
+            remove(socket_id);
+        }
+    }
+
+    void SelectReadinessBackend::remove(int socket_id)
+    {
+        interest.erase(socket_id);
+    }
+
+    bool SelectReadinessBackend::wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready)
+    {
+        ready.clear();
+        clear_sets();
+
+        int max_file_descriptor = wake.get_fd();
+
+        if (wake.is_open())
+        {
+            set_fd(wake.get_fd(), read_set);
+        }
+
+        for (const auto& [socket_id, i] : interest)
+        {
+            if (i.read)
+            {
+                set_fd(socket_id, read_set);
+            }
+
+            if (i.write)
+            {
+                set_fd(socket_id, write_set);
+            }
+
+            max_file_descriptor = std::max(max_file_descriptor, socket_id);
+        }
+
+        bool res = true;
+
+        if (max_file_descriptor < 0)
+        {
+            // Nothing to wait on
+            std::this_thread::sleep_for(timeout);
+        }
+        else
+        {
+            timeval tv{};
+            tv.tv_sec = static_cast<decltype(tv.tv_sec)>(timeout.count() / 1000);
+            tv.tv_usec = static_cast<decltype(tv.tv_usec)>((timeout.count() % 1000) * 1000);
+
+            auto count = select(max_file_descriptor + 1, &read_set, &write_set, nullptr, &tv);
+
+            if (count < 0)
+            {
+                res = errno == EINTR;
+            }
+            else if (count > 0)
+            {
+                if (wake.is_open() && is_fd_set(wake.get_fd(), read_set))
+                {
+                    wake.clear();
+                }
+
+                for (const auto& [socket_id, i] : interest)
+                {
+                    bool readable = i.read && is_fd_set(socket_id, read_set);
+                    bool writable = i.write && is_fd_set(socket_id, write_set);
+
+                    if (readable || writable)
+                    {
+                        ready.push_back(SocketReadiness{ socket_id, readable, writable });
+                    }
+                }
+            }
+        }
+
+        return res;
+    }
+
+    void SelectReadinessBackend::clear_sets()
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+        FD_ZERO(&read_set);
+        FD_ZERO(&write_set);
+#pragma GCC diagnostic pop
+    }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+
+    void SelectReadinessBackend::set_fd(int socket_id, fd_set& fd)
+    {
+        FD_SET(static_cast<FD>(socket_id), &fd);
+    }
+
+    bool SelectReadinessBackend::is_fd_set(int socket_id, fd_set& fd)
+    {
+        return FD_ISSET(static_cast<FD>(socket_id), &fd);
+    }
+
+#pragma GCC diagnostic pop
+}
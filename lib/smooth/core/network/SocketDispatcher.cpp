@@ -16,10 +16,16 @@ limitations under the License.
 */
 
 #include <algorithm>
+#include <array>
 #include <functional>
+#include <string>
+#include <thread>
 #include "smooth/core/network/SocketDispatcher.h"
 #include "smooth/core/task_priorities.h"
 #include "smooth/config_constants.h"
+#include "smooth/core/network/SelectReadinessBackend.h"
+#include "smooth/core/network/PollReadinessBackend.h"
+#include "smooth/core/network/EpollReadinessBackend.h"
 
 #ifndef ESP_PLATFORM
 
@@ -34,87 +40,160 @@ using namespace std::chrono;
 
 namespace smooth::core::network
 {
+    static std::mutex shard_guard{};
+    static std::array<std::unique_ptr<SocketDispatcher>, SocketDispatcher::max_shards> shards{};
+    static std::size_t shard_count = static_cast<std::size_t>(CONFIG_SMOOTH_SOCKET_DISPATCHER_SHARDS);
+
     SocketDispatcher& SocketDispatcher::instance()
     {
-        static SocketDispatcher instance;
+        return shard(0);
+    }
 
-        // Start task on first use
-        static bool initialized = false;
+    SocketDispatcher& SocketDispatcher::shard(std::size_t index)
+    {
+        std::lock_guard<std::mutex> lock{ shard_guard };
+        auto& s = shards[index];
 
-        if (!initialized)
+        if (!s)
         {
-            initialized = true;
-            instance.start();
+            s.reset(new SocketDispatcher(index, core_for_shard(index)));
+
+            if (index > 0)
+            {
+                s->has_ip = shards[0] && shards[0]->has_ip;
+            }
+
+            // Start task on first use
+            s->start();
+        }
+
+        return *s;
+    }
+
+    SocketDispatcher& SocketDispatcher::least_loaded()
+    {
+        auto* best = &shard(0);
+
+        for (std::size_t i = 1; i < get_shard_count(); ++i)
+        {
+            auto& candidate = shard(i);
+
+            if (candidate.get_load() < best->get_load())
+            {
+                best = &candidate;
+            }
         }
 
-        return instance;
+        return *best;
     }
 
-    SocketDispatcher::SocketDispatcher()
-            : Task(tag, CONFIG_SMOOTH_SOCKET_DISPATCHER_STACK_SIZE, SOCKET_DISPATCHER_PRIO,
-                   std::chrono::milliseconds(0)),
+    void SocketDispatcher::set_shard_count(std::size_t count)
+    {
+        std::lock_guard<std::mutex> lock{ shard_guard };
+        shard_count = std::clamp(count, std::size_t{ 1 }, max_shards);
+    }
+
+    std::size_t SocketDispatcher::get_shard_count()
+    {
+        std::lock_guard<std::mutex> lock{ shard_guard };
+
+        return shard_count;
+    }
+
+    int SocketDispatcher::core_for_shard(std::size_t index)
+    {
+        // Called with shard_guard held.
+        int core = tskNO_AFFINITY;
+
+        if (shard_count > 1)
+        {
+#ifdef ESP_PLATFORM
+            const auto cores = static_cast<std::size_t>(portNUM_PROCESSORS);
+#else
+            const auto cores = std::max(std::size_t{ 1 }, static_cast<std::size_t>(std::thread::hardware_concurrency()));
+#endif
+            core = static_cast<int>(index % cores);
+        }
+
+        return core;
+    }
+
+    std::size_t SocketDispatcher::get_load() const
+    {
+        return held + pending;
+    }
+
+    static std::unique_ptr<IReadinessBackend> create_readiness_backend()
+    {
+#if defined(__linux__)
+        return std::make_unique<EpollReadinessBackend>();
+#elif !defined(ESP_PLATFORM) || defined(CONFIG_SMOOTH_SOCKET_DISPATCHER_USE_POLL)
+        return std::make_unique<PollReadinessBackend>();
+#else
+        return std::make_unique<SelectReadinessBackend>();
+#endif
+    }
+
+    SocketDispatcher::SocketDispatcher(std::size_t index, int core)
+            : Task(index == 0 ? std::string{ tag } : tag + std::to_string(index),
+                   CONFIG_SMOOTH_SOCKET_DISPATCHER_STACK_SIZE,
+                   SOCKET_DISPATCHER_PRIO,
+                   std::chrono::milliseconds(0),
+                   core),
               active_sockets(),
               inactive_sockets(),
               socket_guard(),
               network_events(NetworkEventQueue::create(10, *this, *this)),
-              socket_op(SocketOperationQueue::create(CONFIG_LWIP_MAX_SOCKETS,
+              // Room for every socket to be both added and stopped, as when a burst of connections is
+              // accepted while others are closing.
+              socket_op(SocketOperationQueue::create(2 * CONFIG_LWIP_MAX_SOCKETS,
                                                      *this,
-                                                     *this))
+                                                     *this)),
+              backend(create_readiness_backend())
     {
-        clear_sets();
+        // Any event queued for the dispatcher, such as socket operations from perform_op(),
+        // must interrupt the wait for socket readiness.
+        set_event_wake_up([this]() { wake_up(); });
     }
 
-    void SocketDispatcher::tick()
+    void SocketDispatcher::init()
     {
-        std::lock_guard<std::mutex> lock(socket_guard);
-        restart_inactive_sockets();
-        check_socket_timeouts();
+#ifndef ESP_PLATFORM
 
-        int max_file_descriptor = build_sets();
+        // On the ESP, the network stack isn't guaranteed to be up yet so there we open
+        // the wake-up signal once an IP has been received.
+        backend->open_wake_up();
+#else
 
-        if (max_file_descriptor >= 0)
+        if (has_ip)
         {
-            set_timeout();
-            int res = select(max_file_descriptor + 1, &read_set, &write_set, nullptr, &tv);
-
-            if (res == -1)
-            {
-                Log::error(tag, "Error during select: {}", strerror(errno));
-            }
-            else if (res > 0)
-            {
-                for (int i = 0; i <= max_file_descriptor; ++i)
-                {
-                    if (is_fd_set(static_cast<FD>(i), read_set))
-                    {
-                        auto it = active_sockets.find(i);
+            // Started after the network came up.
+            backend->open_wake_up();
+        }
+#endif
+    }
 
-                        if (it != active_sockets.end())
-                        {
-                            it->second->readable(*this);
-                        }
-                    }
+    void SocketDispatcher::wake_up()
+    {
+        backend->wake_up();
+    }
 
-                    if (is_fd_set(static_cast<FD>(i), write_set))
-                    {
-                        auto it = active_sockets.find(i);
+    void SocketDispatcher::tick()
+    {
+        std::lock_guard<std::mutex> lock(socket_guard);
+        restart_inactive_sockets();
+        check_socket_timeouts();
+        update_interest();
 
-                        if (it != active_sockets.end())
-                        {
-                            it->second->writable();
-                        }
-                    }
-                }
-            }
-        }
-        else
+        if (active_sockets.empty() && !backend->can_wake_up())
         {
             // Nothing to do, wait for work.
             // Note: We cannot block, waiting for a notification from a socket since we're the ones polling
-            // the sockets to determine if there are work to be done. And since ESP-IDF does not guarantee
-            // round-robin scheduling, std::this_thread::yield() is not an option as that results in this
-            // thread hogging the CPU, starving other threads. As such, we must spend some time sleeping to
-            // guarantee other tasks gets a chance to run.
+            // the sockets to determine if there are work to be done, and without a wake-up signal there is
+            // no way to interrupt the wait. And since ESP-IDF does not guarantee round-robin scheduling,
+            // std::this_thread::yield() is not an option as that results in this thread hogging the CPU,
+            // starving other threads. As such, we must spend some time sleeping to guarantee other tasks
+            // gets a chance to run.
             //
             // https://esp32.com/viewtopic.php?p=28594#p28589
             // https://docs.espressif.com/projects/esp-idf/en/v3.0.2/api-guides/freertos-smp.html#round-robin-scheduling
@@ -124,53 +203,111 @@ namespace smooth::core::network
             // operation, but only when there was no socket read/write to do prior to that operation being queued.
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
+        else if (backend->wait(buffered.empty() ? get_wait_time() : milliseconds{ 0 }, ready))
+        {
+            dispatch_ready_sockets();
+            dispatch_buffered_sockets();
+        }
+        else
+        {
+            Log::error(tag, "Error while waiting for sockets: {}", strerror(errno));
+        }
     }
 
-    void SocketDispatcher::set_timeout()
+    void SocketDispatcher::dispatch_ready_sockets()
     {
-        tv.tv_sec = 0;
-        tv.tv_usec = 10000;
+        for (const auto& r : ready)
+        {
+            if (r.readable)
+            {
+                auto it = active_sockets.find(r.socket_id);
+
+                if (it != active_sockets.end())
+                {
+                    it->second->readable(*this);
+                }
+            }
+
+            if (r.writable)
+            {
+                auto it = active_sockets.find(r.socket_id);
+
+                if (it != active_sockets.end())
+                {
+                    it->second->writable();
+                }
+            }
+        }
     }
 
-    void SocketDispatcher::clear_sets()
+    void SocketDispatcher::dispatch_buffered_sockets()
     {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-        FD_ZERO(&read_set);
-        FD_ZERO(&write_set);
-#pragma GCC diagnostic pop
+        for (auto socket_id : buffered)
+        {
+            auto it = active_sockets.find(socket_id);
+
+            // Data may already have been consumed if the socket also was readable.
+            if (it != active_sockets.end() && it->second->has_buffered_data())
+            {
+                it->second->readable(*this);
+            }
+        }
     }
 
-    int SocketDispatcher::build_sets()
+    std::chrono::milliseconds SocketDispatcher::get_wait_time()
     {
-        clear_sets();
+        // Without a wake-up signal, changes such as newly queued data are only
+        // seen between waits so these must be kept short.
+        milliseconds wait_time{ 10 };
+
+        if (backend->can_wake_up())
+        {
+            // Sockets must be checked for timeouts regularly, but when there are none the
+            // dispatcher only has to wake up for events, which signal the backend.
+            wait_time = active_sockets.empty() ? milliseconds{ 1000 } : milliseconds{ 100 };
+        }
 
-        int max = ISocket::INVALID_SOCKET;
+        // Don't sleep past the end of a back-off.
+        const auto now = steady_clock::now();
+
+        for (const auto& pair : backed_off)
+        {
+            auto remaining = duration_cast<milliseconds>(pair.second - now) + milliseconds{ 1 };
+            wait_time = std::max(milliseconds{ 0 }, std::min(wait_time, remaining));
+        }
+
+        return wait_time;
+    }
+
+    void SocketDispatcher::update_interest()
+    {
+        buffered.clear();
 
         for (auto& pair : active_sockets)
         {
             auto& s = pair.second;
-
-            max = std::max(max, s->get_socket_id());
+            bool read = false;
+            bool write = false;
 
             if (s->is_active())
             {
-                if (!is_backed_off(s->get_socket_id()))
+                if (!is_backed_off(pair.first))
                 {
-                    if (s->has_data_to_transmit() || !s->is_connected())
-                    {
-                        set_fd(static_cast<FD>(s->get_socket_id()), write_set);
-                    }
+                    write = s->has_data_to_transmit() || !s->is_connected();
 
-                    if (s->is_connected())
+                    // A paused socket is left unread, which makes the remote end stop sending once the
+                    // buffers in between are full.
+                    read = s->is_connected() && !s->is_receive_paused();
+
+                    if (read && s->has_buffered_data())
                     {
-                        set_fd(static_cast<FD>(s->get_socket_id()), read_set);
+                        buffered.push_back(pair.first);
                     }
                 }
             }
-        }
 
-        return max;
+            backend->set_interest(pair.first, read, write);
+        }
     }
 
     void SocketDispatcher::start_socket(const std::shared_ptr<ISocket>& socket)
@@ -204,6 +341,9 @@ namespace smooth::core::network
 
         if (socket_id != ISocket::INVALID_SOCKET)
         {
+            // Must stop monitoring the socket before the file descriptor is closed and possibly reused.
+            backend->remove(socket_id);
+
             int res = shutdown(socket_id, SHUT_RDWR);
 
             // Don't log "Not connected" errors
@@ -290,6 +430,7 @@ namespace smooth::core::network
         if (event.get_event() == NetworkEvent::GOT_IP)
         {
             Log::info(tag, "Network up, sockets will be restarted.");
+            backend->open_wake_up();
             has_ip = true;
             shall_close_sockets = true;
         }
@@ -316,23 +457,50 @@ namespace smooth::core::network
         if (event.get_op() == SocketOperation::Op::Start)
         {
             start_socket(event.get_socket());
+            --pending;
         }
         else if (event.get_op() == SocketOperation::Op::AddActiveSocket)
         {
             auto socket = event.get_socket();
             active_sockets.emplace(socket->get_socket_id(), socket);
+            --pending;
         }
         else
         {
             shutdown_socket(event.get_socket());
         }
 
+        update_load();
+
         Log::info(tag, "Active sockets: {}", active_sockets.size());
     }
 
     void SocketDispatcher::perform_op(SocketOperation::Op op, std::shared_ptr<ISocket> socket)
     {
-        socket_op->push(SocketOperation(op, std::move(socket)));
+        auto& owner = socket->get_dispatcher();
+        const bool adds = op == SocketOperation::Op::Start || op == SocketOperation::Op::AddActiveSocket;
+
+        if (adds)
+        {
+            // Counted right away, so that sockets started in quick succession are spread over the shards.
+            ++owner.pending;
+        }
+
+        if (!owner.socket_op->push(SocketOperation(op, std::move(socket))))
+        {
+            Log::error(tag, "Socket operation queue full, operation dropped");
+
+            if (adds)
+            {
+                --owner.pending;
+            }
+        }
+    }
+
+    void SocketDispatcher::update_load()
+    {
+        std::lock_guard<std::mutex> lock(socket_guard);
+        held = active_sockets.size() + inactive_sockets.size();
     }
 
     void SocketDispatcher::check_socket_timeouts()
@@ -355,19 +523,6 @@ namespace smooth::core::network
         }
     }
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wsign-conversion"
-
-    void SocketDispatcher::set_fd(FD socket_id, fd_set& fd)
-    {
-        FD_SET(socket_id, &fd);
-    }
-
-    bool SocketDispatcher::is_fd_set(FD socket_id, fd_set& fd)
-    {
-        return FD_ISSET(socket_id, &fd);
-    }
-
     void SocketDispatcher::back_off(int socket_id, std::chrono::milliseconds duration)
     {
         backed_off[socket_id] = steady_clock::now() + duration;
@@ -402,6 +557,4 @@ namespace smooth::core::network
             backed_off.erase(it);
         }
     }
-
-#pragma GCC diagnostic pop
 }
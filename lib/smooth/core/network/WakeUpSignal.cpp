@@ -0,0 +1,143 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "smooth/core/network/WakeUpSignal.h"
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "smooth/core/logging/log.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#else
+#include <netinet/in.h>
+#endif
+
+using namespace smooth::core::logging;
+
+namespace smooth::core::network
+{
+    static constexpr const char* tag = "WakeUpSignal";
+
+    WakeUpSignal::~WakeUpSignal()
+    {
+        if (is_open())
+        {
+            close(fd.load());
+        }
+    }
+
+    bool WakeUpSignal::open()
+    {
+        if (!is_open())
+        {
+#ifdef __linux__
+            auto new_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+            auto new_fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+            if (new_fd >= 0)
+            {
+                sockaddr_in addr{};
+                addr.sin_family = AF_INET;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wconversion"
+                addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+#pragma GCC diagnostic pop
+                addr.sin_port = 0;
+                socklen_t len = sizeof(addr);
+                auto* address = reinterpret_cast<sockaddr*>(&addr);
+
+                // Bind to an ephemeral port, then connect the socket to itself so that anything
+                // sent on it is received on the same socket.
+                bool ok = bind(new_fd, address, len) == 0
+                          && getsockname(new_fd, address, &len) == 0
+                          && connect(new_fd, address, len) == 0;
+
+                if (ok)
+                {
+                    auto opts = fcntl(new_fd, F_GETFL, 0);
+                    ok = opts >= 0 && fcntl(new_fd, F_SETFL, opts | O_NONBLOCK) == 0;
+                }
+
+                if (!ok)
+                {
+                    close(new_fd);
+                    new_fd = -1;
+                }
+            }
+#endif
+
+            // Only publish the file descriptor once it is ready to be signalled.
+            fd.store(new_fd, std::memory_order_release);
+
+            if (is_open())
+            {
+                Log::debug(tag, "Opened wake-up signal, fd: {}", new_fd);
+            }
+            else
+            {
+                Log::warning(tag, "Could not open wake-up signal");
+            }
+        }
+
+        return is_open();
+    }
+
+    void WakeUpSignal::signal()
+    {
+        // Only the first signal since the last clear() needs to reach the file descriptor.
+        auto current = get_fd();
+
+        if (current >= 0 && !pending.exchange(true))
+        {
+#ifdef __linux__
+            uint64_t value = 1;
+            [[maybe_unused]] auto res = write(current, &value, sizeof(value));
+#else
+            uint8_t value = 1;
+            [[maybe_unused]] auto res = send(current, &value, sizeof(value), 0);
+#endif
+        }
+    }
+
+    void WakeUpSignal::clear()
+    {
+        auto current = get_fd();
+
+        if (current >= 0)
+        {
+#ifdef __linux__
+            uint64_t value;
+            [[maybe_unused]] auto res = read(current, &value, sizeof(value));
+#else
+            uint8_t value[8];
+
+            while (recv(current, value, sizeof(value), 0) > 0)
+            {
+            }
+#endif
+
+            // Reset after draining; any signal made in between is covered by the caller
+            // processing its work after returning from the wait.
+            pending = false;
+        }
+    }
+}
@@ -33,13 +33,11 @@ namespace smooth::core::timer
               queue(std::move(event_queue)),
               expire_time(steady_clock::now())
     {
-        // Start the timer service when a timer is fist used.
-        TimerService::start_service();
     }
 
     void Timer::start()
     {
-        stop();
+        // Adding a timer that is already running restarts it.
         TimerService::get().add_timer(shared_from_this());
     }
 
@@ -56,7 +54,6 @@ namespace smooth::core::timer
 
     void Timer::reset()
     {
-        stop();
         start();
     }
 
@@ -65,15 +62,34 @@ namespace smooth::core::timer
         return id;
     }
 
-    void Timer::expired()
+    void Timer::expired(steady_clock::time_point now)
     {
-        TimerExpiredEvent ev(id);
+        uint32_t skipped = 0;
+        bool keep_rate = repeating && fixed_rate && timer_interval.count() > 0;
+
+        if (keep_rate)
+        {
+            // Whole periods that have passed since the deadline are lost.
+            skipped = static_cast<uint32_t>((now - expire_time) / timer_interval);
+        }
+
+        TimerExpiredEvent ev(id, skipped);
         const auto& q = queue.lock();
 
         if (q)
         {
             q->push(ev);
         }
+
+        if (keep_rate)
+        {
+            // Schedule from the deadline rather than from now to avoid drifting.
+            expire_time += timer_interval * (skipped + 1);
+        }
+        else if (repeating)
+        {
+            calculate_next_execution();
+        }
     }
 
     TimerOwner Timer::create(int id,
@@ -81,6 +97,9 @@ namespace smooth::core::timer
                              bool auto_reload,
                              std::chrono::milliseconds interval)
     {
+        // Start the timer service when a timer is fist used.
+        TimerService::start_service();
+
         return TimerOwner(create_protected_shared<Timer>(id, event_queue, auto_reload, interval));
     }
 
@@ -30,11 +30,7 @@ namespace smooth::core::timer
                    CONFIG_SMOOTH_TIMER_SERVICE_STACK_SIZE,
                    TIMER_SERVICE_PRIO,
                    milliseconds(0)),
-              cmp([](const SharedTimer& left, const SharedTimer& right) {
-                      // We want the timer with the least time left to be first in the list
-                      return left->expires_at() > right->expires_at();
-                  }),
-              queue(cmp),
+              wheel(steady_clock::now()),
               guard()
     {
     }
@@ -55,71 +51,56 @@ namespace smooth::core::timer
     {
         std::lock_guard<std::mutex> lock(guard);
         timer->calculate_next_execution();
-        queue.push(timer);
-        cond.notify_one();
+        wheel.insert(timer);
+
+        // Only wake the service if it would otherwise sleep past the new timer.
+        if (timer->expires_at() < wake_up_at)
+        {
+            wake_up_early = true;
+            cond.notify_one();
+        }
     }
 
     void TimerService::remove_timer(const SharedTimer& timer)
     {
         std::lock_guard<std::mutex> lock(guard);
-        queue.remove_timer(timer);
-        cond.notify_one();
+        wheel.remove(*timer);
     }
 
     void TimerService::tick()
     {
         std::unique_lock<std::mutex> lock(guard);
 
-        if (queue.empty())
-        {
-            // No timers, wait until one is added.
-            cond.wait_for(lock, seconds(1));
-        }
-        else
-        {
-            // Get a fixed 'now'
-            auto now = steady_clock::now();
+        // Get a fixed 'now' and process any expired timers
+        auto now = steady_clock::now();
+        wheel.advance(now, expired);
 
-            std::vector<SharedTimer> processed{};
+        for (auto& timer : expired)
+        {
+            // This also calculates the next expiry of repeating timers.
+            timer->expired(now);
 
-            // Process any expired timers
-            while (!queue.empty() && now >= queue.top()->expires_at())
+            // Add the timer again if repeating, otherwise simply forget about it.
+            if (timer->is_repeating())
             {
-                auto timer = queue.top();
-                timer->expired();
-
-                // Timer expired, remove from queue
-                queue.pop();
-
-                // Save timer to later add it, if repeating.
-                // Otherwise, simply forget about it.
-                if (timer->is_repeating())
-                {
-                    processed.push_back(timer);
-                }
+                wheel.insert(timer);
             }
+        }
 
-            for (auto& t : processed)
-            {
-                t->calculate_next_execution();
-                queue.push(t);
-            }
+        expired.clear();
+        wake_up_early = false;
 
-            if (!queue.empty())
-            {
-                // Get next timer to expire
-                auto timer = queue.top();
-
-                // Wait for the timer to expire, or a timer to be removed or added.
-                auto current_queue_length = queue.size();
-
-                cond.wait_until(lock,
-                                timer->expires_at(),
-                                [current_queue_length, this]() {
-                                    // Wake up if a timer has been added or removed.
-                                    return current_queue_length != queue.size();
-                                });
-            }
+        if (wheel.empty())
+        {
+            // No timers, wait until one is added.
+            wake_up_at = steady_clock::time_point::max();
+            cond.wait_for(lock, seconds(1), [this]() { return wake_up_early; });
+        }
+        else
+        {
+            // Wait for the next timer to expire, or an earlier one to be added.
+            wake_up_at = wheel.next_wake_up();
+            cond.wait_until(lock, wake_up_at, [this]() { return wake_up_early; });
         }
     }
 }
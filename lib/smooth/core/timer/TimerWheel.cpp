@@ -0,0 +1,256 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "smooth/core/timer/TimerWheel.h"
+#include "smooth/core/timer/Timer.h"
+#include <algorithm>
+
+using namespace std::chrono;
+
+namespace smooth::core::timer
+{
+    static_assert(TimerWheel::slots_per_level == 64, "Slot occupancy is tracked in a 64 bit word per level");
+
+    TimerWheel::TimerWheel(steady_clock::time_point epoch)
+            : epoch(epoch)
+    {
+    }
+
+    TimerWheel::~TimerWheel()
+    {
+        // Release the references to any remaining timers.
+        for (auto& head : slots)
+        {
+            while (head)
+            {
+                auto ref = std::move(head->wheel_ref);
+                unlink(*head);
+            }
+        }
+    }
+
+    void TimerWheel::insert(const SharedTimer& timer)
+    {
+        if (timer->wheel_slot >= 0)
+        {
+            unlink(*timer);
+        }
+        else
+        {
+            timer->wheel_ref = timer;
+            ++count;
+        }
+
+        // A timer can't expire in the tick already processed, so the earliest is the next one.
+        auto earliest = std::max(to_tick_ceil(timer->expires_at()), current + 1);
+        auto latest = earliest + timer->slack_ms;
+
+        // Within the window allowed by the slack, pick the tick with the most trailing zero bits. Timers with
+        // overlapping windows then tend to pick the same tick, and so expire together in a single wake-up.
+        auto tick = latest;
+
+        while ((tick & (tick - 1)) >= earliest)
+        {
+            tick &= tick - 1;
+        }
+
+        timer->wheel_tick = tick;
+        link(*timer);
+    }
+
+    void TimerWheel::remove(Timer& timer)
+    {
+        if (timer.wheel_slot >= 0)
+        {
+            unlink(timer);
+            --count;
+
+            // Release the reference last, it may be the last one to the timer.
+            auto ref = std::move(timer.wheel_ref);
+        }
+    }
+
+    void TimerWheel::advance(steady_clock::time_point now, std::vector<SharedTimer>& expired)
+    {
+        auto target = to_tick_floor(now);
+
+        // Skip directly between the ticks where something happens instead of visiting every tick.
+        while (count > 0)
+        {
+            auto next = next_event_tick();
+
+            if (next > target)
+            {
+                break;
+            }
+
+            process_tick(next, expired);
+        }
+
+        current = std::max(current, target);
+    }
+
+    steady_clock::time_point TimerWheel::next_wake_up() const
+    {
+        return epoch + milliseconds(next_event_tick());
+    }
+
+    uint64_t TimerWheel::next_event_tick() const
+    {
+        auto res = std::numeric_limits<uint64_t>::max();
+
+        for (uint32_t level = 0; level < level_count; ++level)
+        {
+            if (level_size[level] > 0)
+            {
+                // Slots are always ahead of the current position on their level, except for
+                // the lowest level where the slot for the current tick has already been processed.
+                auto from = position(current, level) + 1;
+                auto tick = (from + first_occupied(level, from)) << (bits_per_level * level);
+                res = std::min(res, tick);
+            }
+        }
+
+        return res;
+    }
+
+    uint64_t TimerWheel::to_tick_ceil(steady_clock::time_point time) const
+    {
+        return time > epoch ? static_cast<uint64_t>(ceil<milliseconds>(time - epoch).count()) : 0;
+    }
+
+    uint64_t TimerWheel::to_tick_floor(steady_clock::time_point time) const
+    {
+        return time > epoch ? static_cast<uint64_t>(floor<milliseconds>(time - epoch).count()) : 0;
+    }
+
+    void TimerWheel::link(Timer& timer)
+    {
+        // Find the lowest level where the timer fits within one lap of the slots.
+        uint32_t level = 0;
+
+        while (level < level_count - 1
+               && position(timer.wheel_tick, level) - position(current, level) >= slots_per_level)
+        {
+            ++level;
+        }
+
+        // Timers beyond the range of the top level are parked in its furthest slot
+        // and placed again once that slot is reached.
+        auto pos = std::min(position(timer.wheel_tick, level), position(current, level) + slots_per_level - 1);
+        auto slot = pos & slot_mask;
+        auto index = level * slots_per_level + slot;
+
+        auto& head = slots[index];
+        timer.wheel_prev = nullptr;
+        timer.wheel_next = head;
+
+        if (head)
+        {
+            head->wheel_prev = &timer;
+        }
+
+        head = &timer;
+        timer.wheel_slot = static_cast<int>(index);
+        occupied[level] |= uint64_t{ 1 } << slot;
+        ++level_size[level];
+    }
+
+    void TimerWheel::unlink(Timer& timer)
+    {
+        auto index = static_cast<size_t>(timer.wheel_slot);
+        auto level = index / slots_per_level;
+
+        if (timer.wheel_prev)
+        {
+            timer.wheel_prev->wheel_next = timer.wheel_next;
+        }
+        else
+        {
+            slots[index] = timer.wheel_next;
+        }
+
+        if (timer.wheel_next)
+        {
+            timer.wheel_next->wheel_prev = timer.wheel_prev;
+        }
+
+        if (slots[index] == nullptr)
+        {
+            occupied[level] &= ~(uint64_t{ 1 } << (index % slots_per_level));
+        }
+
+        --level_size[level];
+        timer.wheel_prev = nullptr;
+        timer.wheel_next = nullptr;
+        timer.wheel_slot = -1;
+    }
+
+    void TimerWheel::process_tick(uint64_t tick, std::vector<SharedTimer>& expired)
+    {
+        current = tick;
+
+        // Move timers down from each level whose slot boundary is crossed, highest level first
+        // so that they can continue further down in the same tick.
+        for (auto level = level_count - 1; level > 0; --level)
+        {
+            auto low_bits = (uint64_t{ 1 } << (bits_per_level * level)) - 1;
+
+            if ((tick & low_bits) == 0)
+            {
+                cascade(level, position(tick, level) & slot_mask);
+            }
+        }
+
+        auto& head = slots[tick & slot_mask];
+
+        while (head)
+        {
+            auto timer = std::move(head->wheel_ref);
+            unlink(*timer);
+            --count;
+            expired.emplace_back(std::move(timer));
+        }
+    }
+
+    void TimerWheel::cascade(uint32_t level, uint64_t slot)
+    {
+        auto index = level * slots_per_level + slot;
+        auto timer = slots[index];
+        slots[index] = nullptr;
+        occupied[level] &= ~(uint64_t{ 1 } << slot);
+
+        while (timer)
+        {
+            auto next = timer->wheel_next;
+            --level_size[level];
+            link(*timer);
+            timer = next;
+        }
+    }
+
+    uint32_t TimerWheel::first_occupied(uint32_t level, uint64_t from) const
+    {
+        // Rotate the occupancy bits so that the slot for 'from' is the lowest bit, then find the first set bit.
+        auto shift = static_cast<uint32_t>(from & slot_mask);
+        auto bits = occupied[level];
+        auto rotated = shift == 0 ? bits : (bits >> shift) | (bits << (slots_per_level - shift));
+
+        return static_cast<uint32_t>(__builtin_ctzll(rotated));
+    }
+}
@@ -18,6 +18,8 @@ limitations under the License.
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -44,20 +46,45 @@ namespace smooth::application::network::http
 
             HTTPPacket(HTTPPacket&&) = default;
 
+            HTTPPacket& operator=(HTTPPacket&&) = default;
+
+            // The headers and the content are kept in separate buffers and sent as two segments,
+            // so the content is never copied; pass it using std::move() to avoid copying it here too.
             HTTPPacket(regular::ResponseCode code, const std::string& version,
                        const std::unordered_map<std::string, std::string>& new_headers,
-                       const std::vector<uint8_t>& response_content);
+                       std::vector<uint8_t> response_content);
 
             HTTPPacket(regular::HTTPMethod method, const std::string& url,
                        const std::unordered_map<std::string, std::string>& new_headers,
-                       const std::vector<uint8_t>& response_content);
+                       std::vector<uint8_t> response_content);
 
             explicit HTTPPacket(std::vector<uint8_t>& response_content);
 
+            /// Sends the content from memory owned by someone else instead of the content buffer.
+            /// The owner is kept alive for as long as the packet lives. As the packet is sent in segments
+            /// with an int length, keep the length well below INT_MAX.
+            void set_shared_body(std::shared_ptr<const void> owner, const uint8_t* data, std::size_t length)
+            {
+                body.clear();
+                shared_body_owner = std::move(owner);
+                shared_body = data;
+                shared_body_length = length;
+            }
+
+            /// Frames the body as a single chunk of the chunked transfer coding.
+            /// \param last_chunk If true, the chunk is followed by the last (empty) chunk, ending the response.
+            void frame_as_chunk(bool last_chunk);
+
             // Must return the total amount of bytes to send
             int get_send_length() override
             {
-                return static_cast<int>(content.size());
+                return static_cast<int>(get_send_size());
+            }
+
+            /// Gets the total amount of bytes to send, without the limits of an int.
+            [[nodiscard]] std::size_t get_send_size() const
+            {
+                return content.size() + body_size() + chunk_trailer_length;
             }
 
             // Must return a pointer to the data to be sent.
@@ -66,6 +93,29 @@ namespace smooth::application::network::http
                 return content.data();
             }
 
+            int get_segment_count() override
+            {
+                return 1 + (body_size() == 0 ? 0 : 1) + (chunk_trailer_length == 0 ? 0 : 1);
+            }
+
+            core::network::PacketSegment get_segment(int index) override
+            {
+                core::network::PacketSegment segment{ content.data(), static_cast<int>(content.size()) };
+
+                if (index == 1 && body_size() > 0)
+                {
+                    segment = shared_body_owner
+                              ? core::network::PacketSegment{ shared_body, static_cast<int>(shared_body_length) }
+                              : core::network::PacketSegment{ body.data(), static_cast<int>(body.size()) };
+                }
+                else if (index != 0)
+                {
+                    segment = core::network::PacketSegment{ chunk_trailer, static_cast<int>(chunk_trailer_length) };
+                }
+
+                return segment;
+            }
+
             const auto& get_buffer()
             {
                 return content;
@@ -142,6 +192,11 @@ namespace smooth::application::network::http
             void clear()
             {
                 content.clear();
+                body.clear();
+                set_shared_body({}, nullptr, 0);
+                head_length = 0;
+                chunk_trailer = nullptr;
+                chunk_trailer_length = 0;
             }
 
             auto find_header_ending() const
@@ -161,8 +216,35 @@ namespace smooth::application::network::http
                 return ws_opcode;
             }
 
+            /// Marks websocket data as part of a message compressed using permessage-deflate.
+            void set_ws_compressed()
+            {
+                ws_compressed = true;
+            }
+
+            bool is_ws_compressed() const
+            {
+                return ws_compressed;
+            }
+
+            /// Marks websocket data as the end of a message, i.e. the last part of the final fragment.
+            void set_ws_message_end()
+            {
+                ws_message_end = true;
+            }
+
+            bool is_ws_message_end() const
+            {
+                return ws_message_end;
+            }
+
             static constexpr std::array<uint8_t, 4> ending{ '\r', '\n', '\r', '\n' };
         private:
+            std::size_t body_size() const
+            {
+                return shared_body_owner ? shared_body_length : body.size();
+            }
+
             void append(const std::string& s);
 
             void add_header(const std::string& key, const std::string& value);
@@ -172,9 +254,20 @@ namespace smooth::application::network::http
             std::string request_url{};
             std::string request_version{};
             std::vector<uint8_t> content{};
+            std::vector<uint8_t> body{};
+            std::shared_ptr<const void> shared_body_owner{};
+            const uint8_t* shared_body = nullptr;
+            std::size_t shared_body_length = 0;
+
+            // Size of the start line and headers at the beginning of content, if any.
+            std::size_t head_length = 0;
+            const uint8_t* chunk_trailer = nullptr;
+            std::size_t chunk_trailer_length = 0;
             regular::ResponseCode resp_code{};
             bool continuation = false;
             bool continued = false;
             websocket::OpCode ws_opcode{ websocket::OpCode::Continuation };
+            bool ws_compressed = false;
+            bool ws_message_end = false;
     };
 }
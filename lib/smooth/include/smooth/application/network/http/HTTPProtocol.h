@@ -65,12 +65,17 @@ namespace smooth::application::network::http
 
             bool is_error() override;
 
+            void take_excess_data(std::vector<uint8_t>& target) override;
+
             void packet_consumed() override;
 
             void reset() override;
 
             void upgrade_to_websocket() override;
 
+            /// Accepts compressed websocket messages, once permessage-deflate has been negotiated.
+            void enable_websocket_compression();
+
         private:
             const int max_header_size;
             const int content_chunk_size;
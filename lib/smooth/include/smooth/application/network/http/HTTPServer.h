@@ -39,10 +39,15 @@ limitations under the License.
 #include "smooth/application/network/http/HTTPServerClient.h"
 #include "smooth/application/network/http/regular/responses/ErrorResponse.h"
 #include "smooth/application/network/http/regular/responses/FileContentResponse.h"
+#include "smooth/application/network/http/regular/responses/AssetResponse.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
 #include "smooth/application/hash/sha.h"
 #include "regular/RequestHandlerSignature.h"
 #include "regular/HTTPRequestHandler.h"
+#include "regular/Router.h"
+#include "regular/AssetCache.h"
+#include "regular/WebRootLookupCache.h"
 #include "regular/WebSocketUpgradeDetector.h"
 #include "HTTPServerConfig.h"
 
@@ -64,8 +69,12 @@ namespace smooth::application::network::http
                                             backlog,
                                             config.max_header_size(),
                                             config.chunk_size(),
-                                            config.max_responses());
+                                            config.max_responses(),
+                                            config.max_response_bytes(),
+                                            response_budget);
                 server->set_client_context(this);
+                server->set_pool_exhaustion_policy(config.pool_exhaustion_policy(), service_unavailable_response());
+                server->set_reuse_port(config.reuse_port());
                 server->start(std::move(bind_to));
             }
 
@@ -86,28 +95,64 @@ namespace smooth::application::network::http
                                             password,
                                             config.max_header_size(),
                                             config.chunk_size(),
-                                            config.max_responses());
+                                            config.max_responses(),
+                                            config.max_response_bytes(),
+                                            response_budget);
 
                 server->set_client_context(this);
+                server->set_pool_exhaustion_policy(config.pool_exhaustion_policy());
+                server->set_reuse_port(config.reuse_port());
                 server->start(std::move(bind_to));
             }
 
+            /// Gets what has happened to incoming connections so far.
+            [[nodiscard]] smooth::core::network::AcceptStatistics get_accept_statistics() const
+            {
+                return server ? server->get_accept_statistics() : smooth::core::network::AcceptStatistics{};
+            }
+
             /// Configure a request handler to handle a specific HTTP verb and path.
             /// Responders may be used for multiple URLS and/or methods, but must not be shared
             /// between different instances of an HTTP server since there is no guarantee in
             /// what order the data arrives to the handler. (If a handler is state-less, then this
             /// limitation does not apply.)
+            /// The path may contain parameters, e.g. "/api/devices/{id}", which the handler retrieves via
+            /// path_parameters().
             void on(HTTPMethod method, const std::string& url,
                     const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler);
 
+            /// Configure a request handler to handle a specific HTTP verb for a path and everything beneath it,
+            /// unless there is a more specific handler. See on() for further details.
+            void mount(HTTPMethod method, const std::string& prefix,
+                       const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler);
+
+            /// Forgets where requested files were found in the web root, or that they were not found.
+            /// Call after changing the files in the web root to make the changes visible immediately.
+            void clear_lookup_cache()
+            {
+                lookup_cache.clear();
+            }
+
+            /// Loads a file from the web root into the asset cache, instead of waiting for it to be requested.
+            /// Has no effect unless the asset cache is enabled in the HTTPServerConfig.
+            /// \param url The URL of the file, e.g. "/js/app.js"
+            /// \return true if the file is cached.
+            bool preload(const std::string& url)
+            {
+                auto file = find_file(url);
+
+                return !file.path.empty() && asset_cache.get(file.path, file.last_modified) != nullptr;
+            }
+
+            /// Accepts websocket connections on the URL, handled by instances of WServerType.
+            /// \param compression If set, messages are compressed using permessage-deflate with clients offering it.
+            /// \param group If set, every connection joins the group, receiving the messages broadcast to it.
             template<typename WServerType>
-            void enable_websocket_on(const std::string& url);
+            void enable_websocket_on(const std::string& url,
+                                     std::optional<websocket::PerMessageDeflateConfig> compression = std::nullopt,
+                                     std::shared_ptr<websocket::WebsocketGroup> group = nullptr);
 
         private:
-            using HandlerByURL = std::unordered_map<std::string,
-                                                    std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>>;
-            using HandlerByMethod = std::unordered_map<HTTPMethod, HandlerByURL>;
-
             void handle(HTTPMethod method,
                         IServerResponse& response,
                         IConnectionTimeoutModifier& timeout_modifier,
@@ -120,21 +165,38 @@ namespace smooth::application::network::http
 
             smooth::core::filesystem::Path find_index(const smooth::core::filesystem::Path& search_path) const;
 
+            regular::WebRootLookupCache::Lookup find_file(const std::string& requested_url);
+
             void
             reply_with(IServerResponse& response, std::unique_ptr<IResponseOperation> res);
 
             void serve_file(const HTTPMethod& method, IServerResponse& response, const std::string& requested_url,
                             const std::unordered_map<std::string, std::string>& request_headers);
 
+            /// The response sent to connections rejected while all clients are in use.
+            static std::vector<uint8_t> service_unavailable_response()
+            {
+                const std::string response = "HTTP/1.1 503 Service Unavailable\r\n"
+                                             "Retry-After: 1\r\n"
+                                             "Content-Length: 0\r\n"
+                                             "Connection: close\r\n\r\n";
+
+                return std::vector<uint8_t>(response.begin(), response.end());
+            }
+
             smooth::core::Task& task;
             std::shared_ptr<smooth::core::network::ServerSocket<
                                 smooth::application::network::http::HTTPServerClient,
                                 smooth::application::network::http::HTTPProtocol, IRequestHandler>> server{};
 
-            HandlerByMethod handlers{};
+            regular::Router router{};
+            regular::Router::Parameters path_parameters{};
             HTTPServerConfig config;
             const char* tag = "HTTPServer";
             TemplateProcessor template_processor;
+            regular::WebRootLookupCache lookup_cache;
+            regular::AssetCache asset_cache;
+            std::shared_ptr<ResponseBudget> response_budget;
     };
 
     template<typename ServerSocketType>
@@ -142,7 +204,10 @@ namespace smooth::application::network::http
             :
               task(task),
               config(configuration),
-              template_processor(configuration.templates(), config.data_retriever())
+              template_processor(configuration.templates(), config.data_retriever()),
+              lookup_cache(config.lookup_cache_entries(), config.lookup_cache_duration()),
+              asset_cache(config.asset_cache_budget()),
+              response_budget(std::make_shared<ResponseBudget>(config.max_total_response_bytes()))
     {
     }
 
@@ -151,7 +216,15 @@ namespace smooth::application::network::http
                                     const std::string& url,
                                     const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler)
     {
-        handlers[method][url] = handler;
+        router.add(method, url, handler);
+    }
+
+    template<typename ServerType>
+    void HTTPServer<ServerType>::mount(HTTPMethod method,
+                                       const std::string& prefix,
+                                       const std::shared_ptr<smooth::application::network::http::regular::HTTPRequestHandler>& handler)
+    {
+        router.mount(method, prefix, handler);
     }
 
     template<typename ServerType>
@@ -168,49 +241,41 @@ namespace smooth::application::network::http
     {
         using namespace smooth::core::logging;
 
-        // Is there a URL for the given method?
-        auto by_url = handlers.find(method);
+        // Is there a handler for this URL?
+        auto handler = router.find(method, requested_url, path_parameters);
 
-        if (by_url != handlers.end())
+        if (!handler)
         {
-            // Is there a specific handler for this URL?
-            auto response_handler = (*by_url).second.find(requested_url);
-
-            if (response_handler == (*by_url).second.end())
+            // No handler for this URL, does it match a file path beneath the web root?
+            serve_file(method, response, requested_url, request_headers);
+        }
+        else
+        {
+            // Call order is important - must update call params before calling the rest of the methods in the
+            // inheriting class.
+            if (first_part || last_part)
             {
-                // No handler for this URL, does it match a file path beneath the web root?
-                serve_file(method, response, requested_url, request_headers);
+                handler->update_call_params(first_part,
+                                            last_part,
+                                            response,
+                                            request_headers,
+                                            request_parameters,
+                                            path_parameters);
             }
-            else
-            {
-                auto handler = (*response_handler).second;
 
-                // Call order is important - must update call params before calling the rest of the methods in the
-                // inheriting class.
-                if (first_part || last_part)
-                {
-                    handler->update_call_params(first_part, last_part, response, request_headers, request_parameters);
-                }
-
-                if (first_part)
-                {
-                    handler->prepare_mime();
-                    handler->start_of_request();
-                }
+            if (first_part)
+            {
+                handler->prepare_mime();
+                handler->start_of_request();
+            }
 
-                handler->request(timeout_modifier, requested_url, data);
+            handler->request(timeout_modifier, requested_url, data);
 
-                if (last_part)
-                {
-                    handler->end_of_request();
-                }
+            if (last_part)
+            {
+                handler->end_of_request();
             }
         }
-        else
-        {
-            // No specific handler for this URL.
-            serve_file(method, response, requested_url, request_headers);
-        }
     }
 
     template<typename ServerType>
@@ -223,71 +288,91 @@ namespace smooth::application::network::http
 
         Log::info(tag, "Request: {}: '{}'", utils::http_method_to_string(method), requested_url);
 
-        filesystem::Path search{ config.web_root() };
-        search /= requested_url;
+        auto file = find_file(requested_url);
 
-        if (config.web_root().is_parent_of(search) || config.web_root() == search)
+        if (!file.path.empty())
         {
-            filesystem::FileInfo info(search);
+            // Attempt to process the file as a template.
+            auto processed_template = template_processor.process_template(file.path, file.last_modified);
 
-            if (info.is_regular_file())
+            if (processed_template)
+            {
+                reply_with(response, std::move(processed_template));
+            }
+            else
             {
-                // Attempt to process the file as a template.
-                auto processed_template = template_processor.process_template(info.path());
+                // Not a template, serve the requested file from memory if it is cached.
+                auto asset = asset_cache.get(file.path, file.last_modified);
+                auto gzip = false;
+                std::string etag{};
 
-                if (processed_template)
+                if (asset)
                 {
-                    reply_with(response, std::move(processed_template));
+                    auto accept_encoding = request_headers.find(ACCEPT_ENCODING);
+                    gzip = asset->gzip.exists()
+                           && accept_encoding != request_headers.end()
+                           && utils::accepts_encoding(accept_encoding->second, "gzip");
+                    etag = gzip ? asset->gzip.etag : asset->identity.etag;
                 }
-                else
-                {
-                    // Not a template, simply serve the requested file
-                    bool send_not_modified = false;
-                    auto if_modified_since = request_headers.find("if-modified-since");
 
-                    if (if_modified_since != request_headers.end())
-                    {
-                        auto since = utils::parse_http_time((*if_modified_since).second);
+                bool send_not_modified = false;
+                auto if_none_match = request_headers.find(IF_NONE_MATCH);
+                auto if_modified_since = request_headers.find("if-modified-since");
 
-                        if (since >= info.last_modified_point())
-                        {
-                            send_not_modified = true;
-                        }
-                    }
+                // If-None-Match takes precedence over If-Modified-Since:
+                // https://tools.ietf.org/html/rfc7232#section-6
+                if (if_none_match != request_headers.end() && !etag.empty())
+                {
+                    send_not_modified = utils::matches_etag(if_none_match->second, etag);
+                }
+                else if (!file.index && if_modified_since != request_headers.end())
+                {
+                    auto since = utils::parse_http_time((*if_modified_since).second);
 
-                    if (send_not_modified)
+                    if (since >= std::chrono::system_clock::from_time_t(file.last_modified))
                     {
-                        reply_with(response,
-                                   std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Modified));
-                    }
-                    else
-                    {
-                        reply_with(response, std::make_unique<responses::FileContentResponse>(search));
+                        send_not_modified = true;
                     }
                 }
 
-                found = true;
-            }
-            else if (info.is_directory())
-            {
-                auto index_path = find_index(search);
-
-                if (!index_path.empty())
+                if (send_not_modified && !etag.empty())
                 {
-                    auto processed_template = template_processor.process_template(index_path);
-
-                    if (processed_template)
+                    auto not_modified = std::make_unique<responses::HeaderOnlyResponse>(ResponseCode::Not_Modified);
+                    not_modified->set_header(ETAG, etag);
+                    reply_with(response, std::move(not_modified));
+                }
+                else if (send_not_modified)
+                {
+                    reply_with(response,
+                               std::make_unique<responses::ErrorResponse>(ResponseCode::Not_Modified));
+                }
+                else
+                {
+                    // Partial requests are served from the file, which allows seeking straight to the
+                    // requested ranges. If-Range makes sure a client resuming a download gets the rest of
+                    // the same file: https://tools.ietf.org/html/rfc7233#section-3.2
+                    auto range = request_headers.find(RANGE);
+                    auto if_range = request_headers.find(IF_RANGE);
+                    auto partial = range != request_headers.end()
+                                   && (if_range == request_headers.end()
+                                       || utils::matches_if_range(if_range->second,
+                                                                  asset ? asset->identity.etag : "",
+                                                                  file.last_modified));
+
+                    if (asset && !partial)
                     {
-                        reply_with(response, std::move(processed_template));
+                        reply_with(response, std::make_unique<responses::AssetResponse>(asset, gzip));
                     }
                     else
                     {
-                        reply_with(response, std::make_unique<responses::FileContentResponse>(index_path));
+                        reply_with(response,
+                                   std::make_unique<responses::FileContentResponse>(file.path,
+                                                                                    partial ? range->second : ""));
                     }
-
-                    found = true;
                 }
             }
+
+            found = true;
         }
 
         if (!found)
@@ -296,6 +381,47 @@ namespace smooth::application::network::http
         }
     }
 
+    template<typename ServerType>
+    regular::WebRootLookupCache::Lookup HTTPServer<ServerType>::find_file(const std::string& requested_url)
+    {
+        const auto* cached = lookup_cache.find(requested_url);
+
+        if (cached)
+        {
+            return *cached;
+        }
+
+        regular::WebRootLookupCache::Lookup res{};
+
+        filesystem::Path search{ config.web_root() };
+        search /= requested_url;
+
+        if (config.web_root().is_parent_of(search) || config.web_root() == search)
+        {
+            filesystem::FileInfo info(search);
+
+            if (info.is_regular_file())
+            {
+                res.path = search;
+                res.last_modified = info.last_modified();
+            }
+            else if (info.is_directory())
+            {
+                res.path = find_index(search);
+                res.index = true;
+
+                if (!res.path.empty())
+                {
+                    res.last_modified = filesystem::FileInfo{ res.path }.last_modified();
+                }
+            }
+        }
+
+        lookup_cache.insert(requested_url, res);
+
+        return res;
+    }
+
     template<typename ServerType>
     smooth::core::filesystem::Path HTTPServer<ServerType>::find_index(
         const smooth::core::filesystem::Path& search_path) const
@@ -330,9 +456,12 @@ namespace smooth::application::network::http
 
     template<typename ServerType>
     template<typename WSServerType>
-    void HTTPServer<ServerType>::enable_websocket_on(const std::string& url)
+    void HTTPServer<ServerType>::enable_websocket_on(const std::string& url,
+                                                     std::optional<websocket::PerMessageDeflateConfig> compression,
+                                                     std::shared_ptr<websocket::WebsocketGroup> group)
     {
-        auto detector = std::make_shared<regular::WebSocketUpgradeDetector<WSServerType>>();
+        auto detector = std::make_shared<regular::WebSocketUpgradeDetector<WSServerType>>(std::move(compression),
+                                                                                          std::move(group));
 
         on(HTTPMethod::GET, url, detector);
     }
@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <deque>
@@ -29,6 +30,7 @@ limitations under the License.
 #include "URLEncoding.h"
 #include "IServerResponse.h"
 #include "IResponseOperation.h"
+#include "ResponseBudget.h"
 
 namespace smooth::application::network::http
 {
@@ -42,14 +44,17 @@ namespace smooth::application::network::http
     class HTTPServerClient
         : public smooth::core::network::ServerClient<HTTPServerClient, HTTPProtocol, IRequestHandler>,
         public IServerResponse,
-        public IConnectionTimeoutModifier
+        public IConnectionTimeoutModifier,
+        private IResponseBudgetListener
     {
         public:
             HTTPServerClient(smooth::core::Task& task,
                              smooth::core::network::ClientPool<HTTPServerClient>& pool,
                              std::size_t max_header_size,
                              std::size_t content_chunk_size,
-                             std::size_t max_enqueued_responses)
+                             std::size_t max_enqueued_responses,
+                             std::size_t max_enqueued_bytes = 0,
+                             std::shared_ptr<ResponseBudget> budget = nullptr)
                     : core::network::ServerClient<HTTPServerClient,
                                                   smooth::application::network::http::HTTPProtocol, IRequestHandler>(
                           task,
@@ -60,7 +65,9 @@ namespace smooth::application::network::http
                                                                                        *this)),
                       content_chunk_size(content_chunk_size),
                       task(task),
-                      max_enqueued_responses(max_enqueued_responses)
+                      max_enqueued_responses(max_enqueued_responses),
+                      max_enqueued_bytes(max_enqueued_bytes),
+                      budget(std::move(budget))
             {
             }
 
@@ -88,11 +95,19 @@ namespace smooth::application::network::http
 
             void reply_error(std::unique_ptr<IResponseOperation> response) override;
 
+            void disconnect() override;
+
             void set_receive_timeout(const std::chrono::milliseconds& timeout) override
             {
                 socket->set_receive_timeout(timeout);
             }
 
+            /// A connection kept alive between requests is idle once every request has been responded to.
+            [[nodiscard]] bool is_idle() const override
+            {
+                return idle;
+            }
+
         protected:
             smooth::core::Task& get_task() override
             {
@@ -107,6 +122,12 @@ namespace smooth::application::network::http
                 mode = Mode::Websocket;
             }
 
+            void use_websocket_compression(std::unique_ptr<websocket::PerMessageDeflate> deflate) override
+            {
+                message_deflate = std::move(deflate);
+                container->get_protocol().enable_websocket_compression();
+            }
+
         private:
             enum class Mode
             {
@@ -120,7 +141,43 @@ namespace smooth::application::network::http
 
             void separate_request_parameters(std::string& url);
 
-            void send_first_part();
+            /// Queues packets from the current and following responses in the transmit buffer.
+            void fill_tx_buffer();
+
+            void handle_request(HTTPPacket& packet);
+
+            /// Gets the next part of the current operation, either copied into 'data' or as shared content.
+            ResponseStatus get_next_part(std::vector<uint8_t>& data, SharedContent& shared);
+
+            /// Selects the chunked transfer coding for responses with a body of unknown length, i.e.
+            /// those not setting a Content-Length, unless the client does not support it.
+            /// \return false if the end of the response can then only be told by the connection closing.
+            bool select_transfer_coding(IResponseOperation& operation) const;
+
+            static bool is_chunked(const IResponseOperation& operation);
+
+            /// Determines if the connection is to be closed once the response has been sent.
+            static bool closes_connection(const IResponseOperation& operation);
+
+            /// Accounts for the memory held by an operation queued for sending.
+            void operation_enqueued(const IResponseOperation& operation);
+
+            /// Accounts for an operation no longer waiting to be sent.
+            void operation_dequeued(const IResponseOperation& operation);
+
+            void clear_operations();
+
+            /// Lets an operation that is waiting for data continue the response once it has more.
+            void set_wake_up(IResponseOperation& operation);
+
+            /// Pauses reading from the socket while the queued responses exceed the limits, resuming once
+            /// they are back within them. This stops the client from sending more requests than can be handled.
+            void update_flow_control();
+
+            /// Hands over data of a compressed message to the websocket server, decompressed.
+            void receive_compressed(HTTPPacket& packet);
+
+            void response_budget_available() override;
 
             bool translate_method(const HTTPPacket& packet, HTTPMethod& method) const;
 
@@ -132,7 +189,28 @@ namespace smooth::application::network::http
             URLEncoding encoding{};
             std::deque<std::unique_ptr<IResponseOperation>> operations{};
             std::unique_ptr<IResponseOperation> current_operation{};
+            // Number of queued operations, from the front, that are responses to HTTP requests.
+            std::size_t http_responses_queued{ 0 };
+            bool http_response{ false };
+            bool chunked_response{ false };
+            bool chunked_allowed{ true };
+            bool close_after_response{ false };
+            // Set once a response after which the connection is closed has been queued for sending.
+            bool closing{ false };
+            bool handling_requests{ false };
             const std::size_t max_enqueued_responses;
+            const std::size_t max_enqueued_bytes;
+            std::shared_ptr<ResponseBudget> budget;
+            // Bytes held by the queued operations, i.e. not including the one currently being sent.
+            std::size_t enqueued_bytes{ 0 };
+            bool receive_paused{ false };
+            std::unique_ptr<websocket::PerMessageDeflate> message_deflate{};
+            // Set if the compressed message being received is text.
+            bool compressed_text{ false };
+            // Requests received, in part or in full, that have not yet been responded to.
+            std::size_t unanswered_requests{ 0 };
+            // Read by the socket dispatcher.
+            std::atomic<bool> idle{ false };
 
             void set_keep_alive();
     };
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include "smooth/core/network/PoolExhaustionPolicy.h"
 
 namespace smooth::application::network::http
 {
@@ -31,22 +33,51 @@ namespace smooth::application::network::http
             /// prevent large HTTP POST/GET requests from consuming memory.
             /// \arg max_enqueued_responses Each response takes up a little bit of memory (more so if responding with
             /// data). To prevent an out-of-memory situation when there is a steady stream of incoming data, and the
-            /// device can't send out the responses fast enough, this threshold protects the device by closing the
-            /// connection if it is reached.
+            /// device can't send out the responses fast enough, the server stops reading from a connection with this
+            /// many responses waiting to be sent until they have been sent.
+            /// \arg lookup_cache_size The number of requested URLs for which the result of looking them up beneath
+            /// the web root is remembered, found or not. 0 disables the cache.
+            /// \arg lookup_cache_time How long a lookup is remembered, i.e. the longest time it may take for
+            /// files added to or removed from the web root to be noticed.
+            /// \arg asset_cache_size The number of bytes of static files from the web root to keep in memory, see
+            /// AssetCache. 0 disables the cache.
+            /// \arg max_enqueued_bytes Like max_enqueued_responses, but limits the number of bytes held by the
+            /// responses waiting to be sent on a connection. 0 means no limit.
+            /// \arg max_total_enqueued_bytes The number of bytes responses waiting to be sent may hold across all
+            /// connections. While exceeded, the server stops reading from all connections. 0 means no limit.
+            /// \arg exhaustion_policy What to do with new connections while all clients are in use. When rejected,
+            /// connections are sent a 503 Service Unavailable response, unless using TLS.
+            /// \arg reuse_port Lets several servers, each running on its own task, listen on the same port, with
+            /// incoming connections spread among them. Only supported on Linux.
             HTTPServerConfig(smooth::core::filesystem::Path web_root,
                              std::vector<std::string> index_files,
                              std::set<std::string> template_files,
                              std::shared_ptr<ITemplateDataRetriever> template_data_retriever,
                              std::size_t max_header_size,
                              std::size_t content_chunk_size,
-                             std::size_t max_enqueued_responses)
+                             std::size_t max_enqueued_responses,
+                             std::size_t lookup_cache_size = 32,
+                             std::chrono::milliseconds lookup_cache_time = std::chrono::seconds{ 5 },
+                             std::size_t asset_cache_size = 0,
+                             std::size_t max_enqueued_bytes = 0,
+                             std::size_t max_total_enqueued_bytes = 0,
+                             smooth::core::network::PoolExhaustionPolicy exhaustion_policy =
+                                 smooth::core::network::PoolExhaustionPolicy::Queue,
+                             bool reuse_port = false)
                     : root_path(std::move(web_root)),
                       index(std::move(index_files)),
                       template_files(std::move(template_files)),
                       template_data_retriever(std::move(template_data_retriever)),
                       maximum_header_size(max_header_size),
                       content_chunk_size(content_chunk_size),
-                      max_enqueued_responses(max_enqueued_responses)
+                      max_enqueued_responses(max_enqueued_responses),
+                      lookup_cache_size(lookup_cache_size),
+                      lookup_cache_time(lookup_cache_time),
+                      asset_cache_size(asset_cache_size),
+                      max_enqueued_bytes(max_enqueued_bytes),
+                      max_total_enqueued_bytes(max_total_enqueued_bytes),
+                      exhaustion_policy(exhaustion_policy),
+                      reuse_listening_port(reuse_port)
             {
             }
 
@@ -85,6 +116,41 @@ namespace smooth::application::network::http
                 return max_enqueued_responses;
             }
 
+            [[nodiscard]] std::size_t max_response_bytes() const
+            {
+                return max_enqueued_bytes;
+            }
+
+            [[nodiscard]] std::size_t max_total_response_bytes() const
+            {
+                return max_total_enqueued_bytes;
+            }
+
+            [[nodiscard]] smooth::core::network::PoolExhaustionPolicy pool_exhaustion_policy() const
+            {
+                return exhaustion_policy;
+            }
+
+            [[nodiscard]] bool reuse_port() const
+            {
+                return reuse_listening_port;
+            }
+
+            [[nodiscard]] std::size_t lookup_cache_entries() const
+            {
+                return lookup_cache_size;
+            }
+
+            [[nodiscard]] std::chrono::milliseconds lookup_cache_duration() const
+            {
+                return lookup_cache_time;
+            }
+
+            [[nodiscard]] std::size_t asset_cache_budget() const
+            {
+                return asset_cache_size;
+            }
+
         private:
             smooth::core::filesystem::Path root_path{};
             std::vector<std::string> index{};
@@ -93,5 +159,12 @@ namespace smooth::application::network::http
             std::size_t maximum_header_size{};
             std::size_t content_chunk_size{};
             std::size_t max_enqueued_responses{};
+            std::size_t lookup_cache_size{};
+            std::chrono::milliseconds lookup_cache_time{};
+            std::size_t asset_cache_size{};
+            std::size_t max_enqueued_bytes{};
+            std::size_t max_total_enqueued_bytes{};
+            smooth::core::network::PoolExhaustionPolicy exhaustion_policy{};
+            bool reuse_listening_port{ false };
     };
 }
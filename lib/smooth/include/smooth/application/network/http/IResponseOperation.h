@@ -17,10 +17,17 @@ limitations under the License.
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <unordered_map>
 #include "smooth/core/network/BufferContainer.h"
 #include "smooth/application/network/http/regular/ResponseCodes.h"
 
+namespace smooth::application::network::http::websocket
+{
+    class PerMessageDeflate;
+}
+
 namespace smooth::application::network::http
 {
     enum class ResponseStatus
@@ -28,7 +35,19 @@ namespace smooth::application::network::http
         Error,
         HasMoreData,
         LastData,
-        NoData
+        NoData,
+        /// No data is available right now, but more will follow. The operation calls the function given to
+        /// set_wake_up() once it has more data.
+        Pending
+    };
+
+    /// A view of data that is sent without being copied. The owner keeps the data alive
+    /// until the packet it is sent in has been destroyed.
+    struct SharedContent
+    {
+        std::shared_ptr<const void> owner{};
+        const uint8_t* data = nullptr;
+        std::size_t length = 0;
     };
 
     // A request operation is responsible for providing outgoing data chunked into smaller pieces
@@ -51,6 +70,36 @@ namespace smooth::application::network::http
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             virtual ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) = 0;
 
+            /// Determines if get_shared_data() is to be used instead of get_data().
+            virtual bool has_shared_data() const
+            {
+                return false;
+            }
+
+            /// Used instead of get_data() by operations whose content already is in memory, such as a memory
+            /// mapped file. As nothing is copied, the amount provided may exceed max_amount.
+            virtual ResponseStatus get_shared_data(std::size_t /*max_amount*/, SharedContent& /*target*/)
+            {
+                return ResponseStatus::Error;
+            }
+
+            /// Sets the function an operation returning ResponseStatus::Pending calls, from any task, once more
+            /// data is available. Set by the server before the operation is asked for data.
+            virtual void set_wake_up(std::function<void()> /*wake_up*/)
+            {}
+
+            /// Gives a websocket message the compression negotiated for the connection, just before it is
+            /// asked for data. Called in the order messages are sent, as compression may refer to earlier messages.
+            virtual void set_message_compression(websocket::PerMessageDeflate& /*deflate*/)
+            {}
+
+            /// Gets the number of bytes of content the operation holds in memory while waiting to be sent,
+            /// which is what counts towards the response budgets of the server.
+            [[nodiscard]] virtual std::size_t get_buffered_size() const
+            {
+                return 0;
+            }
+
             /// Sets a header, replacing any existing value
             virtual void set_header(const std::string& /*key*/, const std::string& /*value*/)
             {}
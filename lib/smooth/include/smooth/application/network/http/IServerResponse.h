@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <memory>
 #include "smooth/application/network/http/websocket/WebsocketServer.h"
+#include "smooth/application/network/http/websocket/PerMessageDeflate.h"
 #include "smooth/application/network/http/IResponseOperation.h"
 
 namespace smooth::application::network::http
@@ -32,11 +33,29 @@ namespace smooth::application::network::http
 
             virtual void reply_error(std::unique_ptr<IResponseOperation> response) = 0;
 
+            /// Closes the connection, discarding the responses waiting to be sent.
+            virtual void disconnect() = 0;
+
+            /// Switches the connection to websocket mode.
+            /// \param deflate The compression negotiated for the connection, if any.
+            /// \param group A group for the connection to join, if any.
             template<typename WSServerType>
-            void upgrade_to_websocket()
+            void upgrade_to_websocket(std::unique_ptr<websocket::PerMessageDeflate> deflate = nullptr,
+                                      const std::shared_ptr<websocket::WebsocketGroup>& group = nullptr)
             {
                 upgrade_to_websocket_internal();
+
+                if (deflate)
+                {
+                    use_websocket_compression(std::move(deflate));
+                }
+
                 ws_server = std::make_unique<WSServerType>(*this, get_task());
+
+                if (group)
+                {
+                    ws_server->join(group);
+                }
             }
 
         protected:
@@ -44,6 +63,9 @@ namespace smooth::application::network::http
 
             virtual void upgrade_to_websocket_internal() = 0;
 
+            virtual void use_websocket_compression(std::unique_ptr<websocket::PerMessageDeflate> /*deflate*/)
+            {}
+
             std::unique_ptr<websocket::WebsocketServer> ws_server{};
     };
 }
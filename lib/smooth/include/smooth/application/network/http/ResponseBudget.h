@@ -0,0 +1,85 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace smooth::application::network::http
+{
+    /// Implemented by those waiting for a ResponseBudget to become available.
+    class IResponseBudgetListener
+    {
+        public:
+            virtual ~IResponseBudgetListener() = default;
+
+            virtual void response_budget_available() = 0;
+    };
+
+    /// Keeps track of the number of bytes held by queued responses across all connections of a server,
+    /// so that the server as a whole stays within a memory budget. Connections stop reading new requests
+    /// while the budget is exhausted and are notified once it is available again.
+    ///
+    /// Not thread safe; it is only to be used from the task the server runs on.
+    class ResponseBudget
+    {
+        public:
+            /// \param limit The maximum number of bytes held by queued responses; 0 means no limit.
+            explicit ResponseBudget(std::size_t limit)
+                    : limit(limit)
+            {
+            }
+
+            /// Accounts for bytes held by a queued response.
+            void reserve(std::size_t amount)
+            {
+                used += amount;
+            }
+
+            /// Returns bytes previously reserved, notifying those waiting once the budget is no longer exhausted.
+            void release(std::size_t amount);
+
+            /// Registers a listener to be notified once the budget is available again. A listener is notified
+            /// once per registration.
+            void wait(IResponseBudgetListener& listener);
+
+            /// Removes a listener, e.g. when its connection is closed.
+            void stop_waiting(IResponseBudgetListener& listener);
+
+            [[nodiscard]] bool is_exhausted() const
+            {
+                return limit > 0 && used >= limit;
+            }
+
+            [[nodiscard]] std::size_t get_used() const
+            {
+                return used;
+            }
+
+            [[nodiscard]] std::size_t get_limit() const
+            {
+                return limit;
+            }
+
+        private:
+            const std::size_t limit;
+            std::size_t used{ 0 };
+            std::vector<IResponseBudgetListener*> waiting{};
+    };
+}
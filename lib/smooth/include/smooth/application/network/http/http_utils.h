@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <string>
 #include <chrono>
+#include <vector>
 #include "smooth/core/filesystem/Path.h"
 #include "regular/HTTPMethod.h"
 
@@ -35,4 +36,42 @@ namespace smooth::application::network::http::utils
     time_t timegm(tm& tm);
 
     std::string http_method_to_string(regular::HTTPMethod m);
+
+    /// Determines if a content coding, e.g. "gzip", is acceptable according to the value of an
+    /// Accept-Encoding header.
+    bool accepts_encoding(const std::string& accept_encoding, const std::string& coding);
+
+    /// Determines if an entity tag matches any of the tags in the value of an If-None-Match header,
+    /// using the weak comparison: https://tools.ietf.org/html/rfc7232#section-2.3.2
+    bool matches_etag(const std::string& if_none_match, const std::string& etag);
+
+    /// A range of bytes within a representation
+    struct ByteRange
+    {
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    enum class RangeStatus
+    {
+        /// The Range header is invalid or unsupported and is to be ignored, i.e. the full representation is sent.
+        Ignore,
+        /// At least one of the ranges is within the representation.
+        Satisfiable,
+        /// None of the ranges are within the representation.
+        Unsatisfiable
+    };
+
+    /// Parses the value of a Range header for a representation of the given size, clamping each
+    /// range to it and leaving out those beyond its end: https://tools.ietf.org/html/rfc7233#section-2.1
+    /// Headers asking for more than max_ranges ranges are ignored.
+    RangeStatus parse_byte_ranges(const std::string& range,
+                                  std::size_t size,
+                                  std::vector<ByteRange>& ranges,
+                                  std::size_t max_ranges = 8);
+
+    /// Determines if the value of an If-Range header matches the current representation, i.e. if
+    /// the Range header is to be honoured: https://tools.ietf.org/html/rfc7233#section-3.2
+    /// Entity tags use the strong comparison, dates must match the last modification time exactly.
+    bool matches_if_range(const std::string& if_range, const std::string& etag, time_t last_modified);
 }
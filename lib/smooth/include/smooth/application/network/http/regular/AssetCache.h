@@ -0,0 +1,113 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <ctime>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "smooth/core/filesystem/MemoryMappedFile.h"
+#include "smooth/core/filesystem/Path.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// Keeps static files from the web root in memory so that they can be served without accessing the
+    /// file system. Files are memory mapped where supported, otherwise read into memory. A precompressed
+    /// sibling, i.e. "file.js.gz" for "file.js", is loaded alongside the file if it exists, and the file is
+    /// reloaded when the sibling changes.
+    ///
+    /// The total size of the cached files is kept within a budget by evicting the least recently used
+    /// files; files larger than a quarter of the budget are not cached at all, nor loaded to find that out.
+    class AssetCache
+    {
+        public:
+            struct Variant
+            {
+                std::shared_ptr<const void> owner{};
+                const uint8_t* data = nullptr;
+                std::size_t size = 0;
+                /// Strong entity tag, including quotes.
+                std::string etag{};
+                /// The mapping holding the data, unless it was read into memory.
+                std::shared_ptr<const smooth::core::filesystem::MemoryMappedFile> mapping{};
+
+                [[nodiscard]] bool exists() const
+                {
+                    return owner != nullptr;
+                }
+
+                /// Determines if the data can still be used, i.e. the file has not been truncated
+                /// while mapped. See MemoryMappedFile::is_intact().
+                [[nodiscard]] bool is_intact() const
+                {
+                    return !mapping || mapping->is_intact();
+                }
+            };
+
+            struct Asset
+            {
+                Variant identity{};
+                Variant gzip{};
+                std::string content_type{};
+                time_t last_modified{};
+                /// The time the precompressed sibling was last modified, 0 if there was none.
+                time_t gzip_last_modified{};
+            };
+
+            /// \param budget The maximum number of bytes to keep in memory; 0 disables the cache.
+            explicit AssetCache(std::size_t budget)
+                    : budget(budget)
+            {
+            }
+
+            /// Gets a file, loading it into the cache unless already loaded.
+            /// \param path The full path of the file
+            /// \param last_modified The time the file was last modified; a cached file with another time is reloaded.
+            /// \return The file, or nullptr if it could not be cached.
+            std::shared_ptr<const Asset> get(const smooth::core::filesystem::Path& path, time_t last_modified);
+
+            void clear();
+
+            /// Gets the number of bytes currently cached.
+            [[nodiscard]] std::size_t size() const
+            {
+                return used;
+            }
+
+        private:
+            using Entry = std::pair<std::string, std::shared_ptr<const Asset>>;
+
+            static Variant load(const smooth::core::filesystem::Path& path, const char* etag_suffix);
+
+            static std::size_t size_of(const Asset& asset)
+            {
+                return asset.identity.size + asset.gzip.size;
+            }
+
+            void erase(std::list<Entry>::iterator entry);
+
+            const std::size_t budget;
+            std::size_t used = 0;
+
+            // Most recently used first
+            std::list<Entry> entries{};
+            std::unordered_map<std::string, std::list<Entry>::iterator> by_path{};
+    };
+}
@@ -0,0 +1,99 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace smooth::application::network::http::regular
+{
+    /// Decodes content sent using the chunked transfer coding, https://tools.ietf.org/html/rfc7230#section-4.1
+    /// Data may be passed in pieces of any size; the content of the chunks is moved to the start of each piece
+    /// so that it can be decoded where it was received. Chunk extensions and trailers are skipped.
+    class ChunkedDecoder
+    {
+        public:
+            /// Decodes the data in place.
+            /// \param data The received data, is overwritten with the decoded content.
+            /// \param length Number of bytes in data
+            /// \return The number of content bytes now at the start of data.
+            std::size_t decode(uint8_t* data, std::size_t length);
+
+            /// \return The number of bytes used by the latest call to decode(). Once the end of the content has
+            /// been reached the remaining bytes, if any, belong to whatever follows it.
+            std::size_t consumed() const
+            {
+                return last_consumed;
+            }
+
+            /// \return true while receiving the content of a chunk, in which case content_remaining()
+            /// bytes of content can be received without passing the end of the chunk.
+            bool in_content() const
+            {
+                return state == State::Data;
+            }
+
+            std::size_t content_remaining() const
+            {
+                return in_content() ? chunk_remaining : 0;
+            }
+
+            /// \return true when the last chunk and the trailers have been received.
+            bool is_complete() const
+            {
+                return state == State::Done;
+            }
+
+            bool is_error() const
+            {
+                return state == State::Error;
+            }
+
+            void reset();
+
+        private:
+            enum class State
+            {
+                Size,
+                Extension,
+                SizeLF,
+                Data,
+                DataCR,
+                DataLF,
+                LineStart,
+                Trailer,
+                EndLF,
+                Done,
+                Error
+            };
+
+            void size_digit(uint8_t c);
+
+            void size_line_end();
+
+            static constexpr int max_size_digits = 8;
+            static constexpr std::size_t max_line_length = 1024;
+
+            State state{ State::Size };
+            std::size_t chunk_remaining{ 0 };
+            std::size_t line_length{ 0 };
+            int size_digits{ 0 };
+            std::size_t last_consumed{ 0 };
+    };
+}
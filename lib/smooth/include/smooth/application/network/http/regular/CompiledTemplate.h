@@ -0,0 +1,90 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace smooth::application::network::http::regular
+{
+    /// A template split once into literal text and key slots, so that rendering never
+    /// has to search the document again. Keys are in the form {{alpha_num}}, where
+    /// alpha_num may also contain '_' and '-'.
+    class CompiledTemplate
+    {
+        public:
+            static constexpr std::size_t no_key = std::numeric_limits<std::size_t>::max();
+
+            /// A range of the template text. For key slots, the range covers the
+            /// complete token, including the braces, and key is an index into keys().
+            struct Segment
+            {
+                std::size_t offset;
+                std::size_t length;
+                std::size_t key;
+
+                bool is_key() const
+                {
+                    return key != no_key;
+                }
+            };
+
+            explicit CompiledTemplate(std::string text);
+
+            const std::string& text() const
+            {
+                return data;
+            }
+
+            const std::vector<Segment>& segments() const
+            {
+                return parts;
+            }
+
+            /// The distinct keys in the template, in order of first appearance.
+            const std::vector<std::string>& keys() const
+            {
+                return key_names;
+            }
+
+            /// Total size of the literal text, i.e. excluding all keys.
+            std::size_t literal_size() const
+            {
+                return literal_length;
+            }
+
+            /// Renders the template into a string, using values[i] for keys()[i].
+            std::string render(const std::vector<std::string>& values) const;
+
+        private:
+            void compile();
+
+            void add_literal(std::size_t offset, std::size_t length);
+
+            static std::size_t token_length(const std::string& text, std::size_t offset);
+
+            std::string data;
+            std::vector<Segment> parts{};
+            std::vector<std::string> key_names{};
+            std::size_t literal_length = 0;
+    };
+}
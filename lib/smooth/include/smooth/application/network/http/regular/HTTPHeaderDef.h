@@ -32,4 +32,16 @@ namespace smooth::application::network::http::regular
     extern const char* SEC_WEBSOCKET_PROTOCOL;
     extern const char* SEC_WEBSOCKET_VERSION;
     extern const char* SEC_WEBSOCKET_ACCEPT;
+    extern const char* SEC_WEBSOCKET_EXTENSIONS;
+    extern const char* ETAG;
+    extern const char* IF_NONE_MATCH;
+    extern const char* ACCEPT_ENCODING;
+    extern const char* CONTENT_ENCODING;
+    extern const char* VARY;
+    extern const char* TRANSFER_ENCODING;
+    extern const char* RANGE;
+    extern const char* IF_RANGE;
+    extern const char* CONTENT_RANGE;
+    extern const char* ACCEPT_RANGES;
+    extern const char* CACHE_CONTROL;
 }
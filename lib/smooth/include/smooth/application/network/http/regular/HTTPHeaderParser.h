@@ -0,0 +1,122 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace smooth::application::network::http::regular
+{
+    /// Incremental parser for the start line and headers of a HTTP request or response.
+    ///
+    /// The parser neither copies nor allocates; it records where each part is located as offsets into
+    /// the caller's buffer, which may therefore be reallocated between calls as long as the data already
+    /// passed stays at the same offsets. Each call resumes where the previous one stopped, so every byte
+    /// is only scanned once no matter how many recv() calls it takes to receive the headers.
+    class HTTPHeaderParser
+    {
+        public:
+            enum class Result
+            {
+                NeedMoreData,
+                Complete,
+                Malformed,
+                TooManyHeaders
+            };
+
+            /// Location of a part of the parsed data.
+            struct Span
+            {
+                uint32_t offset = 0;
+                uint32_t length = 0;
+            };
+
+            struct Header
+            {
+                Span name{};
+                Span value{};
+            };
+
+            static constexpr std::size_t max_headers = 40;
+
+            /// Parses the data received so far.
+            /// \param data Start of the buffer.
+            /// \param length Total number of bytes in the buffer, including the bytes passed in earlier calls.
+            /// \return The parse result, which does not change once it is no longer Result::NeedMoreData.
+            Result parse(const uint8_t* data, std::size_t length);
+
+            /// Prepares the parser for the next message.
+            void reset();
+
+            /// Determines if the start line is a request line or, if false, a status line.
+            [[nodiscard]] bool is_request() const
+            {
+                return request;
+            }
+
+            /// Gets the three parts of the start line. For requests these are the method, the request target and
+            /// the version (e.g. "1.1"), for responses the version, the status code and the reason phrase.
+            [[nodiscard]] const std::array<Span, 3>& start_line() const
+            {
+                return start;
+            }
+
+            [[nodiscard]] std::size_t header_count() const
+            {
+                return count;
+            }
+
+            /// Gets a header; the name is as received, i.e. not lower-cased, and the value is trimmed.
+            [[nodiscard]] const Header& header(std::size_t index) const
+            {
+                return headers[index];
+            }
+
+            /// Gets the size of the header block including the terminating empty line, i.e. the offset
+            /// of the first byte of the content. Only valid once parsing is complete.
+            [[nodiscard]] std::size_t header_size() const
+            {
+                return end_of_headers;
+            }
+
+            static std::string_view view(const uint8_t* data, Span span)
+            {
+                return { reinterpret_cast<const char*>(data) + span.offset, span.length };
+            }
+
+        private:
+            Result parse_line(const uint8_t* data, std::size_t begin, std::size_t end);
+
+            bool parse_start_line(const uint8_t* data, std::size_t begin, std::size_t end);
+
+            Result parse_header(const uint8_t* data, std::size_t begin, std::size_t end);
+
+            std::array<Span, 3> start{};
+            std::array<Header, max_headers> headers{};
+            std::size_t count = 0;
+            std::size_t line_start = 0;
+            std::size_t scan_pos = 0;
+            std::size_t end_of_headers = 0;
+            bool start_line_parsed = false;
+            bool request = false;
+            Result result = Result::NeedMoreData;
+    };
+}
@@ -64,7 +64,8 @@ namespace smooth::application::network::http::regular
                                     bool last_part,
                                     IServerResponse& /*response*/,
                                     const std::unordered_map<std::string, std::string>& headers,
-                                    const std::unordered_map<std::string, std::string>& request_parameters);
+                                    const std::unordered_map<std::string, std::string>& request_parameters,
+                                    const std::unordered_map<std::string, std::string>& path_parameters);
 
         protected:
             MIMEParser mime{};
@@ -87,6 +88,13 @@ namespace smooth::application::network::http::regular
                 return *request_params.request_parameters;
             }
 
+            /// Returns the values of the parameters in the path the handler was registered on,
+            /// e.g. "id" for "/api/devices/{id}"
+            const std::unordered_map<std::string, std::string>& path_parameters() const
+            {
+                return *request_params.path_parameters;
+            }
+
         private:
             /// This structure holds parameters for the current request,
             /// to be accessed via above methods.
@@ -97,6 +105,7 @@ namespace smooth::application::network::http::regular
                 IServerResponse* response{};
                 const std::unordered_map<std::string, std::string>* headers{ nullptr };
                 const std::unordered_map<std::string, std::string>* request_parameters{ nullptr };
+                const std::unordered_map<std::string, std::string>* path_parameters{ nullptr };
             };
 
             RequestParams request_params{};
@@ -18,15 +18,21 @@ limitations under the License.
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <regex>
+#include <string>
 #include <vector>
-#include <tuple>
 #include <unordered_map>
+#include "smooth/core/util/BoyerMooreHorspool.h"
 
 namespace smooth::application::network::http::regular
 {
     using MimeData = std::vector<uint8_t>;
-    using BoundaryIterator = MimeData::const_iterator;
+
+    /// Form data is handed over as a range of bytes, which either point directly into the data given to
+    /// MIMEParser::parse(), or into a small internal buffer when the data arrived in pieces too small to be
+    /// handed over by themselves. The range is only valid during the call.
+    using BoundaryIterator = const uint8_t*;
     using Boundaries = std::vector<BoundaryIterator>;
 
     class IFormData
@@ -53,11 +59,14 @@ namespace smooth::application::network::http::regular
     static const uint8_t LEN_OF_CRLF = 2;
     const std::vector<uint8_t> equal{ '=' };
 
+    /// Parses multipart/form-data and application/x-www-form-urlencoded content.
+    /// Multipart content is parsed as it arrives: the boundary is searched for using Boyer-Moore-Horspool
+    /// and only the last few bytes that may be the start of a boundary are kept between calls to parse().
     class MIMEParser
     {
         public:
             using MimeData = std::vector<uint8_t>;
-            using BoundaryIterator = MimeData::const_iterator;
+            using BoundaryIterator = regular::BoundaryIterator;
             using Boundaries = std::vector<BoundaryIterator>;
             using FormDataCallback = std::function<void (const std::string& field_name,
                                                          const std::string& actual_file_name,
@@ -77,6 +86,8 @@ namespace smooth::application::network::http::regular
                 parse(p.data(), p.size(), form_data, url_data, chunksize);
             }
 
+            /// Parses the next piece of content.
+            /// \param chunksize The largest amount of form data handed over in a single call to IFormData.
             void parse(const uint8_t* p, std::size_t length,
                        IFormData& form_data,
                        IURLEncodedData& url_data,
@@ -94,39 +105,53 @@ namespace smooth::application::network::http::regular
             {
                 Begin,
                 Headers,
-                Data
+                Data,
+                Delimiter,
+                End
             };
 
-            auto find_boundary() const;
+            std::size_t parse_body(const uint8_t* p, std::size_t length, IFormData& form_data, uint16_t chunksize);
+
+            std::size_t parse_headers(const uint8_t* p, std::size_t length);
+
+            std::size_t parse_delimiter(const uint8_t* p, std::size_t length);
+
+            std::size_t match_held_back(const uint8_t* p, std::size_t length, IFormData& form_data,
+                                        uint16_t chunksize);
 
-            auto find_end_boundary() const;
+            std::size_t partial_delimiter_at_end(const uint8_t* p, std::size_t length) const;
 
-            BoundaryIterator get_end_of_boundary(BoundaryIterator begin);
+            void deliver(const uint8_t* p, std::size_t length, bool last, IFormData& form_data, uint16_t chunksize);
 
-            bool is_crlf(BoundaryIterator start) const;
+            void parse_url_encoded(IURLEncodedData& url_data);
 
-            std::tuple<BoundaryIterator,
-                       std::unordered_map<std::string, std::string>,
-                       std::unordered_map<std::string, std::string>>
-            consume_headers(BoundaryIterator begin, BoundaryIterator end) const;
+            void consume_headers(const std::string& header_block);
+
+            void parse_content_disposition(const std::unordered_map<std::string, std::string>& headers,
+                                           std::unordered_map<std::string, std::string>& content_disposition) const;
 
             std::string id{};
             std::string filename{};
             bool first_part{ false };
-            bool end_of_transmission{ false };
-            std::vector<uint8_t> boundary{};
-            std::vector<uint8_t> end_boundary{};
+
+            // CRLF followed by "--" and the boundary.
+            smooth::core::util::BoyerMooreHorspool delimiter{};
+
+            // Trailing bytes that may be the start of a delimiter, held back until more data arrives.
+            std::vector<uint8_t> held_back{};
+
+            // Part data that arrived in pieces too small to hand over directly.
+            std::vector<uint8_t> staged{};
+
+            // The part headers, or the rest of the line following a delimiter.
+            std::string header_block{};
+
             std::vector<uint8_t> data{};
             std::unordered_map<std::string, std::string> form_url_encoded_data{};
             const std::regex form_data_pattern{ R"!(multipart\/form-data;.*boundary=(.+?)( |$))!" };
             const std::regex url_encoded_pattern{ R"!(application\/x-www-form-urlencoded)!" };
-            const std::vector<uint8_t> crlf{ '\r', '\n' };
-            const std::vector<uint8_t> crlf_double{ '\r', '\n', '\r', '\n' };
             Mode mode{ Mode::None };
             std::size_t expected_content_length{ 0 };
             ParseStatus parse_status{ ParseStatus::Begin };
-
-            void parse_content_disposition(const std::unordered_map<std::string, std::string>& headers,
-                                           std::unordered_map<std::string, std::string>& content_disposition) const;
     };
 }
@@ -17,10 +17,11 @@ limitations under the License.
 
 #pragma once
 
-#include <regex>
 #include "smooth/core/network/IPacketAssembly.h"
 #include "smooth/application/network/http/HTTPPacket.h"
 #include "smooth/application/network/http/IServerResponse.h"
+#include "HTTPHeaderParser.h"
+#include "ChunkedDecoder.h"
 #include "IUpgradeToWebsocket.h"
 
 namespace smooth::application::network::http::regular
@@ -52,12 +53,18 @@ namespace smooth::application::network::http::regular
 
             bool is_error() override;
 
+            void take_excess_data(std::vector<uint8_t>& target) override;
+
             void packet_consumed() override;
 
             void reset() override;
 
         private:
-            int consume_headers(HTTPPacket& packet, std::vector<uint8_t>::const_iterator header_ending);
+            int consume_headers(HTTPPacket& packet);
+
+            void decode_chunks(HTTPPacket& packet, int length);
+
+            void keep_excess_data(const uint8_t* data, std::size_t length);
 
             enum class State
             {
@@ -75,8 +82,13 @@ namespace smooth::application::network::http::regular
             int incoming_content_length{ 0 };
             int actual_header_size{ 0 };
 
-            const std::regex response_line{ R"!(HTTP\/(\d.\d)\ (\d+)\ (.+))!" }; // HTTP/1.1 200 OK
-            const std::regex request_line{ R"!((.+)\ (.+)\ HTTP\/(\d\.\d))!" }; // "GET / HTTP/1.1"
+            HTTPHeaderParser header_parser{};
+
+            bool chunked = false;
+            ChunkedDecoder chunk_decoder{};
+
+            // Data received beyond the end of the request, e.g. a pipelined request.
+            std::vector<uint8_t> excess{};
 
             bool error = false;
             State state = State::reading_headers;
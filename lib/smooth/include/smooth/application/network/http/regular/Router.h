@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "smooth/application/network/http/regular/HTTPMethod.h"
+#include "smooth/application/network/http/regular/HTTPRequestHandler.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// Maps request paths to request handlers using one radix tree per HTTP method.
+    ///
+    /// Paths may contain parameters, e.g. "/api/devices/{id}", where each parameter matches a single
+    /// non-empty path segment. Handlers may also be mounted on a prefix, in which case they handle the
+    /// prefix itself and every path beneath it, unless a more specific route exists. When several routes
+    /// match, literal path segments take precedence over parameters, which take precedence over mounts.
+    class Router
+    {
+        public:
+            using Handler = std::shared_ptr<HTTPRequestHandler>;
+            using Parameters = std::unordered_map<std::string, std::string>;
+
+            /// Adds a route, replacing any existing handler for the same method and path.
+            void add(HTTPMethod method, const std::string& path, Handler handler);
+
+            /// Mounts a handler on a path prefix, e.g. "/files" handles "/files" and "/files/a/b", not "/filesystem".
+            void mount(HTTPMethod method, const std::string& prefix, Handler handler);
+
+            /// Finds the handler for the given path.
+            /// \param parameters Receives the values of the path parameters of the matched route.
+            /// \return The handler, or nullptr if no route matches.
+            Handler find(HTTPMethod method, const std::string& path, Parameters& parameters) const;
+
+        private:
+            struct Node
+            {
+                std::string prefix{};
+                std::vector<std::unique_ptr<Node>> children{};
+                std::unique_ptr<Node> parameter{};
+                std::string parameter_name{};
+                Handler handler{};
+                Handler mounted{};
+            };
+
+            Node& insert(HTTPMethod method, const std::string& path);
+
+            static Node& insert_literal(Node& node, std::string_view literal);
+
+            static bool match(const Node& node, std::string_view path, Parameters& parameters, Handler& result);
+
+            std::unordered_map<HTTPMethod, Node> roots{};
+    };
+}
@@ -17,12 +17,15 @@ limitations under the License.
 
 #pragma once
 
+#include <ctime>
 #include <memory>
 #include <set>
-#include <regex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "smooth/core/filesystem/Path.h"
-#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/IResponseOperation.h"
+#include "CompiledTemplate.h"
 #include "ITemplateDataRetriever.h"
 
 namespace smooth::application::network::http::regular
@@ -33,8 +36,15 @@ namespace smooth::application::network::http::regular
             explicit TemplateProcessor(std::set<std::string> template_files,
                                        std::shared_ptr<ITemplateDataRetriever> data_retriever);
 
+            /// Renders the file if it is a template, otherwise returns an empty pointer.
+            /// Templates are compiled on first use and recompiled when last_modified changes.
+            /// \param path Path to the file
+            /// \param last_modified Modification time of the file
             std::unique_ptr<smooth::application::network::http::IResponseOperation>
-            process_template(const smooth::core::filesystem::Path& path);
+            process_template(const smooth::core::filesystem::Path& path, std::time_t last_modified);
+
+            /// Drops all compiled templates.
+            void clear();
 
 #ifndef EXPOSE_PRIVATE_PARTS_FOR_TEST
         private:
@@ -42,8 +52,19 @@ namespace smooth::application::network::http::regular
 
             void process_template(std::string& template_data) const;
 
+            std::shared_ptr<const CompiledTemplate> compile(const smooth::core::filesystem::Path& path,
+                                                            std::time_t last_modified);
+
+            std::vector<std::string> resolve(const CompiledTemplate& compiled) const;
+
+            struct Entry
+            {
+                std::time_t last_modified;
+                std::shared_ptr<const CompiledTemplate> compiled;
+            };
+
             std::set<std::string> template_files;
             std::shared_ptr<ITemplateDataRetriever> data_retriever;
-            const std::regex token{ R"!(\{\{[\d\_\-a-zA-Z]+\}\})!", std::regex::ECMAScript };
+            std::unordered_map<std::string, Entry> compiled_templates{};
     };
 }
@@ -0,0 +1,76 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include "smooth/core/filesystem/Path.h"
+
+namespace smooth::application::network::http::regular
+{
+    /// Remembers what requested URLs resolved to beneath the web root, including that nothing was found,
+    /// so that repeated requests don't have to query the file system. Entries expire after a set time so
+    /// that changes to the web root are picked up, and the oldest entries are evicted when full.
+    class WebRootLookupCache
+    {
+        public:
+            struct Lookup
+            {
+                /// The file to serve, empty if not found.
+                smooth::core::filesystem::Path path{};
+                /// True if path is the index file of the requested directory.
+                bool index = false;
+                time_t last_modified{};
+            };
+
+            WebRootLookupCache(std::size_t max_entries, std::chrono::milliseconds time_to_live)
+                    : max_entries(max_entries),
+                      time_to_live(time_to_live)
+            {
+            }
+
+            /// Gets a previous lookup of the URL.
+            /// \return The lookup, or nullptr if there is none or it has expired.
+            const Lookup* find(const std::string& url);
+
+            void insert(const std::string& url, Lookup lookup);
+
+            void clear();
+
+        private:
+            struct Entry
+            {
+                std::string url{};
+                Lookup lookup{};
+                std::chrono::steady_clock::time_point expires{};
+            };
+
+            void erase(std::list<Entry>::iterator entry);
+
+            const std::size_t max_entries;
+            const std::chrono::milliseconds time_to_live;
+
+            // Oldest first; as all entries live equally long this is also the order they expire in.
+            std::list<Entry> entries{};
+            std::unordered_map<std::string, std::list<Entry>::iterator> by_url{};
+    };
+}
@@ -17,8 +17,11 @@ limitations under the License.
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include "smooth/application/network/http/regular/HTTPRequestHandler.h"
+#include "smooth/application/network/http/websocket/PerMessageDeflate.h"
+#include "smooth/application/network/http/websocket/WebsocketGroup.h"
 
 namespace smooth::application::network::http::regular
 {
@@ -26,6 +29,15 @@ namespace smooth::application::network::http::regular
     class WebSocketUpgradeDetector : public HTTPRequestHandler
     {
         public:
+            /// \param compression If set, permessage-deflate is accepted when offered by the client.
+            /// \param group If set, the group upgraded connections join.
+            explicit WebSocketUpgradeDetector(
+                std::optional<websocket::PerMessageDeflateConfig> compression = std::nullopt,
+                std::shared_ptr<websocket::WebsocketGroup> group = nullptr)
+                    : compression(std::move(compression)), group(std::move(group))
+            {
+            }
+
             void request(IConnectionTimeoutModifier& timeout_modifier,
                          const std::string& url,
                          const std::vector<uint8_t>& content)
@@ -63,6 +75,20 @@ namespace smooth::application::network::http::regular
                             res->add_header(UPGRADE, "websocket");
                             res->add_header(CONNECTION, "upgrade");
                             res->add_header(SEC_WEBSOCKET_ACCEPT, reply_key);
+
+                            std::unique_ptr<websocket::PerMessageDeflate> deflate{};
+                            const auto extensions = headers().find(SEC_WEBSOCKET_EXTENSIONS);
+
+                            if (compression && extensions != headers().end())
+                            {
+                                if (auto params = websocket::PerMessageDeflate::negotiate(extensions->second,
+                                                                                          *compression))
+                                {
+                                    res->add_header(SEC_WEBSOCKET_EXTENSIONS, params->to_string());
+                                    deflate = std::make_unique<websocket::PerMessageDeflate>(*params, *compression);
+                                }
+                            }
+
                             response().reply(std::move(res), false);
                             did_upgrade = true;
 
@@ -70,7 +96,7 @@ namespace smooth::application::network::http::regular
                             timeout_modifier.set_receive_timeout(std::chrono::milliseconds{ 0 });
 
                             // Finally change protocols.
-                            response().upgrade_to_websocket<WSServerType>();
+                            response().upgrade_to_websocket<WSServerType>(std::move(deflate), group);
                         }
                     }
                     catch (std::exception& ex)
@@ -85,5 +111,9 @@ namespace smooth::application::network::http::regular
                     }
                 }
             }
+
+        private:
+            std::optional<websocket::PerMessageDeflateConfig> compression;
+            std::shared_ptr<websocket::WebsocketGroup> group;
     };
 }
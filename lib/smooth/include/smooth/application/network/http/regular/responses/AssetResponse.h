@@ -0,0 +1,48 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include "HeaderOnlyResponse.h"
+#include "smooth/application/network/http/regular/AssetCache.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Sends a file held by the AssetCache, straight from memory.
+    class AssetResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            /// \param asset The file to send
+            /// \param gzip If true, the precompressed variant is sent.
+            AssetResponse(std::shared_ptr<const AssetCache::Asset> asset, bool gzip);
+
+            bool has_shared_data() const override
+            {
+                return true;
+            }
+
+            ResponseStatus get_shared_data(std::size_t max_amount, SharedContent& target) override;
+
+        private:
+            std::shared_ptr<const AssetCache::Asset> asset;
+            const AssetCache::Variant& variant;
+            bool sent = false;
+    };
+}
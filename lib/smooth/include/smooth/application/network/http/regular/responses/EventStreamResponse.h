@@ -0,0 +1,111 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "HeaderOnlyResponse.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// The sending end of a Server-Sent Events stream (https://html.spec.whatwg.org/multipage/server-sent-events.html),
+    /// shared between the application, which sends events from any task, and the EventStreamResponse that
+    /// delivers them to the client.
+    ///
+    /// Events not yet delivered are queued, up to a limit. When a client can't keep up, the oldest events
+    /// are dropped so that the client always gets the latest ones.
+    class EventStream
+    {
+        public:
+            /// \param max_queued_events The number of events to keep for a client that can't keep up.
+            explicit EventStream(std::size_t max_queued_events = 16)
+                    : max_queued_events(max_queued_events)
+            {
+            }
+
+            /// Queues an event for sending.
+            /// \param data The event data, may contain multiple lines.
+            /// \param event The event type, or empty for the default type, "message".
+            /// \param id The event id, or empty to not set one.
+            /// \return false if the stream has been closed, e.g. because the client disconnected.
+            bool send(const std::string& data, const std::string& event = "", const std::string& id = "");
+
+            /// Ends the stream. The response is completed once the queued events have been sent.
+            void close();
+
+            /// \return true until the stream has been closed, by either end.
+            [[nodiscard]] bool is_open() const;
+
+            /// \return The number of events dropped due to the queue being full.
+            [[nodiscard]] std::size_t get_dropped_count() const;
+
+        private:
+            friend class EventStreamResponse;
+
+            /// Moves the queued events into target.
+            /// \return false once the stream has been closed and there are no more events.
+            bool take(std::string& target);
+
+            void set_wake_up(std::function<void()> wake_up);
+
+            /// Called when the response goes away.
+            void detach();
+
+            const std::size_t max_queued_events;
+            mutable std::mutex guard{};
+            std::deque<std::string> events{};
+            std::function<void()> wake_up{};
+            std::size_t dropped{ 0 };
+            bool waiting{ false };
+            bool closed{ false };
+    };
+
+    /// A response with content type text/event-stream which sends the events of an EventStream as they are
+    /// sent by the application, for as long as the stream is open. As it is long-lived, the request handler
+    /// replying with it should disable the receive timeout of the connection.
+    class EventStreamResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            explicit EventStreamResponse(std::shared_ptr<EventStream> stream);
+
+            EventStreamResponse& operator=(EventStreamResponse&&) = delete;
+
+            EventStreamResponse(EventStreamResponse&&) = delete;
+
+            EventStreamResponse& operator=(const EventStreamResponse&) = delete;
+
+            EventStreamResponse(const EventStreamResponse&) = delete;
+
+            ~EventStreamResponse() override;
+
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            void set_wake_up(std::function<void()> wake_up) override;
+
+        private:
+            std::shared_ptr<EventStream> stream;
+            std::string pending{};
+            std::size_t pending_offset{ 0 };
+            bool open{ true };
+    };
+}
@@ -17,26 +17,66 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
 #include "StringResponse.h"
+#include "smooth/application/network/http/http_utils.h"
 #include "smooth/core/filesystem/Path.h"
 #include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/filesystem/MemoryMappedFile.h"
 
 namespace smooth::application::network::http::regular::responses
 {
+    /// Sends the contents of a file. Where supported, the file is memory mapped for the duration of
+    /// the response and sent straight from the mapping, otherwise it is read in chunks.
+    /// When given the Range header of the request, only the requested parts of the file are sent, using
+    /// 206 Partial Content, and multipart/byteranges when more than one range is requested.
     class FileContentResponse
         : public StringResponse
     {
         public:
-            explicit FileContentResponse(smooth::core::filesystem::Path full_path);
+            /// \param full_path The file to send
+            /// \param range The value of the Range header, or empty to send the entire file.
+            explicit FileContentResponse(smooth::core::filesystem::Path full_path, const std::string& range = "");
 
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
 
+            bool has_shared_data() const override;
+
+            ResponseStatus get_shared_data(std::size_t max_amount, SharedContent& target) override;
+
             void dump() const override;
 
+            /// The largest part of the file handed out at once by get_shared_data().
+            static constexpr std::size_t max_shared_part = 1024 * 1024;
+
         private:
+            /// A part of the response body; either text, such as the header of a part of a multipart
+            /// response, or a region of the file.
+            struct Part
+            {
+                std::shared_ptr<const std::string> text;
+                std::size_t offset;
+                std::size_t length;
+            };
+
+            void add_text(std::string text);
+
+            void add_region(std::size_t offset, std::size_t length);
+
+            void set_ranges(const std::vector<utils::ByteRange>& ranges);
+
+            ResponseStatus advance(std::size_t amount);
+
             smooth::core::filesystem::Path path;
             smooth::core::filesystem::FileInfo info;
+            std::shared_ptr<smooth::core::filesystem::MemoryMappedFile> mapping;
+            std::vector<Part> parts{};
+            std::size_t current_part{ 0 };
+            std::size_t sent_of_part{ 0 };
             std::size_t sent{ 0 };
+            std::size_t total{ 0 };
     };
 }
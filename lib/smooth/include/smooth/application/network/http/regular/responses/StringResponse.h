@@ -41,6 +41,11 @@ namespace smooth::application::network::http::regular::responses
             // Called at least once when sending a response and until ResponseStatus::AllSent is returned
             ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
 
+            [[nodiscard]] std::size_t get_buffered_size() const override
+            {
+                return data.size();
+            }
+
             void dump() const override;
 
         private:
@@ -0,0 +1,49 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "HeaderOnlyResponse.h"
+#include "smooth/application/network/http/regular/CompiledTemplate.h"
+
+namespace smooth::application::network::http::regular::responses
+{
+    /// Renders a compiled template chunk by chunk, without building the complete document in memory.
+    class TemplateResponse
+        : public HeaderOnlyResponse
+    {
+        public:
+            /// \param compiled The template to render
+            /// \param values The values for the keys of the template, values[i] for compiled->keys()[i].
+            TemplateResponse(std::shared_ptr<const CompiledTemplate> compiled, std::vector<std::string> values);
+
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            void dump() const override;
+
+        private:
+            std::shared_ptr<const CompiledTemplate> compiled;
+            std::vector<std::string> values;
+            std::size_t segment = 0;
+            std::size_t segment_offset = 0;
+            std::size_t remaining = 0;
+    };
+}
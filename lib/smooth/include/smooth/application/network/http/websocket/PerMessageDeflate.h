@@ -0,0 +1,203 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct z_stream_s;
+
+namespace smooth::application::network::http::websocket
+{
+    /// Settings for the permessage-deflate extension, https://tools.ietf.org/html/rfc7692, offered to websocket
+    /// clients. The defaults keep the compression state of a connection within a few tens of kilobytes, as is
+    /// suitable for an ESP32.
+    class PerMessageDeflateConfig
+    {
+        public:
+            /// \arg server_max_window_bits Base-2 logarithm of the window used to compress outgoing messages, 9 - 15.
+            /// Compression takes (1 << (server_max_window_bits + 2)) + (1 << (memory_level + 9)) bytes plus about
+            /// 6 kB of state.
+            /// \arg client_max_window_bits Base-2 logarithm of the largest window the client is asked to compress
+            /// its messages with, 9 - 15. Decompression takes (1 << client_max_window_bits) bytes plus about 7 kB.
+            /// Clients that don't allow the window to be limited may use 15.
+            /// \arg server_no_context_takeover If true, each outgoing message is compressed on its own instead of
+            /// referring to previous messages. This compresses worse, but allows a message that doesn't get smaller
+            /// to be sent uncompressed.
+            /// \arg client_no_context_takeover If true, the client is asked to compress each message on its own.
+            /// \arg memory_level zlib memLevel, 1 - 9, used when compressing.
+            /// \arg memory_budget The number of bytes the compression state of a connection may take up. Clients
+            /// whose messages can't be decompressed within this are not offered compression. If there is too
+            /// little left to compress messages, they are sent uncompressed. 0 means no limit.
+            /// \arg compression_level zlib compression level, 1 (fastest) - 9 (best).
+            /// \arg min_message_size Messages smaller than this are sent uncompressed.
+            explicit PerMessageDeflateConfig(int server_max_window_bits = 10,
+                                             int client_max_window_bits = 10,
+                                             bool server_no_context_takeover = false,
+                                             bool client_no_context_takeover = false,
+                                             int memory_level = 4,
+                                             std::size_t memory_budget = 48 * 1024,
+                                             int compression_level = 6,
+                                             std::size_t min_message_size = 32);
+
+            [[nodiscard]] int server_window_bits() const
+            {
+                return server_max_window_bits;
+            }
+
+            [[nodiscard]] int client_window_bits() const
+            {
+                return client_max_window_bits;
+            }
+
+            [[nodiscard]] bool server_no_takeover() const
+            {
+                return server_no_context_takeover;
+            }
+
+            [[nodiscard]] bool client_no_takeover() const
+            {
+                return client_no_context_takeover;
+            }
+
+            [[nodiscard]] int mem_level() const
+            {
+                return memory_level;
+            }
+
+            [[nodiscard]] std::size_t budget() const
+            {
+                return memory_budget;
+            }
+
+            [[nodiscard]] int level() const
+            {
+                return compression_level;
+            }
+
+            [[nodiscard]] std::size_t min_size() const
+            {
+                return min_message_size;
+            }
+
+        private:
+            int server_max_window_bits;
+            int client_max_window_bits;
+            bool server_no_context_takeover;
+            bool client_no_context_takeover;
+            int memory_level;
+            std::size_t memory_budget;
+            int compression_level;
+            std::size_t min_message_size;
+    };
+
+    /// The parameters of permessage-deflate agreed on with a client.
+    struct DeflateParameters
+    {
+        int server_max_window_bits = 15;
+        int client_max_window_bits = 15;
+        bool server_no_context_takeover = false;
+        bool client_no_context_takeover = false;
+
+        // Set if the offer included the respective parameter, which must then be answered.
+        bool server_max_window_bits_offered = false;
+        bool client_max_window_bits_offered = false;
+
+        /// Formats the parameters as the value of the Sec-WebSocket-Extensions header of the response.
+        [[nodiscard]] std::string to_string() const;
+    };
+
+    /// Compresses outgoing and decompresses incoming messages of a websocket connection using permessage-deflate.
+    class PerMessageDeflate
+    {
+        public:
+            using Receiver = std::function<void(bool first_part, bool last_part, const std::vector<uint8_t>& part)>;
+
+            PerMessageDeflate(const DeflateParameters& parameters, const PerMessageDeflateConfig& config);
+
+            ~PerMessageDeflate();
+
+            PerMessageDeflate(const PerMessageDeflate&) = delete;
+
+            PerMessageDeflate& operator=(const PerMessageDeflate&) = delete;
+
+            PerMessageDeflate(PerMessageDeflate&&) = delete;
+
+            PerMessageDeflate& operator=(PerMessageDeflate&&) = delete;
+
+            /// Selects the first of the offers in the value of a Sec-WebSocket-Extensions request header that
+            /// can be accepted, if any.
+            static std::optional<DeflateParameters> negotiate(const std::string& offers,
+                                                              const PerMessageDeflateConfig& config);
+
+            /// Compresses, in place, a fragment of an outgoing message. Fragments must be given in the order
+            /// they are sent. Whether a message is compressed is decided at its first fragment.
+            /// \return true if the message is sent compressed, in which case the first frame must have RSV1 set.
+            bool compress(std::vector<uint8_t>& data, bool first_fragment, bool last_fragment);
+
+            /// Decompresses the next part of a received, compressed, message and hands the result over in parts
+            /// of at most chunk_size bytes.
+            /// \param message_end true if the data ends the message.
+            /// \return false if the data could not be decompressed.
+            bool decompress(const std::vector<uint8_t>& data, bool message_end, std::size_t chunk_size,
+                            const Receiver& receiver);
+
+            /// Gets the number of bytes currently allocated for compressing outgoing messages.
+            [[nodiscard]] std::size_t get_deflate_memory() const
+            {
+                return deflate_memory;
+            }
+
+            /// Gets the number of messages sent uncompressed as there wasn't enough memory to compress them.
+            [[nodiscard]] std::size_t get_uncompressed_count() const
+            {
+                return uncompressed_count;
+            }
+
+        private:
+            bool init_deflate();
+
+            static void* allocate(void* opaque, unsigned int items, unsigned int size);
+
+            static void release(void* opaque, void* address);
+
+            const DeflateParameters parameters;
+            const int memory_level;
+            const int compression_level;
+            const std::size_t min_message_size;
+
+            // What is left of the memory budget once decompression has been provided for. 0 means no limit.
+            std::size_t deflate_budget;
+            std::size_t deflate_memory{ 0 };
+            bool deflate_unavailable{ false };
+            bool compressing_message{ false };
+            std::size_t uncompressed_count{ 0 };
+
+            bool inflating_message{ false };
+            std::vector<uint8_t> inflated{};
+
+            std::unique_ptr<z_stream_s> deflate_stream{};
+            std::unique_ptr<z_stream_s> inflate_stream{};
+    };
+}
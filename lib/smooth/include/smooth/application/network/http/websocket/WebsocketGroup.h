@@ -0,0 +1,125 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "smooth/application/network/http/websocket/responses/WSBroadcastResponse.h"
+
+namespace smooth::application::network::http::websocket
+{
+    class WebsocketServer;
+
+    /// What to do with a member of a WebsocketGroup that does not keep up with the messages broadcast to it.
+    enum class SlowConsumerPolicy
+    {
+        /// New messages are not sent to the member until it has caught up.
+        Drop,
+        /// The newest of the messages waiting to be sent is replaced by the new one, so the member
+        /// skips intermediate messages but always gets the most recent one.
+        Coalesce,
+        /// The connection is closed.
+        Disconnect
+    };
+
+    /// A group of websocket connections that messages are broadcast to. Each message is framed once, into a
+    /// buffer shared by all members, and queued on every connection without being copied. Members join using
+    /// WebsocketServer::join(), or HTTPServer::enable_websocket_on(), and leave when their connection closes.
+    ///
+    /// Messages are sent uncompressed, even to members using permessage-deflate, as the compression state
+    /// belongs to each connection. A group must only be used from the task the HTTP server runs on, and be
+    /// owned by a std::shared_ptr.
+    class WebsocketGroup
+    {
+        public:
+            /// \param policy The policy for members not given one when joining.
+            /// \param max_waiting The number of broadcast messages that may be waiting to be sent to a member
+            /// before it is considered too slow.
+            explicit WebsocketGroup(SlowConsumerPolicy policy = SlowConsumerPolicy::Drop, std::size_t max_waiting = 8);
+
+            WebsocketGroup(const WebsocketGroup&) = delete;
+
+            WebsocketGroup& operator=(const WebsocketGroup&) = delete;
+
+            /// Sends a text message to all members.
+            void broadcast(const std::string& text);
+
+            /// Sends a message to all members.
+            /// \param data The message
+            /// \param is_text If true, the message is sent as text, otherwise as binary.
+            void broadcast(const std::vector<uint8_t>& data, bool is_text);
+
+            /// Sends a message to all members.
+            void broadcast(const uint8_t* data, std::size_t length, bool is_text);
+
+            /// Gets the number of members.
+            [[nodiscard]] std::size_t size() const
+            {
+                return members.size();
+            }
+
+            /// Gets the number of messages not sent to members that were too slow to receive them.
+            [[nodiscard]] uint64_t get_dropped_count() const
+            {
+                return dropped;
+            }
+
+            /// Gets the number of messages that replaced one waiting to be sent to a member.
+            [[nodiscard]] uint64_t get_coalesced_count() const
+            {
+                return coalesced;
+            }
+
+            /// Gets the number of members disconnected for being too slow.
+            [[nodiscard]] uint64_t get_disconnected_count() const
+            {
+                return disconnected;
+            }
+
+        private:
+            friend class WebsocketServer;
+
+            struct Member
+            {
+                WebsocketServer* server;
+                SlowConsumerPolicy policy;
+                std::shared_ptr<responses::BroadcastBacklog> backlog;
+                bool disconnecting;
+            };
+
+            /// Adds a member, or changes the policy of an existing one.
+            /// \return true if added.
+            bool add(WebsocketServer& server, std::optional<SlowConsumerPolicy> member_policy);
+
+            void remove(WebsocketServer& server);
+
+            /// Applies the policy of a member that is too slow.
+            void too_slow(Member& member, const responses::SharedFrame& frame);
+
+            const SlowConsumerPolicy policy;
+            const std::size_t max_waiting;
+            std::vector<Member> members{};
+            uint64_t dropped{ 0 };
+            uint64_t coalesced{ 0 };
+            uint64_t disconnected{ 0 };
+    };
+}
@@ -71,6 +71,13 @@ namespace smooth::application::network::http::websocket
 
             void reset() override;
 
+            /// Accepts messages compressed using permessage-deflate, once negotiated. Such messages are
+            /// delivered as received, marked as compressed.
+            void enable_compression()
+            {
+                compression = true;
+            }
+
             /* https://tools.ietf.org/html/rfc6455#section-5.2
 
               0                   1                   2                   3
@@ -125,10 +132,14 @@ namespace smooth::application::network::http::websocket
             IServerResponse& response;
 
             bool error{ false };
+            bool compression{ false };
+            // Set if the message the current frame belongs to is compressed.
+            bool message_compressed{ false };
             int data_received_in_current_state{ 0 };
             uint64_t payload_length{ 0 };
             uint64_t received_payload{ 0 };
-            uint64_t demask_ix{ 0 };
+            // Index into the masking key of the next byte of the payload.
+            std::size_t demask_ix{ 0 };
             uint64_t received_payload_in_current_package{ 0 };
             int amount_wanted_in_current_state = 0;
 
@@ -17,8 +17,12 @@ limitations under the License.
 
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <vector>
 #include "smooth/core/Task.h"
 #include "smooth/application/network/http/websocket/responses/WSResponse.h"
+#include "smooth/application/network/http/websocket/WebsocketGroup.h"
 
 namespace smooth::application::network::http
 {
@@ -35,15 +39,31 @@ namespace smooth::application::network::http::websocket
             {
             }
 
-            virtual ~WebsocketServer() = default;
+            virtual ~WebsocketServer();
+
+            WebsocketServer(const WebsocketServer&) = delete;
+
+            WebsocketServer& operator=(const WebsocketServer&) = delete;
 
             virtual void data_received(bool first_part, bool last_part, bool is_text,
                                        const std::vector<uint8_t>& data) = 0;
 
             void close_connection();
 
+            /// Makes the connection receive the messages broadcast to the group, until it is closed.
+            /// \param policy What to do when the connection does not keep up, if not the default of the group.
+            void join(const std::shared_ptr<WebsocketGroup>& group,
+                      std::optional<SlowConsumerPolicy> policy = std::nullopt);
+
+            /// Stops receiving the messages broadcast to the group.
+            void leave(const std::shared_ptr<WebsocketGroup>& group);
+
         protected:
             IServerResponse& response;
             smooth::core::Task& task;
+        private:
+            friend class WebsocketGroup;
+
+            std::vector<std::weak_ptr<WebsocketGroup>> groups{};
     };
 }
@@ -0,0 +1,49 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "OpCode.h"
+
+namespace smooth::application::network::http::websocket
+{
+    /// The largest header of an unmasked frame, i.e. as sent by a server.
+    static constexpr std::size_t MaxFrameHeaderSize = 10;
+
+    /// Writes the header of an unmasked frame.
+    /// \param target Where to write the header, must have room for MaxFrameHeaderSize bytes.
+    /// \param op_code The op code of the frame
+    /// \param fin true if this is the final fragment of the message.
+    /// \param payload_length The length of the payload following the header.
+    /// \param compressed true to set RSV1, marking the first frame of a message compressed using permessage-deflate.
+    /// \return The size of the header.
+    std::size_t write_frame_header(uint8_t* target, OpCode op_code, bool fin, uint64_t payload_length,
+                                   bool compressed = false);
+
+    /// Masks, or unmasks, data in place as per https://tools.ietf.org/html/rfc6455#section-5.3. The data is
+    /// processed a vector register or a machine word at a time where possible, without any alignment requirements.
+    /// \param data The data
+    /// \param length The length of the data
+    /// \param mask_key The four byte masking key
+    /// \param phase The index into the masking key of the first byte, i.e. the number of bytes of the payload
+    /// already processed, modulo 4. This allows a payload to be processed in parts.
+    /// \return The phase following the last byte, to be used with the next part of the payload.
+    std::size_t apply_mask(uint8_t* data, std::size_t length, const uint8_t* mask_key, std::size_t phase = 0);
+}
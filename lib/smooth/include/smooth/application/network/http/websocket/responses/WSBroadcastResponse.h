@@ -0,0 +1,74 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "smooth/application/network/http/IResponseOperation.h"
+
+namespace smooth::application::network::http::websocket::responses
+{
+    class WSBroadcastResponse;
+
+    /// A complete frame, header included, shared by all connections it is sent to.
+    using SharedFrame = std::shared_ptr<const std::vector<uint8_t>>;
+
+    /// Keeps track of the broadcast messages queued on a connection that have not yet started being sent.
+    struct BroadcastBacklog
+    {
+        std::size_t waiting{ 0 };
+        /// The most recently queued message still waiting, if any.
+        WSBroadcastResponse* latest{ nullptr };
+    };
+
+    /// Sends a frame encoded once for many connections, without copying it.
+    class WSBroadcastResponse
+        : public IResponseOperation
+    {
+        public:
+            WSBroadcastResponse(SharedFrame frame, std::shared_ptr<BroadcastBacklog> backlog);
+
+            ~WSBroadcastResponse() override;
+
+            WSBroadcastResponse(const WSBroadcastResponse&) = delete;
+
+            WSBroadcastResponse& operator=(const WSBroadcastResponse&) = delete;
+
+            ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
+
+            bool has_shared_data() const override
+            {
+                return true;
+            }
+
+            ResponseStatus get_shared_data(std::size_t max_amount, SharedContent& target) override;
+
+            /// Replaces the frame with a newer one. Only possible until the frame has started being sent.
+            /// \return true if replaced.
+            bool replace(SharedFrame newer);
+
+        private:
+            /// Removes the message from the backlog, once sent or discarded.
+            void leave_backlog();
+
+            SharedFrame frame;
+            std::shared_ptr<BroadcastBacklog> backlog;
+            bool started{ false };
+    };
+}
@@ -56,16 +56,23 @@ namespace smooth::application::network::http::websocket::responses
 
             ResponseStatus get_data(std::size_t max_amount, std::vector<uint8_t>& target) override;
 
+            void set_message_compression(PerMessageDeflate& deflate) override;
+
+            [[nodiscard]] std::size_t get_buffered_size() const override
+            {
+                return data.size() - sent;
+            }
+
         private:
             bool header_sent{ false };
 
-            void set_length(uint64_t len, std::vector<uint8_t>& buff) const;
-
             smooth::application::network::http::websocket::OpCode op_code;
 
             bool first_fragment{ true };
             bool last_fragment{ true };
+            bool compressed{ false };
 
             std::vector<uint8_t> data{};
+            std::size_t sent{ 0 };
     };
 }
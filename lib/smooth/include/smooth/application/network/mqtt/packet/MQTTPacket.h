@@ -33,6 +33,16 @@ namespace smooth::application::network::mqtt::packet
     {
         friend class MQTTProtocol;
         public:
+            MQTTPacket() = default;
+
+            MQTTPacket(const MQTTPacket&) = default;
+
+            MQTTPacket(MQTTPacket&&) = default;
+
+            MQTTPacket& operator=(const MQTTPacket&) = default;
+
+            MQTTPacket& operator=(MQTTPacket&&) = default;
+
             ~MQTTPacket() override = default;
 
             virtual std::vector<uint8_t>::const_iterator get_payload_cbegin() const
@@ -102,7 +112,7 @@ namespace smooth::application::network::mqtt::packet
 
             void append_msb_lsb(uint16_t value, std::vector<uint8_t>& target);
 
-            void apply_constructed_data(const std::vector<uint8_t>& variable);
+            void apply_constructed_data(std::vector<uint8_t>&& variable);
 
             void encode_remaining_length(int length);
 
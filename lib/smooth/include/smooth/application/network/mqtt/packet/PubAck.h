@@ -32,7 +32,7 @@ namespace smooth::application::network::mqtt::packet
                 set_header(PUBACK, 0x2);
                 std::vector<uint8_t> variable_header;
                 append_msb_lsb(packet_id, variable_header);
-                apply_constructed_data(variable_header);
+                apply_constructed_data(std::move(variable_header));
             }
 
             explicit PubAck(const MQTTPacket& packet)
@@ -32,7 +32,7 @@ namespace smooth::application::network::mqtt::packet
                 set_header(PUBREC, 0);
                 std::vector<uint8_t> variable_header;
                 append_msb_lsb(packet_id, variable_header);
-                apply_constructed_data(variable_header);
+                apply_constructed_data(std::move(variable_header));
             }
 
             explicit PubRec(const MQTTPacket& packet)
@@ -39,7 +39,7 @@ namespace smooth::application::network::mqtt::packet
 
                 std::vector<uint8_t> variable_header;
                 append_msb_lsb(packet_id, variable_header);
-                apply_constructed_data(variable_header);
+                apply_constructed_data(std::move(variable_header));
             }
 
             void visit(IPacketReceiver& receiver) override;
@@ -40,7 +40,7 @@ namespace smooth::application::network::mqtt::packet
                 append_msb_lsb(PacketIdentifierFactory::get_id(), data);
                 append_string(topic, data);
                 data.push_back(qos);
-                apply_constructed_data(data);
+                apply_constructed_data(std::move(data));
             }
 
             uint16_t get_packet_identifier() const override
@@ -31,7 +31,7 @@ namespace smooth::application::network::mqtt::packet
                 std::vector<uint8_t> data;
                 append_msb_lsb(PacketIdentifierFactory::get_id(), data);
                 append_string(topic, data);
-                apply_constructed_data(data);
+                apply_constructed_data(std::move(data));
             }
 
             explicit Unsubscribe(const MQTTPacket& packet)
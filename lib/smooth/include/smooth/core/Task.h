@@ -23,6 +23,7 @@ limitations under the License.
 #include <map>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
 
 #include <thread>
 
@@ -109,6 +110,21 @@ namespace smooth::core
 
             void report_stack_status();
 
+            /// Registers a function that is called whenever an event is queued for this task.
+            /// Only needed by tasks that block inside tick() waiting on something other than
+            /// their event queues, so that they can return in time to process the event.
+            /// \param wake_up The function to call. Must be thread-safe and must not block.
+            void set_event_wake_up(std::function<void()> wake_up);
+
+            /// Sets the maximum number of events the task handles each time it wakes up. The default, 1,
+            /// handles a single event before checking the tick and polled queues again. A larger value
+            /// takes several notifications in one go, which saves locking per event under load, at the cost of
+            /// delaying tick() and polled queues by up to that many events. Events are still delivered in the
+            /// order they were sent, also across queues.
+            /// Must be called from the task itself, such as from its constructor or init().
+            /// \param max_events Maximum number of events per wake-up, values less than 1 are treated as 1.
+            void set_event_batch_size(uint32_t max_events);
+
             const std::string name;
         private:
             void exec();
@@ -126,5 +142,6 @@ namespace smooth::core
             std::condition_variable start_condition{};
             smooth::core::timer::ElapsedTime status_report_timer{};
             std::vector<smooth::core::ipc::IPolledTaskQueue*> polled_queues{};
+            size_t event_batch_size = 1;
     };
 }
@@ -0,0 +1,74 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "smooth/core/filesystem/Path.h"
+
+namespace smooth::core::filesystem
+{
+    /// Maps an entire file into memory, read-only, for as long as the instance lives.
+    /// Only supported on platforms providing mmap(); on other platforms, or if the file can't
+    /// be mapped, is_mapped() returns false and the file must be read by other means.
+    /// Should the file be truncated while mapped, touching the part of the mapping beyond the new end
+    /// of the file raises SIGBUS, so check is_intact() before handing out the data.
+    class MemoryMappedFile
+    {
+        public:
+            explicit MemoryMappedFile(const Path& path);
+
+            ~MemoryMappedFile();
+
+            MemoryMappedFile(const MemoryMappedFile&) = delete;
+
+            MemoryMappedFile(MemoryMappedFile&&) = delete;
+
+            MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+            MemoryMappedFile& operator=(MemoryMappedFile&&) = delete;
+
+            /// Determines if the file is mapped into memory.
+            [[nodiscard]] bool is_mapped() const
+            {
+                return mapped != nullptr;
+            }
+
+            /// Gets a pointer to the file contents, or nullptr if not mapped.
+            [[nodiscard]] const uint8_t* data() const
+            {
+                return mapped;
+            }
+
+            /// Gets the size of the mapped file, in bytes.
+            [[nodiscard]] std::size_t size() const
+            {
+                return length;
+            }
+
+            /// Determines if the file still covers all of the mapping, i.e. it has not been truncated
+            /// since it was mapped. A file replaced by another one is fine, the mapping keeps the original.
+            [[nodiscard]] bool is_intact() const;
+
+        private:
+            const uint8_t* mapped = nullptr;
+            std::size_t length = 0;
+            int fd = -1;
+    };
+}
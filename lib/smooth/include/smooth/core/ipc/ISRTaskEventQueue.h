@@ -45,7 +45,11 @@ namespace smooth::core::ipc
 
             static auto create(Task& task, IEventListener<DataType>& listener)
             {
-                return smooth::core::util::create_protected_shared<ISRTaskEventQueue<DataType, Size>>(task, listener);
+                auto queue = smooth::core::util::create_protected_shared<ISRTaskEventQueue<DataType, Size>>(task,
+                                                                                                            listener);
+                queue->notification_id = queue->notification->register_queue(queue, Size);
+
+                return queue;
             }
 
             ~ISRTaskEventQueue() override;
@@ -70,7 +74,7 @@ namespace smooth::core::ipc
                     && uxQueueMessagesWaiting(queue) > 0)
                 {
                     read_since_poll = false;
-                    notification->notify(this->shared_from_this());
+                    notification->notify(notification_id);
                 }
             }
 
@@ -84,6 +88,7 @@ namespace smooth::core::ipc
             Task& task;
             IEventListener<DataType>& listener;
             QueueNotification* notification = nullptr;
+            int notification_id = -1;
             bool read_since_poll = true;
     };
 
@@ -140,5 +145,6 @@ namespace smooth::core::ipc
     ISRTaskEventQueue<DataType, Size>::~ISRTaskEventQueue()
     {
         task.unregister_polled_queue_with_task(this);
+        notification->unregister_queue(notification_id);
     }
 }
@@ -0,0 +1,213 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace smooth::core::ipc
+{
+    /// A bounded, lock-free queue for many producers and a single consumer (MPSC), with a
+    /// faster path for when there is only a single producer (SPSC).
+    ///
+    /// Each slot carries a sequence number that tells producers and the consumer whether the slot
+    /// is free to write or ready to read, so neither side ever takes a lock. Producers claim a slot
+    /// with a compare-and-swap on the write position, which is skipped entirely in single producer mode.
+    ///
+    /// Only one thread may call pop() at any time. In single producer mode, only one thread may call push().
+    /// As with Queue<T>, T must be default constructible and copy- or move-assignable.
+    /// \tparam T The type of object to hold in the queue.
+    template<typename T>
+    class LockFreeQueue
+    {
+        public:
+            /// Constructor
+            /// \param size The number of items the queue can hold.
+            /// \param single_producer If true, only a single thread may push items onto the queue.
+            LockFreeQueue(int size, bool single_producer)
+                    : capacity(static_cast<size_t>(size > 0 ? size : 0)),
+                      single_producer(single_producer),
+                      cells(std::make_unique<Cell[]>(capacity))
+            {
+                for (size_t i = 0; i < capacity; ++i)
+                {
+                    cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            LockFreeQueue(const LockFreeQueue&) = delete;
+
+            LockFreeQueue(LockFreeQueue&&) = delete;
+
+            LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+            LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+
+            ~LockFreeQueue() = default;
+
+            /// Gets the size of the queue.
+            /// \return number of items the queue can hold.
+            int size() const
+            {
+                return static_cast<int>(capacity);
+            }
+
+            /// Pushes a copy of an item onto the queue.
+            /// \return true if the queue could accept the item, otherwise false.
+            bool push(const T& item)
+            {
+                return emplace(item);
+            }
+
+            /// Moves an item onto the queue.
+            /// \return true if the queue could accept the item, otherwise false, in which case item is left untouched.
+            bool push(T&& item)
+            {
+                return emplace(std::move(item));
+            }
+
+            /// Pops an item off the queue. Must only be called from the consuming thread.
+            /// \param target A reference to an instance of T which will be move-assigned the item taken from the queue.
+            /// \return true if an item could be received, otherwise false.
+            bool pop(T& target)
+            {
+                bool res = false;
+
+                if (capacity > 0)
+                {
+                    auto pos = read_pos.load(std::memory_order_relaxed);
+                    auto& cell = cells[pos % capacity];
+
+                    // The slot is ready when the producer has published it, i.e. its sequence is one ahead.
+                    res = cell.sequence.load(std::memory_order_acquire) == pos + 1;
+
+                    if (res)
+                    {
+                        target = std::move(cell.data);
+                        // As in Queue<T>, don't let the slot hold on to a copied-out item until the next lap.
+                        cell.data = T{};
+
+                        // Hand the slot back to producers for use on the next lap.
+                        cell.sequence.store(pos + capacity, std::memory_order_release);
+                        read_pos.store(pos + 1, std::memory_order_relaxed);
+                    }
+                }
+
+                return res;
+            }
+
+            /// Returns a value indicating if the queue has no item ready to be popped.
+            /// Exact when called from the consuming thread, otherwise a snapshot.
+            bool empty() const
+            {
+                bool res = true;
+
+                if (capacity > 0)
+                {
+                    auto pos = read_pos.load(std::memory_order_relaxed);
+                    res = cells[pos % capacity].sequence.load(std::memory_order_acquire) != pos + 1;
+                }
+
+                return res;
+            }
+
+            /// Returns the number of items waiting to be popped.
+            /// As producers and the consumer run concurrently this is only a snapshot.
+            int count() const
+            {
+                auto read = read_pos.load(std::memory_order_relaxed);
+                auto write = write_pos.load(std::memory_order_relaxed);
+
+                return write > read ? static_cast<int>(write - read) : 0;
+            }
+
+        private:
+            template<typename Item>
+            bool emplace(Item&& item)
+            {
+                if (capacity == 0)
+                {
+                    return false;
+                }
+
+                auto pos = write_pos.load(std::memory_order_relaxed);
+                Cell* cell = nullptr;
+
+                if (single_producer)
+                {
+                    cell = &cells[pos % capacity];
+
+                    if (cell->sequence.load(std::memory_order_acquire) != pos)
+                    {
+                        // Consumer has not yet freed this slot; the queue is full.
+                        return false;
+                    }
+
+                    write_pos.store(pos + 1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    for (bool claimed = false; !claimed; )
+                    {
+                        cell = &cells[pos % capacity];
+                        auto seq = cell->sequence.load(std::memory_order_acquire);
+
+                        if (seq == pos)
+                        {
+                            // Slot is free, try to claim it. On failure pos is updated to the current value.
+                            claimed = write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed);
+                        }
+                        else if (seq < pos)
+                        {
+                            // Slot still holds an item from the previous lap; the queue is full.
+                            return false;
+                        }
+                        else
+                        {
+                            // Another producer claimed the slot before us, retry with the latest position.
+                            pos = write_pos.load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                cell->data = std::forward<Item>(item);
+                cell->sequence.store(pos + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            // Keep positions and slots on separate cache lines to avoid producers and the consumer
+            // invalidating each other's cache on every operation.
+            static constexpr size_t cache_line_size = 64;
+
+            struct Cell
+            {
+                std::atomic<size_t> sequence{ 0 };
+                T data{};
+            };
+
+            const size_t capacity;
+            const bool single_producer;
+            std::unique_ptr<Cell[]> cells;
+            alignas(cache_line_size) std::atomic<size_t> write_pos{ 0 };
+            alignas(cache_line_size) std::atomic<size_t> read_pos{ 0 };
+    };
+}
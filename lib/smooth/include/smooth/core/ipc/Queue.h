@@ -22,6 +22,7 @@ limitations under the License.
 #include <vector>
 #include <mutex>
 #include <algorithm>
+#include <utility>
 #include "smooth/core/logging/log.h"
 
 using namespace smooth::core::logging;
@@ -33,22 +34,23 @@ namespace smooth::core::ipc
     /// more specialized implementations, such as the TaskEventQueue and SubscribingTaskEventQueue.
     /// Please note that this implementation supports actual C++ objects as opposed to the FreeRTOS
     /// plain data-only queues. This means that you can place any type of C++ object on these queues
-    /// as long as the objects are copyable (the default copy constructor and assignment operator are enough)
-    /// Items are placed on the queue by copy, not by reference.
+    /// as long as the objects are default constructible and copyable or movable.
+    /// Items are placed on the queue by copy or move, not by reference.
+    ///
+    /// The storage is a fixed-size ring allocated up front, so both push and pop are O(1) regardless
+    /// of how many items are queued and the queue itself never allocates after construction.
     /// \tparam T The type of object to hold in the queue.
     template<typename T>
     class Queue
     {
         public:
             /// Constructor
-            /// \param name The name of the queue, mainly used for debugging and logging.
             /// \param size The size of the queue, i.e. the number of items it can hold.
             explicit Queue(int size)
                     : queue_size(size),
-                      items(),
+                      items(static_cast<size_t>(std::max(size, 0))),
                       guard()
             {
-                items.reserve(static_cast<size_t>(size));
             }
 
             /// Destructor
@@ -74,29 +76,54 @@ namespace smooth::core::ipc
             {
                 std::lock_guard<std::mutex> lock(guard);
 
-                bool res = items.size() < static_cast<size_t>(queue_size);
+                bool res = item_count < items.size();
 
                 if (res)
                 {
-                    items.emplace_back(item);
+                    items[write_pos] = item;
+                    advance(write_pos);
+                    ++item_count;
+                }
+
+                return res;
+            }
+
+            /// Pushes an item into the queue by moving it.
+            /// \param item The item to move into the queue. Left untouched if the queue is full.
+            /// \return true if the queue could accept the item, otherwise false.
+            bool push(T&& item)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                bool res = item_count < items.size();
+
+                if (res)
+                {
+                    items[write_pos] = std::move(item);
+                    advance(write_pos);
+                    ++item_count;
                 }
 
                 return res;
             }
 
             /// Pops an item off the queue.
-            /// \param target A reference to an instance of T which will be assigned the item taken from the queue.
+            /// \param target A reference to an instance of T which will be move-assigned the item taken from the queue.
             /// \return true if an item could be received, otherwise false.
             bool pop(T& target)
             {
                 std::lock_guard<std::mutex> lock(guard);
 
-                bool res = items.size() > 0;
+                bool res = item_count > 0;
 
                 if (res)
                 {
-                    target = items.front();
-                    items.erase(items.begin());
+                    target = std::move(items[read_pos]);
+                    // Types without move assignment are copied out, so release whatever the slot
+                    // holds on to now rather than when it is next written.
+                    items[read_pos] = T{};
+                    advance(read_pos);
+                    --item_count;
                 }
 
                 return res;
@@ -115,12 +142,23 @@ namespace smooth::core::ipc
             {
                 std::lock_guard<std::mutex> lock(guard);
 
-                return static_cast<int>(items.size());
+                return static_cast<int>(item_count);
             }
 
         private:
+            void advance(size_t& pos) const
+            {
+                if (++pos == items.size())
+                {
+                    pos = 0;
+                }
+            }
+
             const int queue_size;
             std::vector<T> items;
+            size_t read_pos = 0;
+            size_t write_pos = 0;
+            size_t item_count = 0;
             std::mutex guard;
     };
 }
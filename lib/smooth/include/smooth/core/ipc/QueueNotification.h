@@ -15,16 +15,27 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <deque>
+#include <functional>
 #include <memory>
+#include <vector>
 #include "ITaskEventQueue.h"
 
 namespace smooth::core::ipc
 {
+    /// Keeps track of which of a Task's queues have events available, and in which order they arrived.
+    ///
+    /// Each queue is registered once and given an id. A notification only records that id in a ring
+    /// sized by the total capacity of the registered queues, so notifying never allocates. Each queue
+    /// also counts its notifications that have not yet been handled, so its slot is only reused once
+    /// all of them have been handled, even if the queue has been destroyed in the meantime.
     class QueueNotification
     {
         public:
@@ -32,20 +43,72 @@ namespace smooth::core::ipc
 
             ~QueueNotification() = default;
 
-            void notify(const std::weak_ptr<ITaskEventQueue>& queue);
+            QueueNotification(const QueueNotification&) = delete;
+
+            QueueNotification(QueueNotification&&) = delete;
+
+            QueueNotification& operator=(const QueueNotification&) = delete;
+
+            QueueNotification& operator=(QueueNotification&&) = delete;
+
+            /// Registers a queue.
+            /// \param queue The queue to register.
+            /// \param size The number of items the queue can hold.
+            /// \return The id to pass to notify() and unregister_queue().
+            int register_queue(const std::weak_ptr<ITaskEventQueue>& queue, int size);
+
+            /// Unregisters a queue. Notifications already made for it are discarded.
+            /// \param id The id returned by register_queue()
+            void unregister_queue(int id);
 
-            void remove_expired_queues();
+            /// Signals that the queue with the given id has an item available.
+            /// \param id The id returned by register_queue()
+            void notify(int id);
 
-            std::weak_ptr<ITaskEventQueue> wait_for_notification(std::chrono::milliseconds timeout);
+            /// Waits for at least one notification, then forwards one event for each of up to max_count
+            /// notifications, in the order the notifications were made. Must only be called by the owning Task.
+            /// \param timeout The maximum time to wait for the first notification.
+            /// \param max_count The maximum number of events to forward.
+            /// \return true if any notifications were handled, false on timeout.
+            bool forward_events(std::chrono::milliseconds timeout, size_t max_count);
 
-            void clear()
+            void clear();
+
+            /// Sets a function that is called each time a notification is made. This allows a Task that
+            /// blocks on something other than its event queues, such as a system call, to be woken up.
+            /// \param callback The function to call. Must be thread-safe and must not block.
+            void set_wake_up(std::function<void()> callback)
             {
                 std::lock_guard<std::mutex> lock(guard);
-                queues.clear();
+                wake_up = std::move(callback);
             }
 
         private:
-            std::deque<std::weak_ptr<ITaskEventQueue>> queues{};
+            struct Slot
+            {
+                std::weak_ptr<ITaskEventQueue> queue{};
+                int id = 0;
+                size_t size = 0;
+                uint32_t pending = 0;
+                bool registered = false;
+            };
+
+            void add_to_ring(int id);
+
+            void grow_ring(size_t new_size);
+
+            void release(Slot& slot);
+
+            // A deque never moves its elements when growing, so a Slot can be accessed without holding the
+            // lock for as long as it has pending notifications.
+            std::deque<Slot> slots{};
+            std::vector<int> free_slots{};
+            std::vector<int> ring{};
+            size_t ring_head = 0;
+            size_t ring_count = 0;
+            size_t registered_size = 0;
+            std::vector<Slot*> batch{};
+            std::function<void()> wake_up{};
             std::mutex guard{};
             std::condition_variable cond{};
     };
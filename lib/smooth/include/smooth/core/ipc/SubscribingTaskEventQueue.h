@@ -48,15 +48,13 @@ namespace smooth::core::ipc
 
             SubscribingTaskEventQueue& operator=(const SubscribingTaskEventQueue&&) = delete;
 
-            bool push(const T& item) override
-            {
-                return this->push_internal(item, this->template shared_from_base<SubscribingTaskEventQueue<T>>());
-            }
-
-            static auto create(int size, Task& task, IEventListener<T>& listener)
+            static auto create(int size, Task& task, IEventListener<T>& listener,
+                               EventQueueType type = EventQueueType::Locking)
             {
                 auto queue = smooth::core::util::create_protected_shared<SubscribingTaskEventQueue<T>>(size, task,
-                                                                                                       listener);
+                                                                                                       listener,
+                                                                                                       type);
+                queue->register_with_notification();
                 queue->link_up();
 
                 return queue;
@@ -69,9 +67,10 @@ namespace smooth::core::ipc
             /// \param task The Task to which to signal when an event is available.
             /// \param listener The receiver of the events. Normally this is the same as the task, but it can be
             /// any object instance.
-            SubscribingTaskEventQueue(int size, Task& task, IEventListener<T>& listener)
+            /// \param type The kind of storage to use for the queue.
+            SubscribingTaskEventQueue(int size, Task& task, IEventListener<T>& listener, EventQueueType type)
                     :
-                      TaskEventQueue<T>(size, task, listener),
+                      TaskEventQueue<T>(size, task, listener, type),
                       link()
             {
             }
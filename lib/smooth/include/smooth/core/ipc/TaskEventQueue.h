@@ -18,17 +18,36 @@ limitations under the License.
 #pragma once
 
 #include "smooth/core/Task.h"
+#include <atomic>
 #include <memory>
 #include "ITaskEventQueue.h"
 #include "IEventListener.h"
 #include "QueueNotification.h"
+#include "LockFreeQueue.h"
 #include "smooth/core/util/create_protected.h"
 
 namespace smooth::core::ipc
 {
+    /// Selects the storage used by a TaskEventQueue.
+    enum class EventQueueType
+    {
+        /// Mutex protected queue. Each event is signaled to the owning Task individually,
+        /// so events from several queues owned by the same Task are received in the order they were sent.
+        Locking,
+        /// Lock-free queue that accepts events from any number of threads.
+        LockFreeMultiProducer,
+        /// Lock-free queue that only ever receives events from a single thread.
+        LockFreeSingleProducer
+    };
+
     /// TaskEventQueue expands the functionality of the Queue<T> by, together with the Task, adding the ability
     /// to signal a Task when an item is available, making polling a queue unnecessary which frees up the task
     /// to do other things.
+    ///
+    /// The lock-free queue types avoid taking any lock when pushing, and only signal the Task when the queue
+    /// goes from empty to non-empty; the Task then keeps coming back to the queue until it is drained.
+    /// The price is that the order of events is only kept within each lock-free queue, not across the
+    /// queues owned by the same Task.
     /// \tparam T The type of events to receive.
     template<typename T>
     class TaskEventQueue
@@ -41,15 +60,19 @@ namespace smooth::core::ipc
             static_assert(std::is_default_constructible<T>::value, "DataType must be default-constructible");
             static_assert(std::is_assignable<T, T>::value, "DataType must be a assignable");
 
-            static auto create(int size, Task& owner_task, IEventListener<T>& event_listener)
+            static auto create(int size, Task& owner_task, IEventListener<T>& event_listener,
+                               EventQueueType type = EventQueueType::Locking)
             {
-                return smooth::core::util::create_protected_shared<TaskEventQueue<T>>(size, owner_task,
-                                                                                      event_listener);
+                auto queue = smooth::core::util::create_protected_shared<TaskEventQueue<T>>(size, owner_task,
+                                                                                            event_listener, type);
+                queue->register_with_notification();
+
+                return queue;
             }
 
             ~TaskEventQueue() override
             {
-                notif->remove_expired_queues();
+                notif->unregister_queue(notification_id);
             }
 
             TaskEventQueue() = delete;
@@ -67,21 +90,21 @@ namespace smooth::core::ipc
             /// \return true if the queue could accept the item, otherwise false.
             virtual bool push(const T& item)
             {
-                return push_internal(item, this->shared_from_this());
+                return push_internal(item);
             }
 
             /// Gets the size of the queue.
             /// \return number of items the queue can hold.
             int size() override
             {
-                return queue.size();
+                return lock_free ? lock_free->size() : queue.size();
             }
 
             /// Returns the number of items waiting to be popped.
             /// \return The number of items in the queue.
             int count()
             {
-                return queue.count();
+                return lock_free ? lock_free->count() : queue.count();
             }
 
             void register_notification(QueueNotification* notification) override
@@ -91,10 +114,19 @@ namespace smooth::core::ipc
 
             void clear()
             {
-                while (!queue.empty())
+                T t;
+
+                if (lock_free)
+                {
+                    while (lock_free->pop(t))
+                    {
+                    }
+                }
+                else
                 {
-                    T t;
-                    queue.pop(t);
+                    while (queue.pop(t))
+                    {
+                    }
                 }
             }
 
@@ -105,22 +137,50 @@ namespace smooth::core::ipc
             /// \param task The Task to which to signal when an event is available.
             /// \param listener The receiver of the events. Normally this is the same as the task, but it can be
             /// any object instance.
-            TaskEventQueue(int size, Task& task, IEventListener<T>& listener)
+            /// \param type The kind of storage to use for the queue.
+            TaskEventQueue(int size, Task& task, IEventListener<T>& listener,
+                           EventQueueType type = EventQueueType::Locking)
                     :
-                      queue(size),
+                      queue(type == EventQueueType::Locking ? size : 0),
+                      lock_free(type == EventQueueType::Locking
+                                ? nullptr
+                                : std::make_unique<LockFreeQueue<T>>(
+                                      size, type == EventQueueType::LockFreeSingleProducer)),
                       task(task),
                       listener(listener)
             {
                 task.register_queue_with_task(this);
             }
 
-            bool push_internal(const T& item, const std::weak_ptr<ITaskEventQueue>& receiver)
+            /// Registers the queue with the owning Task's notification. Must be called by create(),
+            /// as soon as the queue is owned by a shared_ptr.
+            void register_with_notification()
+            {
+                notification_id = notif->register_queue(this->shared_from_this(), size());
+            }
+
+            bool push_internal(const T& item)
             {
-                auto res = queue.push(item);
+                bool res;
+
+                if (lock_free)
+                {
+                    res = lock_free->push(item);
 
-                if (res)
+                    // Only signal the task if it isn't already scheduled to visit this queue.
+                    if (res && !scheduled.exchange(true, std::memory_order_acq_rel))
+                    {
+                        notif->notify(notification_id);
+                    }
+                }
+                else
                 {
-                    notif->notify(receiver);
+                    res = queue.push(item);
+
+                    if (res)
+                    {
+                        notif->notify(notification_id);
+                    }
                 }
 
                 return res;
@@ -133,7 +193,10 @@ namespace smooth::core::ipc
             }
 
             Queue<T> queue;
+            std::unique_ptr<LockFreeQueue<T>> lock_free;
+            std::atomic_bool scheduled{ false };
             QueueNotification* notif = nullptr;
+            int notification_id = -1;
         private:
             void forward_to_event_listener() override
             {
@@ -141,7 +204,24 @@ namespace smooth::core::ipc
                 // and must be copyable and have the assignment operator.
                 T m;
 
-                if (queue.pop(m))
+                if (lock_free)
+                {
+                    // Clear the flag before popping so that a push racing with this call schedules a new visit.
+                    scheduled.exchange(false, std::memory_order_acq_rel);
+                    bool res = lock_free->pop(m);
+
+                    if (!lock_free->empty() && !scheduled.exchange(true, std::memory_order_acq_rel))
+                    {
+                        // More to do, come back after any other queues that are waiting.
+                        notif->notify(notification_id);
+                    }
+
+                    if (res)
+                    {
+                        listener.event(m);
+                    }
+                }
+                else if (queue.pop(m))
                 {
                     listener.event(m);
                 }
@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include "smooth/core/Task.h"
 #include "smooth/core/ipc/TaskEventQueue.h"
@@ -78,6 +79,14 @@ namespace smooth::core::network
                 return rx_buffer.get_proto();
             }
 
+            /// Sets the function that wakes the dispatcher handling the socket, called when data is put in,
+            /// or taken out of, the buffers.
+            void set_wake_up(const std::function<void()>& wake_up)
+            {
+                tx_buffer.set_wake_up(wake_up);
+                rx_buffer.set_wake_up(wake_up);
+            }
+
         private:
             using TxEmptyQueue = smooth::core::ipc::TaskEventQueue<event::TransmitBufferEmptyEvent>;
             std::shared_ptr<TxEmptyQueue> tx_empty;
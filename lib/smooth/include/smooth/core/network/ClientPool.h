@@ -17,8 +17,11 @@ limitations under the License.
 
 #pragma once
 
+#include <chrono>
 #include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <algorithm>
 
@@ -32,6 +35,7 @@ namespace smooth::core::network
     /// ClientPool holds a number of client instances which are requested by the
     /// owning ServerSocket. When a client is done, i.e. connection closed, it
     /// is returned to the pool for reuse at a later time.
+    /// Clients are taken by the socket dispatcher and returned by the task they run on.
     /// \tparam Client The client type held by the pool.
     template<typename Client>
     class ClientPool
@@ -41,6 +45,8 @@ namespace smooth::core::network
 
             bool empty() const
             {
+                std::lock_guard<std::mutex> lock{ guard };
+
                 return clients.empty();
             }
 
@@ -48,18 +54,33 @@ namespace smooth::core::network
 
             void return_client(std::shared_ptr<Client> client);
 
+            /// Sets a function to call, on the task returning it, after a client has been returned to the pool.
+            void set_client_returned(std::function<void()> callback)
+            {
+                client_returned = std::move(callback);
+            }
+
+            /// Disconnects the client in use that has received nothing for the longest time of those that are
+            /// idle, have nothing left to send and are not already being disconnected. It is returned to the pool
+            /// once disconnected.
+            /// \return true if a client is being disconnected.
+            bool evict_idlest();
+
             template<typename... Args>
             void create_clients(Args ... args);
 
         private:
             smooth::core::Task& task;
+            mutable std::mutex guard{};
             std::deque<std::shared_ptr<Client>> clients{};
             std::vector<std::shared_ptr<Client>> in_use{};
+            std::function<void()> client_returned{};
     };
 
     template<typename Client>
     std::shared_ptr<Client> ClientPool<Client>::get()
     {
+        std::lock_guard<std::mutex> lock{ guard };
         std::shared_ptr<Client> c{};
 
         if (!clients.empty())
@@ -75,15 +96,61 @@ namespace smooth::core::network
     template<typename Client>
     void ClientPool<Client>::return_client(std::shared_ptr<Client> client)
     {
-        client->reset();
-        auto found = std::find(in_use.begin(), in_use.end(), client);
+        {
+            std::lock_guard<std::mutex> lock{ guard };
+            client->reset();
+            auto found = std::find(in_use.begin(), in_use.end(), client);
+
+            if (found != in_use.end())
+            {
+                in_use.erase(found);
+            }
+
+            clients.push_back(std::move(client));
+        }
+
+        if (client_returned)
+        {
+            client_returned();
+        }
+    }
+
+    template<typename Client>
+    bool ClientPool<Client>::evict_idlest()
+    {
+        std::shared_ptr<Client> idlest{};
+
+        {
+            std::lock_guard<std::mutex> lock{ guard };
+            std::chrono::milliseconds longest{ -1 };
+
+            for (const auto& c : in_use)
+            {
+                if (!c->evicted && c->socket && c->is_idle() && !c->socket->has_data_to_transmit())
+                {
+                    auto idle_time = c->socket->get_receive_idle_time();
+
+                    if (idle_time > longest)
+                    {
+                        longest = idle_time;
+                        idlest = c;
+                    }
+                }
+            }
+
+            if (idlest)
+            {
+                idlest->evicted = true;
+            }
+        }
 
-        if (found != in_use.end())
+        if (idlest)
         {
-            in_use.erase(found);
+            // Outside the lock, as the client is returned to the pool once disconnected.
+            idlest->socket->stop("Evicted to make room for a new connection");
         }
 
-        clients.push_back(std::move(client));
+        return idlest != nullptr;
     }
 
     template<typename Client>
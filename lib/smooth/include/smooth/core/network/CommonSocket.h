@@ -26,6 +26,7 @@ limitations under the License.
 #include <netinet/in.h>
 #endif
 
+#include <atomic>
 #include <chrono>
 #include "smooth/core/timer/ElapsedTime.h"
 
@@ -72,7 +73,22 @@ namespace smooth::core::network
                 return receive_timeout;
             }
 
+            std::chrono::milliseconds get_receive_idle_time() const override
+            {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed_receive_time.get_running_time());
+            }
+
+            void pause_receive(bool paused) override;
+
+            bool is_receive_paused() const override
+            {
+                return receive_paused;
+            }
+
         protected:
+            /// Assigns the socket to the least loaded dispatcher shard the first time it is called.
+            SocketDispatcher& get_dispatcher() override;
+
             bool set_non_blocking();
 
             void log(const char* message);
@@ -90,7 +106,9 @@ namespace smooth::core::network
 
             bool has_receive_expired() const override
             {
-                return receive_timeout.count() > 0
+                // Not receiving anything is expected while paused.
+                return !receive_paused
+                       && receive_timeout.count() > 0
                        && elapsed_receive_time.is_running()
                        && elapsed_receive_time.get_running_time() > receive_timeout;
             }
@@ -103,5 +121,7 @@ namespace smooth::core::network
             std::chrono::milliseconds receive_timeout{ 0 };
             smooth::core::timer::ElapsedTime elapsed_send_time{};
             smooth::core::timer::ElapsedTime elapsed_receive_time{};
+            std::atomic<bool> receive_paused{ false };
+            std::atomic<SocketDispatcher*> dispatcher{ nullptr };
     };
 }
@@ -0,0 +1,75 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#ifdef __linux__
+
+#include <cstdint>
+#include <unordered_map>
+#include <sys/epoll.h>
+#include "IReadinessBackend.h"
+#include "WakeUpSignal.h"
+
+namespace smooth::core::network
+{
+    /// Readiness backend based on epoll, only available on Linux. Interest is registered with
+    /// the kernel and only updated when it changes, so the cost of a wait is proportional to
+    /// the number of ready sockets rather than the number of monitored sockets.
+    class EpollReadinessBackend
+        : public IReadinessBackend
+    {
+        public:
+            EpollReadinessBackend();
+
+            ~EpollReadinessBackend() override;
+
+            EpollReadinessBackend(const EpollReadinessBackend&) = delete;
+
+            EpollReadinessBackend(EpollReadinessBackend&&) = delete;
+
+            EpollReadinessBackend& operator=(const EpollReadinessBackend&) = delete;
+
+            EpollReadinessBackend& operator=(EpollReadinessBackend&&) = delete;
+
+            void set_interest(int socket_id, bool read, bool write) override;
+
+            void remove(int socket_id) override;
+
+            bool wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready) override;
+
+            bool open_wake_up() override;
+
+            [[nodiscard]] bool can_wake_up() const override
+            {
+                return wake.is_open();
+            }
+
+            void wake_up() override
+            {
+                wake.signal();
+            }
+
+        private:
+            int epoll_fd;
+            std::unordered_map<int, uint32_t> interest{};
+            std::vector<epoll_event> events{};
+            WakeUpSignal wake{};
+    };
+}
+
+#endif
@@ -18,6 +18,7 @@ limitations under the License.
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 namespace smooth::core::network
 {
@@ -58,6 +59,14 @@ namespace smooth::core::network
             /// \return true or false
             virtual bool is_error() = 0;
 
+            /// Called when a packet is complete. Moves any data received beyond the end of the packet, such as
+            /// the start of a pipelined request, to target. The data is then passed on again, as if received
+            /// anew, when assembling the next packet.
+            /// \param target Where to place the excess data, is empty when called.
+            virtual void take_excess_data(std::vector<uint8_t>& /*target*/)
+            {
+            }
+
             /// Tells the protocol that the current working-package has been consumed.
             virtual void packet_consumed() = 0;
 
@@ -14,25 +14,48 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 */
-
 #pragma once
 
 #include <cstdint>
 
 namespace smooth::core::network
 {
+    /// A contiguous part of a packet
+    struct PacketSegment
+    {
+        const uint8_t* data;
+        int length;
+    };
+
     /// Interface for packets that can be disassembled into a series of bytes
     class IPacketDisassembly
     {
         public:
-            /// Must return the total amount of bytes to send
+            /// Must return the total amount of bytes to send, i.e. the sum of the length of all segments.
             /// \return Number of bytes to send
             virtual int get_send_length() = 0;
 
-            /// Must return a pointer to the data to be sent.
+            /// Must return a pointer to the data to be sent, i.e. the start of the first segment.
             /// \return The read position
             virtual const uint8_t* get_data() = 0;
 
+            /// Returns the number of segments the packet consists of. Packets that keep their parts
+            /// (such as headers and content) in separate buffers can override this and get_segment()
+            /// to have them sent as-is, without first copying them into a single buffer.
+            /// \return Number of segments, at least 1.
+            virtual int get_segment_count()
+            {
+                return 1;
+            }
+
+            /// Returns the segment at the given index.
+            /// \param index 0 <= index < get_segment_count()
+            /// \return The segment
+            virtual PacketSegment get_segment(int /*index*/)
+            {
+                return { get_data(), get_send_length() };
+            }
+
             virtual ~IPacketDisassembly() = default;
     };
 }
@@ -18,6 +18,7 @@ limitations under the License.
 #pragma once
 
 #include <mutex>
+#include <vector>
 
 namespace smooth::core::network
 {
@@ -81,6 +82,10 @@ namespace smooth::core::network
             /// \return true of false.
             virtual bool is_packet_complete() = 0;
 
+            /// Moves data received beyond the end of the completed packet to target, see
+            /// IPacketAssembly::take_excess_data().
+            virtual void take_excess_data(std::vector<uint8_t>& target) = 0;
+
             /// Gets the current packet. Don't call before is_packet_complete() returns true.
             /// \param target The instance which will be assigned the data.
             /// \return True if the packet could be received.
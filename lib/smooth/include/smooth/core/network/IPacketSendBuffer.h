@@ -18,6 +18,7 @@ limitations under the License.
 #pragma once
 
 #include <cstdint>
+#include "IPacketDisassembly.h"
 
 namespace smooth::core::network
 {
@@ -37,13 +38,23 @@ namespace smooth::core::network
             /// \return A pointer to the first byte of the data to send.
             virtual const uint8_t* get_data_to_send() = 0;
 
-            /// Gets the number of bytes to be sent.
-            /// \return The number of bytes remaining to be sent.
+            /// Gets the number of bytes that can be sent in one go from the position returned by get_data_to_send().
+            /// \return The number of contiguous bytes remaining to be sent.
             virtual int get_remaining_data_length() = 0;
 
-            /// Called when the specified amount of data has been sent.
+            /// Gets the remaining segments of the current packet, followed by the segments of the packets
+            /// queued after it, so that they can be sent using a single vectored write. The packets are
+            /// not removed from the buffer; call data_has_been_sent() with the number of bytes actually sent.
+            /// \param segments Where to store the segments.
+            /// \param max_segments Maximum number of segments to store.
+            /// \return The number of segments stored.
+            virtual int get_segments_to_send(PacketSegment* segments, int max_segments) = 0;
+
+            /// Called when the specified amount of data has been sent. If the amount exceeds what
+            /// remains of the current packet, the following packets are consumed in order.
             /// \param length The number of bytes that has been sent.
-            virtual void data_has_been_sent(int length) = 0;
+            /// \return The number of packets that were completely sent.
+            virtual int data_has_been_sent(int length) = 0;
 
             /// Perpares the next packet to be sent.
             virtual void prepare_next_packet() = 0;
@@ -52,6 +63,14 @@ namespace smooth::core::network
             /// \return true if the item could be queued, otherwise false.
             virtual bool put(const Packet& item) = 0;
 
+            /// Moves an item into the buffer to be sent.
+            /// \return true if the item could be queued, otherwise false.
+            virtual bool put(Packet&& item) = 0;
+
+            /// Returns a value indicating if the buffer is full, i.e. if put() would fail.
+            /// \return true or false.
+            virtual bool is_full() = 0;
+
             /// Clears the buffer.
             virtual void clear() = 0;
 
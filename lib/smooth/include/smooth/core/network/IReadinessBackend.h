@@ -0,0 +1,71 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+namespace smooth::core::network
+{
+    /// Readiness of a single socket, as reported by an IReadinessBackend.
+    struct SocketReadiness
+    {
+        int socket_id;
+        bool readable;
+        bool writable;
+    };
+
+    /// Interface for the mechanism the SocketDispatcher uses to wait for sockets to become
+    /// readable or writable, e.g. select(), poll() or epoll.
+    /// Interest is tracked persistently by the backend; the dispatcher only needs to tell
+    /// it when the interest for a socket changes.
+    /// As an application programmer you are not meant to call any of these methods.
+    class IReadinessBackend
+    {
+        public:
+            virtual ~IReadinessBackend() = default;
+
+            /// Sets what events the given socket is of interest for. Calling this method with
+            /// the same values as the previous call must be cheap, i.e. not result in a system call.
+            /// Setting both read and write to false stops monitoring the socket.
+            /// \param socket_id The socket
+            /// \param read If true, the socket will be reported when it is readable.
+            /// \param write If true, the socket will be reported when it is writable.
+            virtual void set_interest(int socket_id, bool read, bool write) = 0;
+
+            /// Stops monitoring the socket. Must be called before the socket is closed.
+            /// \param socket_id The socket
+            virtual void remove(int socket_id) = 0;
+
+            /// Waits until at least one socket is ready, the timeout expires or wake_up() is called.
+            /// \param timeout The maximum time to wait.
+            /// \param ready Receives the sockets that are ready. Cleared before being filled.
+            /// \return false if an error occurred, otherwise true.
+            virtual bool wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready) = 0;
+
+            /// Opens the wake-up mechanism. Must be called when the network stack is available.
+            /// \return true if the backend can be woken up using wake_up().
+            virtual bool open_wake_up() = 0;
+
+            /// \return true if the backend can be woken up using wake_up().
+            [[nodiscard]] virtual bool can_wake_up() const = 0;
+
+            /// Makes a call to wait() return as soon as possible. May be called from any thread.
+            virtual void wake_up() = 0;
+    };
+}
@@ -88,14 +88,35 @@ namespace smooth::core::network
 
             [[nodiscard]] virtual std::chrono::milliseconds get_send_timeout() const = 0;
 
+            /// \return The time since data was last received, or the socket connected.
+            [[nodiscard]] virtual std::chrono::milliseconds get_receive_idle_time() const = 0;
+
+            /// Stops (or resumes) reading from the socket, leaving unread data in the network stack which in turn
+            /// makes the remote end slow down. Used to apply backpressure when the application can't keep up.
+            /// May be called from any task.
+            /// \param paused true to stop reading, false to resume.
+            virtual void pause_receive(bool paused) = 0;
+
+            /// \return true if reading from the socket is paused.
+            [[nodiscard]] virtual bool is_receive_paused() const = 0;
+
+            /// \return true if there is data waiting to be sent. Called from the socket dispatcher.
+            [[nodiscard]] virtual bool has_data_to_transmit() = 0;
+
         protected:
+            /// \return The dispatcher shard the socket is assigned to.
+            virtual SocketDispatcher& get_dispatcher() = 0;
+
             [[nodiscard]] virtual bool is_connected() const = 0;
 
             virtual void readable(ISocketBackOff& ops) = 0;
 
             virtual void writable() = 0;
 
-            [[nodiscard]] virtual bool has_data_to_transmit() = 0;
+            /// Returns true if the socket holds data, already read from the network, which it is
+            /// ready to pass on. Such data does not make the socket readable so the SocketDispatcher
+            /// must call readable() without waiting for that.
+            [[nodiscard]] virtual bool has_buffered_data() = 0;
 
             [[nodiscard]] virtual bool internal_start() = 0;
 
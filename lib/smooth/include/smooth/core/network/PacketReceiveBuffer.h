@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <functional>
 #include <mutex>
 #include <memory>
 #include "smooth/core/util/CircularBuffer.h"
@@ -83,11 +84,35 @@ namespace smooth::core::network
                 return proto->is_complete(current_item);
             }
 
-            bool get(Packet& target) override
+            void take_excess_data(std::vector<uint8_t>& target) override
             {
                 std::unique_lock<std::mutex> lock(guard);
+                proto->take_excess_data(target);
+            }
+
+            bool get(Packet& target) override
+            {
+                bool res;
+                std::function<void()> wake_up;
+
+                {
+                    std::unique_lock<std::mutex> lock(guard);
+                    auto was_full = buffer.is_full();
+                    res = buffer.get(target);
+
+                    if (res && was_full)
+                    {
+                        wake_up = wake_up_dispatcher;
+                    }
+                }
 
-                return buffer.get(target);
+                if (wake_up)
+                {
+                    // The socket may be holding on to data it could not pass on while the buffer was full.
+                    wake_up();
+                }
+
+                return res;
             }
 
             void clear() override
@@ -131,6 +156,15 @@ namespace smooth::core::network
                 return *proto;
             }
 
+            /// Sets the function to call when data is put in, or taken out of, the buffer and the socket
+            /// dispatcher has to take note, i.e. the wake-up of the dispatcher handling the socket.
+            /// \param wake_up The function to call. Must be thread-safe and must not block.
+            void set_wake_up(std::function<void()> wake_up)
+            {
+                std::unique_lock<std::mutex> lock(guard);
+                wake_up_dispatcher = std::move(wake_up);
+            }
+
         private:
             void ReplacePacketWithDefault()
             {
@@ -143,5 +177,6 @@ namespace smooth::core::network
             Packet current_item{};
             std::unique_ptr<Protocol> proto;
             smooth::core::util::CircularBuffer<Packet, Size> buffer{};
+            std::function<void()> wake_up_dispatcher{};
     };
 }
@@ -19,13 +19,16 @@ limitations under the License.
 
 #include "smooth/core/util/CircularBuffer.h"
 #include "IPacketSendBuffer.h"
+#include <functional>
 #include <mutex>
+#include <utility>
 
 namespace smooth::core::network
 {
     /// PacketSendBuffer is a buffer that can hold Size packets of type T, with
     /// byte access to each individual element which makes it easy to perform
-    /// send() operations directly on each packet.
+    /// send() operations directly on each packet, or a single vectored send() covering
+    /// several packets.
     /// T must provide the IPacketDisassembly interface (either directly or via inheritance) and fulfill the following
     // contract:
     /// * Default constructable
@@ -37,17 +40,14 @@ namespace smooth::core::network
         : public IPacketSendBuffer<Protocol>
     {
         public:
-            bool put(const Packet& item)
+            bool put(const Packet& item) override
             {
-                std::lock_guard<std::mutex> lock(guard);
-                bool res = !buffer.is_full();
-
-                if (res)
-                {
-                    buffer.put(item);
-                }
+                return put_item(item);
+            }
 
-                return res;
+            bool put(Packet&& item) override
+            {
+                return put_item(std::move(item));
             }
 
             bool is_in_progress() override
@@ -60,33 +60,83 @@ namespace smooth::core::network
             const uint8_t* get_data_to_send() override
             {
                 std::lock_guard<std::mutex> lock(guard);
+                skip_empty_segments();
 
-                return current_item.get_data() + bytes_sent;
+                return current_item.get_segment(segment_ix).data + segment_offset;
             }
 
             int get_remaining_data_length() override
             {
                 std::lock_guard<std::mutex> lock(guard);
+                skip_empty_segments();
+
+                return current_item.get_segment(segment_ix).length - segment_offset;
+            }
+
+            int get_segments_to_send(PacketSegment* segments, int max_segments) override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                int count = 0;
+
+                if (in_progress)
+                {
+                    count = add_segments(current_item, segment_ix, segment_offset, segments, count, max_segments);
+
+                    for (int i = 0; i < buffer.available_items() && count < max_segments; ++i)
+                    {
+                        count = add_segments(buffer.peek(i), 0, 0, segments, count, max_segments);
+                    }
+                }
 
-                return current_item.get_send_length() - bytes_sent;
+                return count;
             }
 
-            void data_has_been_sent(int length) override
+            int data_has_been_sent(int length) override
             {
                 std::lock_guard<std::mutex> lock(guard);
-                bytes_sent += length;
+                int completed = 0;
 
-                if (bytes_sent >= current_item.get_send_length())
+                while (in_progress)
                 {
+                    auto segment_count = current_item.get_segment_count();
+
+                    for (; segment_ix < segment_count; ++segment_ix, segment_offset = 0)
+                    {
+                        auto remaining = current_item.get_segment(segment_ix).length - segment_offset;
+
+                        if (length < remaining)
+                        {
+                            segment_offset += length;
+                            length = 0;
+                            break;
+                        }
+
+                        length -= remaining;
+                    }
+
+                    if (segment_ix < segment_count)
+                    {
+                        // Current packet only partially sent
+                        break;
+                    }
+
+                    ++completed;
                     in_progress = false;
+
+                    if (length > 0)
+                    {
+                        // Data from the following packet(s) has also been sent.
+                        start_next_packet();
+                    }
                 }
+
+                return completed;
             }
 
             void prepare_next_packet() override
             {
                 std::lock_guard<std::mutex> lock(guard);
-                in_progress = buffer.get(current_item);
-                bytes_sent = 0;
+                start_next_packet();
             }
 
             void clear() override
@@ -94,7 +144,15 @@ namespace smooth::core::network
                 std::lock_guard<std::mutex> lock(guard);
                 buffer.clear();
                 in_progress = false;
-                bytes_sent = 0;
+                segment_ix = 0;
+                segment_offset = 0;
+            }
+
+            bool is_full() override
+            {
+                std::lock_guard<std::mutex> lock(guard);
+
+                return buffer.is_full();
             }
 
             bool is_empty() override
@@ -104,11 +162,85 @@ namespace smooth::core::network
                 return !in_progress && buffer.is_empty();
             }
 
+            /// Sets the function to call when data is put in, or taken out of, the buffer and the socket
+            /// dispatcher has to take note, i.e. the wake-up of the dispatcher handling the socket.
+            /// \param wake_up The function to call. Must be thread-safe and must not block.
+            void set_wake_up(std::function<void()> wake_up)
+            {
+                std::lock_guard<std::mutex> lock(guard);
+                wake_up_dispatcher = std::move(wake_up);
+            }
+
         private:
+            template<typename T>
+            bool put_item(T&& item)
+            {
+                bool res;
+                std::function<void()> wake_up;
+
+                {
+                    std::lock_guard<std::mutex> lock(guard);
+                    res = !buffer.is_full();
+
+                    if (res)
+                    {
+                        buffer.put(std::forward<T>(item));
+                        wake_up = wake_up_dispatcher;
+                    }
+                }
+
+                if (wake_up)
+                {
+                    // Let the dispatcher know there is something to send.
+                    wake_up();
+                }
+
+                return res;
+            }
+
+            void start_next_packet()
+            {
+                in_progress = buffer.get(current_item);
+                segment_ix = 0;
+                segment_offset = 0;
+            }
+
+            void skip_empty_segments()
+            {
+                auto last = current_item.get_segment_count() - 1;
+
+                while (segment_ix < last
+                       && current_item.get_segment(segment_ix).length == segment_offset)
+                {
+                    ++segment_ix;
+                    segment_offset = 0;
+                }
+            }
+
+            static int add_segments(Packet& packet, int first, int offset,
+                                    PacketSegment* segments, int count, int max_segments)
+            {
+                auto segment_count = packet.get_segment_count();
+
+                for (int i = first; i < segment_count && count < max_segments; ++i, offset = 0)
+                {
+                    auto segment = packet.get_segment(i);
+
+                    if (segment.length > offset)
+                    {
+                        segments[count++] = { segment.data + offset, segment.length - offset };
+                    }
+                }
+
+                return count;
+            }
+
             Packet current_item{};
             std::mutex guard{};
-            int bytes_sent = 0;
+            int segment_ix = 0;
+            int segment_offset = 0;
             bool in_progress = false;
             smooth::core::util::CircularBuffer<Packet, Size> buffer{};
+            std::function<void()> wake_up_dispatcher{};
     };
 }
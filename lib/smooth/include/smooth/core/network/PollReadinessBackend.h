@@ -0,0 +1,59 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <sys/poll.h>
+#include "IReadinessBackend.h"
+#include "WakeUpSignal.h"
+
+namespace smooth::core::network
+{
+    /// Readiness backend based on poll(). The pollfd array is kept between waits and only
+    /// modified when the interest of a socket changes.
+    class PollReadinessBackend
+        : public IReadinessBackend
+    {
+        public:
+            PollReadinessBackend();
+
+            void set_interest(int socket_id, bool read, bool write) override;
+
+            void remove(int socket_id) override;
+
+            bool wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready) override;
+
+            bool open_wake_up() override;
+
+            [[nodiscard]] bool can_wake_up() const override
+            {
+                return wake.is_open();
+            }
+
+            void wake_up() override
+            {
+                wake.signal();
+            }
+
+        private:
+            // The first entry is reserved for the wake-up signal.
+            std::vector<pollfd> fds{};
+            std::unordered_map<int, std::size_t> index{};
+            WakeUpSignal wake{};
+    };
+}
@@ -0,0 +1,50 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace smooth::core::network
+{
+    /// What a ServerSocket does with new connections while all of its clients are in use.
+    enum class PoolExhaustionPolicy
+    {
+        /// Connections wait in the listen backlog and are accepted as soon as a client is available.
+        Queue,
+        /// Connections are accepted and closed right away, after being sent the rejection response, if any.
+        Reject,
+        /// The client that has received nothing for the longest time, of those that are idle, is disconnected
+        /// to make room for the new connection, which waits as with Queue until it is. If no client is idle,
+        /// this is the same as Queue.
+        EvictIdlest
+    };
+
+    /// Counts what happened to incoming connections on a ServerSocket.
+    struct AcceptStatistics
+    {
+        /// Connections handed to a client.
+        uint32_t accepted{ 0 };
+        /// Times accepting was put on hold until a client was available.
+        uint32_t queued{ 0 };
+        /// Connections closed as no client was available.
+        uint32_t rejected{ 0 };
+        /// Idle clients disconnected to make room for new connections.
+        uint32_t evicted{ 0 };
+    };
+}
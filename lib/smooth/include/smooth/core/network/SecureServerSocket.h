@@ -60,7 +60,9 @@ namespace smooth::core::network
                 server_context.init_server(ca_chain, own_cert, private_key, password);
             }
 
-            void readable(ISocketBackOff& ops) override;
+            void add_client(const std::shared_ptr<InetAddress>& ip, int socket_id, Client& client) override;
+
+            void reject(int socket_id) override;
 
         private:
             MBedTLSContext server_context{};
@@ -91,21 +93,24 @@ namespace smooth::core::network
     }
 
     template<typename Client, typename Protocol, typename ClientContext>
-    void SecureServerSocket<Client, Protocol, ClientContext>::readable(ISocketBackOff& ops)
+    void SecureServerSocket<Client, Protocol, ClientContext>::add_client(const std::shared_ptr<InetAddress>& ip,
+                                                                         int socket_id,
+                                                                         Client& client)
     {
-        const auto& [ip, accepted_socket_id] = this->accept_request(ops);
+        auto socket = SecureSocket<Protocol>::create(ip,
+                                                     socket_id,
+                                                     client.get_buffers(),
+                                                     server_context.create_context(),
+                                                     client.get_send_timeout());
 
-        if (ip)
-        {
-            auto client = this->pool.get();
-            auto socket = SecureSocket<Protocol>::create(ip,
-                                                         accepted_socket_id,
-                                                         client->get_buffers(),
-                                                         server_context.create_context(),
-                                                         client->get_send_timeout());
+        client.set_client_context(this->client_context);
+        client.set_socket(socket);
+    }
 
-            client->set_client_context(this->client_context);
-            client->set_socket(socket);
-        }
+    template<typename Client, typename Protocol, typename ClientContext>
+    void SecureServerSocket<Client, Protocol, ClientContext>::reject(int socket_id)
+    {
+        // Nothing can be sent without a TLS session, which is too costly to set up just to reject the connection.
+        ::close(socket_id);
     }
 }
@@ -117,6 +117,8 @@ namespace smooth::core::network
 
             bool has_data_to_transmit() override;
 
+            bool has_buffered_data() override;
+
         private:
             static constexpr const char* tag = "SecureSocket";
             std::unique_ptr<SSLContext> secure_context{};
@@ -220,7 +222,20 @@ namespace smooth::core::network
 
         do
         {
-            if (rx.is_full())
+            if (this->read_ahead_pos < this->read_ahead_end)
+            {
+                // Data received beyond the end of a previous packet, such as pipelined requests,
+                // must be passed on before anything still held by mbedtls. Once the receiver is
+                // full, the SocketDispatcher calls readable() again when there is room for more,
+                // see has_buffered_data().
+                if (rx.is_full())
+                {
+                    return;
+                }
+
+                this->consume_read_ahead(container);
+            }
+            else if (rx.is_full())
             {
                 // Receiver is full. Since mbedtls_ssl_read() moves data from the underlying socket, we get no
                 // no more readable-events on it, which results in the SocketDispatcher no longer calling
@@ -259,24 +274,12 @@ namespace smooth::core::network
                 }
                 else
                 {
-                    rx.data_received(read_amount);
-
-                    if (rx.is_error())
-                    {
-                        Log::error(tag, "Assembly error");
-                        rx.prepare_new_packet();
-                        this->stop("Assembly error");
-                    }
-                    else if (rx.is_packet_complete())
-                    {
-                        event::DataAvailableEvent<Protocol> d(&rx);
-                        container->get_data_available()->push(d);
-                        rx.prepare_new_packet();
-                    }
+                    this->packet_data_received(container, read_amount);
                 }
             }
         }
         while (this->is_active()
+               && !this->is_receive_paused()
                && mbedtls_ssl_get_bytes_avail(*secure_context) > 0);
     }
 
@@ -359,4 +362,22 @@ namespace smooth::core::network
         return !is_handshake_complete(*secure_context)
                || Socket<Protocol, Packet>::has_data_to_transmit();
     }
+
+    template<typename Protocol, typename Packet>
+    bool SecureSocket<Protocol, Packet>::has_buffered_data()
+    {
+        auto res = Socket<Protocol, Packet>::has_buffered_data();
+
+        // Data already decrypted by mbedtls, such as that left when reading was paused,
+        // doesn't make the socket readable either.
+        if (!res
+            && is_handshake_complete(*secure_context)
+            && mbedtls_ssl_get_bytes_avail(*secure_context) > 0)
+        {
+            auto cont = this->get_container_or_close();
+            res = cont && !cont->get_rx_buffer().is_full();
+        }
+
+        return res;
+    }
 }
@@ -0,0 +1,81 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <map>
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#include <sys/socket.h>
+#pragma GCC diagnostic pop
+#include "IReadinessBackend.h"
+#include "WakeUpSignal.h"
+
+namespace smooth::core::network
+{
+    /// Readiness backend based on select(). Works everywhere, but is limited to file descriptors
+    /// below FD_SETSIZE and has to rebuild the fd_sets on every wait.
+    class SelectReadinessBackend
+        : public IReadinessBackend
+    {
+        public:
+            void set_interest(int socket_id, bool read, bool write) override;
+
+            void remove(int socket_id) override;
+
+            bool wait(std::chrono::milliseconds timeout, std::vector<SocketReadiness>& ready) override;
+
+            bool open_wake_up() override
+            {
+                return wake.open();
+            }
+
+            [[nodiscard]] bool can_wake_up() const override
+            {
+                return wake.is_open();
+            }
+
+            void wake_up() override
+            {
+                wake.signal();
+            }
+
+        private:
+#ifdef ESP_PLATFORM
+            using FD = size_t;
+#else
+            using FD = int;
+#endif
+
+            struct Interest
+            {
+                bool read;
+                bool write;
+            };
+
+            void clear_sets();
+
+            static void set_fd(int socket_id, fd_set& fd);
+
+            static bool is_fd_set(int socket_id, fd_set& fd);
+
+            std::map<int, Interest> interest{};
+            fd_set read_set{};
+            fd_set write_set{};
+            WakeUpSignal wake{};
+    };
+}
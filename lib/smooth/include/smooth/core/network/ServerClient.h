@@ -68,6 +68,13 @@ namespace smooth::core::network
 
             virtual void reset_client() = 0;
 
+            /// Determines if the client is connected but not handling a request, so that it may be disconnected
+            /// to make room for another connection. Called from the socket dispatcher.
+            [[nodiscard]] virtual bool is_idle() const
+            {
+                return false;
+            }
+
             void event(const smooth::core::network::event::ConnectionStatusEvent& event) final
             {
                 if (event.is_connected())
@@ -120,10 +127,13 @@ namespace smooth::core::network
                 reset_client();
                 socket.reset();
                 container->clear();
+                evicted = false;
             }
 
             smooth::core::network::ClientPool<FinalClientTypeName>& pool;
             ClientContext* client_context{ nullptr };
+            // Set while being disconnected to make room for another connection.
+            bool evicted{ false };
     };
 
     template<typename FinalClientTypeName, typename Protocol, typename ClientContext>
@@ -18,13 +18,16 @@ limitations under the License.
 #pragma once
 
 #include <sys/socket.h>
+#include <atomic>
 #include <cstring>
 #include <memory>
+#include <vector>
 #include "ClientPool.h"
 #include "InetAddress.h"
 #include "ISocket.h"
 #include "IPv4.h"
 #include "IPv6.h"
+#include "PoolExhaustionPolicy.h"
 #include "smooth/core/ipc/TaskEventQueue.h"
 #include "smooth/core/logging/log.h"
 #include "smooth/core/network/SocketDispatcher.h"
@@ -65,7 +68,33 @@ namespace smooth::core::network
                 return true;
             }
 
+            /// Sets what to do with new connections while all clients are in use. The default is
+            /// PoolExhaustionPolicy::Queue.
+            /// \param policy The policy
+            /// \param rejection Data sent to connections closed due to PoolExhaustionPolicy::Reject, such as an error
+            /// response. It is sent without waiting for the socket to be writable, so should be small.
+            void set_pool_exhaustion_policy(PoolExhaustionPolicy policy, std::vector<uint8_t> rejection = {})
+            {
+                exhaustion_policy = policy;
+                rejection_data = std::move(rejection);
+            }
+
+            [[nodiscard]] AcceptStatistics get_accept_statistics() const
+            {
+                return AcceptStatistics{ accepted, queued, rejected, evicted };
+            }
+
+            /// Lets several server sockets, each with its own clients and assigned to a dispatcher shard of its
+            /// own, listen on the same port, with the kernel spreading incoming connections among them. Only
+            /// supported on Linux, and must be set before the socket is started.
+            void set_reuse_port(bool reuse)
+            {
+                reuse_port = reuse;
+            }
+
         protected:
+            /// Accepts the connections waiting in the backlog, as readiness is reported once for any number
+            /// of them.
             void readable(ISocketBackOff& ops) override;
 
             void writable() override;
@@ -73,11 +102,22 @@ namespace smooth::core::network
             virtual std::tuple<std::shared_ptr<smooth::core::network::InetAddress>, int>
             accept_request(ISocketBackOff& ops);
 
+            /// Hands an accepted connection to a client.
+            virtual void add_client(const std::shared_ptr<InetAddress>& ip, int socket_id, Client& client);
+
+            /// Closes a connection for which there is no client, sending it the rejection data first.
+            virtual void reject(int socket_id);
+
             bool has_data_to_transmit() override
             {
                 return false;
             }
 
+            bool has_buffered_data() override
+            {
+                return false;
+            }
+
             bool internal_start() override;
 
             void publish_connected_status() override
@@ -97,12 +137,31 @@ namespace smooth::core::network
                       pool(task, max_client_count), backlog(backlog)
             {
                 pool.create_clients(proto_args...);
+
+                // Called from the task the client runs on.
+                pool.set_client_returned([this]() {
+                                             pause_receive(false);
+                                         });
             }
 
             ClientPool<Client> pool;
             ClientContext* client_context{ nullptr };
         private:
+            /// Leaves new connections waiting in the backlog until a client is available, evicting an idle
+            /// one first if so configured.
+            void wait_for_client();
+
+            /// The most connections accepted per readiness event, to not hold up other sockets for too long.
+            static constexpr int max_accepts_per_wake_up = 16;
+
             int backlog{ 0 };
+            bool reuse_port{ false };
+            PoolExhaustionPolicy exhaustion_policy{ PoolExhaustionPolicy::Queue };
+            std::vector<uint8_t> rejection_data{};
+            std::atomic<uint32_t> accepted{ 0 };
+            std::atomic<uint32_t> queued{ 0 };
+            std::atomic<uint32_t> rejected{ 0 };
+            std::atomic<uint32_t> evicted{ 0 };
     };
 
     template<typename Client, typename Protocol, typename ClientContext>
@@ -119,7 +178,7 @@ namespace smooth::core::network
 
             if (res)
             {
-                SocketDispatcher::instance().perform_op(SocketOperation::Op::Start, shared_from_this());
+                get_dispatcher().perform_op(SocketOperation::Op::Start, shared_from_this());
             }
         }
 
@@ -135,48 +194,57 @@ namespace smooth::core::network
 
         auto res = std::make_tuple<std::shared_ptr<smooth::core::network::InetAddress>, int>(nullptr, 0);
 
-        if (pool.empty())
-        {
-            Log::warning("ServerSocket", "No client available at this time");
-            ops.back_off(socket_id, DefaultReceiveTimeout);
-        }
-        else
-        {
-            sockaddr addr{};
-            socklen_t len{ AF_INET6 };
+        // Large enough for both IPv4 and IPv6 addresses.
+        sockaddr_storage addr{};
+        socklen_t len{ sizeof(addr) };
 
-            auto accepted_socket = accept(socket_id, &addr, &len);
+#ifdef __linux__
+        // Made non-blocking right away, saving the calls otherwise needed to do so.
+        auto accepted_socket = accept4(socket_id, reinterpret_cast<sockaddr*>(&addr), &len,
+                                       SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+        auto accepted_socket = accept(socket_id, reinterpret_cast<sockaddr*>(&addr), &len);
+#endif
 
-            if (accepted_socket == INVALID_SOCKET)
+        if (accepted_socket == INVALID_SOCKET)
+        {
+            // Not an error when there are no more connections waiting.
+            if (errno != EWOULDBLOCK)
             {
                 std::string msg = "Error accepting: ";
                 msg += strerror(errno);
                 loge(msg.c_str());
-            }
-            else
-            {
-                std::shared_ptr<smooth::core::network::InetAddress> ip{};
 
-                if (addr.sa_family == AF_INET)
+                if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
                 {
+                    // Out of resources, give the connections in use a chance to finish before trying again.
+                    ops.back_off(socket_id, DefaultReceiveTimeout);
+                }
+            }
+        }
+        else
+        {
+            std::shared_ptr<smooth::core::network::InetAddress> ip{};
+
+            if (addr.ss_family == AF_INET)
+            {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-align"
-                    auto ipv4_address = reinterpret_cast<sockaddr_in*>(&addr);
+                auto ipv4_address = reinterpret_cast<sockaddr_in*>(&addr);
 #pragma GCC diagnostic pop
-                    ip = std::make_shared<smooth::core::network::IPv4>(*ipv4_address);
-                }
-                else
-                {
+                ip = std::make_shared<smooth::core::network::IPv4>(*ipv4_address);
+            }
+            else
+            {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-align"
-                    auto ipv6_address = reinterpret_cast<sockaddr_in6*>(&addr);
+                auto ipv6_address = reinterpret_cast<sockaddr_in6*>(&addr);
 #pragma GCC diagnostic pop
-                    ip = std::make_shared<smooth::core::network::IPv6>(*ipv6_address);
-                }
-
-                Log::info("ServerSocket", "Connection accepted");
-                res = std::make_tuple<>(ip, accepted_socket);
+                ip = std::make_shared<smooth::core::network::IPv6>(*ipv6_address);
             }
+
+            Log::info("ServerSocket", "Connection accepted");
+            res = std::make_tuple<>(ip, accepted_socket);
         }
 
         return res;
@@ -185,18 +253,90 @@ namespace smooth::core::network
     template<typename Client, typename Protocol, typename ClientContext>
     void ServerSocket<Client, Protocol, ClientContext>::readable(ISocketBackOff& ops)
     {
-        const auto& [ip, accepted_socket_id] = accept_request(ops);
+        for (int i = 0; i < max_accepts_per_wake_up; ++i)
+        {
+            const auto available = !pool.empty();
+
+            if (!available && exhaustion_policy != PoolExhaustionPolicy::Reject)
+            {
+                // Only on the first pass is a connection known to be waiting; if there are more they
+                // are reported again on the next wake-up.
+                if (i == 0)
+                {
+                    wait_for_client();
+                }
+
+                break;
+            }
+
+            const auto& [ip, accepted_socket_id] = accept_request(ops);
+
+            if (!ip)
+            {
+                // No more connections waiting, or accepting failed.
+                break;
+            }
+
+            if (available)
+            {
+                ++accepted;
+                add_client(ip, accepted_socket_id, *pool.get());
+            }
+            else
+            {
+                ++rejected;
+                reject(accepted_socket_id);
+            }
+        }
+    }
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    void ServerSocket<Client, Protocol, ClientContext>::add_client(const std::shared_ptr<InetAddress>& ip,
+                                                                   int socket_id,
+                                                                   Client& client)
+    {
+        auto socket = Socket<Protocol>::create(ip,
+                                               socket_id,
+                                               client.get_buffers(),
+                                               client.get_send_timeout());
+
+        client.set_client_context(client_context);
+        client.set_socket(socket);
+    }
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    void ServerSocket<Client, Protocol, ClientContext>::reject(int socket_id)
+    {
+        if (!rejection_data.empty())
+        {
+            // Best effort; the connection is closed regardless of how much is sent.
+            static_cast<void>(::send(socket_id, rejection_data.data(), rejection_data.size(),
+                                     MSG_DONTWAIT | SEND_FLAGS));
+            ::shutdown(socket_id, SHUT_WR);
+        }
+
+        ::close(socket_id);
+    }
+
+    template<typename Client, typename Protocol, typename ClientContext>
+    void ServerSocket<Client, Protocol, ClientContext>::wait_for_client()
+    {
+        // While paused, the connections are no longer reported as waiting until a client is returned.
+        pause_receive(true);
 
-        if (ip)
+        if (exhaustion_policy == PoolExhaustionPolicy::EvictIdlest && pool.evict_idlest())
         {
-            auto client = pool.get();
-            auto socket = Socket<Protocol>::create(ip,
-                                                   accepted_socket_id,
-                                                   client->get_buffers(),
-                                                   client->get_send_timeout());
-
-            client->set_client_context(client_context);
-            client->set_socket(socket);
+            ++evicted;
+        }
+        else
+        {
+            ++queued;
+        }
+
+        // A client may have been returned before the pause took effect.
+        if (!pool.empty())
+        {
+            pause_receive(false);
         }
     }
 
@@ -295,6 +435,15 @@ namespace smooth::core::network
                 int no_delay = 1;
                 res &= setsockopt(socket_id, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay)) == 0;
 
+#ifdef __linux__
+
+                if (reuse_port)
+                {
+                    int reuse = 1;
+                    res &= setsockopt(socket_id, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) == 0;
+                }
+#endif
+
                 if (res)
                 {
                     log("Created server socket");
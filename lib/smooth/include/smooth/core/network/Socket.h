@@ -19,6 +19,8 @@ limitations under the License.
 
 #include "InetAddress.h"
 #include "ISocket.h"
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <memory>
 #include <chrono>
@@ -34,6 +36,7 @@ limitations under the License.
 #include "smooth/core/network/event/ConnectionStatusEvent.h"
 #include "smooth/core/logging/log.h"
 #include "smooth/core/util/create_protected.h"
+#include "smooth/config_constants.h"
 
 namespace smooth::core::network
 {
@@ -111,10 +114,21 @@ namespace smooth::core::network
 
             virtual void read_data(const std::shared_ptr<BufferContainer<Protocol>>& container);
 
+            bool check_read_result(ssize_t read_count);
+
+            void consume_read_ahead(const std::shared_ptr<BufferContainer<Protocol>>& container);
+
+            void keep_excess_data();
+
+            bool packet_data_received(const std::shared_ptr<BufferContainer<Protocol>>& container, int length);
+
             virtual void write_data(const std::shared_ptr<BufferContainer<Protocol>>& container);
 
             void send_next_packet();
 
+            /// Maximum number of buffers handed to a single vectored send.
+            static constexpr int max_send_segments = 16;
+
             bool signal_new_connection();
 
             bool internal_start() override;
@@ -138,6 +152,19 @@ namespace smooth::core::network
                 return res;
             }
 
+            bool has_buffered_data() override
+            {
+                bool res = read_ahead_pos < read_ahead_end;
+
+                if (res)
+                {
+                    auto cont = get_container_or_close();
+                    res = cont && !cont->get_rx_buffer().is_full();
+                }
+
+                return res;
+            }
+
             void publish_connected_status() override;
 
             void stop_internal() override;
@@ -147,8 +174,20 @@ namespace smooth::core::network
             bool set_no_delay();
 
             std::weak_ptr<BufferContainer<Protocol>> buffers{};
+
+            // Data read from the socket but not yet passed on to the protocol.
+            std::vector<uint8_t> read_ahead{};
+            int read_ahead_pos = 0;
+            int read_ahead_end = 0;
+
+            // Data received beyond the end of the latest packet.
+            std::vector<uint8_t> excess{};
         private:
             void clear_buffers();
+
+            /// Has the dispatcher shard the socket is assigned to perform the operation, and wake that
+            /// shard when the buffers are used.
+            void hand_to_dispatcher(SocketOperation::Op op);
     };
 
     template<typename Protocol, typename Packet>
@@ -205,7 +244,7 @@ namespace smooth::core::network
 
             if (res)
             {
-                SocketDispatcher::instance().perform_op(SocketOperation::Op::Start, shared_from_this());
+                hand_to_dispatcher(SocketOperation::Op::Start);
             }
         }
 
@@ -331,18 +370,58 @@ namespace smooth::core::network
     template<typename Protocol, typename Packet>
     void Socket<Protocol, Packet>::read_data(const std::shared_ptr<BufferContainer<Protocol>>& container)
     {
-        auto& rx = container->get_rx_buffer();
+        if (read_ahead_pos < read_ahead_end)
+        {
+            // Data from a previous read is still waiting to be passed on.
+            consume_read_ahead(container);
+        }
+        else
+        {
+            if (read_ahead.empty())
+            {
+                read_ahead.resize(static_cast<size_t>(CONFIG_SMOOTH_SOCKET_READ_AHEAD_SIZE));
+            }
 
-        // How much data to assemble the current packet?
-        int wanted_length = rx.amount_wanted();
+            auto& rx = container->get_rx_buffer();
 
-        // Try to read the desired amount
-        ssize_t read_count = 0;
-        {
-            auto write_pos = rx.get_write_pos();
-            read_count = recv(socket_id, static_cast<void*>(write_pos), static_cast<size_t>(wanted_length), 0);
+            // How much data to assemble the current packet?
+            int wanted_length = rx.amount_wanted();
+
+            if (wanted_length >= static_cast<int>(read_ahead.size()))
+            {
+                // Read straight into the packet; going via the read-ahead buffer would only add a copy.
+                ssize_t read_count = 0;
+                {
+                    auto write_pos = rx.get_write_pos();
+                    read_count = recv(socket_id, static_cast<void*>(write_pos), static_cast<size_t>(wanted_length), 0);
+                }
+
+                if (check_read_result(read_count))
+                {
+                    packet_data_received(container, socket_cast(read_count));
+                }
+            }
+            else
+            {
+                // Read as much as is available so that the protocol, which often asks for just a few bytes
+                // at a time while parsing headers, can be fed from memory instead of by further calls to recv().
+                auto read_count = recv(socket_id, static_cast<void*>(read_ahead.data()), read_ahead.size(), 0);
+
+                if (check_read_result(read_count))
+                {
+                    read_ahead_pos = 0;
+                    read_ahead_end = socket_cast(read_count);
+                    consume_read_ahead(container);
+                }
+            }
         }
 
+        elapsed_receive_time.start();
+    }
+
+    template<typename Protocol, typename Packet>
+    bool Socket<Protocol, Packet>::check_read_result(ssize_t read_count)
+    {
         if (read_count == 0)
         {
             stop("Underlying socket closed (recv returned 0)");
@@ -354,24 +433,109 @@ namespace smooth::core::network
                 stop("Error during receive");
             }
         }
-        else
+
+        return read_count > 0;
+    }
+
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::consume_read_ahead(const std::shared_ptr<BufferContainer<Protocol>>& container)
+    {
+        auto& rx = container->get_rx_buffer();
+        bool ok = true;
+
+        // Stop when the receive buffer is full, the rest is passed on once the application has consumed a packet.
+        while (ok && read_ahead_pos < read_ahead_end && is_active() && !rx.is_full())
         {
-            rx.data_received(socket_cast(read_count));
+            auto amount = std::min(rx.amount_wanted(), read_ahead_end - read_ahead_pos);
 
-            if (rx.is_error())
+            if (amount <= 0)
             {
-                rx.prepare_new_packet();
                 stop("Assembly error");
+                ok = false;
+            }
+            else
+            {
+                {
+                    auto write_pos = rx.get_write_pos();
+                    std::copy_n(read_ahead.cbegin() + read_ahead_pos, amount, static_cast<uint8_t*>(write_pos));
+                }
+
+                read_ahead_pos += amount;
+                ok = packet_data_received(container, amount);
             }
-            else if (rx.is_packet_complete())
+        }
+
+        if (!ok || !is_active() || read_ahead_pos >= read_ahead_end)
+        {
+            // Drained, or the rest is no longer wanted.
+            read_ahead_pos = 0;
+            read_ahead_end = 0;
+        }
+    }
+
+    template<typename Protocol, typename Packet>
+    bool Socket<Protocol, Packet>::packet_data_received(const std::shared_ptr<BufferContainer<Protocol>>& container,
+                                                        int length)
+    {
+        auto& rx = container->get_rx_buffer();
+        rx.data_received(length);
+
+        bool res = !rx.is_error();
+
+        if (!res)
+        {
+            rx.prepare_new_packet();
+            stop("Assembly error");
+        }
+        else if (rx.is_packet_complete())
+        {
+            rx.take_excess_data(excess);
+            event::DataAvailableEvent<Protocol> d(&rx);
+            container->get_data_available()->push(d);
+            rx.prepare_new_packet();
+
+            if (!excess.empty())
             {
-                event::DataAvailableEvent<Protocol> d(&rx);
-                container->get_data_available()->push(d);
-                rx.prepare_new_packet();
+                keep_excess_data();
             }
         }
 
-        elapsed_receive_time.start();
+        return res;
+    }
+
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::keep_excess_data()
+    {
+        // Data belonging to the next packet, e.g. a pipelined request, is passed on again via the read-ahead
+        // buffer, in front of anything still waiting there. The excess may have been received straight into
+        // the packet rather than via the read-ahead buffer, so it is always copied.
+        auto amount = static_cast<int>(excess.size());
+        auto remaining = read_ahead_end - read_ahead_pos;
+
+        if (read_ahead_pos >= amount)
+        {
+            // Room enough in front of the data still waiting.
+            read_ahead_pos -= amount;
+        }
+        else
+        {
+            auto total = static_cast<std::size_t>(amount + remaining);
+
+            if (read_ahead.size() < total)
+            {
+                read_ahead.resize(total);
+            }
+
+            // Move the data still waiting up to make room for the excess in front of it.
+            std::copy_backward(read_ahead.begin() + read_ahead_pos,
+                               read_ahead.begin() + read_ahead_end,
+                               read_ahead.begin() + static_cast<std::ptrdiff_t>(total));
+            read_ahead_pos = 0;
+            read_ahead_end = amount + remaining;
+        }
+
+        std::copy(excess.cbegin(), excess.cend(), read_ahead.begin() + read_ahead_pos);
+        excess.clear();
     }
 
     template<typename Protocol, typename Packet>
@@ -381,14 +545,31 @@ namespace smooth::core::network
 
         // Try to send as much as possible. The only guarantee POSIX gives when a socket is writable
         // is that send( id, some_data, some_length ) will be >= 1 and may or may not send the entire
-        // packet.
+        // packet. To keep the number of calls down, the remains of the current packet and as many of
+        // the queued packets as fits are handed over in a single vectored send.
         auto& tx = container->get_tx_buffer();
-        auto data_to_send = tx.get_data_to_send();
-        auto length = tx.get_remaining_data_length();
-        auto amount_sent = ::send(socket_id,
-                                  data_to_send,
-                                  static_cast<size_t>(length),
-                                  SEND_FLAGS);
+
+        std::array<PacketSegment, max_send_segments> segments{};
+        auto count = tx.get_segments_to_send(segments.data(), max_send_segments);
+
+        ssize_t amount_sent = 0;
+
+        if (count > 0)
+        {
+            std::array<iovec, max_send_segments> vectors{};
+
+            for (size_t i = 0; i < static_cast<size_t>(count); ++i)
+            {
+                vectors[i].iov_base = const_cast<uint8_t*>(segments[i].data);
+                vectors[i].iov_len = static_cast<size_t>(segments[i].length);
+            }
+
+            msghdr message{};
+            message.msg_iov = vectors.data();
+            message.msg_iovlen = static_cast<decltype(message.msg_iovlen)>(count);
+
+            amount_sent = ::sendmsg(socket_id, &message, SEND_FLAGS);
+        }
 
         if (amount_sent == -1)
         {
@@ -396,14 +577,14 @@ namespace smooth::core::network
         }
         else
         {
-            tx.data_has_been_sent(static_cast<int>(amount_sent));
+            auto completed = tx.data_has_been_sent(static_cast<int>(amount_sent));
 
-            // Was a complete packet sent?
             if (tx.is_in_progress())
             {
                 elapsed_send_time.start();
             }
-            else
+
+            if (completed > 0)
             {
                 // Let the application know it may now send another packet.
                 smooth::core::network::event::TransmitBufferEmptyEvent event(shared_from_this());
@@ -453,6 +634,8 @@ namespace smooth::core::network
             active = false;
             connected = false;
             elapsed_send_time.stop_and_zero();
+            read_ahead_pos = 0;
+            read_ahead_end = 0;
         }
     }
 
@@ -486,7 +669,7 @@ namespace smooth::core::network
         set_non_blocking();
         set_no_delay();
 
-        SocketDispatcher::instance().perform_op(SocketOperation::Op::AddActiveSocket, shared_from_this());
+        hand_to_dispatcher(SocketOperation::Op::AddActiveSocket);
     }
 
     template<typename Protocol, typename Packet>
@@ -528,4 +711,18 @@ namespace smooth::core::network
             cont->clear();
         }
     }
+
+    template<typename Protocol, typename Packet>
+    void Socket<Protocol, Packet>::hand_to_dispatcher(SocketOperation::Op op)
+    {
+        auto& owner = get_dispatcher();
+        auto cont = buffers.lock();
+
+        if (cont)
+        {
+            cont->set_wake_up([&owner]() { owner.wake_up(); });
+        }
+
+        owner.perform_op(op, shared_from_this());
+    }
 }
@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <vector>
@@ -33,12 +34,17 @@ limitations under the License.
 #include "NetworkStatus.h"
 #include "SocketOperation.h"
 #include "ISocketBackOff.h"
+#include "IReadinessBackend.h"
 
 namespace smooth::core::network
 {
     /// The SocketDispatcher handles all tasks related to sockets and is responsible for
     /// creating and sending the necessary events to the application. As an application developer
     /// you should never have to care about this class.
+    ///
+    /// There may be several dispatchers, shards, each running on its own task and handling the sockets
+    /// assigned to it. A socket is assigned to the least loaded shard when it is first started and stays
+    /// with it; operations on it are always performed by that shard.
     class SocketDispatcher
         : public smooth::core::Task,
         public smooth::core::ipc::IEventListener<NetworkStatus>,
@@ -46,32 +52,62 @@ namespace smooth::core::network
         private ISocketBackOff
     {
         public:
-#ifdef ESP_PLATFORM
-            using FD = size_t;
-#else
-            using FD = int;
-#endif
             ~SocketDispatcher() override = default;
 
+            /// \return The first shard.
             static SocketDispatcher& instance();
 
+            /// \param index Index of the shard, less than max_shards.
+            /// \return The shard with the given index, started on first use.
+            static SocketDispatcher& shard(std::size_t index);
+
+            /// \return The shard with the fewest sockets, of those in use.
+            static SocketDispatcher& least_loaded();
+
+            /// Sets the number of shards that new sockets are spread over. Sockets already assigned to
+            /// a shard stay with it. When more than one shard is used, each is pinned to a core of its
+            /// own as it is started, shard i to core i modulo the number of cores.
+            /// \param count Number of shards, 1 to max_shards.
+            static void set_shard_count(std::size_t count);
+
+            [[nodiscard]] static std::size_t get_shard_count();
+
+            /// \return The number of sockets assigned to this shard.
+            [[nodiscard]] std::size_t get_load() const;
+
+            /// Queues an operation on the socket, to be performed by the shard the socket is assigned to.
             void perform_op(SocketOperation::Op op, std::shared_ptr<ISocket> socket);
 
+            /// Wakes the dispatcher if it is waiting for socket readiness, so that it re-evaluates
+            /// what sockets to monitor. Call when data has been queued for transmission.
+            void wake_up();
+
+            void init() override;
+
             void tick() override;
 
             void event(const NetworkStatus& event) override;
 
             void event(const SocketOperation& event) override;
 
+            static constexpr std::size_t max_shards = 8;
+
         protected:
         private:
-            SocketDispatcher();
+            SocketDispatcher(std::size_t index, int core);
+
+            static int core_for_shard(std::size_t index);
+
+            /// Updates the load from the sockets held, once an operation has been performed.
+            void update_load();
+
+            void update_interest();
 
-            int build_sets();
+            std::chrono::milliseconds get_wait_time();
 
-            void clear_sets();
+            void dispatch_ready_sockets();
 
-            void set_timeout();
+            void dispatch_buffered_sockets();
 
             void restart_inactive_sockets();
 
@@ -98,14 +134,18 @@ namespace smooth::core::network
             using SocketOperationQueue = smooth::core::ipc::TaskEventQueue<SocketOperation>;
             std::shared_ptr<SocketOperationQueue> socket_op;
 
-            static void set_fd(FD socket_id, fd_set& fd);
+            std::unique_ptr<IReadinessBackend> backend;
+            std::vector<SocketReadiness> ready{};
 
-            static bool is_fd_set(FD socket_id, fd_set& fd);
+            // Sockets with data already read from the network, which are to be dispatched without waiting
+            std::vector<int> buffered{};
+            // Sockets held, plus those queued to be started.
+            std::atomic<std::size_t> held{ 0 };
+            std::atomic<std::size_t> pending{ 0 };
 
-            fd_set read_set{};
-            fd_set write_set{};
-            timeval tv{};
-            bool has_ip = false;
+            // A shard started after the network came up has not seen the event, so it takes the state from
+            // the first shard.
+            std::atomic<bool> has_ip{ false };
             static constexpr const char* tag = "SocketDispatcher";
             std::unordered_map<int, std::chrono::steady_clock::time_point> backed_off{};
 
@@ -0,0 +1,70 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+
+namespace smooth::core::network
+{
+    /// WakeUpSignal provides a file descriptor that becomes readable when signal() is called,
+    /// making it possible to wake up a thread blocked in select(), poll() or epoll_wait().
+    /// On Linux an eventfd is used, elsewhere a UDP socket connected to itself on the loopback
+    /// interface acts as a self-pipe, which works on lwIP as long as loopback support is enabled.
+    /// Multiple signals are coalesced into one until clear() is called.
+    class WakeUpSignal
+    {
+        public:
+            WakeUpSignal() = default;
+
+            ~WakeUpSignal();
+
+            WakeUpSignal(const WakeUpSignal&) = delete;
+
+            WakeUpSignal(WakeUpSignal&&) = delete;
+
+            WakeUpSignal& operator=(const WakeUpSignal&) = delete;
+
+            WakeUpSignal& operator=(WakeUpSignal&&) = delete;
+
+            /// Opens the underlying file descriptor, unless already open.
+            /// \return true if the signal is open.
+            bool open();
+
+            [[nodiscard]] bool is_open() const
+            {
+                return fd.load(std::memory_order_acquire) >= 0;
+            }
+
+            /// \return The file descriptor to wait for readability on, or -1 if not open.
+            [[nodiscard]] int get_fd() const
+            {
+                return fd.load(std::memory_order_acquire);
+            }
+
+            /// Makes the file descriptor readable. Thread-safe.
+            void signal();
+
+            /// Consumes any pending signal, call when the file descriptor is readable.
+            void clear();
+
+        private:
+            // Set once fully set up, since signal() may be called from other tasks while open() runs.
+            std::atomic<int> fd{ -1 };
+            std::atomic_bool pending{ false };
+    };
+}
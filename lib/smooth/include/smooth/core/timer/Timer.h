@@ -18,7 +18,10 @@ limitations under the License.
 #pragma once
 
 #include <string>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include "smooth/core/timer/Timer.h"
 #include "smooth/core/timer/TimerExpiredEvent.h"
@@ -28,6 +31,8 @@ namespace smooth::core::timer
 {
     class TimerService;
 
+    class TimerWheel;
+
     class Timer;
 
     /// RAII helper for Timer.
@@ -115,6 +120,27 @@ namespace smooth::core::timer
                 return repeating;
             }
 
+            /// Sets a repeating timer to run at a fixed rate. Normally, the next expiry is calculated from
+            /// when the previous one was processed, so the timer drifts by the processing latency each period.
+            /// At a fixed rate, each expiry is instead scheduled from the previous deadline. If the timer
+            /// falls behind by one or more whole periods, these are skipped and reported via
+            /// TimerExpiredEvent::get_skipped_periods().
+            /// \param fixed_rate true to run at a fixed rate.
+            void set_fixed_rate(bool fixed_rate)
+            {
+                this->fixed_rate = fixed_rate;
+            }
+
+            /// Allows the timer to expire up to 'slack' after its deadline. This lets the TimerService
+            /// expire several timers with overlapping windows together, saving wake-ups, such as on
+            /// battery powered devices. Takes effect the next time the timer is started or repeats.
+            /// For fixed rate timers, keep the slack below the interval or periods will be reported as skipped.
+            /// \param slack The maximum allowed delay, defaults to zero.
+            void set_slack(std::chrono::milliseconds slack)
+            {
+                slack_ms = static_cast<uint32_t>(std::max(slack.count(), std::chrono::milliseconds::rep{ 0 }));
+            }
+
             /// \r Returns the time point where the timer expires.
             std::chrono::steady_clock::time_point expires_at() const;
 
@@ -131,14 +157,30 @@ namespace smooth::core::timer
             Timer(int id, std::weak_ptr<ipc::TaskEventQueue<timer::TimerExpiredEvent>> event_queue,
                   bool auto_reload, std::chrono::milliseconds interval);
 
+            /// Sets the time point where the timer expires, without starting it.
+            void set_expires_at(std::chrono::steady_clock::time_point time)
+            {
+                expire_time = time;
+            }
+
         private:
             friend class smooth::core::timer::TimerService;
+            friend class smooth::core::timer::TimerWheel;
 
-            void expired();
+            void expired(std::chrono::steady_clock::time_point now);
 
             void calculate_next_execution();
 
             std::weak_ptr<ipc::TaskEventQueue<TimerExpiredEvent>> queue;
             std::chrono::steady_clock::time_point expire_time;
+            std::atomic_bool fixed_rate{ false };
+            std::atomic<uint32_t> slack_ms{ 0 };
+
+            // Bookkeeping for the TimerWheel, only accessed while holding the TimerService lock.
+            Timer* wheel_prev = nullptr;
+            Timer* wheel_next = nullptr;
+            int wheel_slot = -1;
+            uint64_t wheel_tick = 0;
+            std::shared_ptr<Timer> wheel_ref{};
     };
 }
@@ -17,6 +17,7 @@ limitations under the License.
 
 #pragma once
 
+#include <cstdint>
 #include "smooth/core/timer/ITimer.h"
 
 namespace smooth::core::timer
@@ -27,8 +28,9 @@ namespace smooth::core::timer
         public:
             TimerExpiredEvent() = default;
 
-            explicit TimerExpiredEvent(int id)
-                    : id(id)
+            explicit TimerExpiredEvent(int id, uint32_t skipped_periods = 0)
+                    : id(id),
+                      skipped(skipped_periods)
             {
             }
 
@@ -39,7 +41,16 @@ namespace smooth::core::timer
                 return id;
             }
 
+            /// Gets the number of whole periods that passed without the timer expiring, i.e.
+            /// the number of expirations that have been dropped. Only set for fixed rate timers.
+            /// \return The number of skipped periods.
+            [[nodiscard]] uint32_t get_skipped_periods() const
+            {
+                return skipped;
+            }
+
         private:
             int id = -1;
+            uint32_t skipped = 0;
     };
 }
@@ -17,53 +17,19 @@ limitations under the License.
 
 #pragma once
 
-#include <algorithm>
+#include <chrono>
 #include <condition_variable>
-#include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <vector>
 #include "smooth/core/Task.h"
+#include "smooth/core/timer/TimerWheel.h"
 
 namespace smooth::core::timer
 {
-    class Timer;
-
-    using SharedTimer = std::shared_ptr<Timer>;
-
-    using TimerComparator = std::function<bool (SharedTimer left, SharedTimer right)>;
-
-    /// TimerQueue extends std::priority_queue with the ability to remove an item.
-    class TimerQueue
-        : public std::priority_queue<SharedTimer, std::vector<SharedTimer>, TimerComparator>
-    {
-        public:
-            explicit TimerQueue(const TimerComparator& cmp)
-                    :
-                      std::priority_queue<SharedTimer, std::vector<SharedTimer>, TimerComparator>(cmp)
-            {
-            }
-
-            void remove_timer(const SharedTimer& timer)
-            {
-                auto it = find_if(c.begin(),
-                                  c.end(),
-                                  [timer](const SharedTimer& o) {
-                                      // Compare pointers
-                                      bool found = timer == o;
-
-                                      return found;
-                                  });
-
-                if (it != c.end())
-                {
-                    c.erase(it);
-                }
-            }
-    };
-
     /// TimerService provides functionality to register a Timer that, when expired results in
     /// a message being posted to the Timer's event queue.
+    /// Timers are kept in a TimerWheel, making starting, stopping and resetting them O(1).
     /// \note You are not meant to use this class directly.
     class TimerService
         : private smooth::core::Task
@@ -75,6 +41,7 @@ namespace smooth::core::timer
 
             static TimerService& get();
 
+            /// Adds the timer, or restarts it if already added.
             void add_timer(const SharedTimer& timer);
 
             void remove_timer(const SharedTimer& timer);
@@ -83,8 +50,10 @@ namespace smooth::core::timer
             void tick() override;
 
         private:
-            TimerComparator cmp;
-            TimerQueue queue;
+            TimerWheel wheel;
+            std::vector<SharedTimer> expired{};
+            std::chrono::steady_clock::time_point wake_up_at = std::chrono::steady_clock::time_point::max();
+            bool wake_up_early = false;
             std::mutex guard;
             std::condition_variable cond{};
     };
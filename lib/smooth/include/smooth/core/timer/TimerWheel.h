@@ -0,0 +1,121 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace smooth::core::timer
+{
+    class Timer;
+
+    using SharedTimer = std::shared_ptr<Timer>;
+
+    /// A hierarchical timing wheel with millisecond resolution.
+    ///
+    /// Timers are kept in intrusive lists, one per slot, on a number of levels where each slot on a level
+    /// spans all of the slots on the level below. Inserting and removing a timer is O(1) regardless of
+    /// how many timers there are. As time passes, the timers of a slot on a higher level are redistributed
+    /// to the lower levels, until they reach the lowest level where they expire.
+    ///
+    /// A timer that is in the wheel is held by a shared_ptr until it expires or is removed.
+    /// \note Not thread-safe; the TimerService guards it with its lock.
+    class TimerWheel
+    {
+        public:
+            explicit TimerWheel(std::chrono::steady_clock::time_point epoch);
+
+            ~TimerWheel();
+
+            TimerWheel(const TimerWheel&) = delete;
+
+            TimerWheel(TimerWheel&&) = delete;
+
+            TimerWheel& operator=(const TimerWheel&) = delete;
+
+            TimerWheel& operator=(TimerWheel&&) = delete;
+
+            /// Inserts the timer to expire at the time given by Timer::expires_at().
+            /// If the timer is already in the wheel, it is moved.
+            void insert(const SharedTimer& timer);
+
+            /// Removes the timer from the wheel, if present.
+            void remove(Timer& timer);
+
+            /// Advances the wheel to the given point in time.
+            /// \param now The current time.
+            /// \param expired Receives the timers that have expired, in the order they expired. These are
+            /// no longer in the wheel.
+            void advance(std::chrono::steady_clock::time_point now, std::vector<SharedTimer>& expired);
+
+            /// Gets the point in time at which advance() next needs to be called. This is either when the
+            /// next timer expires or, for timers far ahead, when they need to be moved to a lower level.
+            /// Only valid when the wheel isn't empty.
+            [[nodiscard]] std::chrono::steady_clock::time_point next_wake_up() const;
+
+            [[nodiscard]] bool empty() const
+            {
+                return count == 0;
+            }
+
+            [[nodiscard]] size_t size() const
+            {
+                return count;
+            }
+
+            static constexpr uint32_t bits_per_level = 6;
+            static constexpr uint32_t slots_per_level = 1U << bits_per_level;
+            static constexpr uint64_t slot_mask = slots_per_level - 1;
+            static constexpr uint32_t level_count = 4;
+
+        private:
+            [[nodiscard]] uint64_t next_event_tick() const;
+
+            [[nodiscard]] uint64_t to_tick_ceil(std::chrono::steady_clock::time_point time) const;
+
+            [[nodiscard]] uint64_t to_tick_floor(std::chrono::steady_clock::time_point time) const;
+
+            static uint64_t position(uint64_t tick, uint32_t level)
+            {
+                return tick >> (bits_per_level * level);
+            }
+
+            void link(Timer& timer);
+
+            void unlink(Timer& timer);
+
+            void process_tick(uint64_t tick, std::vector<SharedTimer>& expired);
+
+            void cascade(uint32_t level, uint64_t slot);
+
+            [[nodiscard]] uint32_t first_occupied(uint32_t level, uint64_t from) const;
+
+            std::chrono::steady_clock::time_point epoch;
+            uint64_t current = 0;
+            size_t count = 0;
+            std::array<Timer*, level_count * slots_per_level> slots{};
+            std::array<uint64_t, level_count> occupied{};
+            std::array<size_t, level_count> level_size{};
+    };
+}
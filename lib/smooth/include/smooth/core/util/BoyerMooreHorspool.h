@@ -0,0 +1,103 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace smooth::core::util
+{
+    /// \brief Finds a fixed byte pattern using the Boyer-Moore-Horspool algorithm.
+    /// After a mismatch, the search skips ahead by up to the length of the pattern, so long patterns,
+    /// such as MIME boundaries, are found while only looking at a fraction of the searched bytes.
+    class BoyerMooreHorspool
+    {
+        public:
+            BoyerMooreHorspool() = default;
+
+            explicit BoyerMooreHorspool(std::vector<uint8_t> pattern)
+                    : needle(std::move(pattern))
+            {
+                if (needle.size() > std::numeric_limits<uint16_t>::max())
+                {
+                    throw std::invalid_argument("Pattern too long");
+                }
+
+                const auto length = static_cast<uint16_t>(needle.size());
+                skip.fill(length);
+
+                for (uint16_t i = 0; i + 1 < length; ++i)
+                {
+                    skip[needle[i]] = static_cast<uint16_t>(length - 1 - i);
+                }
+            }
+
+            /// \brief Searches [begin, end) for the pattern.
+            /// \return A pointer to the first match, or end if there is no match.
+            const uint8_t* find(const uint8_t* begin, const uint8_t* end) const
+            {
+                const auto length = needle.size();
+                const uint8_t* res = end;
+
+                if (length == 0)
+                {
+                    res = begin;
+                }
+                else if (static_cast<std::size_t>(end - begin) >= length)
+                {
+                    const auto last = length - 1;
+                    const uint8_t* pos = begin;
+                    const uint8_t* stop = end - length;
+
+                    while (pos <= stop)
+                    {
+                        const auto c = pos[last];
+
+                        if (c == needle[last] && std::memcmp(pos, needle.data(), last) == 0)
+                        {
+                            res = pos;
+                            break;
+                        }
+
+                        pos += skip[c];
+                    }
+                }
+
+                return res;
+            }
+
+            const std::vector<uint8_t>& pattern() const
+            {
+                return needle;
+            }
+
+            std::size_t size() const
+            {
+                return needle.size();
+            }
+
+        private:
+            std::vector<uint8_t> needle{};
+            std::array<uint16_t, 256> skip{};
+    };
+}
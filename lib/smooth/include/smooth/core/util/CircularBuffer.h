@@ -17,6 +17,8 @@ limitations under the License.
 
 #pragma once
 
+#include <utility>
+
 namespace smooth::core::util
 {
     /// \brief Interface for a circular buffer.
@@ -29,11 +31,20 @@ namespace smooth::core::util
             /// Puts data onto the buffer
             virtual void put(const T& data) = 0;
 
+            /// Puts data onto the buffer
+            virtual void put(T&& data) = 0;
+
             /// Gets data from the buffer
             /// \param t The item to put on the buffer
             /// \return true on success, false on failure.
             virtual bool get(T& t) = 0;
 
+            /// Gets a reference to an item without removing it from the buffer.
+            /// \param index The index of the item, where 0 is the item get() would return next.
+            /// Must be less than available_items().
+            /// \return A reference to the item
+            virtual T& peek(int index) = 0;
+
             /// Returns a value indicating if the buffer is empty.
             /// \return true or false
             virtual bool is_empty() = 0;
@@ -68,8 +79,15 @@ namespace smooth::core::util
 
             void put(const T& data) override;
 
+            void put(T&& data) override;
+
             bool get(T& d) override;
 
+            T& peek(int index) override
+            {
+                return buffer[(read_pos + index) % Size];
+            }
+
             bool is_empty() override
             {
                 return count == 0;
@@ -102,6 +120,8 @@ namespace smooth::core::util
             CircularBuffer& operator=(const CircularBuffer&) = delete;
 
         private:
+            void advance_write_pos();
+
             int next_pos(int current)
             {
                 return (current + 1) % Size;
@@ -126,7 +146,19 @@ namespace smooth::core::util
     void CircularBuffer<T, Size>::put(const T& data)
     {
         buffer[write_pos] = data;
+        advance_write_pos();
+    }
+
+    template<typename T, int Size>
+    void CircularBuffer<T, Size>::put(T&& data)
+    {
+        buffer[write_pos] = std::move(data);
+        advance_write_pos();
+    }
 
+    template<typename T, int Size>
+    void CircularBuffer<T, Size>::advance_write_pos()
+    {
         if (!is_full())
         {
             ++count;
@@ -148,7 +180,7 @@ namespace smooth::core::util
 
         if (!is_empty())
         {
-            d = buffer[read_pos];
+            d = std::move(buffer[read_pos]);
             read_pos = next_pos(read_pos);
             --count;
 
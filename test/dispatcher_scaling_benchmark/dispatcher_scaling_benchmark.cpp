@@ -0,0 +1,305 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dispatcher_scaling_benchmark.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/network/IPv4.h"
+#include "smooth/core/network/SocketDispatcher.h"
+#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "wifi_creds.h"
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http;
+using namespace std::chrono;
+
+namespace dispatcher_scaling_benchmark
+{
+    static constexpr const char* tag = "DispatcherScaling";
+    static constexpr uint16_t base_port = 8090;
+    static constexpr int connections = 8;
+    static constexpr int pipeline_depth = 8;
+    static constexpr auto round_duration = seconds{ 2 };
+
+    static int connect_to_server(uint16_t port)
+    {
+        int fd = -1;
+
+        for (int attempt = 0; fd < 0 && attempt < 50; ++attempt)
+        {
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+            if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+            {
+                close(fd);
+                fd = -1;
+                std::this_thread::sleep_for(milliseconds{ 100 });
+            }
+        }
+
+        return fd;
+    }
+
+    static bool write_all(int fd, const std::string& s)
+    {
+        size_t written = 0;
+
+        while (written < s.size())
+        {
+            auto res = write(fd, s.data() + written, s.size() - written);
+
+            if (res <= 0)
+            {
+                return false;
+            }
+
+            written += static_cast<size_t>(res);
+        }
+
+        return true;
+    }
+
+    /// Reads a response, headers and content. Any data received beyond that is left in 'pending'.
+    static bool read_response(int fd, std::string& pending)
+    {
+        std::array<char, 1024> buff{};
+        size_t wanted = std::string::npos;
+
+        while (wanted == std::string::npos || pending.size() < wanted)
+        {
+            auto header_end = pending.find("\r\n\r\n");
+
+            if (wanted == std::string::npos && header_end != std::string::npos)
+            {
+                size_t content_length = 0;
+                auto pos = pending.find("Content-Length: ");
+
+                if (pos != std::string::npos && pos < header_end)
+                {
+                    content_length = std::stoul(pending.substr(pos + 16));
+                }
+
+                wanted = header_end + 4 + content_length;
+                continue;
+            }
+
+            auto res = read(fd, buff.data(), buff.size());
+
+            if (res <= 0)
+            {
+                return false;
+            }
+
+            pending.append(buff.data(), static_cast<size_t>(res));
+        }
+
+        pending.erase(0, wanted);
+
+        return true;
+    }
+
+    void Responder::request(IConnectionTimeoutModifier& /*timeout_modifier*/,
+                            const std::string& /*url*/,
+                            const std::vector<uint8_t>& /*content*/)
+    {
+        if (is_last())
+        {
+            response().reply(std::make_unique<regular::responses::StringResponse>(ResponseCode::OK, "Hello", false),
+                             false);
+        }
+    }
+
+    ServerTask::ServerTask(const std::string& name, uint16_t port, bool reuse_port)
+            : Task(name, 8192, APPLICATION_BASE_PRIO, seconds(1)),
+              port(port),
+              reuse_port(reuse_port)
+    {
+    }
+
+    void ServerTask::init()
+    {
+        HTTPServerConfig cfg{ smooth::core::filesystem::Path{ "/web_root" }, {}, {}, nullptr, 1024, 2048, 10,
+                              32, seconds{ 5 }, 0, 0, 0, PoolExhaustionPolicy::Queue, reuse_port };
+
+        // Room for all connections, however the kernel spreads them over the servers sharing the port.
+        server = std::make_unique<InsecureServer>(*this, cfg);
+        server->start(connections, connections, std::make_shared<IPv4>("0.0.0.0", port));
+        server->on(HTTPMethod::GET, "/bench", std::make_shared<Responder>());
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    App::~App()
+    {
+        if (load.joinable())
+        {
+            load.join();
+        }
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        network::Wifi& wifi = get_wifi();
+        wifi.set_host_name("Smooth-ESP");
+        wifi.set_auto_connect(true);
+        wifi.set_ap_credentials(WIFI_SSID, WIFI_PASSWORD);
+        wifi.connect_to_ap();
+
+        load = std::thread([this]() { generate_load(); });
+    }
+
+    void App::generate_load()
+    {
+        // Sharding is still exercised on a single core, where no gain is to be expected.
+        const auto cores = static_cast<std::size_t>(std::thread::hardware_concurrency());
+        const auto max_shards = std::min(SocketDispatcher::max_shards, std::max(cores, std::size_t{ 2 }));
+        auto port = base_port;
+
+        Log::info(tag, "{} cores, {} connections pipelining {} requests each", cores, connections, pipeline_depth);
+
+        for (std::size_t shards = 1; shards <= max_shards; shards *= 2)
+        {
+            SocketDispatcher::set_shard_count(shards);
+
+            // Each round listens on ports of its own, as servers are not stopped.
+            start_servers(1, port, false);
+            auto single = run_round(port++);
+
+            start_servers(shards, port, true);
+            auto shared = run_round(port++);
+
+            Log::info(tag,
+                      "{} shard(s): one server {:.0f} requests/s, {} server(s) sharing the port {:.0f} requests/s",
+                      shards,
+                      single,
+                      shards,
+                      shared);
+        }
+
+        Log::info(tag, "Benchmark complete");
+    }
+
+    void App::start_servers(std::size_t count, uint16_t port, bool reuse_port)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            servers.emplace_back(std::make_unique<ServerTask>("Server" + std::to_string(servers.size()),
+                                                              port,
+                                                              reuse_port));
+            servers.back()->start();
+        }
+    }
+
+    double App::run_round(uint16_t port)
+    {
+        std::atomic<bool> stop{ false };
+        std::atomic<uint64_t> completed{ 0 };
+        std::atomic<int> failed{ 0 };
+        std::vector<std::thread> clients{};
+
+        for (int c = 0; c < connections; ++c)
+        {
+            clients.emplace_back([port, &stop, &completed, &failed]() {
+                                     auto fd = connect_to_server(port);
+
+                                     if (fd < 0)
+                                     {
+                                         ++failed;
+                                         return;
+                                     }
+
+                                     // Fail rather than hang should a response never arrive.
+                                     timeval timeout{ 2, 0 };
+                                     setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+                                     std::string requests{};
+
+                                     for (int i = 0; i < pipeline_depth; ++i)
+                                     {
+                                         requests += "GET /bench HTTP/1.1\r\nHost: localhost\r\n\r\n";
+                                     }
+
+                                     std::string pending{};
+                                     bool ok = true;
+
+                                     while (ok && !stop && write_all(fd, requests))
+                                     {
+                                         for (int i = 0; ok && i < pipeline_depth; ++i)
+                                         {
+                                             ok = read_response(fd, pending);
+                                             completed += ok ? 1 : 0;
+                                         }
+                                     }
+
+                                     failed += ok ? 0 : 1;
+                                     close(fd);
+                                 });
+        }
+
+        // Let the connections be established before measuring.
+        std::this_thread::sleep_for(milliseconds{ 500 });
+        auto completed_before = completed.load();
+        auto start = steady_clock::now();
+        std::this_thread::sleep_for(round_duration);
+        auto count = completed.load() - completed_before;
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+
+        std::string loads{};
+
+        for (std::size_t i = 0; i < SocketDispatcher::get_shard_count(); ++i)
+        {
+            loads += " " + std::to_string(SocketDispatcher::shard(i).get_load());
+        }
+
+        stop = true;
+
+        for (auto& t : clients)
+        {
+            t.join();
+        }
+
+        if (failed > 0)
+        {
+            Log::error(tag, "{} connections failed", failed.load());
+        }
+
+        Log::info(tag, "Sockets per shard:{}", loads);
+
+        return static_cast<double>(count) * 1e6 / static_cast<double>(std::max(elapsed.count(), int64_t{ 1 }));
+    }
+}
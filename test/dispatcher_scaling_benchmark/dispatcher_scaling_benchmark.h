@@ -0,0 +1,82 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/Task.h"
+#include "smooth/application/network/http/HTTPServer.h"
+#include "smooth/application/network/http/regular/HTTPRequestHandler.h"
+
+namespace dispatcher_scaling_benchmark
+{
+    /// Replies to each request with a short, fixed response.
+    class Responder
+        : public smooth::application::network::http::regular::HTTPRequestHandler
+    {
+        public:
+            void request(smooth::application::network::http::IConnectionTimeoutModifier& timeout_modifier,
+                         const std::string& url,
+                         const std::vector<uint8_t>& content) override;
+    };
+
+    /// Runs an HTTP server on a task of its own.
+    class ServerTask
+        : public smooth::core::Task
+    {
+        public:
+            ServerTask(const std::string& name, uint16_t port, bool reuse_port);
+
+            void init() override;
+
+        private:
+            uint16_t port;
+            bool reuse_port;
+            std::unique_ptr<smooth::application::network::http::InsecureServer> server{};
+    };
+
+    /// Measures the number of requests per second handled with the sockets spread over 1 to N socket
+    /// dispatcher shards, both by a single server and by one server per shard, all listening on the same
+    /// port. The load is generated from separate threads, over pipelined keep-alive connections on the
+    /// loopback interface, so it competes with the server for the cores.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            ~App() override;
+
+            void init() override;
+
+        private:
+            void generate_load();
+
+            void start_servers(std::size_t count, uint16_t port, bool reuse_port);
+
+            /// \return Requests per second.
+            double run_round(uint16_t port);
+
+            std::vector<std::unique_ptr<ServerTask>> servers{};
+            std::thread load{};
+    };
+}
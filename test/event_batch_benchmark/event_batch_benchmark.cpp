@@ -0,0 +1,119 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "event_batch_benchmark.h"
+
+#include <algorithm>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace event_batch_benchmark
+{
+    static constexpr const char* tag = "EventBatchBenchmark";
+    static constexpr int event_count = 200000;
+    static constexpr int queue_size = 100;
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, milliseconds(100)),
+              first(Queue::create(queue_size, *this, *this)),
+              second(Queue::create(queue_size, *this, *this)),
+              batch_sizes{ 1, 4, 16, 64 }
+    {
+    }
+
+    void App::tick()
+    {
+        if (!running && current_run < batch_sizes.size())
+        {
+            start_run(batch_sizes[current_run]);
+        }
+    }
+
+    void App::start_run(uint32_t batch_size)
+    {
+        // Called from within the task, as required by set_event_batch_size().
+        set_event_batch_size(batch_size);
+
+        running = true;
+        received = 0;
+        last_sequence = -1;
+        out_of_order = 0;
+        total_latency = nanoseconds::zero();
+        max_latency = nanoseconds::zero();
+        run_start = steady_clock::now();
+
+        producer = std::thread([this]() {
+                                   for (int i = 0; i < event_count; ++i)
+                                   {
+                                       auto& q = i % 2 == 0 ? first : second;
+
+                                       while (!q->push(StampedEvent{ i, steady_clock::now() }))
+                                       {
+                                           std::this_thread::yield();
+                                       }
+                                   }
+                               });
+    }
+
+    void App::event(const StampedEvent& event)
+    {
+        auto latency = duration_cast<nanoseconds>(steady_clock::now() - event.sent);
+        total_latency += latency;
+        max_latency = std::max(max_latency, latency);
+
+        if (event.sequence != last_sequence + 1)
+        {
+            ++out_of_order;
+        }
+
+        last_sequence = event.sequence;
+
+        if (++received == event_count)
+        {
+            end_run();
+        }
+    }
+
+    void App::end_run()
+    {
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - run_start);
+        producer.join();
+
+        auto rate = elapsed.count() > 0
+                    ? static_cast<double>(received) * 1e6 / static_cast<double>(elapsed.count()) : 0.0;
+
+        Log::info(tag, "Batch size {:>3}: {:>10.0f} events/s, latency avg {:>7.1f}us max {:>7}us, {} out of order",
+                  batch_sizes[current_run],
+                  rate,
+                  static_cast<double>(total_latency.count()) / received / 1000.0,
+                  duration_cast<microseconds>(max_latency).count(),
+                  out_of_order);
+
+        running = false;
+        ++current_run;
+
+        if (current_run == batch_sizes.size())
+        {
+            Log::info(tag, "Benchmark complete");
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+
+namespace event_batch_benchmark
+{
+    struct StampedEvent
+    {
+        int sequence = 0;
+        std::chrono::steady_clock::time_point sent{};
+    };
+
+    /// Compares event throughput and latency with different event batch sizes. A producer thread
+    /// alternates between two queues owned by the application, so the run also verifies that events
+    /// are delivered in the order they were sent across queues.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<StampedEvent>
+    {
+        public:
+            App();
+
+            void tick() override;
+
+            void event(const StampedEvent& event) override;
+
+        private:
+            void start_run(uint32_t batch_size);
+
+            void end_run();
+
+            using Queue = smooth::core::ipc::TaskEventQueue<StampedEvent>;
+            std::shared_ptr<Queue> first;
+            std::shared_ptr<Queue> second;
+            std::vector<uint32_t> batch_sizes;
+            size_t current_run = 0;
+            bool running = false;
+            std::thread producer{};
+            int received = 0;
+            int last_sequence = -1;
+            int out_of_order = 0;
+            std::chrono::nanoseconds total_latency{};
+            std::chrono::nanoseconds max_latency{};
+            std::chrono::steady_clock::time_point run_start{};
+    };
+}
@@ -0,0 +1,36 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "BenchResponder.h"
+#include "smooth/application/network/http/regular/responses/StringResponse.h"
+
+namespace http_benchmark
+{
+    using namespace smooth::application::network::http;
+    using namespace smooth::application::network::http::regular;
+
+    void BenchResponder::request(IConnectionTimeoutModifier& /*timeout_modifier*/,
+                                 const std::string& /*url*/,
+                                 const std::vector<uint8_t>& /*content*/)
+    {
+        if (is_last())
+        {
+            response().reply(std::make_unique<responses::StringResponse>(ResponseCode::OK, "Hello", false), false);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "EventSource.h"
+
+namespace http_benchmark
+{
+    using namespace smooth::application::network::http;
+    using namespace smooth::application::network::http::regular;
+
+    void EventSource::request(IConnectionTimeoutModifier& timeout_modifier,
+                              const std::string& /*url*/,
+                              const std::vector<uint8_t>& /*content*/)
+    {
+        if (is_last())
+        {
+            // Events may be far apart, don't let the connection time out meanwhile.
+            timeout_modifier.set_receive_timeout(std::chrono::milliseconds{ 0 });
+
+            auto s = std::make_shared<responses::EventStream>(max_queued_events);
+            response().reply(std::make_unique<responses::EventStreamResponse>(s), false);
+
+            std::lock_guard<std::mutex> lock(guard);
+            stream = s;
+        }
+    }
+
+    std::shared_ptr<responses::EventStream> EventSource::get_stream()
+    {
+        std::lock_guard<std::mutex> lock(guard);
+
+        return stream;
+    }
+}
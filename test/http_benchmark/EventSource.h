@@ -0,0 +1,45 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include "smooth/application/network/http/regular/HTTPRequestHandler.h"
+#include "smooth/application/network/http/regular/responses/EventStreamResponse.h"
+
+namespace http_benchmark
+{
+    /// Replies with an event stream, which the load generator then sends events on.
+    class EventSource
+        : public smooth::application::network::http::regular::HTTPRequestHandler
+    {
+        public:
+            void request(smooth::application::network::http::IConnectionTimeoutModifier& timeout_modifier,
+                         const std::string& url,
+                         const std::vector<uint8_t>& content) override;
+
+            /// Gets the stream of the latest request, if any.
+            std::shared_ptr<smooth::application::network::http::regular::responses::EventStream> get_stream();
+
+            static constexpr std::size_t max_queued_events = 64;
+        private:
+            std::mutex guard{};
+            std::shared_ptr<smooth::application::network::http::regular::responses::EventStream> stream{};
+    };
+}
@@ -0,0 +1,41 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "WSCounter.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/websocket/responses/WSResponse.h"
+
+namespace http_benchmark
+{
+    using namespace smooth::application::network::http::websocket::responses;
+
+    WSCounter::WSCounter(smooth::application::network::http::IServerResponse& response, smooth::core::Task& task)
+            : WebsocketServer(response, task)
+    {
+    }
+
+    void WSCounter::data_received(bool /*first_part*/, bool last_part, bool /*is_text*/,
+                                  const std::vector<uint8_t>& /*data*/)
+    {
+        if (last_part && ++received == expected_messages)
+        {
+            received = 0;
+            response.reply(std::make_unique<WSResponse>(std::string{ "done" }, true, true), false);
+        }
+    }
+}
@@ -0,0 +1,528 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "http_benchmark.h"
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/network/IPv4.h"
+#include "BenchResponder.h"
+#include "EventSource.h"
+#include "WSCounter.h"
+#include "wifi_creds.h"
+
+#ifdef __linux__
+
+#include <sys/syscall.h>
+
+#endif
+
+using namespace smooth::core;
+using namespace smooth::core::network;
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http;
+using namespace std::chrono;
+
+namespace http_benchmark
+{
+    static constexpr const char* tag = "HTTPBenchmark";
+    static constexpr uint16_t port = 8080;
+    static constexpr int http_requests = 5000;
+    // Deeper than MaxResponses, so that the server has to stop reading while responses are pending.
+    static constexpr int pipeline_depth = 16;
+    static constexpr size_t message_size = 16;
+    static constexpr int messages_per_write = 256;
+    static constexpr int stream_events = 100000;
+    // More connecting threads than the server has clients.
+    static constexpr int burst_threads = 4;
+    static constexpr int burst_connections = 250;
+
+    // Number of calls to recv() and sendmsg(), which are only used by the server side as the
+    // load generator uses read() and write().
+    static std::atomic<uint32_t> receive_calls{ 0 };
+    static std::atomic<uint32_t> send_calls{ 0 };
+}
+
+#ifdef __linux__
+
+// Interpose recv() to count the calls made by the sockets.
+extern "C" ssize_t recv(int socket, void* buffer, size_t length, int flags)
+{
+    ++http_benchmark::receive_calls;
+
+    return syscall(SYS_recvfrom, socket, buffer, length, flags, nullptr, nullptr);
+}
+
+extern "C" ssize_t sendmsg(int socket, const struct msghdr* message, int flags)
+{
+    ++http_benchmark::send_calls;
+
+    return syscall(SYS_sendmsg, socket, message, flags);
+}
+
+#endif
+
+namespace http_benchmark
+{
+    static int connect_to_server()
+    {
+        int fd = -1;
+
+        for (int attempt = 0; fd < 0 && attempt < 50; ++attempt)
+        {
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+            if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+            {
+                close(fd);
+                fd = -1;
+                std::this_thread::sleep_for(milliseconds{ 100 });
+            }
+        }
+
+        return fd;
+    }
+
+    static bool write_all(int fd, const uint8_t* data, size_t length)
+    {
+        size_t written = 0;
+
+        while (written < length)
+        {
+            auto res = write(fd, data + written, length - written);
+
+            if (res <= 0)
+            {
+                return false;
+            }
+
+            written += static_cast<size_t>(res);
+        }
+
+        return true;
+    }
+
+    static bool write_all(int fd, const std::string& s)
+    {
+        return write_all(fd, reinterpret_cast<const uint8_t*>(s.data()), s.size());
+    }
+
+    /// Reads until the end of the headers, and then until the content has been received, if any.
+    /// Any data received beyond that is left in 'pending'.
+    static bool read_response(int fd, std::string& pending, bool read_content)
+    {
+        std::array<char, 1024> buff{};
+        size_t header_end = std::string::npos;
+        size_t wanted = std::string::npos;
+
+        while (wanted == std::string::npos || pending.size() < wanted)
+        {
+            if (header_end == std::string::npos)
+            {
+                header_end = pending.find("\r\n\r\n");
+
+                if (header_end != std::string::npos)
+                {
+                    size_t content_length = 0;
+                    auto pos = pending.find("Content-Length: ");
+
+                    if (read_content && pos != std::string::npos && pos < header_end)
+                    {
+                        content_length = std::stoul(pending.substr(pos + 16));
+                    }
+
+                    wanted = header_end + 4 + content_length;
+                    continue;
+                }
+            }
+
+            auto res = read(fd, buff.data(), buff.size());
+
+            if (res <= 0)
+            {
+                return false;
+            }
+
+            pending.append(buff.data(), static_cast<size_t>(res));
+        }
+
+        pending.erase(0, wanted);
+
+        return true;
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    App::~App()
+    {
+        if (load.joinable())
+        {
+            load.join();
+        }
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        network::Wifi& wifi = get_wifi();
+        wifi.set_host_name("Smooth-ESP");
+        wifi.set_auto_connect(true);
+        wifi.set_ap_credentials(WIFI_SSID, WIFI_PASSWORD);
+        wifi.connect_to_ap();
+
+        const smooth::core::filesystem::Path web_root{ "/web_root" };
+
+        HTTPServerConfig cfg{ web_root, {}, {}, nullptr, MaxHeaderSize, ContentChunkSize, MaxResponses };
+
+        server = std::make_unique<InsecureServer>(*this, cfg);
+        server->start(2, 2, std::make_shared<IPv4>("0.0.0.0", port));
+        server->on(HTTPMethod::GET, "/bench", std::make_shared<BenchResponder>());
+        server->enable_websocket_on<WSCounter>("/ws");
+        server->on(HTTPMethod::GET, "/events", event_source);
+
+        load = std::thread([this]() { generate_load(); });
+    }
+
+    void App::generate_load()
+    {
+        run_http_requests();
+        run_websocket_messages();
+        run_event_stream();
+        Log::info(tag, "Benchmark complete");
+    }
+
+    void App::run_http_requests()
+    {
+        run_requests("HTTP", 1);
+        run_requests("HTTP pipelined", pipeline_depth);
+        run_connection_burst();
+    }
+
+    void App::run_requests(const char* name, int depth)
+    {
+        auto fd = connect_to_server();
+
+        if (fd < 0)
+        {
+            Log::error(tag, "Could not connect to server");
+            return;
+        }
+
+        // Fail rather than hang should a response never arrive.
+        timeval timeout{ 2, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        const std::string request = "GET /bench HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n";
+        std::string requests{};
+
+        for (int i = 0; i < depth; ++i)
+        {
+            requests += request;
+        }
+
+        std::string pending{};
+
+        auto receive_calls_before = receive_calls.load();
+        auto send_calls_before = send_calls.load();
+        auto start = steady_clock::now();
+        int completed = 0;
+        bool ok = true;
+
+        // Send 'depth' requests at a time, before reading the responses.
+        while (ok && completed < http_requests && write_all(fd, requests))
+        {
+            for (int i = 0; ok && i < depth; ++i)
+            {
+                ok = read_response(fd, pending, true);
+                completed += ok ? 1 : 0;
+            }
+        }
+
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        auto receives = receive_calls.load() - receive_calls_before;
+        auto sends = send_calls.load() - send_calls_before;
+        close(fd);
+
+        if (!ok)
+        {
+            Log::error(tag, "{}: No response after {} requests", name, completed);
+        }
+
+        Log::info(tag,
+                  "{}: {} requests in {}ms, {:.0f} requests/s, {:.2f} recv() and {:.2f} sendmsg() calls per request",
+                  name,
+                  completed,
+                  elapsed.count() / 1000,
+                  completed * 1e6 / static_cast<double>(std::max(elapsed.count(), int64_t{ 1 })),
+                  static_cast<double>(receives) / std::max(completed, 1),
+                  static_cast<double>(sends) / std::max(completed, 1));
+    }
+
+    void App::run_connection_burst()
+    {
+        std::atomic<int> completed{ 0 };
+        std::atomic<int> failed{ 0 };
+        std::vector<std::thread> threads{};
+        auto start = steady_clock::now();
+
+        for (int t = 0; t < burst_threads; ++t)
+        {
+            threads.emplace_back([&completed, &failed]() {
+                                     const std::string request = "GET /bench HTTP/1.1\r\nHost: localhost\r\n"
+                                                                 "Connection: close\r\n\r\n";
+
+                                     for (int i = 0; i < burst_connections; ++i)
+                                     {
+                                         auto fd = connect_to_server();
+
+                                         if (fd < 0)
+                                         {
+                                             ++failed;
+                                             continue;
+                                         }
+
+                                         std::string pending{};
+                                         timeval timeout{ 5, 0 };
+                                         setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+                                         if (write_all(fd, request) && read_response(fd, pending, true))
+                                         {
+                                             ++completed;
+                                         }
+                                         else
+                                         {
+                                             ++failed;
+                                         }
+
+                                         close(fd);
+                                     }
+                                 });
+        }
+
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        auto stats = server->get_accept_statistics();
+
+        Log::info(tag,
+                  "Connection burst: {} connections ({} failed) in {}ms, {:.0f} connections/s, "
+                  "accepted {}, queued {} times",
+                  completed.load(),
+                  failed.load(),
+                  elapsed.count() / 1000,
+                  completed * 1e6 / static_cast<double>(std::max(elapsed.count(), int64_t{ 1 })),
+                  stats.accepted,
+                  stats.queued);
+    }
+
+    void App::run_websocket_messages()
+    {
+        auto fd = connect_to_server();
+
+        if (fd < 0)
+        {
+            Log::error(tag, "Could not connect to server");
+            return;
+        }
+
+        const std::string upgrade = "GET /ws HTTP/1.1\r\n"
+                                    "Host: localhost\r\n"
+                                    "Upgrade: websocket\r\n"
+                                    "Connection: Upgrade\r\n"
+                                    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                                    "Sec-WebSocket-Version: 13\r\n\r\n";
+        std::string pending{};
+
+        if (!write_all(fd, upgrade) || !read_response(fd, pending, false))
+        {
+            Log::error(tag, "Websocket upgrade failed");
+            close(fd);
+
+            return;
+        }
+
+        // Masked binary frames, as sent by a client.
+        std::vector<uint8_t> frames{};
+
+        for (int i = 0; i < messages_per_write; ++i)
+        {
+            const uint8_t mask[] = { 0x12, 0x34, 0x56, 0x78 };
+            frames.push_back(0x82);
+            frames.push_back(static_cast<uint8_t>(0x80 | message_size));
+            frames.insert(frames.end(), std::begin(mask), std::end(mask));
+
+            for (size_t j = 0; j < message_size; ++j)
+            {
+                frames.push_back(static_cast<uint8_t>(j ^ mask[j % 4]));
+            }
+        }
+
+        auto calls_before = receive_calls.load();
+        auto start = steady_clock::now();
+        bool ok = true;
+
+        for (int sent = 0; ok && sent < WSCounter::expected_messages; sent += messages_per_write)
+        {
+            auto count = static_cast<size_t>(std::min(messages_per_write, WSCounter::expected_messages - sent));
+            ok = write_all(fd, frames.data(), count * frames.size() / static_cast<size_t>(messages_per_write));
+        }
+
+        // Wait for the reply that is sent once all messages have been received.
+        std::array<uint8_t, 16> reply{};
+        ok = ok && read(fd, reply.data(), reply.size()) > 0;
+
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        auto calls = receive_calls.load() - calls_before;
+        close(fd);
+
+        if (ok)
+        {
+            Log::info(tag,
+                      "Websocket: {} messages of {} bytes in {}ms, {:.0f} messages/s, {:.3f} recv() calls per message",
+                      WSCounter::expected_messages,
+                      message_size,
+                      elapsed.count() / 1000,
+                      WSCounter::expected_messages * 1e6 / static_cast<double>(std::max(elapsed.count(), int64_t{ 1 })),
+                      static_cast<double>(calls) / WSCounter::expected_messages);
+        }
+        else
+        {
+            Log::error(tag, "Websocket run failed");
+        }
+    }
+
+    void App::run_event_stream()
+    {
+        auto fd = connect_to_server();
+
+        if (fd < 0)
+        {
+            Log::error(tag, "Could not connect to server");
+            return;
+        }
+
+        timeval timeout{ 2, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::string received{};
+
+        if (!write_all(fd, "GET /events HTTP/1.1\r\nHost: localhost\r\n\r\n") || !read_response(fd, received, false))
+        {
+            Log::error(tag, "Event stream request failed");
+            close(fd);
+
+            return;
+        }
+
+        auto stream = event_source->get_stream();
+
+        for (int attempt = 0; !stream && attempt < 100; ++attempt)
+        {
+            std::this_thread::sleep_for(milliseconds{ 10 });
+            stream = event_source->get_stream();
+        }
+
+        if (!stream)
+        {
+            Log::error(tag, "Event stream not opened");
+            close(fd);
+
+            return;
+        }
+
+        auto send_calls_before = send_calls.load();
+        auto start = steady_clock::now();
+
+        // Events are sent from another thread, as fast as possible, just as an application task would.
+        std::thread producer([stream]() {
+                                 for (int i = 0; i < stream_events; ++i)
+                                 {
+                                     stream->send(std::to_string(i));
+                                 }
+
+                                 // Being the latest, the final event is never dropped.
+                                 stream->send("", "end");
+                             });
+
+        std::array<char, 4096> buff{};
+        bool ok = true;
+
+        while (ok && received.find("event: end") == std::string::npos)
+        {
+            auto res = read(fd, buff.data(), buff.size());
+            ok = res > 0;
+
+            if (ok)
+            {
+                received.append(buff.data(), static_cast<size_t>(res));
+            }
+        }
+
+        producer.join();
+
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        auto sends = send_calls.load() - send_calls_before;
+        close(fd);
+
+        // Not counting the final event.
+        int delivered = -1;
+
+        for (auto pos = received.find("data: "); pos != std::string::npos; pos = received.find("data: ", pos + 1))
+        {
+            ++delivered;
+        }
+
+        if (ok)
+        {
+            Log::info(tag,
+                      "Event stream: {} of {} events delivered ({} dropped) in {}ms, {:.0f} events/s, "
+                      "{:.3f} sendmsg() calls per event",
+                      delivered,
+                      stream_events,
+                      stream->get_dropped_count(),
+                      elapsed.count() / 1000,
+                      delivered * 1e6 / static_cast<double>(std::max(elapsed.count(), int64_t{ 1 })),
+                      static_cast<double>(sends) / std::max(delivered, 1));
+        }
+        else
+        {
+            Log::error(tag, "Event stream run failed");
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+#include "smooth/core/Application.h"
+#include "smooth/application/network/http/HTTPServer.h"
+#include "EventSource.h"
+
+namespace http_benchmark
+{
+    /// Measures the number of recv() and sendmsg() calls and the throughput of the HTTP server, for
+    /// regular requests, one at a time and pipelined, for small websocket messages and for server-sent
+    /// events. The load is generated from a separate thread, connecting to the server over the loopback
+    /// interface.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            ~App() override;
+
+            void init() override;
+
+        private:
+            void generate_load();
+
+            void run_http_requests();
+
+            /// Sends requests over a keep-alive connection, 'depth' at a time before reading the responses.
+            void run_requests(const char* name, int depth);
+
+            /// Sends one request per connection from several threads at once, more than there are clients
+            /// to serve them, so that new connections have to wait for a client to be returned.
+            void run_connection_burst();
+
+            void run_websocket_messages();
+
+            /// Sends events on an event stream from another thread while reading them as a browser would.
+            void run_event_stream();
+
+            static constexpr int MaxHeaderSize = 1024;
+            static constexpr int ContentChunkSize = 2048;
+            static constexpr int MaxResponses = 10;
+
+            std::unique_ptr<smooth::application::network::http::InsecureServer> server{};
+            std::shared_ptr<EventSource> event_source{ std::make_shared<EventSource>() };
+            std::thread load{};
+    };
+}
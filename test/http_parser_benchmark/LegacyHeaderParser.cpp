@@ -0,0 +1,105 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "LegacyHeaderParser.h"
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include "smooth/core/util/string_util.h"
+
+using namespace smooth::core;
+
+namespace http_parser_benchmark
+{
+    static constexpr std::array<uint8_t, 4> ending{ '\r', '\n', '\r', '\n' };
+
+    int LegacyHeaderParser::data_received(std::vector<uint8_t>& data, std::size_t received, ParsedRequest& request)
+    {
+        int res = 0;
+        const auto end = data.cbegin() + static_cast<std::vector<uint8_t>::difference_type>(received);
+        const auto end_of_header = std::search(data.cbegin(), end, ending.cbegin(), ending.cend());
+
+        if (end_of_header != end)
+        {
+            res = consume_headers(data, end_of_header, request);
+        }
+
+        return res;
+    }
+
+    int LegacyHeaderParser::consume_headers(std::vector<uint8_t>& data,
+                                            std::vector<uint8_t>::const_iterator header_ending,
+                                            ParsedRequest& request)
+    {
+        std::stringstream ss;
+
+        std::for_each(data.cbegin(),
+                      header_ending,
+                      [&ss](auto& c) {
+                          if (c != '\n')
+                          {
+                              ss << static_cast<char>(c);
+                          }
+        });
+
+        header_ending += ending.size();
+        auto actual_header_bytes_received = static_cast<int>(std::distance(data.cbegin(), header_ending));
+        data.erase(data.begin(), header_ending);
+
+        std::string s;
+
+        while (std::getline(ss, s, '\r'))
+        {
+            if (!s.empty())
+            {
+                auto colon = std::find(s.begin(), s.end(), ':');
+
+                if (colon == s.end())
+                {
+                    std::smatch m;
+
+                    if (std::regex_match(s, m, request_line))
+                    {
+                        request.method = m[1].str();
+                        request.url = m[2].str();
+                        request.version = m[3].str();
+                    }
+                    else if (std::regex_match(s, m, response_line))
+                    {
+                        request.version = m[1].str();
+                    }
+                }
+                else if (std::distance(colon, s.end()) > 2)
+                {
+                    auto& curr_header = request.headers[string_util::to_lower_copy({ s.begin(), colon })];
+
+                    if (curr_header.empty())
+                    {
+                        curr_header = { colon + 2, s.end() };
+                    }
+                    else
+                    {
+                        curr_header.append(", ").append({ colon + 2, s.end() });
+                    }
+                }
+            }
+        }
+
+        return actual_header_bytes_received;
+    }
+}
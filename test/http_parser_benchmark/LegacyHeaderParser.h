@@ -0,0 +1,56 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace http_parser_benchmark
+{
+    using Headers = std::unordered_map<std::string, std::string>;
+
+    struct ParsedRequest
+    {
+        std::string method{};
+        std::string url{};
+        std::string version{};
+        Headers headers{};
+    };
+
+    /// The header parsing previously done by RegularHTTPProtocol, kept as a reference: the received data is
+    /// searched for the end of the headers after each receive, then the header block is copied into a
+    /// stringstream, split into lines and matched against regular expressions.
+    class LegacyHeaderParser
+    {
+        public:
+            /// Called after each receive with the total number of bytes received.
+            /// \return The size of the headers once complete, otherwise 0.
+            int data_received(std::vector<uint8_t>& data, std::size_t received, ParsedRequest& request);
+
+        private:
+            int consume_headers(std::vector<uint8_t>& data,
+                                std::vector<uint8_t>::const_iterator header_ending,
+                                ParsedRequest& request);
+
+            const std::regex response_line{ R"!(HTTP\/(\d.\d)\ (\d+)\ (.+))!" }; // HTTP/1.1 200 OK
+            const std::regex request_line{ R"!((.+)\ (.+)\ HTTP\/(\d\.\d))!" }; // "GET / HTTP/1.1"
+    };
+}
@@ -0,0 +1,182 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "http_parser_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+#include "smooth/core/util/string_util.h"
+#include "request_corpus.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http::regular;
+using namespace std::chrono;
+
+namespace http_parser_benchmark
+{
+    static constexpr const char* tag = "HTTPParserBenchmark";
+    static constexpr int iterations = 20000;
+    static constexpr std::size_t max_header_size = 4096;
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        if (verify())
+        {
+            run(max_header_size);
+            run(64);
+            Log::info(tag, "Benchmark complete");
+        }
+    }
+
+    bool App::verify()
+    {
+        bool res = true;
+
+        for (const auto& request : request_corpus())
+        {
+            ParsedRequest expected{};
+            ParsedRequest actual{};
+            legacy_parse(request, 17, expected);
+            parse(request, 17, actual);
+
+            if (expected.method != actual.method
+                || expected.url != actual.url
+                || expected.version != actual.version
+                || expected.headers != actual.headers)
+            {
+                Log::error(tag, "Parsers disagree on request: {}", request);
+                res = false;
+            }
+        }
+
+        return res;
+    }
+
+    void App::run(std::size_t receive_size)
+    {
+        auto requests = iterations * static_cast<int>(request_corpus().size());
+        ParsedRequest parsed{};
+
+        auto start = steady_clock::now();
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (const auto& request : request_corpus())
+            {
+                parsed.headers.clear();
+                legacy_parse(request, receive_size, parsed);
+            }
+        }
+
+        auto legacy_time = duration_cast<nanoseconds>(steady_clock::now() - start);
+
+        start = steady_clock::now();
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (const auto& request : request_corpus())
+            {
+                parsed.headers.clear();
+                parse(request, receive_size, parsed);
+            }
+        }
+
+        auto new_time = duration_cast<nanoseconds>(steady_clock::now() - start);
+
+        Log::info(tag, "Receive size {}: legacy {}ns/request, incremental {}ns/request ({:.1f}x)",
+                  std::min(receive_size, max_header_size),
+                  legacy_time.count() / requests,
+                  new_time.count() / requests,
+                  static_cast<double>(legacy_time.count()) / static_cast<double>(new_time.count()));
+    }
+
+    void App::legacy_parse(const std::string& request, std::size_t receive_size, ParsedRequest& parsed)
+    {
+        buffer.resize(max_header_size);
+        std::size_t received = 0;
+        int header_size = 0;
+
+        while (header_size == 0 && received < request.size())
+        {
+            auto amount = std::min(receive_size, request.size() - received);
+            std::copy_n(request.begin() + static_cast<std::string::difference_type>(received),
+                        amount,
+                        buffer.begin() + static_cast<std::vector<uint8_t>::difference_type>(received));
+            received += amount;
+            header_size = legacy.data_received(buffer, received, parsed);
+        }
+    }
+
+    void App::parse(const std::string& request, std::size_t receive_size, ParsedRequest& parsed)
+    {
+        buffer.resize(max_header_size);
+        parser.reset();
+        std::size_t received = 0;
+        auto res = HTTPHeaderParser::Result::NeedMoreData;
+
+        while (res == HTTPHeaderParser::Result::NeedMoreData && received < request.size())
+        {
+            auto amount = std::min(receive_size, request.size() - received);
+            std::copy_n(request.begin() + static_cast<std::string::difference_type>(received),
+                        amount,
+                        buffer.begin() + static_cast<std::vector<uint8_t>::difference_type>(received));
+            received += amount;
+            res = parser.parse(buffer.data(), received);
+        }
+
+        if (res == HTTPHeaderParser::Result::Complete)
+        {
+            // Same work as RegularHTTPProtocol::consume_headers()
+            const auto* data = buffer.data();
+            const auto& start_line = parser.start_line();
+            parsed.method = HTTPHeaderParser::view(data, start_line[0]);
+            parsed.url = HTTPHeaderParser::view(data, start_line[1]);
+            parsed.version = HTTPHeaderParser::view(data, start_line[2]);
+
+            for (std::size_t i = 0; i < parser.header_count(); ++i)
+            {
+                const auto& header = parser.header(i);
+                auto name = string_util::to_lower_copy(std::string{ HTTPHeaderParser::view(data, header.name) });
+                auto value = HTTPHeaderParser::view(data, header.value);
+                auto& curr_header = parsed.headers[name];
+
+                if (curr_header.empty())
+                {
+                    curr_header = value;
+                }
+                else
+                {
+                    curr_header.append(", ").append(value);
+                }
+            }
+
+            buffer.erase(buffer.begin(),
+                         buffer.begin() + static_cast<std::vector<uint8_t>::difference_type>(parser.header_size()));
+        }
+    }
+}
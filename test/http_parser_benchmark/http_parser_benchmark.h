@@ -0,0 +1,52 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+#include "LegacyHeaderParser.h"
+
+namespace http_parser_benchmark
+{
+    /// Compares the incremental header parser with the previous stringstream/regex based parsing,
+    /// using recorded requests delivered either in a single receive or in small pieces.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            void init() override;
+
+        private:
+            bool verify();
+
+            void run(std::size_t receive_size);
+
+            void legacy_parse(const std::string& request, std::size_t receive_size, ParsedRequest& parsed);
+
+            void parse(const std::string& request, std::size_t receive_size, ParsedRequest& parsed);
+
+            LegacyHeaderParser legacy{};
+            smooth::application::network::http::regular::HTTPHeaderParser parser{};
+            std::vector<uint8_t> buffer{};
+    };
+}
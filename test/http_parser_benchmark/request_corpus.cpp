@@ -0,0 +1,133 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "request_corpus.h"
+
+namespace http_parser_benchmark
+{
+    const std::vector<std::string>& request_corpus()
+    {
+        static const std::vector<std::string> corpus{
+            // Chrome, page load
+            "GET / HTTP/1.1\r\n"
+            "Host: 192.168.10.200:8080\r\n"
+            "Connection: keep-alive\r\n"
+            "Cache-Control: max-age=0\r\n"
+            "Upgrade-Insecure-Requests: 1\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+            "Chrome/78.0.3904.108 Safari/537.36\r\n"
+            "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,image/apng,*/*;q=0.8,"
+            "application/signed-exchange;v=b3\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "Accept-Language: en-US,en;q=0.9,sv;q=0.8\r\n"
+            "\r\n",
+
+            // Chrome, image
+            "GET /images/dog.jpg HTTP/1.1\r\n"
+            "Host: 192.168.10.200:8080\r\n"
+            "Connection: keep-alive\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+            "Chrome/78.0.3904.108 Safari/537.36\r\n"
+            "Accept: image/webp,image/apng,image/*,*/*;q=0.8\r\n"
+            "Referer: http://192.168.10.200:8080/\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "Accept-Language: en-US,en;q=0.9,sv;q=0.8\r\n"
+            "If-None-Match: \"5dd2f1a3-1f7e4\"\r\n"
+            "If-Modified-Since: Mon, 18 Nov 2019 19:35:31 GMT\r\n"
+            "\r\n",
+
+            // Firefox, page load
+            "GET /index.html HTTP/1.1\r\n"
+            "Host: 192.168.10.200:8080\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Ubuntu; Linux x86_64; rv:70.0) Gecko/20100101 Firefox/70.0\r\n"
+            "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+            "Accept-Language: en-US,en;q=0.5\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "DNT: 1\r\n"
+            "Connection: keep-alive\r\n"
+            "Upgrade-Insecure-Requests: 1\r\n"
+            "Pragma: no-cache\r\n"
+            "Cache-Control: no-cache\r\n"
+            "\r\n",
+
+            // Firefox, form upload
+            "POST /upload HTTP/1.1\r\n"
+            "Host: 192.168.10.200:8080\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Ubuntu; Linux x86_64; rv:70.0) Gecko/20100101 Firefox/70.0\r\n"
+            "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+            "Accept-Language: en-US,en;q=0.5\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "Content-Type: multipart/form-data; boundary=---------------------------9051914041544843365972754266\r\n"
+            "Content-Length: 554\r\n"
+            "Origin: http://192.168.10.200:8080\r\n"
+            "DNT: 1\r\n"
+            "Connection: keep-alive\r\n"
+            "Referer: http://192.168.10.200:8080/upload.html\r\n"
+            "Upgrade-Insecure-Requests: 1\r\n"
+            "\r\n",
+
+            // Safari, XHR
+            "POST /api/settings HTTP/1.1\r\n"
+            "Host: 192.168.10.200:8080\r\n"
+            "Content-Type: application/json\r\n"
+            "Origin: http://192.168.10.200:8080\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "Connection: keep-alive\r\n"
+            "Accept: */*\r\n"
+            "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_1) AppleWebKit/605.1.15 (KHTML, like Gecko) "
+            "Version/13.0.3 Safari/605.1.15\r\n"
+            "Referer: http://192.168.10.200:8080/settings.html\r\n"
+            "Content-Length: 27\r\n"
+            "Accept-Language: en-us\r\n"
+            "\r\n",
+
+            // Websocket upgrade
+            "GET /sockets/ HTTP/1.1\r\n"
+            "Host: 192.168.10.200:8080\r\n"
+            "Connection: Upgrade\r\n"
+            "Pragma: no-cache\r\n"
+            "Cache-Control: no-cache\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+            "Chrome/78.0.3904.108 Safari/537.36\r\n"
+            "Upgrade: websocket\r\n"
+            "Origin: http://192.168.10.200:8080\r\n"
+            "Sec-WebSocket-Version: 13\r\n"
+            "Accept-Encoding: gzip, deflate\r\n"
+            "Accept-Language: en-US,en;q=0.9,sv;q=0.8\r\n"
+            "Sec-WebSocket-Key: 4dL8xTx2pbUQ5d/tCo0c3Q==\r\n"
+            "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n"
+            "\r\n",
+
+            // curl
+            "GET /api/status HTTP/1.1\r\n"
+            "Host: 192.168.10.200:8080\r\n"
+            "User-Agent: curl/7.65.3\r\n"
+            "Accept: */*\r\n"
+            "\r\n",
+
+            // ESP32 HTTP client
+            "GET /firmware/version HTTP/1.1\r\n"
+            "User-Agent: ESP32 HTTP Client/1.0\r\n"
+            "Host: 192.168.10.200:8080\r\n"
+            "Content-Length: 0\r\n"
+            "\r\n"
+        };
+
+        return corpus;
+    }
+}
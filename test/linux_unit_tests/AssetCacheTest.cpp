@@ -0,0 +1,207 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <string>
+#include <utime.h>
+#include "smooth/application/network/http/regular/AssetCache.h"
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/filesystem.h"
+#include "smooth/core/filesystem/FSLock.h"
+
+using namespace smooth::core::filesystem;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+
+namespace
+{
+    std::string content_of(const AssetCache::Variant& v)
+    {
+        return { reinterpret_cast<const char*>(v.data), v.size };
+    }
+}
+
+SCENARIO("AssetCache")
+{
+    FSLock::set_limit(5);
+
+    const auto dir = Path{ "test_data" } / "asset_cache";
+    create_directory(Path{ dir });
+
+    const auto js = dir / "app.js";
+    const auto css = dir / "style.css";
+    const auto html = dir / "index.html";
+    REQUIRE(File{ static_cast<const char*>(js) }.write(std::string(100, 'j')));
+    REQUIRE(File{ static_cast<const char*>(dir / "app.js.gz") }.write(std::string(10, 'z')));
+    REQUIRE(File{ static_cast<const char*>(css) }.write(std::string(100, 'c')));
+    REQUIRE(File{ static_cast<const char*>(html) }.write(std::string(100, 'h')));
+
+    GIVEN("A cache with room for four times the largest file")
+    {
+        AssetCache cache{ 440 };
+
+        THEN("Files are loaded with their precompressed variant")
+        {
+            auto asset = cache.get(js, 1);
+            REQUIRE(asset);
+            REQUIRE(content_of(asset->identity) == std::string(100, 'j'));
+            REQUIRE(asset->gzip.exists());
+            REQUIRE(content_of(asset->gzip) == std::string(10, 'z'));
+            REQUIRE(asset->content_type == "text/javascript");
+            REQUIRE(asset->identity.etag.size() == 18);
+            REQUIRE(asset->identity.etag != asset->gzip.etag);
+            REQUIRE(cache.size() == 110);
+
+            AND_THEN("Cached files are reused")
+            {
+                REQUIRE(cache.get(js, 1) == asset);
+            }
+
+            AND_THEN("Modified files are reloaded")
+            {
+                auto reloaded = cache.get(js, 2);
+                REQUIRE(reloaded);
+                REQUIRE(reloaded != asset);
+                REQUIRE(reloaded->identity.etag == asset->identity.etag);
+                REQUIRE(cache.size() == 110);
+            }
+        }
+
+        THEN("The least recently used file is evicted when over budget")
+        {
+            auto first = cache.get(js, 1);
+            auto second = cache.get(css, 1);
+            REQUIRE(cache.get(js, 1) == first);
+            REQUIRE(cache.size() == 210);
+
+            REQUIRE(File{ static_cast<const char*>(dir / "other.txt") }.write(std::string(110, 'o')));
+            auto other = cache.get(dir / "other.txt", 1);
+            REQUIRE(other);
+            REQUIRE(cache.size() == 320);
+
+            REQUIRE(cache.get(html, 1));
+            REQUIRE(cache.size() == 420);
+
+            REQUIRE(File{ static_cast<const char*>(dir / "more.txt") }.write(std::string(100, 'm')));
+            REQUIRE(cache.get(dir / "more.txt", 1));
+            REQUIRE(cache.size() == 420);
+
+            // style.css was least recently used.
+            REQUIRE(cache.get(js, 1) == first);
+            REQUIRE(cache.get(css, 1) != second);
+        }
+
+        THEN("Files larger than a quarter of the budget are not cached")
+        {
+            REQUIRE(File{ static_cast<const char*>(dir / "large.bin") }.write(std::string(111, 'l')));
+            REQUIRE_FALSE(cache.get(dir / "large.bin", 1));
+            REQUIRE(cache.size() == 0);
+        }
+
+        THEN("Files whose precompressed variant takes them over a quarter of the budget are not cached")
+        {
+            REQUIRE(File{ static_cast<const char*>(dir / "page.html") }.write(std::string(100, 'p')));
+            REQUIRE(File{ static_cast<const char*>(dir / "page.html.gz") }.write(std::string(11, 'z')));
+            REQUIRE_FALSE(cache.get(dir / "page.html", 1));
+            REQUIRE(cache.size() == 0);
+        }
+
+        THEN("Truncated files are reloaded")
+        {
+            auto asset = cache.get(css, 1);
+            REQUIRE(asset);
+            REQUIRE(File{ static_cast<const char*>(css) }.write(std::string(50, 'c')));
+
+            auto reloaded = cache.get(css, 1);
+            REQUIRE(reloaded);
+            REQUIRE(reloaded != asset);
+            REQUIRE(content_of(reloaded->identity) == std::string(50, 'c'));
+            REQUIRE(cache.size() == 50);
+        }
+
+        THEN("Files are reloaded when their precompressed variant is rebuilt")
+        {
+            auto asset = cache.get(js, 1);
+            REQUIRE(asset);
+
+            const auto gz = dir / "app.js.gz";
+            REQUIRE(File{ static_cast<const char*>(gz) }.write(std::string(10, 'y')));
+            const utimbuf later{ asset->gzip_last_modified + 10, asset->gzip_last_modified + 10 };
+            REQUIRE(utime(gz, &later) == 0);
+
+            auto reloaded = cache.get(js, 1);
+            REQUIRE(reloaded);
+            REQUIRE(reloaded != asset);
+            REQUIRE(content_of(reloaded->gzip) == std::string(10, 'y'));
+            REQUIRE(reloaded->gzip.etag != asset->gzip.etag);
+            REQUIRE(reloaded->identity.etag == asset->identity.etag);
+            REQUIRE(cache.get(js, 1) == reloaded);
+        }
+
+        THEN("Files are reloaded when a precompressed variant is added")
+        {
+            const auto gz = dir / "index.html.gz";
+            std::remove(gz);
+
+            auto asset = cache.get(html, 1);
+            REQUIRE(asset);
+            REQUIRE_FALSE(asset->gzip.exists());
+
+            REQUIRE(File{ static_cast<const char*>(gz) }.write(std::string(10, 'z')));
+            auto reloaded = cache.get(html, 1);
+            std::remove(gz);
+
+            REQUIRE(reloaded);
+            REQUIRE(content_of(reloaded->gzip) == std::string(10, 'z'));
+            REQUIRE(cache.size() == 110);
+        }
+
+        THEN("Missing files are not cached")
+        {
+            REQUIRE_FALSE(cache.get(dir / "missing.txt", 1));
+        }
+    }
+
+    GIVEN("A disabled cache")
+    {
+        AssetCache cache{ 0 };
+        REQUIRE_FALSE(cache.get(js, 1));
+    }
+}
+
+SCENARIO("Content negotiation and validation")
+{
+    REQUIRE(utils::accepts_encoding("gzip, deflate, br", "gzip"));
+    REQUIRE(utils::accepts_encoding("deflate, GZIP;q=0.5", "gzip"));
+    REQUIRE_FALSE(utils::accepts_encoding("deflate, br", "gzip"));
+    REQUIRE_FALSE(utils::accepts_encoding("gzip;q=0, *", "gzip"));
+    REQUIRE_FALSE(utils::accepts_encoding("gzip; q=0.000", "gzip"));
+    REQUIRE(utils::accepts_encoding("*", "gzip"));
+    REQUIRE_FALSE(utils::accepts_encoding("*;q=0", "gzip"));
+    REQUIRE_FALSE(utils::accepts_encoding("", "gzip"));
+
+    REQUIRE(utils::matches_etag("\"abc\"", "\"abc\""));
+    REQUIRE(utils::matches_etag("\"x\", \"abc\"", "\"abc\""));
+    REQUIRE(utils::matches_etag("W/\"abc\"", "\"abc\""));
+    REQUIRE(utils::matches_etag("*", "\"abc\""));
+    REQUIRE_FALSE(utils::matches_etag("\"abcd\"", "\"abc\""));
+    REQUIRE_FALSE(utils::matches_etag("", "\"abc\""));
+}
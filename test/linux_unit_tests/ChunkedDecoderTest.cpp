@@ -0,0 +1,327 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "smooth/application/network/http/HTTPPacket.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/regular/ChunkedDecoder.h"
+#include "smooth/application/network/http/regular/RegularHTTPProtocol.h"
+#include "ServerResponseMock.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using linux_unit_tests::ServerResponseMock;
+
+namespace
+{
+    // Decodes the data in pieces of the given size, returning the content.
+    std::string decode(ChunkedDecoder& decoder, std::string data, std::size_t piece_size)
+    {
+        std::string res{};
+        std::size_t pos = 0;
+
+        while (pos < data.size() && !decoder.is_complete() && !decoder.is_error())
+        {
+            auto* piece = reinterpret_cast<uint8_t*>(&data[pos]);
+            auto length = std::min(piece_size, data.size() - pos);
+            auto decoded = decoder.decode(piece, length);
+            res.append(reinterpret_cast<const char*>(piece), decoded);
+            pos += length;
+        }
+
+        return res;
+    }
+
+    std::string as_string(const smooth::core::network::PacketSegment& segment)
+    {
+        return std::string{ reinterpret_cast<const char*>(segment.data), static_cast<std::size_t>(segment.length) };
+    }
+
+    std::string all_segments(HTTPPacket& packet)
+    {
+        std::string res{};
+
+        for (int i = 0; i < packet.get_segment_count(); ++i)
+        {
+            res += as_string(packet.get_segment(i));
+        }
+
+        return res;
+    }
+
+    class UpgradeMock
+        : public IUpgradeToWebsocket
+    {
+        public:
+            void upgrade_to_websocket() override
+            {}
+    };
+
+    struct ReceivedPacket
+    {
+        std::string content;
+        bool continued;
+        bool continuation;
+    };
+
+    void receive(RegularHTTPProtocol& proto, const std::string& data, HTTPPacket& packet,
+                 std::vector<ReceivedPacket>& packets)
+    {
+        std::size_t pos = 0;
+
+        while (pos < data.size() && !proto.is_error())
+        {
+            auto wanted = static_cast<std::size_t>(proto.get_wanted_amount(packet));
+            auto amount = std::min(wanted, data.size() - pos);
+            std::copy_n(data.begin() + static_cast<std::ptrdiff_t>(pos), amount, proto.get_write_pos(packet));
+            pos += amount;
+            proto.data_received(packet, static_cast<int>(amount));
+
+            if (proto.is_complete(packet))
+            {
+                packets.push_back({ std::string{ packet.data().begin(), packet.data().end() },
+                                    packet.is_continued(),
+                                    packet.is_continuation() });
+                proto.packet_consumed();
+                packet = HTTPPacket{};
+            }
+        }
+    }
+
+    // Feeds the data, arriving in the given pieces, to the protocol the same way
+    // the receive buffer does, respecting the wanted amount.
+    std::vector<ReceivedPacket> receive(RegularHTTPProtocol& proto, const std::vector<std::string>& arrivals)
+    {
+        std::vector<ReceivedPacket> packets{};
+        HTTPPacket packet{};
+
+        for (const auto& data : arrivals)
+        {
+            receive(proto, data, packet, packets);
+        }
+
+        return packets;
+    }
+}
+
+SCENARIO("ChunkedDecoder")
+{
+    const std::string encoded = "4\r\nWiki\r\n"
+                                "6;name=value\r\npedia \r\n"
+                                "E\r\nin \r\n\r\nchunks.\r\n"
+                                "0\r\n"
+                                "Expires: never\r\n"
+                                "\r\n";
+
+    const std::string expected = "Wikipedia in \r\n\r\nchunks.";
+
+    GIVEN("Encoded data with extensions and trailers")
+    {
+        THEN("It decodes the same regardless of how the data is split")
+        {
+            for (std::size_t piece_size = 1; piece_size <= encoded.size(); ++piece_size)
+            {
+                ChunkedDecoder decoder{};
+                REQUIRE(decode(decoder, encoded, piece_size) == expected);
+                REQUIRE(decoder.is_complete());
+                REQUIRE_FALSE(decoder.is_error());
+            }
+        }
+    }
+
+    GIVEN("A decoder in the middle of a chunk")
+    {
+        ChunkedDecoder decoder{};
+        REQUIRE(decode(decoder, "1a\r\nabc", 7) == "abc");
+
+        THEN("It reports the remaining content of the chunk")
+        {
+            REQUIRE(decoder.in_content());
+            REQUIRE(decoder.content_remaining() == 0x1a - 3);
+        }
+    }
+
+    GIVEN("Malformed data")
+    {
+        const std::vector<std::string> bad{
+            "\r\n",                  // Missing size
+            "x\r\n",                 // Not hex
+            "123456789\r\n",         // Too many digits
+            "1\r\nab\r\n",           // Chunk larger than size
+            "1\nab\r\n",             // Missing CR
+            "0\r\n\rX",              // Broken end of message
+        };
+
+        THEN("The decoder enters the error state")
+        {
+            for (const auto& data : bad)
+            {
+                ChunkedDecoder decoder{};
+                decode(decoder, data, data.size());
+                REQUIRE(decoder.is_error());
+
+                decoder.reset();
+                REQUIRE_FALSE(decoder.is_error());
+            }
+        }
+    }
+
+    GIVEN("An endless trailer")
+    {
+        ChunkedDecoder decoder{};
+        std::string data = "0\r\nX-Long: " + std::string(2000, 'a');
+
+        THEN("The decoder enters the error state")
+        {
+            decode(decoder, data, data.size());
+            REQUIRE(decoder.is_error());
+        }
+    }
+}
+
+SCENARIO("HTTPPacket - chunked framing")
+{
+    GIVEN("A packet with headers and content")
+    {
+        HTTPPacket p{ ResponseCode::OK, "1.1", { { "transfer-encoding", "chunked" } },
+                      std::vector<uint8_t>{ 'a', 'b', 'c' } };
+
+        WHEN("Framed as a chunk")
+        {
+            p.frame_as_chunk(false);
+
+            THEN("The size line follows the headers and the content is left in place")
+            {
+                auto data = all_segments(p);
+                REQUIRE(data.find("\r\n\r\n3\r\nabc\r\n") != std::string::npos);
+                REQUIRE(p.get_send_length() == static_cast<int>(data.size()));
+                REQUIRE(as_string(p.get_segment(1)) == "abc");
+            }
+        }
+
+        WHEN("Framed as the last chunk")
+        {
+            p.frame_as_chunk(true);
+
+            THEN("The last chunk follows")
+            {
+                auto data = all_segments(p);
+                REQUIRE(data.substr(data.size() - 13) == "3\r\nabc\r\n0\r\n\r\n");
+            }
+        }
+    }
+
+    GIVEN("A content only packet")
+    {
+        std::vector<uint8_t> content(300, 'x');
+        HTTPPacket p{ content };
+        p.frame_as_chunk(false);
+
+        THEN("It is sent as a chunk")
+        {
+            REQUIRE(all_segments(p) == "12c\r\n" + std::string(300, 'x') + "\r\n");
+        }
+    }
+
+    GIVEN("An empty packet")
+    {
+        HTTPPacket p{};
+        p.frame_as_chunk(true);
+
+        THEN("It is the last chunk")
+        {
+            REQUIRE(all_segments(p) == "0\r\n\r\n");
+        }
+    }
+}
+
+SCENARIO("RegularHTTPProtocol - chunked request")
+{
+    ServerResponseMock response{};
+    UpgradeMock upgrade{};
+
+    const std::string headers = "POST /upload HTTP/1.1\r\n"
+                                "Host: localhost\r\n"
+                                "Transfer-Encoding: chunked\r\n"
+                                "\r\n";
+
+    GIVEN("A chunked request with a body larger than a content chunk")
+    {
+        RegularHTTPProtocol proto{ 1024, 10, response, upgrade };
+
+        auto packets = receive(proto, { headers, "7\r\nabcdefg\r\n9\r\nhijklmnop\r\n3\r\nqrs\r\n0\r\n\r\n" });
+
+        THEN("The content is delivered in parts, without the framing")
+        {
+            std::string content{};
+
+            for (const auto& p : packets)
+            {
+                content += p.content;
+            }
+
+            REQUIRE(content == "abcdefghijklmnopqrs");
+            REQUIRE(packets.size() >= 2);
+            REQUIRE_FALSE(packets.front().continuation);
+            REQUIRE(packets.front().continued);
+            REQUIRE(packets.back().continuation);
+            REQUIRE_FALSE(packets.back().continued);
+            REQUIRE(response.errors.empty());
+        }
+    }
+
+    GIVEN("A chunked request followed by another request")
+    {
+        RegularHTTPProtocol proto{ 1024, 100, response, upgrade };
+
+        auto packets = receive(proto, { headers, "3\r\nabc\r\n0\r\n\r\nGET / HTTP/1.1\r\n\r\n" });
+
+        THEN("Nothing beyond the end of the chunked content is consumed")
+        {
+            REQUIRE(packets.size() == 2);
+            REQUIRE(packets[0].content == "abc");
+            REQUIRE(packets[1].content.empty());
+            REQUIRE_FALSE(packets[1].continuation);
+        }
+    }
+
+    GIVEN("Malformed chunked content")
+    {
+        RegularHTTPProtocol proto{ 1024, 100, response, upgrade };
+        receive(proto, { headers + "zz\r\n" });
+
+        THEN("Bad request is replied")
+        {
+            REQUIRE(response.errors == std::vector<ResponseCode>{ ResponseCode::Bad_Request });
+        }
+    }
+
+    GIVEN("An unsupported transfer coding")
+    {
+        RegularHTTPProtocol proto{ 1024, 100, response, upgrade };
+        receive(proto, { "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n" });
+
+        THEN("Not implemented is replied")
+        {
+            REQUIRE(response.errors == std::vector<ResponseCode>{ ResponseCode::Not_Implemented });
+        }
+    }
+}
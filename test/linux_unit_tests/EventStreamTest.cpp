@@ -0,0 +1,167 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <thread>
+#include "smooth/application/network/http/regular/responses/EventStreamResponse.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::application::network::http::regular::responses;
+
+namespace
+{
+    /// Gets all data available from the response, in parts of at most max_amount bytes.
+    ResponseStatus read_all(EventStreamResponse& response, std::string& target, std::size_t max_amount = 1024)
+    {
+        ResponseStatus res;
+
+        do
+        {
+            std::vector<uint8_t> data{};
+            res = response.get_data(max_amount, data);
+            REQUIRE(data.size() <= max_amount);
+            target.append(data.begin(), data.end());
+        }
+        while (res == ResponseStatus::HasMoreData);
+
+        return res;
+    }
+}
+
+SCENARIO("EventStreamResponse")
+{
+    GIVEN("A response for an event stream")
+    {
+        auto stream = std::make_shared<EventStream>(3);
+        auto response = std::make_unique<EventStreamResponse>(stream);
+        int woken = 0;
+        response->set_wake_up([&woken]() { ++woken; });
+
+        THEN("It is sent as an event stream")
+        {
+            REQUIRE(response->get_response_code() == ResponseCode::OK);
+            REQUIRE(response->get_headers().at(CONTENT_TYPE) == "text/event-stream");
+            REQUIRE(response->get_headers().at(CACHE_CONTROL) == "no-cache");
+        }
+
+        THEN("Events are formatted as per the specification")
+        {
+            REQUIRE(stream->send("plain"));
+            REQUIRE(stream->send("first\nsecond", "update", "42"));
+            REQUIRE(stream->send(""));
+
+            std::string out{};
+            REQUIRE(read_all(*response, out) == ResponseStatus::Pending);
+            REQUIRE(out == "data: plain\n\n"
+                           "event: update\nid: 42\ndata: first\ndata: second\n\n"
+                           "data: \n\n");
+        }
+
+        THEN("Large events are split according to the requested amount")
+        {
+            const std::string data(100, 'x');
+            stream->send(data);
+
+            std::string out{};
+            REQUIRE(read_all(*response, out, 7) == ResponseStatus::Pending);
+            REQUIRE(out == "data: " + data + "\n\n");
+        }
+
+        THEN("The response is woken up once when an event is sent while it waits for data")
+        {
+            std::string out{};
+            stream->send("a");
+            REQUIRE(read_all(*response, out) == ResponseStatus::Pending);
+            REQUIRE(woken == 0);
+
+            REQUIRE(read_all(*response, out) == ResponseStatus::Pending);
+            stream->send("b");
+            stream->send("c");
+            REQUIRE(woken == 1);
+
+            REQUIRE(read_all(*response, out) == ResponseStatus::Pending);
+            REQUIRE(out == "data: a\n\ndata: b\n\ndata: c\n\n");
+        }
+
+        THEN("The oldest events are dropped when the client can't keep up")
+        {
+            for (int i = 0; i < 5; ++i)
+            {
+                stream->send(std::to_string(i));
+            }
+
+            REQUIRE(stream->get_dropped_count() == 2);
+
+            std::string out{};
+            read_all(*response, out);
+            REQUIRE(out == "data: 2\n\ndata: 3\n\ndata: 4\n\n");
+        }
+
+        THEN("Closing the stream ends the response after the queued events")
+        {
+            std::string out{};
+            REQUIRE(read_all(*response, out) == ResponseStatus::Pending);
+
+            stream->send("last");
+            stream->close();
+            REQUIRE_FALSE(stream->is_open());
+            REQUIRE_FALSE(stream->send("too late"));
+            REQUIRE(woken == 1);
+
+            REQUIRE(read_all(*response, out) == ResponseStatus::LastData);
+            REQUIRE(out == "data: last\n\n");
+        }
+
+        THEN("The stream is closed when the response goes away")
+        {
+            stream->send("never sent");
+            response.reset();
+            REQUIRE_FALSE(stream->is_open());
+            REQUIRE_FALSE(stream->send("more"));
+            REQUIRE(woken == 0);
+        }
+
+        THEN("Events can be sent from other threads")
+        {
+            std::thread producer([stream]() {
+                                     for (int i = 0; i < 1000; ++i)
+                                     {
+                                         stream->send("x");
+                                     }
+
+                                     stream->close();
+                                 });
+
+            std::string out{};
+            ResponseStatus res;
+
+            do
+            {
+                res = read_all(*response, out);
+            }
+            while (res != ResponseStatus::LastData);
+
+            producer.join();
+            REQUIRE(out.size() % std::string{ "data: x\n\n" }.size() == 0);
+            REQUIRE(out.size() / std::string{ "data: x\n\n" }.size() + stream->get_dropped_count() == 1000);
+        }
+    }
+}
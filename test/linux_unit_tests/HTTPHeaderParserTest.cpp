@@ -0,0 +1,149 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+#include "smooth/application/network/http/regular/HTTPHeaderParser.h"
+
+using namespace smooth::application::network::http::regular;
+
+namespace
+{
+    const uint8_t* as_bytes(const std::string& s)
+    {
+        return reinterpret_cast<const uint8_t*>(s.data());
+    }
+
+    std::string_view part(const std::string& s, HTTPHeaderParser::Span span)
+    {
+        return HTTPHeaderParser::view(as_bytes(s), span);
+    }
+}
+
+SCENARIO("HTTPHeaderParser - request")
+{
+    const std::string request = "GET /index.html?a=b HTTP/1.1\r\n"
+                                "Host: localhost\r\n"
+                                "Accept:text/html  \r\n"
+                                "X-Empty:\r\n"
+                                "\r\n"
+                                "content";
+
+    GIVEN("A complete request")
+    {
+        HTTPHeaderParser parser;
+
+        THEN("Start line, headers and header size are reported")
+        {
+            REQUIRE(parser.parse(as_bytes(request), request.size()) == HTTPHeaderParser::Result::Complete);
+            REQUIRE(parser.is_request());
+            REQUIRE(part(request, parser.start_line()[0]) == "GET");
+            REQUIRE(part(request, parser.start_line()[1]) == "/index.html?a=b");
+            REQUIRE(part(request, parser.start_line()[2]) == "1.1");
+            REQUIRE(parser.header_count() == 3);
+            REQUIRE(part(request, parser.header(0).name) == "Host");
+            REQUIRE(part(request, parser.header(0).value) == "localhost");
+            REQUIRE(part(request, parser.header(1).name) == "Accept");
+            REQUIRE(part(request, parser.header(1).value) == "text/html");
+            REQUIRE(part(request, parser.header(2).value).empty());
+            REQUIRE(parser.header_size() == request.find("content"));
+        }
+    }
+
+    GIVEN("A request received one byte at a time")
+    {
+        HTTPHeaderParser parser;
+        auto res = HTTPHeaderParser::Result::NeedMoreData;
+        std::size_t length = 0;
+
+        while (res == HTTPHeaderParser::Result::NeedMoreData && length < request.size())
+        {
+            res = parser.parse(as_bytes(request), ++length);
+        }
+
+        THEN("Parsing completes exactly at the end of the headers")
+        {
+            REQUIRE(res == HTTPHeaderParser::Result::Complete);
+            REQUIRE(length == request.find("content"));
+            REQUIRE(parser.header_size() == length);
+            REQUIRE(parser.header_count() == 3);
+            REQUIRE(part(request, parser.header(1).value) == "text/html");
+        }
+    }
+
+    GIVEN("A parser that has been reset")
+    {
+        HTTPHeaderParser parser;
+        REQUIRE(parser.parse(as_bytes(request), request.size()) == HTTPHeaderParser::Result::Complete);
+        parser.reset();
+
+        THEN("It parses the next request")
+        {
+            const std::string next = "\r\nPOST /upload HTTP/1.0\nContent-Length: 5\n\n";
+            REQUIRE(parser.parse(as_bytes(next), next.size()) == HTTPHeaderParser::Result::Complete);
+            REQUIRE(part(next, parser.start_line()[0]) == "POST");
+            REQUIRE(part(next, parser.start_line()[2]) == "1.0");
+            REQUIRE(parser.header_count() == 1);
+            REQUIRE(part(next, parser.header(0).value) == "5");
+            REQUIRE(parser.header_size() == next.size());
+        }
+    }
+}
+
+SCENARIO("HTTPHeaderParser - response")
+{
+    const std::string response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+    HTTPHeaderParser parser;
+
+    REQUIRE(parser.parse(as_bytes(response), response.size()) == HTTPHeaderParser::Result::Complete);
+    REQUIRE_FALSE(parser.is_request());
+    REQUIRE(part(response, parser.start_line()[0]) == "1.1");
+    REQUIRE(part(response, parser.start_line()[1]) == "404");
+    REQUIRE(part(response, parser.start_line()[2]) == "Not Found");
+    REQUIRE(parser.header_count() == 1);
+}
+
+SCENARIO("HTTPHeaderParser - malformed input")
+{
+    const std::vector<std::string> malformed{
+        "GET /\r\n\r\n",
+        "GET / FTP/1.1\r\n\r\n",
+        "GET / HTTP/1.1\r\nNoColon\r\n\r\n",
+        "GET / HTTP/1.1\r\nName : value\r\n\r\n",
+        "GET / HTTP/1.1\r\nName: value\r\n folded\r\n\r\n",
+        "GET / HTTP/1.1\r\n: value\r\n\r\n"
+    };
+
+    for (const auto& s : malformed)
+    {
+        HTTPHeaderParser parser;
+        REQUIRE(parser.parse(as_bytes(s), s.size()) == HTTPHeaderParser::Result::Malformed);
+    }
+
+    std::string many = "GET / HTTP/1.1\r\n";
+
+    for (std::size_t i = 0; i <= HTTPHeaderParser::max_headers; ++i)
+    {
+        many.append("H").append(std::to_string(i)).append(": v\r\n");
+    }
+
+    HTTPHeaderParser parser;
+    REQUIRE(parser.parse(as_bytes(many), many.size()) == HTTPHeaderParser::Result::TooManyHeaders);
+}
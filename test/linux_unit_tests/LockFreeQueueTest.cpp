@@ -0,0 +1,131 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+#include "smooth/core/ipc/LockFreeQueue.h"
+
+using namespace smooth::core::ipc;
+
+SCENARIO("LockFreeQueue keeps FIFO order across wrap-around")
+{
+    for (auto single_producer : { true, false })
+    {
+        LockFreeQueue<int> q(3, single_producer);
+        REQUIRE(q.empty());
+
+        for (int lap = 0; lap < 5; ++lap)
+        {
+            REQUIRE(q.push(lap * 10 + 1));
+            REQUIRE(q.push(lap * 10 + 2));
+            REQUIRE(q.push(lap * 10 + 3));
+            REQUIRE_FALSE(q.push(4));
+            REQUIRE(q.count() == 3);
+
+            int v = 0;
+
+            for (int i = 1; i <= 3; ++i)
+            {
+                REQUIRE(q.pop(v));
+                REQUIRE(v == lap * 10 + i);
+            }
+
+            REQUIRE_FALSE(q.pop(v));
+            REQUIRE(q.empty());
+        }
+    }
+}
+
+SCENARIO("LockFreeQueue delivers all items from multiple producers")
+{
+    constexpr int producers = 4;
+    constexpr int per_producer = 20000;
+
+    LockFreeQueue<int> q(64, false);
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&q, p]() {
+                                 for (int i = 0; i < per_producer; ++i)
+                                 {
+                                     while (!q.push(p * per_producer + i))
+                                     {
+                                         std::this_thread::yield();
+                                     }
+                                 }
+                             });
+    }
+
+    // Items from each producer must arrive in the order they were pushed.
+    std::vector<int> last(producers, -1);
+    int received = 0;
+    int v;
+
+    while (received < producers * per_producer)
+    {
+        if (q.pop(v))
+        {
+            auto p = v / per_producer;
+            REQUIRE(v % per_producer == last[static_cast<size_t>(p)] + 1);
+            last[static_cast<size_t>(p)] = v % per_producer;
+            ++received;
+        }
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    REQUIRE(q.empty());
+}
+
+SCENARIO("LockFreeQueue releases popped items")
+{
+    // Copyable but without move operations, so pop() copies the item out.
+    struct CopyOnlyItem
+    {
+        CopyOnlyItem() = default;
+
+        CopyOnlyItem(const CopyOnlyItem&) = default;
+
+        CopyOnlyItem& operator=(const CopyOnlyItem&) = default;
+
+        std::shared_ptr<int> value{};
+    };
+
+    LockFreeQueue<CopyOnlyItem> q(4, true);
+    auto value = std::make_shared<int>(1);
+    CopyOnlyItem item;
+    item.value = value;
+    REQUIRE(q.push(item));
+    item.value.reset();
+    REQUIRE(value.use_count() == 2);
+
+    {
+        CopyOnlyItem out;
+        REQUIRE(q.pop(out));
+        REQUIRE(value.use_count() == 2);
+    }
+
+    REQUIRE(value.use_count() == 1);
+}
@@ -21,6 +21,7 @@ limitations under the License.
 #include "smooth/core/filesystem/File.h"
 #include "smooth/application/hash/sha.h"
 #include "smooth/core/filesystem/Fileinfo.h"
+#include "smooth/core/util/BoyerMooreHorspool.h"
 
 using namespace smooth::core::filesystem;
 using namespace smooth::application::network::http;
@@ -265,3 +266,158 @@ SCENARIO("MIMEParser - application/x-www-form-urlencoded")
         }
     }
 }
+
+namespace
+{
+    class FormDataCollector
+        : public IFormData
+    {
+        public:
+            void form_data(const std::string& name,
+                           const std::string& /*actual_file_name*/,
+                           const BoundaryIterator& begin,
+                           const BoundaryIterator& end,
+                           const bool file_start,
+                           const bool file_close) override
+            {
+                auto& content = parts[name];
+
+                if (file_start)
+                {
+                    ++starts;
+                    REQUIRE(content.empty());
+                }
+
+                if (file_close)
+                {
+                    ++closes;
+                }
+
+                largest = std::max(largest, static_cast<std::size_t>(std::distance(begin, end)));
+                content.append(begin, end);
+
+                if (begin >= input_begin && end <= input_end && begin != end)
+                {
+                    ++direct;
+                }
+            }
+
+            std::unordered_map<std::string, std::string> parts{};
+            int starts = 0;
+            int closes = 0;
+            int direct = 0;
+            std::size_t largest = 0;
+            const uint8_t* input_begin = nullptr;
+            const uint8_t* input_end = nullptr;
+    };
+
+    class NoURLData
+        : public IURLEncodedData
+    {
+        public:
+            void url_encoded(std::unordered_map<std::string, std::string>&) override
+            {
+            }
+    };
+
+    std::string part(const std::string& boundary, const std::string& name, const std::string& content)
+    {
+        return "--" + boundary + "\r\n"
+               + "Content-Disposition: form-data; name=\"" + name + "\"; filename=\"" + name + ".bin\"\r\n"
+               + "Content-Type: application/octet-stream\r\n\r\n"
+               + content + "\r\n";
+    }
+}
+
+SCENARIO("MIMEParser - multipart/form-data - Split at any position")
+{
+    FSLock::set_limit(5);
+
+    const std::string boundary{ "----WebKitFormBoundaryePkpFF7tjBAqx29L" };
+
+    // Content that contains parts of the delimiter, including right before the real one.
+    std::string first{ "Line\r\n-- \r\n--" + boundary.substr(0, 10) + "\r\n\r\n--" };
+    std::string second{};
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        second.push_back(static_cast<char>(i * 7));
+    }
+
+    // The third part has neither headers nor content.
+    const auto body = "preamble\r\n" + part(boundary, "first", first) + part(boundary, "second", second)
+                      + "--" + boundary + "\r\n\r\n\r\n"
+                      + "--" + boundary + "--\r\nepilogue\r\n--" + boundary + "\r\n";
+
+    const std::vector<uint8_t> data{ body.begin(), body.end() };
+
+    for (auto size : std::vector<std::size_t>{ 1, 2, 3, 5, 17, 41, 64, 1000, 4096, 100000 })
+    {
+        MIMEParser mime;
+        REQUIRE(mime.detect_mode("multipart/form-data; boundary=" + boundary, data.size()));
+
+        FormDataCollector collector{};
+        NoURLData url{};
+
+        for (std::size_t i = 0; i < data.size(); i += size)
+        {
+            auto length = std::min(size, data.size() - i);
+            mime.parse(data.data() + i, length, collector, url, static_cast<uint16_t>(1024));
+        }
+
+        REQUIRE(collector.parts.size() == 3);
+        REQUIRE(collector.parts["first"] == first);
+        REQUIRE(collector.parts["second"] == second);
+        REQUIRE(collector.parts[""].empty());
+        REQUIRE(collector.starts == 3);
+        REQUIRE(collector.closes == 3);
+        REQUIRE(collector.largest <= 1024);
+    }
+}
+
+SCENARIO("MIMEParser - multipart/form-data - Large parts are handed over without copying")
+{
+    const std::string boundary{ "xyz" };
+    std::string content(10000, 'a');
+    const auto body = part(boundary, "file", content) + "--" + boundary + "--\r\n";
+    const std::vector<uint8_t> data{ body.begin(), body.end() };
+
+    MIMEParser mime;
+    REQUIRE(mime.detect_mode("multipart/form-data; boundary=" + boundary, data.size()));
+
+    FormDataCollector collector{};
+    collector.input_begin = data.data();
+    collector.input_end = data.data() + data.size();
+    NoURLData url{};
+
+    mime.parse(data, collector, url, static_cast<uint16_t>(4096));
+
+    REQUIRE(collector.parts["file"] == content);
+    REQUIRE(collector.direct == 3);
+    REQUIRE(collector.closes == 1);
+}
+
+SCENARIO("BoyerMooreHorspool")
+{
+    using smooth::core::util::BoyerMooreHorspool;
+
+    const std::string text{ "abcabdabcabcabdabx" };
+    const auto* begin = reinterpret_cast<const uint8_t*>(text.data());
+    const auto* end = begin + text.size();
+
+    auto find = [&](const std::string& pattern) {
+                    BoyerMooreHorspool bmh{ { pattern.begin(), pattern.end() } };
+                    auto found = bmh.find(begin, end);
+
+                    return found == end ? std::string::npos : static_cast<std::size_t>(found - begin);
+                };
+
+    REQUIRE(find("abcabd") == 0);
+    REQUIRE(find("abcabcabd") == 6);
+    REQUIRE(find("abx") == 15);
+    REQUIRE(find("x") == 17);
+    REQUIRE(find("abcabdabcabcabdabx") == 0);
+    REQUIRE(find("abcabdabcabcabdabxy") == std::string::npos);
+    REQUIRE(find("bb") == std::string::npos);
+    REQUIRE(find("") == 0);
+}
@@ -0,0 +1,433 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "smooth/application/network/http/HTTPPacket.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/websocket/PerMessageDeflate.h"
+#include "smooth/application/network/http/websocket/WebsocketProtocol.h"
+#include "smooth/application/network/http/websocket/responses/WSResponse.h"
+#include "ServerResponseMock.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::websocket;
+using linux_unit_tests::ServerResponseMock;
+
+namespace
+{
+    std::vector<uint8_t> telemetry(int sequence)
+    {
+        std::string s = R"({"device":"sensor-17","sequence":)" + std::to_string(sequence)
+                        + R"(,"temperature":21.5,"humidity":43.25,"pressure":1013.2,"status":"ok"})";
+
+        return { s.begin(), s.end() };
+    }
+
+    /// Decompresses a message the way a client does, https://tools.ietf.org/html/rfc7692#section-7.2.2
+    class ClientInflater
+    {
+        public:
+            ClientInflater()
+            {
+                inflateInit2(&stream, -15);
+            }
+
+            ~ClientInflater()
+            {
+                inflateEnd(&stream);
+            }
+
+            ClientInflater(const ClientInflater&) = delete;
+
+            ClientInflater& operator=(const ClientInflater&) = delete;
+
+            std::vector<uint8_t> inflate_message(std::vector<uint8_t> data)
+            {
+                data.insert(data.end(), { 0x00, 0x00, 0xFF, 0xFF });
+                std::vector<uint8_t> out(64 * 1024);
+                stream.next_in = data.data();
+                stream.avail_in = static_cast<uInt>(data.size());
+                stream.next_out = out.data();
+                stream.avail_out = static_cast<uInt>(out.size());
+                inflate(&stream, Z_SYNC_FLUSH);
+                out.resize(out.size() - stream.avail_out);
+
+                return out;
+            }
+
+        private:
+            z_stream stream{};
+    };
+
+    /// Compresses a message the way a client does.
+    std::vector<uint8_t> client_deflate(const std::vector<uint8_t>& data, int window_bits = 10)
+    {
+        z_stream stream{};
+        deflateInit2(&stream, 6, Z_DEFLATED, -window_bits, 8, Z_DEFAULT_STRATEGY);
+        std::vector<uint8_t> out(deflateBound(&stream, static_cast<uLong>(data.size())) + 16);
+        std::vector<uint8_t> in = data;
+        stream.next_in = in.data();
+        stream.avail_in = static_cast<uInt>(in.size());
+        stream.next_out = out.data();
+        stream.avail_out = static_cast<uInt>(out.size());
+        deflate(&stream, Z_SYNC_FLUSH);
+        out.resize(out.size() - stream.avail_out - 4);
+        deflateEnd(&stream);
+
+        return out;
+    }
+
+    struct Part
+    {
+        bool first;
+        bool last;
+        std::vector<uint8_t> data;
+    };
+
+    /// Feeds a complete frame to the protocol, returning the resulting packet.
+    HTTPPacket receive(WebsocketProtocol& proto, const std::vector<uint8_t>& frame)
+    {
+        HTTPPacket packet{};
+        std::size_t pos = 0;
+
+        while (pos < frame.size() && !proto.is_error())
+        {
+            auto amount = std::min(static_cast<std::size_t>(proto.get_wanted_amount(packet)), frame.size() - pos);
+            std::copy_n(frame.begin() + static_cast<std::ptrdiff_t>(pos), amount, proto.get_write_pos(packet));
+            pos += amount;
+            proto.data_received(packet, static_cast<int>(amount));
+        }
+
+        return packet;
+    }
+}
+
+SCENARIO("Negotiating permessage-deflate")
+{
+    PerMessageDeflateConfig config{};
+
+    GIVEN("An offer as sent by browsers")
+    {
+        auto params = PerMessageDeflate::negotiate("permessage-deflate; client_max_window_bits", config);
+
+        THEN("The windows are limited to the configured sizes")
+        {
+            REQUIRE(params);
+            REQUIRE(params->to_string()
+                    == "permessage-deflate; server_max_window_bits=10; client_max_window_bits=10");
+        }
+    }
+
+    GIVEN("Several offers")
+    {
+        THEN("The first acceptable one is selected")
+        {
+            auto params = PerMessageDeflate::negotiate(
+                "permessage-deflate; server_max_window_bits=8, x-webkit-deflate-frame, "
+                "permessage-deflate; server_max_window_bits=\"12\"; server_no_context_takeover; "
+                "client_max_window_bits=9", config);
+
+            REQUIRE(params);
+            REQUIRE(params->server_no_context_takeover);
+            REQUIRE(params->to_string() == "permessage-deflate; server_no_context_takeover; server_max_window_bits=10; "
+                                           "client_max_window_bits=9");
+        }
+    }
+
+    GIVEN("Offers that can't be accepted")
+    {
+        THEN("They are declined")
+        {
+            REQUIRE_FALSE(PerMessageDeflate::negotiate("x-webkit-deflate-frame", config));
+            REQUIRE_FALSE(PerMessageDeflate::negotiate("permessage-deflate; unknown_parameter", config));
+            REQUIRE_FALSE(PerMessageDeflate::negotiate("permessage-deflate; server_no_context_takeover; "
+                                                       "server_no_context_takeover", config));
+            REQUIRE_FALSE(PerMessageDeflate::negotiate("permessage-deflate; server_max_window_bits", config));
+            REQUIRE_FALSE(PerMessageDeflate::negotiate("permessage-deflate; client_max_window_bits=16", config));
+            REQUIRE_FALSE(PerMessageDeflate::negotiate("permessage-deflate; server_no_context_takeover=1", config));
+        }
+    }
+
+    GIVEN("A memory budget too small to decompress using the largest window")
+    {
+        PerMessageDeflateConfig small{ 10, 10, false, false, 4, 16 * 1024 };
+
+        THEN("Only clients that let the window be limited are accepted")
+        {
+            REQUIRE_FALSE(PerMessageDeflate::negotiate("permessage-deflate", small));
+            REQUIRE(PerMessageDeflate::negotiate("permessage-deflate; client_max_window_bits", small));
+        }
+    }
+}
+
+SCENARIO("Compressing messages")
+{
+    GIVEN("Messages compressed with context takeover")
+    {
+        PerMessageDeflateConfig config{};
+        auto params = PerMessageDeflate::negotiate("permessage-deflate; client_max_window_bits", config);
+        PerMessageDeflate deflate{ *params, config };
+        ClientInflater client{};
+
+        THEN("Later messages refer to earlier ones and are decompressed by the client")
+        {
+            std::vector<std::size_t> sizes{};
+
+            for (int i = 0; i < 5; ++i)
+            {
+                auto data = telemetry(i);
+                REQUIRE(deflate.compress(data, true, true));
+                sizes.push_back(data.size());
+                REQUIRE(client.inflate_message(data) == telemetry(i));
+            }
+
+            REQUIRE(sizes[1] < sizes[0] / 2);
+            REQUIRE(deflate.get_deflate_memory() > 0);
+        }
+
+        THEN("A message sent in fragments is compressed as one")
+        {
+            std::vector<uint8_t> compressed{};
+            std::vector<uint8_t> expected{};
+
+            for (int i = 0; i < 3; ++i)
+            {
+                auto data = telemetry(i);
+                expected.insert(expected.end(), data.begin(), data.end());
+                REQUIRE(deflate.compress(data, i == 0, i == 2));
+                compressed.insert(compressed.end(), data.begin(), data.end());
+            }
+
+            REQUIRE(client.inflate_message(compressed) == expected);
+        }
+
+        THEN("Small messages are sent uncompressed")
+        {
+            std::vector<uint8_t> data{ 'h', 'i' };
+            REQUIRE_FALSE(deflate.compress(data, true, true));
+            REQUIRE(data == std::vector<uint8_t>{ 'h', 'i' });
+        }
+    }
+
+    GIVEN("Messages compressed without context takeover")
+    {
+        PerMessageDeflateConfig config{};
+        auto params = PerMessageDeflate::negotiate(
+            "permessage-deflate; server_no_context_takeover; client_max_window_bits", config);
+        PerMessageDeflate deflate{ *params, config };
+
+        THEN("Each message can be decompressed on its own")
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                ClientInflater client{};
+                auto data = telemetry(i);
+                REQUIRE(deflate.compress(data, true, true));
+                REQUIRE(client.inflate_message(data) == telemetry(i));
+            }
+        }
+
+        THEN("Messages that don't get smaller are sent as they are")
+        {
+            std::vector<uint8_t> data{};
+
+            for (uint32_t i = 0, seed = 1; i < 100; ++i)
+            {
+                seed = seed * 1664525 + 1013904223;
+                data.push_back(static_cast<uint8_t>(seed >> 24));
+            }
+
+            auto original = data;
+            REQUIRE_FALSE(deflate.compress(data, true, true));
+            REQUIRE(data == original);
+        }
+    }
+
+    GIVEN("A memory budget that only allows for decompression")
+    {
+        PerMessageDeflateConfig config{ 10, 10, false, false, 4, 12 * 1024 };
+        auto params = PerMessageDeflate::negotiate("permessage-deflate; client_max_window_bits", config);
+        REQUIRE(params);
+        PerMessageDeflate deflate{ *params, config };
+
+        THEN("Messages are sent uncompressed")
+        {
+            auto data = telemetry(1);
+            REQUIRE_FALSE(deflate.compress(data, true, true));
+            REQUIRE(data == telemetry(1));
+            REQUIRE(deflate.get_uncompressed_count() == 1);
+            REQUIRE(deflate.get_deflate_memory() == 0);
+        }
+    }
+}
+
+SCENARIO("Decompressing messages")
+{
+    PerMessageDeflateConfig config{};
+    auto params = PerMessageDeflate::negotiate("permessage-deflate; client_max_window_bits", config);
+    PerMessageDeflate deflate{ *params, config };
+    std::vector<Part> parts{};
+    auto receiver = [&parts](bool first, bool last, const std::vector<uint8_t>& part) {
+                        parts.push_back({ first, last, part });
+                    };
+
+    GIVEN("A compressed message larger than the chunk size")
+    {
+        std::vector<uint8_t> message{};
+
+        for (int i = 0; i < 100; ++i)
+        {
+            auto t = telemetry(i);
+            message.insert(message.end(), t.begin(), t.end());
+        }
+
+        auto compressed = client_deflate(message);
+
+        THEN("It is handed over in parts, also when received in parts")
+        {
+            const std::size_t half = compressed.size() / 2;
+            std::vector<uint8_t> first{ compressed.begin(), compressed.begin() + static_cast<std::ptrdiff_t>(half) };
+            std::vector<uint8_t> second{ compressed.begin() + static_cast<std::ptrdiff_t>(half), compressed.end() };
+
+            REQUIRE(deflate.decompress(first, false, 1000, receiver));
+            REQUIRE(deflate.decompress(second, true, 1000, receiver));
+
+            std::vector<uint8_t> result{};
+
+            for (std::size_t i = 0; i < parts.size(); ++i)
+            {
+                REQUIRE(parts[i].first == (i == 0));
+                REQUIRE(parts[i].last == (i == parts.size() - 1));
+                REQUIRE(parts[i].data.size() <= 1000);
+                result.insert(result.end(), parts[i].data.begin(), parts[i].data.end());
+            }
+
+            REQUIRE(parts.size() >= message.size() / 1000);
+            REQUIRE(result == message);
+        }
+    }
+
+    GIVEN("Data that isn't compressed")
+    {
+        std::vector<uint8_t> garbage(100, 0xFF);
+
+        THEN("Decompression fails")
+        {
+            REQUIRE_FALSE(deflate.decompress(garbage, true, 1000, receiver));
+        }
+    }
+
+    GIVEN("A client that offers to compress using a window of 8 bits")
+    {
+        auto small_params = PerMessageDeflate::negotiate("permessage-deflate; client_max_window_bits=8", config);
+        REQUIRE(small_params);
+        PerMessageDeflate small_window{ *small_params, config };
+
+        // Data repeated at a distance that needs a window of 9 bits, but not 10.
+        std::vector<uint8_t> message{};
+
+        for (uint32_t i = 0, seed = 1; i < 300; ++i)
+        {
+            seed = seed * 1664525 + 1013904223;
+            message.push_back(static_cast<uint8_t>(seed >> 24));
+        }
+
+        message.insert(message.end(), message.begin(), message.end());
+
+        THEN("Its messages are decompressed using a window of 9 bits, as zlib compresses with when asked for 8")
+        {
+            // Compressed with a larger window since zlib, using 9 bits, stays within distances of 250 bytes.
+            // Handed over in parts smaller than the distance, so that it is referred to through the window.
+            REQUIRE(small_window.decompress(client_deflate(message, 10), true, 100, receiver));
+
+            std::vector<uint8_t> result{};
+
+            for (const auto& part : parts)
+            {
+                result.insert(result.end(), part.data.begin(), part.data.end());
+            }
+
+            REQUIRE(result == message);
+        }
+    }
+}
+
+SCENARIO("Compressed websocket frames")
+{
+    ServerResponseMock response{};
+    auto compressed = client_deflate(telemetry(1));
+    std::vector<uint8_t> frame{ 0x81 | 0x40, static_cast<uint8_t>(compressed.size()) };
+    frame.insert(frame.end(), compressed.begin(), compressed.end());
+
+    GIVEN("A protocol with compression enabled")
+    {
+        WebsocketProtocol proto{ 4096, response };
+        proto.enable_compression();
+
+        THEN("A frame with RSV1 set is marked as a compressed message")
+        {
+            auto packet = receive(proto, frame);
+            REQUIRE_FALSE(proto.is_error());
+            REQUIRE(proto.is_complete(packet));
+            REQUIRE(packet.is_ws_compressed());
+            REQUIRE(packet.is_ws_message_end());
+            REQUIRE(packet.data() == compressed);
+        }
+
+        THEN("A control frame with RSV1 set is an error")
+        {
+            receive(proto, { 0x89 | 0x40, 0x00 });
+            REQUIRE(proto.is_error());
+        }
+    }
+
+    GIVEN("A protocol without compression")
+    {
+        WebsocketProtocol proto{ 4096, response };
+
+        THEN("A frame with RSV1 set is an error")
+        {
+            receive(proto, frame);
+            REQUIRE(proto.is_error());
+        }
+    }
+
+    GIVEN("A compressed outgoing message")
+    {
+        PerMessageDeflateConfig config{};
+        auto params = PerMessageDeflate::negotiate("permessage-deflate; client_max_window_bits", config);
+        PerMessageDeflate deflate{ *params, config };
+        responses::WSResponse ws{ telemetry(1), true, true, true };
+        ws.set_message_compression(deflate);
+
+        THEN("RSV1 is set in the frame header")
+        {
+            std::vector<uint8_t> out{};
+            REQUIRE(ws.get_data(4096, out) == ResponseStatus::LastData);
+            REQUIRE(out[0] == (0x81 | 0x40));
+            REQUIRE(out[1] < telemetry(1).size());
+
+            ClientInflater client{};
+            REQUIRE(client.inflate_message({ out.begin() + 2, out.end() }) == telemetry(1));
+        }
+    }
+}
@@ -0,0 +1,443 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include "smooth/core/Task.h"
+#include "smooth/core/network/Socket.h"
+#include "smooth/core/util/string_util.h"
+#include "smooth/application/network/http/HTTPPacket.h"
+#include "smooth/application/network/http/HTTPProtocol.h"
+#include "smooth/application/network/http/HTTPServerClient.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/regular/responses/HeaderOnlyResponse.h"
+#include "ServerResponseMock.h"
+
+using namespace smooth::core::network;
+using namespace smooth::core::network::event;
+using namespace smooth::application::network::http;
+using linux_unit_tests::ServerResponseMock;
+
+namespace
+{
+    class TestTask
+        : public smooth::core::Task
+    {
+        public:
+            TestTask()
+                    : Task(0, std::chrono::milliseconds{ 0 })
+            {}
+    };
+
+    class Listener
+        : public smooth::core::ipc::IEventListener<TransmitBufferEmptyEvent>,
+        public smooth::core::ipc::IEventListener<DataAvailableEvent<HTTPProtocol>>,
+        public smooth::core::ipc::IEventListener<ConnectionStatusEvent>
+    {
+        public:
+            void event(const TransmitBufferEmptyEvent& /*event*/) override
+            {}
+
+            void event(const DataAvailableEvent<HTTPProtocol>& /*event*/) override
+            {}
+
+            void event(const ConnectionStatusEvent& /*event*/) override
+            {}
+    };
+
+    /// A socket reading from one end of a socket pair, driven by the test instead of the SocketDispatcher.
+    class TestSocket
+        : public Socket<HTTPProtocol>
+    {
+        public:
+            TestSocket(const std::shared_ptr<BufferContainer<HTTPProtocol>>& container, int fd,
+                       std::size_t read_ahead_size)
+                    : Socket<HTTPProtocol>(container)
+            {
+                socket_id = fd;
+                active = true;
+                connected = true;
+
+                if (read_ahead_size > 0)
+                {
+                    read_ahead.resize(read_ahead_size);
+                }
+            }
+
+            void receive(const std::shared_ptr<BufferContainer<HTTPProtocol>>& container)
+            {
+                read_data(container);
+            }
+
+            [[nodiscard]] bool has_read_ahead() const
+            {
+                return read_ahead_pos < read_ahead_end;
+            }
+
+            void transmit()
+            {
+                while (has_data_to_transmit())
+                {
+                    writable();
+                }
+            }
+
+            void stop(const char* /*reason*/) override
+            {
+                active = false;
+                connected = false;
+            }
+    };
+
+    struct Request
+    {
+        std::string url;
+        std::string content;
+    };
+
+    /// Receives the requests sent by the peer of a socket.
+    class Connection
+    {
+        public:
+            /// \param read_ahead_size The size of the socket's read-ahead buffer, 0 for the default size. Requests
+            /// are received straight into the packet while it asks for as much as the read-ahead buffer holds.
+            explicit Connection(std::size_t read_ahead_size, int content_chunk_size = 1024)
+            {
+                REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+                REQUIRE(fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK) == 0);
+
+                container = std::make_shared<BufferContainer<HTTPProtocol>>(
+                    task, listener, listener, listener,
+                    std::make_unique<HTTPProtocol>(1024, content_chunk_size, response));
+
+                socket = std::make_shared<TestSocket>(container, fds[0], read_ahead_size);
+            }
+
+            ~Connection()
+            {
+                close(fds[0]);
+                close(fds[1]);
+            }
+
+            Connection(const Connection&) = delete;
+
+            Connection& operator=(const Connection&) = delete;
+
+            /// Sends the data in pieces of at most piece_size bytes, each received by the socket before
+            /// the next is sent.
+            void send(const std::string& data, std::size_t piece_size)
+            {
+                for (std::size_t offset = 0; offset < data.size(); offset += piece_size)
+                {
+                    auto piece = data.substr(offset, piece_size);
+                    REQUIRE(write(fds[1], piece.data(), piece.size()) == static_cast<ssize_t>(piece.size()));
+                    receive();
+                }
+            }
+
+            std::vector<Request> requests{};
+            ServerResponseMock response{};
+
+        private:
+            void receive()
+            {
+                int available = 0;
+
+                do
+                {
+                    socket->receive(container);
+                    take_packets();
+                    REQUIRE(ioctl(fds[0], FIONREAD, &available) == 0);
+                }
+                while (socket->is_active() && (available > 0 || socket->has_read_ahead()));
+
+                REQUIRE(socket->is_active());
+            }
+
+            void take_packets()
+            {
+                HTTPPacket packet{};
+
+                while (container->get_rx_buffer().get(packet))
+                {
+                    if (packet.is_continuation())
+                    {
+                        requests.back().content.append(packet.data().begin(), packet.data().end());
+                    }
+                    else
+                    {
+                        requests.push_back({ packet.get_request_url(),
+                                             std::string{ packet.data().begin(), packet.data().end() } });
+                    }
+                }
+            }
+
+            int fds[2]{ -1, -1 };
+            TestTask task{};
+            Listener listener{};
+            std::shared_ptr<BufferContainer<HTTPProtocol>> container{};
+            std::shared_ptr<TestSocket> socket{};
+    };
+}
+
+namespace
+{
+    /// A response of unknown length, i.e. without a Content-Length, sent in two parts.
+    class UnknownLengthResponse
+        : public smooth::application::network::http::regular::responses::HeaderOnlyResponse
+    {
+        public:
+            UnknownLengthResponse()
+                    : HeaderOnlyResponse(ResponseCode::OK)
+            {}
+
+            ResponseStatus get_data(std::size_t /*max_amount*/, std::vector<uint8_t>& target) override
+            {
+                const std::string part = parts_sent == 0 ? "first," : "second";
+                target.assign(part.begin(), part.end());
+
+                return ++parts_sent < 2 ? ResponseStatus::HasMoreData : ResponseStatus::LastData;
+            }
+
+        private:
+            int parts_sent{ 0 };
+    };
+
+    class UnknownLengthHandler
+        : public IRequestHandler
+    {
+        public:
+            void handle(HTTPMethod /*method*/,
+                        IServerResponse& response,
+                        IConnectionTimeoutModifier& /*timeout_modifier*/,
+                        const std::string& /*requested_url*/,
+                        const std::unordered_map<std::string, std::string>& /*request_headers*/,
+                        const std::unordered_map<std::string, std::string>& /*request_parameters*/,
+                        const std::vector<uint8_t>& /*data*/,
+                        bool /*fist_part*/,
+                        bool last_part) override
+            {
+                if (last_part)
+                {
+                    response.reply(std::make_unique<UnknownLengthResponse>(), false);
+                }
+            }
+    };
+
+    class TestClient
+        : public HTTPServerClient
+    {
+        public:
+            TestClient(smooth::core::Task& task, ClientPool<HTTPServerClient>& pool)
+                    : HTTPServerClient(task, pool, 1024, 1024, 10)
+            {}
+
+            void attach(const std::shared_ptr<ISocket>& s)
+            {
+                socket = s;
+            }
+    };
+
+    /// A HTTPServerClient serving requests sent by the peer of a socket.
+    class ServedConnection
+    {
+        public:
+            ServedConnection()
+            {
+                REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+                REQUIRE(fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK) == 0);
+                REQUIRE(fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK) == 0);
+
+                client = std::make_shared<TestClient>(task, pool);
+                client->set_client_context(&handler);
+                container = client->get_buffers().lock();
+                socket = std::make_shared<TestSocket>(container, fds[0], 0);
+                client->attach(socket);
+                client->connected();
+            }
+
+            ~ServedConnection()
+            {
+                close(fds[0]);
+                close(fds[1]);
+            }
+
+            ServedConnection(const ServedConnection&) = delete;
+
+            ServedConnection& operator=(const ServedConnection&) = delete;
+
+            /// Sends a request, returning what the client responds with.
+            std::string request(const std::string& data)
+            {
+                REQUIRE(write(fds[1], data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+                socket->receive(container);
+                client->event(DataAvailableEvent<HTTPProtocol>(&container->get_rx_buffer()));
+
+                // Stands in for the socket dispatcher sending, and the task passing on the events.
+                socket->transmit();
+                client->event(TransmitBufferEmptyEvent(socket));
+
+                std::string res{};
+                std::array<char, 256> buff{};
+                ssize_t count;
+
+                while ((count = read(fds[1], buff.data(), buff.size())) > 0)
+                {
+                    res.append(buff.data(), static_cast<std::size_t>(count));
+                }
+
+                return res;
+            }
+
+            TestTask task{};
+            ClientPool<HTTPServerClient> pool{ task, 1 };
+            UnknownLengthHandler handler{};
+            std::shared_ptr<TestClient> client{};
+            std::shared_ptr<BufferContainer<HTTPProtocol>> container{};
+            std::shared_ptr<TestSocket> socket{};
+
+        private:
+            int fds[2]{ -1, -1 };
+    };
+}
+
+SCENARIO("HTTPServerClient - responses of unknown length")
+{
+    using smooth::core::string_util::icontains;
+
+    GIVEN("A HTTP/1.1 request")
+    {
+        ServedConnection connection{};
+        auto response = connection.request("GET / HTTP/1.1\r\n\r\n");
+
+        THEN("The response is sent in chunks and the connection is kept open")
+        {
+            REQUIRE(icontains(response, "transfer-encoding: chunked"));
+            REQUIRE(icontains(response, "connection: keep-alive"));
+            REQUIRE(response.find("6\r\nfirst,\r\n6\r\nsecond\r\n0\r\n\r\n") != std::string::npos);
+            REQUIRE(connection.socket->is_active());
+        }
+    }
+
+    GIVEN("A HTTP/1.0 request")
+    {
+        ServedConnection connection{};
+        auto response = connection.request("GET / HTTP/1.0\r\n\r\n");
+
+        THEN("The response is not chunked and the connection is closed once it has been sent")
+        {
+            REQUIRE_FALSE(icontains(response, "transfer-encoding"));
+            REQUIRE_FALSE(icontains(response, "keep-alive"));
+            REQUIRE(icontains(response, "connection: close"));
+            REQUIRE(response.substr(response.find("\r\n\r\n") + 4) == "first,second");
+            REQUIRE_FALSE(connection.socket->is_active());
+        }
+    }
+}
+
+SCENARIO("Socket - pipelined requests")
+{
+    const std::string pipelined = "GET /a HTTP/1.1\r\nHost: x\r\n\r\n"
+                                  "POST /b HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+                                  "POST /c HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n0\r\n\r\n"
+                                  "GET /d HTTP/1.1\r\n\r\n";
+
+    const auto check = [](const std::vector<Request>& requests, std::size_t offset) {
+                           REQUIRE(requests.size() >= offset + 4);
+                           REQUIRE(requests[offset].url == "/a");
+                           REQUIRE(requests[offset].content.empty());
+                           REQUIRE(requests[offset + 1].url == "/b");
+                           REQUIRE(requests[offset + 1].content == "hello");
+                           REQUIRE(requests[offset + 2].url == "/c");
+                           REQUIRE(requests[offset + 2].content == "abc");
+                           REQUIRE(requests[offset + 3].url == "/d");
+                           REQUIRE(requests[offset + 3].content.empty());
+                       };
+
+    for (std::size_t read_ahead_size : { std::size_t{ 0 }, std::size_t{ 4096 } })
+    {
+        const auto* description = read_ahead_size == 0
+                                  ? "A socket receiving headers straight into the packet"
+                                  : "A socket receiving headers via the read-ahead buffer";
+
+        GIVEN(description)
+        {
+            THEN("Each request is assembled on its own, regardless of how the data arrives")
+            {
+                for (std::size_t piece_size : { std::size_t{ 1 }, std::size_t{ 7 }, std::size_t{ 50 },
+                                                pipelined.size() })
+                {
+                    Connection connection{ read_ahead_size };
+                    connection.send(pipelined, piece_size);
+
+                    REQUIRE(connection.requests.size() == 4);
+                    check(connection.requests, 0);
+                    REQUIRE(connection.response.errors.empty());
+                }
+            }
+
+            THEN("Requests arriving after earlier pipelined requests are not mixed up with those")
+            {
+                Connection connection{ read_ahead_size };
+
+                for (std::size_t round = 0; round < 3; ++round)
+                {
+                    connection.send(pipelined, pipelined.size());
+                    REQUIRE(connection.requests.size() == 4 * (round + 1));
+                    check(connection.requests, 4 * round);
+                }
+
+                const std::string pair = "GET /e HTTP/1.1\r\n\r\nGET /f HTTP/1.1\r\n\r\n";
+                connection.send(pair, pair.size());
+                connection.send(pair, pair.size());
+
+                REQUIRE(connection.requests.size() == 16);
+
+                for (std::size_t i = 12; i < 16; ++i)
+                {
+                    REQUIRE(connection.requests[i].url == (i % 2 == 0 ? "/e" : "/f"));
+                }
+
+                REQUIRE(connection.response.errors.empty());
+            }
+
+            THEN("A request with content split into parts is not followed by part of the next request")
+            {
+                const std::string data = "POST /big HTTP/1.1\r\nContent-Length: 20\r\n\r\n"
+                                         "01234567890123456789"
+                                         "GET /next HTTP/1.1\r\n\r\n";
+
+                for (std::size_t piece_size : { std::size_t{ 8 }, data.size() })
+                {
+                    Connection connection{ read_ahead_size, 8 };
+                    connection.send(data, piece_size);
+
+                    REQUIRE(connection.requests.size() == 2);
+                    REQUIRE(connection.requests[0].content == "01234567890123456789");
+                    REQUIRE(connection.requests[1].url == "/next");
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+#include "smooth/core/ipc/Queue.h"
+
+using namespace smooth::core::ipc;
+
+SCENARIO("Queue keeps FIFO order across wrap-around")
+{
+    Queue<int> q(3);
+    REQUIRE(q.push(1));
+    REQUIRE(q.push(2));
+    REQUIRE(q.push(3));
+    REQUIRE_FALSE(q.push(4));
+    REQUIRE(q.count() == 3);
+
+    int v = 0;
+    REQUIRE(q.pop(v));
+    REQUIRE(v == 1);
+    REQUIRE(q.push(4));
+    REQUIRE(q.push(5) == false);
+
+    for (auto expected : { 2, 3, 4 })
+    {
+        REQUIRE(q.pop(v));
+        REQUIRE(v == expected);
+    }
+
+    REQUIRE_FALSE(q.pop(v));
+    REQUIRE(q.empty());
+}
+
+SCENARIO("Queue moves items in and out")
+{
+    Queue<std::unique_ptr<int>> q(2);
+    auto item = std::make_unique<int>(42);
+    REQUIRE(q.push(std::move(item)));
+    REQUIRE_FALSE(item);
+
+    std::unique_ptr<int> out;
+    REQUIRE(q.pop(out));
+    REQUIRE(out);
+    REQUIRE(*out == 42);
+}
+
+namespace
+{
+    // Like the connection status event, copyable but without move operations.
+    struct CopyOnlyItem
+    {
+        CopyOnlyItem() = default;
+
+        explicit CopyOnlyItem(std::shared_ptr<int> value)
+                : value(std::move(value))
+        {
+        }
+
+        CopyOnlyItem(const CopyOnlyItem&) = default;
+
+        CopyOnlyItem& operator=(const CopyOnlyItem&) = default;
+
+        std::shared_ptr<int> value{};
+    };
+}
+
+SCENARIO("Queue releases popped items")
+{
+    Queue<CopyOnlyItem> q(4);
+    auto value = std::make_shared<int>(1);
+    REQUIRE(q.push(CopyOnlyItem{ value }));
+    REQUIRE(value.use_count() == 2);
+
+    {
+        CopyOnlyItem out;
+        REQUIRE(q.pop(out));
+        REQUIRE(value.use_count() == 2);
+    }
+
+    REQUIRE(value.use_count() == 1);
+}
+
+SCENARIO("Full queue leaves moved item untouched")
+{
+    Queue<std::vector<int>> q(1);
+    REQUIRE(q.push(std::vector<int>{ 1 }));
+
+    std::vector<int> rejected{ 1, 2, 3 };
+    REQUIRE_FALSE(q.push(std::move(rejected)));
+    REQUIRE(rejected.size() == 3);
+}
+
+SCENARIO("Zero sized queue rejects everything")
+{
+    Queue<int> q(0);
+    REQUIRE_FALSE(q.push(1));
+    int v;
+    REQUIRE_FALSE(q.pop(v));
+}
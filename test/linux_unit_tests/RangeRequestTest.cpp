@@ -0,0 +1,273 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+#include "smooth/application/network/http/http_utils.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/application/network/http/regular/responses/FileContentResponse.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/filesystem.h"
+#include "smooth/core/filesystem/FSLock.h"
+
+using namespace smooth::core::filesystem;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+using namespace smooth::application::network::http::regular::responses;
+
+namespace smooth::application::network::http::utils
+{
+    bool operator==(const ByteRange& a, const ByteRange& b)
+    {
+        return a.offset == b.offset && a.length == b.length;
+    }
+}
+
+namespace
+{
+    std::vector<utils::ByteRange> ranges_of(const std::string& range, std::size_t size)
+    {
+        std::vector<utils::ByteRange> ranges{};
+        REQUIRE(utils::parse_byte_ranges(range, size, ranges) == utils::RangeStatus::Satisfiable);
+
+        return ranges;
+    }
+
+    // Collects the body using either of the two ways the server may ask for it.
+    std::string body_of(FileContentResponse& response, bool shared)
+    {
+        std::string body{};
+        auto res = ResponseStatus::HasMoreData;
+
+        while (res == ResponseStatus::HasMoreData)
+        {
+            if (shared)
+            {
+                SharedContent content{};
+                res = response.get_shared_data(7, content);
+                body.append(reinterpret_cast<const char*>(content.data), content.length);
+            }
+            else
+            {
+                std::vector<uint8_t> data{};
+                res = response.get_data(7, data);
+                body.append(data.begin(), data.end());
+            }
+        }
+
+        REQUIRE(res != ResponseStatus::Error);
+
+        return body;
+    }
+}
+
+SCENARIO("Range header parsing")
+{
+    using utils::ByteRange;
+    using utils::RangeStatus;
+
+    REQUIRE(ranges_of("bytes=0-499", 1000) == std::vector<ByteRange>{ { 0, 500 } });
+    REQUIRE(ranges_of("bytes=500-", 1000) == std::vector<ByteRange>{ { 500, 500 } });
+    REQUIRE(ranges_of("bytes=-200", 1000) == std::vector<ByteRange>{ { 800, 200 } });
+    REQUIRE(ranges_of("bytes=-2000", 1000) == std::vector<ByteRange>{ { 0, 1000 } });
+    REQUIRE(ranges_of("bytes=900-1999", 1000) == std::vector<ByteRange>{ { 900, 100 } });
+    REQUIRE(ranges_of("Bytes = 0-0, 10-19 ,-1", 1000) == std::vector<ByteRange>{ { 0, 1 }, { 10, 10 }, { 999, 1 } });
+    REQUIRE(ranges_of("bytes=0-9, 2000-", 1000) == std::vector<ByteRange>{ { 0, 10 } });
+
+    std::vector<ByteRange> ranges{};
+    REQUIRE(utils::parse_byte_ranges("bytes=1000-", 1000, ranges) == RangeStatus::Unsatisfiable);
+    REQUIRE(utils::parse_byte_ranges("bytes=-0", 1000, ranges) == RangeStatus::Unsatisfiable);
+    REQUIRE(utils::parse_byte_ranges("bytes=0-", 0, ranges) == RangeStatus::Unsatisfiable);
+
+    for (const auto& ignored : { "", "bytes=", "items=0-1", "bytes=1", "bytes=5-4", "bytes=a-b", "bytes=-",
+                                 "bytes=0-1,x", "bytes=0--1", "bytes=0-1,2-3,4-5,6-7,8-9,10-11,12-13,14-15,16-17" })
+    {
+        REQUIRE(utils::parse_byte_ranges(ignored, 1000, ranges) == RangeStatus::Ignore);
+        REQUIRE(ranges.empty());
+    }
+}
+
+SCENARIO("If-Range matching")
+{
+    const time_t last_modified = 1571400000;
+    const auto date = utils::make_http_time(last_modified);
+
+    REQUIRE(utils::matches_if_range(date, "", last_modified));
+    REQUIRE_FALSE(utils::matches_if_range(date, "", last_modified + 1));
+    REQUIRE_FALSE(utils::matches_if_range("not a date", "", last_modified));
+    REQUIRE(utils::matches_if_range("\"abc\"", "\"abc\"", last_modified));
+    REQUIRE_FALSE(utils::matches_if_range("\"abc\"", "\"abcd\"", last_modified));
+    REQUIRE_FALSE(utils::matches_if_range("W/\"abc\"", "W/\"abc\"", last_modified));
+    REQUIRE_FALSE(utils::matches_if_range("\"abc\"", "", last_modified));
+}
+
+SCENARIO("FileContentResponse with ranges")
+{
+    FSLock::set_limit(5);
+
+    const auto dir = Path{ "test_data" } / "range_request";
+    create_directory(Path{ dir });
+
+    const auto file = dir / "data.txt";
+    const std::string content = "0123456789abcdefghijklmnopqrstuvwxyz";
+    REQUIRE(File{ static_cast<const char*>(file) }.write(content));
+
+    for (auto shared : { false, true })
+    {
+        const auto* description = shared ? "A memory mapped file" : "A file read in chunks";
+
+        GIVEN(description)
+        {
+            WHEN("No range is requested")
+            {
+                FileContentResponse response{ file };
+
+                THEN("The entire file is sent")
+                {
+                    REQUIRE(response.get_response_code() == ResponseCode::OK);
+                    REQUIRE(response.get_headers().at(ACCEPT_RANGES) == "bytes");
+                    REQUIRE(response.get_headers().at(CONTENT_LENGTH) == "36");
+                    REQUIRE(body_of(response, shared) == content);
+                }
+            }
+
+            WHEN("A single range is requested")
+            {
+                FileContentResponse response{ file, "bytes=10-25" };
+
+                THEN("Only the range is sent")
+                {
+                    REQUIRE(response.get_response_code() == ResponseCode::Partial_Content);
+                    REQUIRE(response.get_headers().at(CONTENT_RANGE) == "bytes 10-25/36");
+                    REQUIRE(response.get_headers().at(CONTENT_LENGTH) == "16");
+                    REQUIRE(response.get_headers().at(CONTENT_TYPE) == "application/octet-stream");
+                    REQUIRE(body_of(response, shared) == "abcdefghijklmnop");
+                }
+            }
+
+            WHEN("Multiple ranges are requested")
+            {
+                FileContentResponse response{ file, "bytes=0-1,-3" };
+
+                THEN("The ranges are sent as multipart/byteranges")
+                {
+                    const auto& type = response.get_headers().at(CONTENT_TYPE);
+                    const std::string prefix = "multipart/byteranges; boundary=";
+                    REQUIRE(type.substr(0, prefix.size()) == prefix);
+                    const auto boundary = type.substr(prefix.size());
+
+                    const auto expected = "--" + boundary + "\r\n"
+                                          "Content-Type: application/octet-stream\r\n"
+                                          "Content-Range: bytes 0-1/36\r\n"
+                                          "\r\n"
+                                          "01"
+                                          "\r\n--" + boundary + "\r\n"
+                                          "Content-Type: application/octet-stream\r\n"
+                                          "Content-Range: bytes 33-35/36\r\n"
+                                          "\r\n"
+                                          "xyz"
+                                          "\r\n--" + boundary + "--\r\n";
+
+                    REQUIRE(response.get_response_code() == ResponseCode::Partial_Content);
+                    REQUIRE(response.get_headers().at(CONTENT_LENGTH) == std::to_string(expected.size()));
+                    REQUIRE(body_of(response, shared) == expected);
+                }
+            }
+
+            WHEN("An unsatisfiable range is requested")
+            {
+                FileContentResponse response{ file, "bytes=100-" };
+
+                THEN("Nothing is sent")
+                {
+                    REQUIRE(response.get_response_code() == ResponseCode::Requested_Range_Not_Satisfiable);
+                    REQUIRE(response.get_headers().at(CONTENT_RANGE) == "bytes */36");
+                    REQUIRE(response.get_headers().at(CONTENT_LENGTH) == "0");
+                    REQUIRE(body_of(response, shared).empty());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("FileContentResponse with a large file")
+{
+    FSLock::set_limit(5);
+
+    const auto dir = Path{ "test_data" } / "range_request";
+    create_directory(Path{ dir });
+
+    const auto file = dir / "large.bin";
+    const auto size = FileContentResponse::max_shared_part * 2 + 123;
+    std::vector<uint8_t> content(size);
+
+    for (std::size_t i = 0; i < content.size(); ++i)
+    {
+        content[i] = static_cast<uint8_t>(i % 251);
+    }
+
+    REQUIRE(File{ static_cast<const char*>(file) }.write(content.data(), static_cast<int>(content.size())));
+
+    GIVEN("A memory mapped file")
+    {
+        FileContentResponse response{ file };
+        REQUIRE(response.has_shared_data());
+
+        WHEN("Sent")
+        {
+            THEN("It is handed out in parts of limited size")
+            {
+                std::vector<std::size_t> lengths{};
+                std::vector<uint8_t> body{};
+                auto res = ResponseStatus::HasMoreData;
+
+                while (res == ResponseStatus::HasMoreData)
+                {
+                    SharedContent part{};
+                    res = response.get_shared_data(7, part);
+                    lengths.push_back(part.length);
+                    body.insert(body.end(), part.data, part.data + part.length);
+                }
+
+                REQUIRE(res == ResponseStatus::LastData);
+                REQUIRE(lengths == std::vector<std::size_t>{ FileContentResponse::max_shared_part,
+                                                             FileContentResponse::max_shared_part,
+                                                             123 });
+                REQUIRE(body == content);
+            }
+        }
+
+        WHEN("The file is truncated while being sent")
+        {
+            SharedContent part{};
+            REQUIRE(response.get_shared_data(7, part) == ResponseStatus::HasMoreData);
+            part = SharedContent{};
+
+            REQUIRE(File{ static_cast<const char*>(file) }.write(content.data(), 1000));
+
+            THEN("The mapping is no longer used and reading the rest fails")
+            {
+                REQUIRE_FALSE(response.has_shared_data());
+
+                std::vector<uint8_t> data{};
+                REQUIRE(response.get_data(7, data) == ResponseStatus::Error);
+            }
+        }
+    }
+}
@@ -0,0 +1,134 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include "smooth/application/network/http/ResponseBudget.h"
+#include "smooth/application/network/http/regular/responses/StringResponse.h"
+#include "smooth/application/network/http/websocket/responses/WSResponse.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+
+namespace
+{
+    class Listener
+        : public IResponseBudgetListener
+    {
+        public:
+            explicit Listener(ResponseBudget& budget, bool wait_again = false)
+                    : budget(budget), wait_again(wait_again)
+            {
+            }
+
+            void response_budget_available() override
+            {
+                ++notified;
+
+                if (wait_again)
+                {
+                    wait_again = false;
+                    budget.wait(*this);
+                }
+            }
+
+            ResponseBudget& budget;
+            bool wait_again;
+            int notified{ 0 };
+    };
+}
+
+SCENARIO("ResponseBudget")
+{
+    GIVEN("A budget of 100 bytes")
+    {
+        ResponseBudget budget{ 100 };
+        Listener a{ budget };
+        Listener b{ budget, true };
+
+        THEN("It is exhausted once the limit is reached")
+        {
+            budget.reserve(60);
+            REQUIRE_FALSE(budget.is_exhausted());
+            budget.reserve(40);
+            REQUIRE(budget.is_exhausted());
+            REQUIRE(budget.get_used() == 100);
+        }
+
+        THEN("Waiting listeners are notified once, when the budget becomes available")
+        {
+            budget.reserve(150);
+            budget.wait(a);
+            budget.wait(a);
+            budget.wait(b);
+
+            budget.release(20);
+            REQUIRE(a.notified == 0);
+            REQUIRE(b.notified == 0);
+
+            budget.release(40);
+            REQUIRE_FALSE(budget.is_exhausted());
+            REQUIRE(a.notified == 1);
+            REQUIRE(b.notified == 1);
+
+            // b started waiting again from within the notification.
+            budget.reserve(50);
+            budget.release(50);
+            REQUIRE(a.notified == 1);
+            REQUIRE(b.notified == 2);
+        }
+
+        THEN("Listeners that stop waiting are not notified")
+        {
+            budget.reserve(100);
+            budget.wait(a);
+            budget.stop_waiting(a);
+            budget.release(100);
+            REQUIRE(a.notified == 0);
+        }
+
+        THEN("Releasing more than reserved does not wrap around")
+        {
+            budget.reserve(10);
+            budget.release(20);
+            REQUIRE(budget.get_used() == 0);
+        }
+    }
+
+    GIVEN("A budget without a limit")
+    {
+        ResponseBudget budget{ 0 };
+        budget.reserve(1000000);
+        REQUIRE_FALSE(budget.is_exhausted());
+    }
+
+    GIVEN("Responses holding content")
+    {
+        THEN("The content counts towards the budget until it is sent")
+        {
+            responses::StringResponse s{ ResponseCode::OK, "0123456789", false };
+            REQUIRE(s.get_buffered_size() == 10);
+
+            websocket::responses::WSResponse ws{ std::string(20, 'x'), true, true };
+            REQUIRE(ws.get_buffered_size() == 20);
+
+            std::vector<uint8_t> target{};
+            s.get_data(4, target);
+            REQUIRE(s.get_buffered_size() == 6);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include "smooth/application/network/http/regular/Router.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::regular;
+
+namespace
+{
+    class Handler
+        : public HTTPRequestHandler
+    {
+        public:
+            void request(IConnectionTimeoutModifier& /*timeout_modifier*/,
+                         const std::string& /*url*/,
+                         const std::vector<uint8_t>& /*content*/) override
+            {
+            }
+    };
+}
+
+SCENARIO("Router - literal paths and parameters")
+{
+    Router router;
+    auto root = std::make_shared<Handler>();
+    auto devices = std::make_shared<Handler>();
+    auto device = std::make_shared<Handler>();
+    auto device_status = std::make_shared<Handler>();
+    auto device_all = std::make_shared<Handler>();
+    auto post = std::make_shared<Handler>();
+
+    router.add(HTTPMethod::GET, "/", root);
+    router.add(HTTPMethod::GET, "/api/devices", devices);
+    router.add(HTTPMethod::GET, "/api/devices/{id}", device);
+    router.add(HTTPMethod::GET, "/api/devices/{id}/status/{item}", device_status);
+    router.add(HTTPMethod::GET, "/api/devices/all", device_all);
+    router.add(HTTPMethod::POST, "/api/devices", post);
+
+    Router::Parameters parameters;
+
+    REQUIRE(router.find(HTTPMethod::GET, "/", parameters) == root);
+    REQUIRE(router.find(HTTPMethod::GET, "/api/devices", parameters) == devices);
+    REQUIRE(router.find(HTTPMethod::POST, "/api/devices", parameters) == post);
+    REQUIRE(router.find(HTTPMethod::PUT, "/api/devices", parameters) == nullptr);
+    REQUIRE(router.find(HTTPMethod::GET, "/api/device", parameters) == nullptr);
+    REQUIRE(router.find(HTTPMethod::GET, "/api/devicesx", parameters) == nullptr);
+    REQUIRE(router.find(HTTPMethod::GET, "/api/devices/", parameters) == nullptr);
+
+    REQUIRE(router.find(HTTPMethod::GET, "/api/devices/all", parameters) == device_all);
+    REQUIRE(parameters.empty());
+
+    REQUIRE(router.find(HTTPMethod::GET, "/api/devices/42", parameters) == device);
+    REQUIRE(parameters.size() == 1);
+    REQUIRE(parameters["id"] == "42");
+
+    // Literal "all" does not match, so the parameter route is used.
+    REQUIRE(router.find(HTTPMethod::GET, "/api/devices/allx", parameters) == device);
+    REQUIRE(parameters["id"] == "allx");
+
+    REQUIRE(router.find(HTTPMethod::GET, "/api/devices/7/status/temperature", parameters) == device_status);
+    REQUIRE(parameters.size() == 2);
+    REQUIRE(parameters["id"] == "7");
+    REQUIRE(parameters["item"] == "temperature");
+
+    REQUIRE(router.find(HTTPMethod::GET, "/api/devices/7/status", parameters) == nullptr);
+}
+
+SCENARIO("Router - mounts")
+{
+    Router router;
+    auto files = std::make_shared<Handler>();
+    auto specific = std::make_shared<Handler>();
+    auto fallback = std::make_shared<Handler>();
+
+    router.mount(HTTPMethod::GET, "/files/", files);
+    router.add(HTTPMethod::GET, "/files/special", specific);
+    router.add(HTTPMethod::GET, "/filesystem", specific);
+
+    Router::Parameters parameters;
+
+    REQUIRE(router.find(HTTPMethod::GET, "/files", parameters) == files);
+    REQUIRE(router.find(HTTPMethod::GET, "/files/", parameters) == files);
+    REQUIRE(router.find(HTTPMethod::GET, "/files/a/b.txt", parameters) == files);
+    REQUIRE(router.find(HTTPMethod::GET, "/files/special", parameters) == specific);
+    REQUIRE(router.find(HTTPMethod::GET, "/files/specialx", parameters) == files);
+    REQUIRE(router.find(HTTPMethod::GET, "/filesystem", parameters) == specific);
+    REQUIRE(router.find(HTTPMethod::GET, "/filesx", parameters) == nullptr);
+    REQUIRE(router.find(HTTPMethod::GET, "/other", parameters) == nullptr);
+
+    router.mount(HTTPMethod::GET, "/", fallback);
+    REQUIRE(router.find(HTTPMethod::GET, "/other", parameters) == fallback);
+    REQUIRE(router.find(HTTPMethod::GET, "/filesx", parameters) == fallback);
+    REQUIRE(router.find(HTTPMethod::GET, "/files/x", parameters) == files);
+}
+
+SCENARIO("Router - invalid routes")
+{
+    Router router;
+    auto handler = std::make_shared<Handler>();
+
+    router.add(HTTPMethod::GET, "/a/{id}", handler);
+    REQUIRE_THROWS_AS(router.add(HTTPMethod::GET, "/a/{name}/b", handler), std::invalid_argument);
+    REQUIRE_THROWS_AS(router.add(HTTPMethod::GET, "/a/{}", handler), std::invalid_argument);
+    REQUIRE_THROWS_AS(router.add(HTTPMethod::GET, "/b/{id", handler), std::invalid_argument);
+}
@@ -0,0 +1,81 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <catch2/catch.hpp>
+
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "smooth/application/network/http/IServerResponse.h"
+
+namespace linux_unit_tests
+{
+    /// Stands in for the connection of a server, holding on to the responses instead of sending them.
+    class ServerResponseMock
+        : public smooth::application::network::http::IServerResponse
+    {
+        public:
+            void reply(std::unique_ptr<smooth::application::network::http::IResponseOperation> response,
+                       bool /*place_first*/) override
+            {
+                queued.emplace_back(std::move(response));
+            }
+
+            void reply_error(std::unique_ptr<smooth::application::network::http::IResponseOperation> response) override
+            {
+                errors.emplace_back(response->get_response_code());
+            }
+
+            void disconnect() override
+            {
+                ++disconnects;
+                queued.clear();
+            }
+
+            /// Sends the oldest queued response, which must have shared data, returning what was sent.
+            smooth::application::network::http::SharedContent send_one()
+            {
+                using namespace smooth::application::network::http;
+
+                SharedContent content{};
+                auto op = std::move(queued.front());
+                queued.pop_front();
+                REQUIRE(op->has_shared_data());
+                REQUIRE(op->get_shared_data(1024, content) == ResponseStatus::LastData);
+                sent.emplace_back(content.data, content.data + content.length);
+
+                return content;
+            }
+
+            std::deque<std::unique_ptr<smooth::application::network::http::IResponseOperation>> queued{};
+            std::vector<std::vector<uint8_t>> sent{};
+            std::vector<smooth::application::network::http::regular::ResponseCode> errors{};
+            int disconnects{ 0 };
+
+        protected:
+            smooth::core::Task& get_task() override
+            {
+                throw std::logic_error("Not used");
+            }
+
+            void upgrade_to_websocket_internal() override
+            {}
+    };
+}
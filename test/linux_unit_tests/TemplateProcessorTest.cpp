@@ -22,8 +22,14 @@ limitations under the License.
 
 #include "smooth/application/network/http/regular/TemplateProcessor.h"
 #include "smooth/application/network/http/regular/ITemplateDataRetriever.h"
+#include "smooth/application/network/http/regular/CompiledTemplate.h"
+#include "smooth/application/network/http/regular/HTTPHeaderDef.h"
+#include "smooth/core/filesystem/File.h"
+#include "smooth/core/filesystem/FSLock.h"
 
+using namespace smooth::application::network::http;
 using namespace smooth::application::network::http::regular;
+using namespace smooth::core::filesystem;
 
 class DataRetriever
     : public ITemplateDataRetriever
@@ -88,3 +94,92 @@ SCENARIO("Parsing a text with unknown tokens")
         }
     }
 }
+
+SCENARIO("Compiling a template")
+{
+    GIVEN("A text with keys, repeated keys and things that look like keys")
+    {
+        CompiledTemplate t{ "{{name}}: {{ x }} {{{food}}} {{}} {{name}}{{a-b_1}}" };
+
+        THEN("Keys are found once each")
+        {
+            REQUIRE(t.keys() == std::vector<std::string>{ "{{name}}", "{{food}}", "{{a-b_1}}" });
+            REQUIRE(t.segments().size() == 6);
+            REQUIRE(t.literal_size() == 18);
+            REQUIRE(t.render({ "A", "B", "C" }) == "A: {{ x }} {B} {{}} AC");
+        }
+    }
+
+    GIVEN("A text without keys")
+    {
+        CompiledTemplate t{ "Just text {{" };
+
+        THEN("It is a single literal")
+        {
+            REQUIRE(t.keys().empty());
+            REQUIRE(t.segments().size() == 1);
+            REQUIRE(t.render({}) == "Just text {{");
+        }
+    }
+}
+
+SCENARIO("Rendering a template file")
+{
+    FSLock::set_limit(5);
+
+    const auto path = Path{ "test_data" } / "template_test.html";
+    REQUIRE(File{ static_cast<const char*>(path) }.write("<p>Hello {{name}}, want {{food}}? {{name}}.</p>"));
+
+    auto dr = std::make_shared<DataRetriever>();
+    TemplateProcessor tp({ ".html" }, dr);
+
+    GIVEN("A file that is not a template")
+    {
+        THEN("Nothing is returned")
+        {
+            REQUIRE_FALSE(tp.process_template(Path{ "test_data" } / "text.txt", 1));
+        }
+    }
+
+    GIVEN("A template file")
+    {
+        const std::string expected{ "<p>Hello Bob, want an ice cream? Bob.</p>" };
+
+        THEN("It is streamed in chunks of the requested size")
+        {
+            auto response = tp.process_template(path, 1);
+            REQUIRE(response);
+            REQUIRE(response->get_response_code() == ResponseCode::OK);
+            REQUIRE(response->get_headers().at(CONTENT_LENGTH) == std::to_string(expected.size()));
+
+            std::vector<uint8_t> data{};
+            ResponseStatus status;
+            auto calls = 0;
+
+            do
+            {
+                auto before = data.size();
+                status = response->get_data(5, data);
+                REQUIRE(data.size() - before <= 5);
+                ++calls;
+            }
+            while (status == ResponseStatus::HasMoreData);
+
+            REQUIRE(status == ResponseStatus::LastData);
+            REQUIRE(calls == 9);
+            REQUIRE(std::string(data.begin(), data.end()) == expected);
+            REQUIRE(response->get_data(5, data) == ResponseStatus::NoData);
+        }
+
+        THEN("The compiled template is reused until the file is modified")
+        {
+            REQUIRE(tp.compile(path, 1) == tp.compile(path, 1));
+
+            REQUIRE(File{ static_cast<const char*>(path) }.write("Bye {{name}}"));
+            auto previous = tp.compile(path, 1);
+            auto updated = tp.compile(path, 2);
+            REQUIRE(updated != previous);
+            REQUIRE(updated->render({ "Bob" }) == "Bye Bob");
+        }
+    }
+}
@@ -0,0 +1,251 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <vector>
+#include "smooth/core/timer/Timer.h"
+#include "smooth/core/timer/TimerWheel.h"
+
+using namespace smooth::core::timer;
+using namespace std::chrono;
+
+namespace
+{
+    // Milliseconds covered by one slot on the top level, and by all of the levels.
+    constexpr uint64_t top_slot_span = uint64_t{ 1 } << (TimerWheel::bits_per_level * (TimerWheel::level_count - 1));
+    constexpr uint64_t wheel_span = top_slot_span * TimerWheel::slots_per_level;
+
+    class WheelTimer
+        : public Timer
+    {
+        public:
+            explicit WheelTimer(int id)
+                    : Timer(id, {}, false, milliseconds(0))
+            {
+            }
+
+            using Timer::set_expires_at;
+    };
+
+    class WheelFixture
+    {
+        public:
+            const steady_clock::time_point epoch = steady_clock::now();
+            TimerWheel wheel{ epoch };
+
+            [[nodiscard]] steady_clock::time_point at(uint64_t tick) const
+            {
+                return epoch + milliseconds(tick);
+            }
+
+            SharedTimer start(int id, uint64_t tick)
+            {
+                auto timer = std::make_shared<WheelTimer>(id);
+                restart(*timer, tick);
+
+                return timer;
+            }
+
+            void restart(WheelTimer& timer, uint64_t tick)
+            {
+                timer.set_expires_at(at(tick));
+                wheel.insert(timer.shared_from_this());
+            }
+
+            /// Advances to the given tick, returning the ids of the timers that expired.
+            std::vector<int> advance(uint64_t tick)
+            {
+                std::vector<SharedTimer> expired;
+                wheel.advance(at(tick), expired);
+                std::vector<int> ids;
+
+                for (auto& t : expired)
+                {
+                    ids.push_back(t->get_id());
+                }
+
+                return ids;
+            }
+
+            /// Advances from one wake-up to the next until the wheel is empty, recording at which tick
+            /// each timer expired, indexed by id.
+            std::vector<uint64_t> run_to_end(size_t timer_count)
+            {
+                std::vector<uint64_t> expired_at(timer_count, 0);
+
+                while (!wheel.empty())
+                {
+                    auto next = wheel.next_wake_up();
+                    REQUIRE(next >= epoch);
+                    auto tick = static_cast<uint64_t>(duration_cast<milliseconds>(next - epoch).count());
+
+                    for (auto id : advance(tick))
+                    {
+                        REQUIRE(expired_at[static_cast<size_t>(id)] == 0);
+                        expired_at[static_cast<size_t>(id)] = tick;
+                    }
+                }
+
+                return expired_at;
+            }
+    };
+}
+
+SCENARIO("TimerWheel expires timers exactly on slot boundaries")
+{
+    for (uint64_t level = 1; level < TimerWheel::level_count; ++level)
+    {
+        auto boundary = uint64_t{ 1 } << (TimerWheel::bits_per_level * level);
+
+        for (auto tick : { boundary - 1, boundary, boundary + 1, 2 * boundary, 3 * boundary - 1 })
+        {
+            WheelFixture f;
+            auto timer = f.start(1, tick);
+            REQUIRE(f.wheel.size() == 1);
+            REQUIRE(f.wheel.next_wake_up() <= f.at(tick));
+
+            REQUIRE(f.advance(tick - 1).empty());
+            REQUIRE(f.advance(tick) == std::vector<int>{ 1 });
+            REQUIRE(f.wheel.empty());
+            REQUIRE(f.advance(tick + wheel_span).empty());
+        }
+    }
+}
+
+SCENARIO("TimerWheel cascades timers down through the levels")
+{
+    const std::vector<uint64_t> ticks{ 1, 63, 64, 65, 130, 4095, 4096, 4160, 5000, 262143, 262144, 300000,
+                                       top_slot_span + 17, wheel_span - 1 };
+
+    GIVEN("Timers on every level, stepped through by their wake-ups")
+    {
+        WheelFixture f;
+        std::vector<SharedTimer> timers;
+
+        for (size_t i = 0; i < ticks.size(); ++i)
+        {
+            timers.emplace_back(f.start(static_cast<int>(i), ticks[i]));
+        }
+
+        REQUIRE(f.wheel.size() == ticks.size());
+        REQUIRE(f.run_to_end(ticks.size()) == ticks);
+    }
+
+    GIVEN("Timers on every level, advanced in uneven steps")
+    {
+        WheelFixture f;
+        std::vector<SharedTimer> timers;
+
+        for (size_t i = 0; i < ticks.size(); ++i)
+        {
+            timers.emplace_back(f.start(static_cast<int>(i), ticks[i]));
+        }
+
+        // Each timer must expire in the first step that reaches its tick, never before.
+        uint64_t previous = 0;
+        size_t expired = 0;
+
+        for (uint64_t now = 37; expired < ticks.size(); previous = now, now += now / 3 + 37)
+        {
+            for (auto id : f.advance(now))
+            {
+                auto tick = ticks[static_cast<size_t>(id)];
+                REQUIRE(tick > previous);
+                REQUIRE(tick <= now);
+                ++expired;
+            }
+        }
+
+        REQUIRE(f.wheel.empty());
+    }
+}
+
+SCENARIO("TimerWheel stops and restarts timers held on a higher level")
+{
+    WheelFixture f;
+    auto timer = f.start(1, 10000);
+    auto& wheel_timer = static_cast<WheelTimer&>(*timer);
+    REQUIRE(f.advance(3000).empty());
+
+    WHEN("Stopped")
+    {
+        f.wheel.remove(*timer);
+        REQUIRE(f.wheel.empty());
+        REQUIRE(timer.use_count() == 1);
+        REQUIRE(f.advance(wheel_span).empty());
+
+        THEN("It can be started again")
+        {
+            f.restart(wheel_timer, wheel_span + 5000);
+            REQUIRE(f.advance(wheel_span + 4999).empty());
+            REQUIRE(f.advance(wheel_span + 5000) == std::vector<int>{ 1 });
+        }
+    }
+
+    WHEN("Restarted to expire earlier")
+    {
+        f.restart(wheel_timer, 7000);
+        REQUIRE(f.wheel.size() == 1);
+        REQUIRE(f.advance(6999).empty());
+        REQUIRE(f.advance(7000) == std::vector<int>{ 1 });
+        REQUIRE(f.advance(20000).empty());
+    }
+
+    WHEN("Restarted to expire later")
+    {
+        f.restart(wheel_timer, 200000);
+        REQUIRE(f.wheel.size() == 1);
+        REQUIRE(f.advance(199999).empty());
+        REQUIRE(f.advance(200000) == std::vector<int>{ 1 });
+        REQUIRE(f.wheel.empty());
+    }
+
+    WHEN("Restarted within the same slot")
+    {
+        f.restart(wheel_timer, 10001);
+        REQUIRE(f.advance(10000).empty());
+        REQUIRE(f.advance(10001) == std::vector<int>{ 1 });
+    }
+}
+
+SCENARIO("TimerWheel holds timers beyond the span of the top level")
+{
+    const std::vector<uint64_t> ticks{ 100, wheel_span, wheel_span + 1, 3 * wheel_span + 12345, 50000000 };
+
+    GIVEN("Timers stepped through by their wake-ups")
+    {
+        WheelFixture f;
+        std::vector<SharedTimer> timers;
+
+        for (size_t i = 0; i < ticks.size(); ++i)
+        {
+            timers.emplace_back(f.start(static_cast<int>(i), ticks[i]));
+        }
+
+        REQUIRE(f.run_to_end(ticks.size()) == ticks);
+    }
+
+    GIVEN("A timer advanced past in a single step")
+    {
+        WheelFixture f;
+        auto timer = f.start(1, 3 * wheel_span);
+        REQUIRE(f.advance(3 * wheel_span - 1).empty());
+        REQUIRE(f.advance(3 * wheel_span) == std::vector<int>{ 1 });
+    }
+}
@@ -0,0 +1,83 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include "smooth/application/network/http/regular/WebRootLookupCache.h"
+
+using namespace std::chrono;
+using namespace smooth::application::network::http::regular;
+
+SCENARIO("WebRootLookupCache")
+{
+    GIVEN("A cache with room for two entries")
+    {
+        WebRootLookupCache cache{ 2, seconds{ 10 } };
+
+        WHEN("Adding found and not found lookups")
+        {
+            cache.insert("/a", { "/root/a", false, 1 });
+            cache.insert("/missing", {});
+
+            THEN("Both are remembered")
+            {
+                REQUIRE(cache.find("/a"));
+                REQUIRE(cache.find("/a")->path == "/root/a");
+                REQUIRE(cache.find("/missing"));
+                REQUIRE(cache.find("/missing")->path.empty());
+                REQUIRE_FALSE(cache.find("/b"));
+            }
+
+            AND_THEN("The oldest is evicted when full")
+            {
+                cache.insert("/b", { "/root/b", false, 2 });
+                REQUIRE_FALSE(cache.find("/a"));
+                REQUIRE(cache.find("/missing"));
+                REQUIRE(cache.find("/b"));
+            }
+
+            AND_THEN("Clearing forgets everything")
+            {
+                cache.clear();
+                REQUIRE_FALSE(cache.find("/a"));
+                REQUIRE_FALSE(cache.find("/missing"));
+            }
+        }
+    }
+
+    GIVEN("A cache with short lived entries")
+    {
+        WebRootLookupCache cache{ 2, milliseconds{ 20 } };
+        cache.insert("/a", { "/root/a", false, 1 });
+        REQUIRE(cache.find("/a"));
+
+        THEN("Entries expire")
+        {
+            std::this_thread::sleep_for(milliseconds{ 30 });
+            REQUIRE_FALSE(cache.find("/a"));
+        }
+    }
+
+    GIVEN("A disabled cache")
+    {
+        WebRootLookupCache cache{ 0, seconds{ 10 } };
+        cache.insert("/a", { "/root/a", false, 1 });
+        REQUIRE_FALSE(cache.find("/a"));
+    }
+}
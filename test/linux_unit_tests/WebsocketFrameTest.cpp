@@ -0,0 +1,232 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+#include "smooth/application/network/http/HTTPPacket.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/websocket/frame_utils.h"
+#include "smooth/application/network/http/websocket/WebsocketProtocol.h"
+#include "smooth/application/network/http/websocket/responses/WSResponse.h"
+#include "ServerResponseMock.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::websocket;
+using linux_unit_tests::ServerResponseMock;
+
+namespace
+{
+    const std::array<uint8_t, 4> mask_key{ 0x12, 0x34, 0x56, 0x78 };
+
+    std::vector<uint8_t> make_payload(std::size_t size)
+    {
+        std::vector<uint8_t> payload(size);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            payload[i] = static_cast<uint8_t>(i * 7 + 3);
+        }
+
+        return payload;
+    }
+
+    // The byte at a time masking previously done by WebsocketProtocol.
+    void reference_mask(uint8_t* data, std::size_t length, std::size_t phase)
+    {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            data[i] = static_cast<uint8_t>(data[i] ^ mask_key[(phase + i) % 4]);
+        }
+    }
+
+    // Feeds a frame to the protocol in reads of at most read_size bytes, collecting the received payload.
+    std::vector<uint8_t> receive(const std::vector<uint8_t>& frame, std::size_t read_size, int content_chunk_size)
+    {
+        ServerResponseMock response{};
+        WebsocketProtocol proto{ content_chunk_size, response };
+        std::vector<uint8_t> payload{};
+        HTTPPacket packet{};
+        std::size_t pos = 0;
+
+        while (pos < frame.size())
+        {
+            auto wanted = static_cast<std::size_t>(proto.get_wanted_amount(packet));
+            auto amount = std::min({ wanted, read_size, frame.size() - pos });
+            std::copy_n(frame.begin() + static_cast<std::ptrdiff_t>(pos), amount, proto.get_write_pos(packet));
+            pos += amount;
+            proto.data_received(packet, static_cast<int>(amount));
+
+            if (proto.is_complete(packet))
+            {
+                payload.insert(payload.end(), packet.data().begin(), packet.data().end());
+                proto.packet_consumed();
+                packet = HTTPPacket{};
+            }
+        }
+
+        return payload;
+    }
+}
+
+SCENARIO("Websocket masking")
+{
+    GIVEN("Data of different lengths, alignments and starting phases")
+    {
+        THEN("The result is the same as when masking a byte at a time")
+        {
+            const auto payload = make_payload(300);
+
+            for (std::size_t offset = 0; offset < 16; ++offset)
+            {
+                for (std::size_t length : { 0U, 1U, 3U, 4U, 7U, 15U, 16U, 17U, 31U, 64U, 100U, 283U })
+                {
+                    for (std::size_t phase = 0; phase < 4; ++phase)
+                    {
+                        auto expected = payload;
+                        reference_mask(expected.data() + offset, length, phase);
+
+                        auto actual = payload;
+                        auto next = apply_mask(actual.data() + offset, length, mask_key.data(), phase);
+
+                        REQUIRE(actual == expected);
+                        REQUIRE(next == (phase + length) % 4);
+                    }
+                }
+            }
+        }
+
+        THEN("A payload masked in parts equals one masked in one go")
+        {
+            auto expected = make_payload(1000);
+            reference_mask(expected.data(), expected.size(), 0);
+
+            auto actual = make_payload(1000);
+            std::size_t phase = 0;
+
+            for (std::size_t pos = 0, part = 1; pos < actual.size(); pos += part, part = part * 3 % 97 + 1)
+            {
+                auto length = std::min(part, actual.size() - pos);
+                phase = apply_mask(actual.data() + pos, length, mask_key.data(), phase);
+            }
+
+            REQUIRE(actual == expected);
+        }
+    }
+}
+
+SCENARIO("Websocket frame headers")
+{
+    std::array<uint8_t, MaxFrameHeaderSize> header{};
+
+    GIVEN("Payloads of different sizes")
+    {
+        THEN("The shortest length encoding is used")
+        {
+            REQUIRE(write_frame_header(header.data(), OpCode::Text, true, 0) == 2);
+            REQUIRE(header[0] == 0x81);
+            REQUIRE(header[1] == 0);
+
+            REQUIRE(write_frame_header(header.data(), OpCode::Binary, false, 125) == 2);
+            REQUIRE(header[0] == 0x02);
+            REQUIRE(header[1] == 125);
+
+            REQUIRE(write_frame_header(header.data(), OpCode::Continuation, true, 126) == 4);
+            REQUIRE(header[0] == 0x80);
+            REQUIRE(header[1] == 126);
+            REQUIRE(header[2] == 0);
+            REQUIRE(header[3] == 126);
+
+            REQUIRE(write_frame_header(header.data(), OpCode::Binary, true, 65535) == 4);
+            REQUIRE(header[2] == 0xFF);
+            REQUIRE(header[3] == 0xFF);
+
+            REQUIRE(write_frame_header(header.data(), OpCode::Binary, true, 0x0102030405ULL) == 10);
+            REQUIRE(header[1] == 127);
+            REQUIRE(std::vector<uint8_t>(header.begin() + 2, header.end())
+                    == std::vector<uint8_t>{ 0, 0, 0, 0x01, 0x02, 0x03, 0x04, 0x05 });
+        }
+    }
+}
+
+SCENARIO("Websocket responses")
+{
+    GIVEN("A payload larger than the amount requested at a time")
+    {
+        const auto payload = make_payload(1000);
+        responses::WSResponse response{ payload, false, true, true };
+
+        THEN("A single frame covering the entire payload is produced")
+        {
+            std::vector<uint8_t> frame{};
+            ResponseStatus res;
+
+            do
+            {
+                res = response.get_data(300, frame);
+            }
+            while (res == ResponseStatus::HasMoreData);
+
+            REQUIRE(res == ResponseStatus::LastData);
+            REQUIRE(frame.size() == 4 + payload.size());
+            REQUIRE(frame[0] == 0x82);
+            REQUIRE(frame[1] == 126);
+            REQUIRE(frame[2] == 0x03);
+            REQUIRE(frame[3] == 0xE8);
+            REQUIRE(std::equal(payload.begin(), payload.end(), frame.begin() + 4));
+            REQUIRE(response.get_buffered_size() == 0);
+        }
+    }
+
+    GIVEN("A control frame")
+    {
+        responses::WSResponse response{ OpCode::Pong };
+
+        THEN("Only the header is sent")
+        {
+            std::vector<uint8_t> frame{};
+            REQUIRE(response.get_data(300, frame) == ResponseStatus::LastData);
+            REQUIRE(frame == std::vector<uint8_t>{ 0x8A, 0x00 });
+        }
+    }
+}
+
+SCENARIO("Receiving masked websocket frames")
+{
+    GIVEN("A masked frame")
+    {
+        const auto payload = make_payload(1000);
+        std::vector<uint8_t> frame{ 0x82, 0x80 | 126, 0x03, 0xE8 };
+        frame.insert(frame.end(), mask_key.begin(), mask_key.end());
+        auto masked = payload;
+        reference_mask(masked.data(), masked.size(), 0);
+        frame.insert(frame.end(), masked.begin(), masked.end());
+
+        THEN("The payload is unmasked, also when received in parts")
+        {
+            for (std::size_t read_size : { 1U, 3U, 64U, 2000U })
+            {
+                for (int chunk_size : { 7, 100, 4096 })
+                {
+                    REQUIRE(receive(frame, read_size, chunk_size) == payload);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,223 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "smooth/core/Task.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/websocket/WebsocketGroup.h"
+#include "smooth/application/network/http/websocket/WebsocketServer.h"
+#include "smooth/application/network/http/websocket/frame_utils.h"
+#include "ServerResponseMock.h"
+
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::websocket;
+using linux_unit_tests::ServerResponseMock;
+
+namespace
+{
+    class TestTask
+        : public smooth::core::Task
+    {
+        public:
+            TestTask()
+                    : Task(0, std::chrono::milliseconds{ 0 })
+            {}
+    };
+
+    class Member
+        : public WebsocketServer
+    {
+        public:
+            Member(IServerResponse& response, smooth::core::Task& task)
+                    : WebsocketServer(response, task)
+            {}
+
+            void data_received(bool /*first_part*/, bool /*last_part*/, bool /*is_text*/,
+                               const std::vector<uint8_t>& /*data*/) override
+            {}
+    };
+
+    std::vector<uint8_t> text_frame(const std::string& text)
+    {
+        std::vector<uint8_t> frame(MaxFrameHeaderSize);
+        frame.resize(write_frame_header(frame.data(), OpCode::Text, true, text.size()));
+        frame.insert(frame.end(), text.begin(), text.end());
+
+        return frame;
+    }
+}
+
+SCENARIO("Broadcasting to a websocket group")
+{
+    TestTask task{};
+
+    GIVEN("A group with several members")
+    {
+        auto group = std::make_shared<WebsocketGroup>();
+        std::vector<ServerResponseMock> responses(3);
+        std::vector<std::unique_ptr<Member>> members{};
+
+        for (auto& r : responses)
+        {
+            members.emplace_back(std::make_unique<Member>(r, task));
+            members.back()->join(group);
+        }
+
+        REQUIRE(group->size() == 3);
+
+        THEN("A message is framed once and sent to all of them")
+        {
+            group->broadcast("Hello everyone");
+
+            std::vector<const uint8_t*> frames{};
+
+            for (auto& r : responses)
+            {
+                REQUIRE(r.queued.size() == 1);
+                frames.push_back(r.send_one().data);
+                REQUIRE(r.sent.back() == text_frame("Hello everyone"));
+            }
+
+            REQUIRE(frames[0] == frames[1]);
+            REQUIRE(frames[1] == frames[2]);
+        }
+
+        THEN("Binary messages are sent as such")
+        {
+            group->broadcast(std::vector<uint8_t>{ 1, 2, 3 }, false);
+            auto frame = responses[0].send_one();
+            REQUIRE(frame.length == 5);
+            REQUIRE(frame.data[0] == 0x82);
+            REQUIRE(frame.data[1] == 3);
+        }
+
+        THEN("Members leave when their connection closes")
+        {
+            members[1].reset();
+            REQUIRE(group->size() == 2);
+
+            group->broadcast("Still here?");
+            REQUIRE(responses[0].queued.size() == 1);
+            REQUIRE(responses[1].queued.empty());
+            REQUIRE(responses[2].queued.size() == 1);
+        }
+
+        THEN("Members can leave and join again")
+        {
+            members[0]->leave(group);
+            REQUIRE(group->size() == 2);
+            members[0]->join(group);
+            members[0]->join(group);
+            REQUIRE(group->size() == 3);
+        }
+
+        THEN("Members outlive the group")
+        {
+            group.reset();
+            members.clear();
+        }
+    }
+}
+
+SCENARIO("Websocket group members not keeping up")
+{
+    TestTask task{};
+    ServerResponseMock response{};
+    Member member{ response, task };
+
+    GIVEN("The drop policy")
+    {
+        auto group = std::make_shared<WebsocketGroup>(SlowConsumerPolicy::Drop, 2);
+        member.join(group);
+
+        THEN("Messages are dropped until the member has caught up")
+        {
+            group->broadcast("1");
+            group->broadcast("2");
+            group->broadcast("3");
+            REQUIRE(response.queued.size() == 2);
+            REQUIRE(group->get_dropped_count() == 1);
+
+            response.send_one();
+            group->broadcast("4");
+            response.send_one();
+            response.send_one();
+
+            REQUIRE(response.sent == std::vector<std::vector<uint8_t>>{ text_frame("1"),
+                                                                        text_frame("2"),
+                                                                        text_frame("4") });
+        }
+    }
+
+    GIVEN("The coalesce policy")
+    {
+        auto group = std::make_shared<WebsocketGroup>(SlowConsumerPolicy::Drop, 2);
+        member.join(group, SlowConsumerPolicy::Coalesce);
+
+        THEN("The newest waiting message is replaced")
+        {
+            group->broadcast("1");
+            group->broadcast("2");
+            group->broadcast("3");
+            group->broadcast("4");
+            REQUIRE(response.queued.size() == 2);
+            REQUIRE(group->get_coalesced_count() == 2);
+
+            response.send_one();
+            response.send_one();
+
+            REQUIRE(response.sent == std::vector<std::vector<uint8_t>>{ text_frame("1"), text_frame("4") });
+        }
+
+        THEN("A message being sent is not replaced")
+        {
+            auto small = std::make_shared<WebsocketGroup>(SlowConsumerPolicy::Coalesce, 1);
+            member.join(small);
+
+            small->broadcast("1");
+            SharedContent content{};
+            response.queued.front()->get_shared_data(1024, content);
+
+            small->broadcast("2");
+            REQUIRE(response.queued.size() == 2);
+            small->broadcast("3");
+            REQUIRE(small->get_coalesced_count() == 1);
+            REQUIRE(std::vector<uint8_t>(content.data, content.data + content.length) == text_frame("1"));
+        }
+    }
+
+    GIVEN("The disconnect policy")
+    {
+        auto group = std::make_shared<WebsocketGroup>(SlowConsumerPolicy::Disconnect, 1);
+        member.join(group);
+
+        THEN("The connection is closed, once")
+        {
+            group->broadcast("1");
+            group->broadcast("2");
+            group->broadcast("3");
+
+            REQUIRE(response.disconnects == 1);
+            REQUIRE(group->get_disconnected_count() == 1);
+            REQUIRE(response.queued.empty());
+        }
+    }
+}
@@ -0,0 +1,259 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "LegacyMIMEParser.h"
+#include <algorithm>
+#include <sstream>
+#include "smooth/core/util/string_util.h"
+
+using namespace smooth::core;
+
+namespace mime_parser_benchmark
+{
+    static const uint8_t LEN_OF_CRLF = 2;
+    static const std::string CONTENT_DISPOSITION = "content-disposition";
+
+    void LegacyMIMEParser::detect_mode(const std::string& b)
+    {
+        boundary = { b.begin(), b.end() };
+        boundary.insert(boundary.begin(), '-');
+        boundary.insert(boundary.begin(), '-');
+        end_boundary = boundary;
+
+        // The ending boundary is the same as the normal one, but suffixed by "--\r\n" instead of just \r\n
+        end_boundary.emplace_back('-');
+        end_boundary.emplace_back('-');
+        end_boundary.emplace_back('\r');
+        end_boundary.emplace_back('\n');
+
+        data.clear();
+        end_of_transmission = false;
+        parse_status = ParseStatus::Begin;
+    }
+
+    auto LegacyMIMEParser::find_boundary() const
+    {
+        BoundaryIterator p = data.cend();
+
+        if (data.size() > boundary.size() + LEN_OF_CRLF)
+        {
+            p = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
+        }
+
+        return p;
+    }
+
+    auto LegacyMIMEParser::find_end_boundary() const
+    {
+        BoundaryIterator p = data.cend();
+
+        if (data.size() >= end_boundary.size())
+        {
+            p = std::search(data.cbegin(), data.cend(), end_boundary.cbegin(), end_boundary.cend());
+        }
+
+        return p;
+    }
+
+    void LegacyMIMEParser::parse(const uint8_t* p, std::size_t length, ILegacyFormData& form_data,
+                                 const uint16_t chunksize)
+    {
+        BoundaryIterator begin{};
+        BoundaryIterator end{};
+        bool get_more_data = false;
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            data.emplace_back(p[i]);
+        }
+
+        while (!end_of_transmission && !get_more_data)
+        {
+            if (parse_status == ParseStatus::Begin)
+            {
+                begin = find_boundary();
+
+                if (begin != data.cend())  // begin boundary found
+                {
+                    parse_status = ParseStatus::Headers;
+
+                    // "+LEN_OF_CRLF": also delete trailing crlf
+                    data.erase(data.begin(), get_end_of_boundary(begin) + LEN_OF_CRLF);
+                }
+                else
+                {
+                    get_more_data = true;
+                }
+            }
+            else if (parse_status == ParseStatus::Headers)
+            {
+                auto p = std::search(data.cbegin(), data.cend(), crlf_double.cbegin(), crlf_double.cend());
+
+                if (p != data.cend())  // end of headers found
+                {
+                    auto [new_start_of_content, headers,
+                          content_disposition] = consume_headers(data.cbegin(), p + 2 * LEN_OF_CRLF);
+                    id = content_disposition["name"];
+                    filename = content_disposition["filename"];
+
+                    // Delete two CRLF
+                    data.erase(data.begin(), p + 2 * LEN_OF_CRLF);
+                    parse_status = ParseStatus::Data;
+                    first_part = true;
+                }
+                else
+                {
+                    get_more_data = true;
+                }
+            }
+            else if (parse_status == ParseStatus::Data)
+            {
+                auto b = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
+
+                if ((data.size() > chunksize + end_boundary.size()) || (b != data.cend()))  // got something to
+                                                                                            // write
+                {
+                    while (std::distance(data.cbegin(), b - LEN_OF_CRLF) > chunksize)
+                    {
+                        form_data.form_data(id,
+                        filename,
+                        data.cbegin(),
+                        data.cbegin() + chunksize,
+                        first_part,
+                        false);
+                        data.erase(data.begin(), data.begin() + chunksize);
+                        first_part = false;
+                        b = std::search(data.cbegin(), data.cend(), boundary.cbegin(), boundary.cend());
+                    }
+
+                    if (b != data.cend())
+                    {
+                        // b - 2 to avoid additional crlf in file end
+                        form_data.form_data(id, filename, data.cbegin(), b - LEN_OF_CRLF, first_part, true);
+                        parse_status = ParseStatus::Headers;
+                        data.erase(data.begin(), b - LEN_OF_CRLF);
+                        first_part = false;
+
+                        if (std::distance(data.cbegin(), find_end_boundary()) <= 2 * LEN_OF_CRLF)
+                        {
+                            end_of_transmission = true;
+                            data.clear();
+                        }
+                    }
+                }
+                else
+                {
+                    get_more_data = true;
+                }
+            }
+        }  // while(!end_of_transmission && !get_more_data)
+
+        end_of_transmission = false;
+    }
+
+    LegacyMIMEParser::BoundaryIterator LegacyMIMEParser::get_end_of_boundary(BoundaryIterator begin)
+    {
+        // Adjust for CRLF at beginning of boundary pattern
+        auto offset = is_crlf(begin) ? LEN_OF_CRLF : 0;
+
+        return begin + static_cast<std::vector<uint8_t>::difference_type>(boundary.size()) + offset;
+    }
+
+    bool LegacyMIMEParser::is_crlf(LegacyMIMEParser::BoundaryIterator start) const
+    {
+        return *start == '\r' && *(start + 1) == '\n';
+    }
+
+    std::tuple<LegacyMIMEParser::BoundaryIterator,
+               std::unordered_map<std::string, std::string>,
+               std::unordered_map<std::string, std::string>> LegacyMIMEParser::consume_headers(
+        LegacyMIMEParser::BoundaryIterator begin,
+        LegacyMIMEParser::BoundaryIterator end) const
+    {
+        std::unordered_map<std::string, std::string> headers{};
+        std::unordered_map<std::string, std::string> content_disp{};
+        auto start_of_actual_content = end;
+
+        auto end_of_headers = std::search(begin, end, crlf_double.begin(), crlf_double.end());
+
+        if (end_of_headers != end)
+        {
+            start_of_actual_content = end_of_headers + static_cast<long>(crlf_double.size());
+
+            std::stringstream ss;
+
+            std::for_each(begin, end_of_headers, [&ss](auto& c) {
+                              if (c != '\n')
+                              {
+                                  ss << static_cast<char>(c);
+                              }
+            });
+
+            std::string s;
+
+            while (std::getline(ss, s, '\r'))
+            {
+                auto colon = std::find(s.begin(), s.end(), ':');
+
+                if (colon != s.end() && !s.empty())
+                {
+                    if (std::distance(colon, s.end()) > 2)
+                    {
+                        headers[string_util::to_lower_copy({ s.begin(), colon })] = { colon + 2, s.end() };
+                    }
+                }
+            }
+
+            parse_content_disposition(headers, content_disp);
+        }
+
+        return std::make_tuple(start_of_actual_content, std::move(headers), std::move(content_disp));
+    }
+
+    void LegacyMIMEParser::parse_content_disposition(
+        const std::unordered_map<std::string, std::string>& headers,
+        std::unordered_map<std::string, std::string>& content_disposition) const
+    {
+        try
+        {
+            const auto& content_dis = headers.at(CONTENT_DISPOSITION);
+
+            auto part = string_util::split(content_dis, ";", true);
+
+            for (const auto& p : part)
+            {
+                auto key_value = string_util::split(p, "=", true);
+
+                if (key_value.size() > 1)
+                {
+                    // Remove leading and ending quotation mark
+                    auto filter = [](char c) { return c != '"'; };
+                    content_disposition[key_value[0]] = string_util::trim(key_value[1], filter);
+                }
+                else
+                {
+                    // Single-value data
+                    content_disposition[key_value[0]] = key_value[0];
+                }
+            }
+        }
+        catch (...)
+        {
+        }
+    }
+}
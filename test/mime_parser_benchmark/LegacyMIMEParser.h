@@ -0,0 +1,91 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace mime_parser_benchmark
+{
+    /// The form data callback of the previous MIMEParser, which handed over ranges of its internal buffer.
+    class ILegacyFormData
+    {
+        public:
+            using BoundaryIterator = std::vector<uint8_t>::const_iterator;
+
+            virtual ~ILegacyFormData() = default;
+
+            virtual void form_data(const std::string& field_name,
+                                   const std::string& actual_file_name,
+                                   const BoundaryIterator& begin,
+                                   const BoundaryIterator& end,
+                                   const bool file_start,
+                                   const bool file_close) = 0;
+    };
+
+    /// The multipart/form-data parsing previously done by MIMEParser, kept as a reference: received data is
+    /// appended byte by byte to a buffer, which is searched from the start for the boundary using std::search,
+    /// and consumed data is erased from the front of the buffer.
+    class LegacyMIMEParser
+    {
+        public:
+            using BoundaryIterator = ILegacyFormData::BoundaryIterator;
+
+            void detect_mode(const std::string& boundary);
+
+            void parse(const uint8_t* p, std::size_t length, ILegacyFormData& form_data, const uint16_t chunksize);
+
+        private:
+            enum class ParseStatus
+            {
+                Begin,
+                Headers,
+                Data
+            };
+
+            auto find_boundary() const;
+
+            auto find_end_boundary() const;
+
+            BoundaryIterator get_end_of_boundary(BoundaryIterator begin);
+
+            bool is_crlf(BoundaryIterator start) const;
+
+            std::tuple<BoundaryIterator,
+                       std::unordered_map<std::string, std::string>,
+                       std::unordered_map<std::string, std::string>>
+            consume_headers(BoundaryIterator begin, BoundaryIterator end) const;
+
+            void parse_content_disposition(const std::unordered_map<std::string, std::string>& headers,
+                                           std::unordered_map<std::string, std::string>& content_disposition) const;
+
+            std::string id{};
+            std::string filename{};
+            bool first_part{ false };
+            bool end_of_transmission{ false };
+            std::vector<uint8_t> boundary{};
+            std::vector<uint8_t> end_boundary{};
+            std::vector<uint8_t> data{};
+            const std::vector<uint8_t> crlf_double{ '\r', '\n', '\r', '\n' };
+            ParseStatus parse_status{ ParseStatus::Begin };
+    };
+}
@@ -0,0 +1,213 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "mime_parser_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http::regular;
+using namespace std::chrono;
+namespace regular = smooth::application::network::http::regular;
+
+namespace mime_parser_benchmark
+{
+    static constexpr const char* tag = "MIMEParserBenchmark";
+
+    // Same sizes as used by http_files_upload_test and its UploadResponder.
+    static constexpr uint16_t form_data_chunk_size = 4096;
+    static constexpr std::size_t content_chunk_size = 4096;
+
+    static constexpr std::size_t iterations = 10;
+
+    static uint64_t fnv1a(uint64_t hash, const uint8_t* begin, const uint8_t* end)
+    {
+        for (auto p = begin; p != end; ++p)
+        {
+            hash = (hash ^ *p) * 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    static constexpr uint64_t fnv_offset = 14695981039346656037ULL;
+
+    void FileHasher::form_data(const std::string& /*field_name*/,
+                               const std::string& actual_file_name,
+                               const regular::BoundaryIterator& begin,
+                               const regular::BoundaryIterator& end,
+                               const bool file_start,
+                               const bool file_close)
+    {
+        if (file_start)
+        {
+            hash = fnv_offset;
+        }
+
+        hash = fnv1a(hash, begin, end);
+
+        if (file_close)
+        {
+            hashes[actual_file_name] = hash;
+        }
+    }
+
+    void FileHasher::form_data(const std::string& field_name,
+                               const std::string& actual_file_name,
+                               const ILegacyFormData::BoundaryIterator& begin,
+                               const ILegacyFormData::BoundaryIterator& end,
+                               const bool file_start,
+                               const bool file_close)
+    {
+        const auto* data = &*begin;
+        form_data(field_name, actual_file_name, data, data + std::distance(begin, end), file_start, file_close);
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        create_upload();
+
+        if (verify())
+        {
+            run(content_chunk_size);
+            run(1460);
+            Log::info(tag, "Benchmark complete");
+        }
+    }
+
+    void App::create_upload()
+    {
+        // Like python-requests, which upload.py uses, the boundary is 32 hex characters.
+        boundary = "9d9d5a4e1f5b4c0e8e4b4d2f7a6c3b1e";
+        std::string body{};
+        uint32_t seed = 1;
+
+        for (auto size : { 16 * 1024, 256 * 1024, 1024 * 1024 })
+        {
+            auto name = "file_" + std::to_string(size) + ".bin";
+            std::vector<uint8_t> content{};
+            content.reserve(static_cast<std::size_t>(size));
+
+            for (int i = 0; i < size; ++i)
+            {
+                seed = seed * 1664525 + 1013904223;
+                content.push_back(static_cast<uint8_t>(seed >> 24));
+            }
+
+            expected[name] = fnv1a(fnv_offset, content.data(), content.data() + content.size());
+
+            body += "--" + boundary + "\r\n";
+            body += "Content-Disposition: form-data; name=\"file_to_upload\"; filename=\"" + name + "\"\r\n\r\n";
+            body.append(content.begin(), content.end());
+            body += "\r\n";
+        }
+
+        body += "--" + boundary + "--\r\n";
+        upload.assign(body.begin(), body.end());
+    }
+
+    bool App::verify()
+    {
+        FileHasher legacy{};
+        FileHasher current{};
+        legacy_parse(content_chunk_size, legacy);
+        parse(content_chunk_size, current);
+
+        auto res = legacy.hashes == expected && current.hashes == expected;
+
+        if (!res)
+        {
+            Log::error(tag, "Parsed files differ from the uploaded ones");
+        }
+
+        return res;
+    }
+
+    void App::run(std::size_t receive_size)
+    {
+        FileHasher hasher{};
+
+        auto start = steady_clock::now();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            legacy_parse(receive_size, hasher);
+        }
+
+        auto legacy_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+        start = steady_clock::now();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            parse(receive_size, hasher);
+        }
+
+        auto new_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+        auto megabytes = static_cast<double>(upload.size() * iterations) / (1024.0 * 1024.0);
+        auto legacy_rate = megabytes / (static_cast<double>(legacy_time.count()) / 1e6);
+        auto new_rate = megabytes / (static_cast<double>(new_time.count()) / 1e6);
+
+        Log::info(tag, "Receive size {}: legacy {:.1f} MB/s, streaming {:.1f} MB/s ({:.1f}x)",
+                  receive_size, legacy_rate, new_rate, new_rate / legacy_rate);
+    }
+
+    void App::legacy_parse(std::size_t receive_size, FileHasher& hasher)
+    {
+        LegacyMIMEParser parser{};
+        parser.detect_mode(boundary);
+
+        for (std::size_t offset = 0; offset < upload.size(); offset += receive_size)
+        {
+            auto amount = std::min(receive_size, upload.size() - offset);
+            parser.parse(upload.data() + offset, amount, hasher, form_data_chunk_size);
+        }
+    }
+
+    void App::parse(std::size_t receive_size, FileHasher& hasher)
+    {
+        MIMEParser parser{};
+        parser.detect_mode("multipart/form-data; boundary=" + boundary, upload.size());
+
+        for (std::size_t offset = 0; offset < upload.size(); offset += receive_size)
+        {
+            // The URL encoded callback is never used for multipart content.
+            struct : IURLEncodedData
+            {
+                void url_encoded(std::unordered_map<std::string, std::string>&) override
+                {
+                }
+            } url_data;
+
+            auto amount = std::min(receive_size, upload.size() - offset);
+            parser.parse(upload.data() + offset, amount, hasher, url_data, form_data_chunk_size);
+        }
+    }
+}
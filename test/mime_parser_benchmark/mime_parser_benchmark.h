@@ -0,0 +1,83 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/application/network/http/regular/MIMEParser.h"
+#include "LegacyMIMEParser.h"
+
+namespace mime_parser_benchmark
+{
+    /// Hashes each uploaded file as it is handed over, like the UploadResponder of http_files_upload_test.
+    class FileHasher
+        : public smooth::application::network::http::regular::IFormData,
+        public ILegacyFormData
+    {
+        public:
+            void form_data(const std::string& field_name,
+                           const std::string& actual_file_name,
+                           const smooth::application::network::http::regular::BoundaryIterator& begin,
+                           const smooth::application::network::http::regular::BoundaryIterator& end,
+                           const bool file_start,
+                           const bool file_close) override;
+
+            void form_data(const std::string& field_name,
+                           const std::string& actual_file_name,
+                           const ILegacyFormData::BoundaryIterator& begin,
+                           const ILegacyFormData::BoundaryIterator& end,
+                           const bool file_start,
+                           const bool file_close) override;
+
+            std::unordered_map<std::string, uint64_t> hashes{};
+
+        private:
+            uint64_t hash = 0;
+    };
+
+    /// Measures the throughput of the multipart/form-data parsing of the MIMEParser compared to the previous
+    /// implementation, using an upload of the same shape as the one sent by http_files_upload_test/scripts/upload.py.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            void init() override;
+
+        private:
+            void create_upload();
+
+            bool verify();
+
+            void run(std::size_t receive_size);
+
+            void legacy_parse(std::size_t receive_size, FileHasher& hasher);
+
+            void parse(std::size_t receive_size, FileHasher& hasher);
+
+            std::string boundary{};
+            std::vector<uint8_t> upload{};
+            std::unordered_map<std::string, uint64_t> expected{};
+    };
+}
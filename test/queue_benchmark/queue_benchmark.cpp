@@ -0,0 +1,119 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "queue_benchmark.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "smooth/core/ipc/Queue.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::ipc;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace queue_benchmark
+{
+    static constexpr const char* tag = "QueueBenchmark";
+
+    // Total number of items passed through the queue per measurement, independent of queue size.
+    static constexpr int items_per_run = 200000;
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        for (auto queue_size : { 10, 100, 1000 })
+        {
+            run("int", queue_size, 0);
+            run("64 byte vector", queue_size, std::vector<uint8_t>(64));
+            run("1024 byte vector", queue_size, std::vector<uint8_t>(1024));
+        }
+
+        done = true;
+    }
+
+    void App::tick()
+    {
+        if (done)
+        {
+            Log::info(tag, "Benchmark complete");
+            done = false;
+        }
+    }
+
+    template<typename T>
+    void App::run(const char* payload_name, int queue_size, const T& sample)
+    {
+        Queue<T> queue(queue_size);
+        T target{};
+
+        // Fill the queue completely with copies, then drain it.
+        auto start = steady_clock::now();
+        int count = 0;
+
+        while (count < items_per_run)
+        {
+            for (int i = 0; i < queue_size; ++i)
+            {
+                queue.push(sample);
+            }
+
+            while (queue.pop(target))
+            {
+                ++count;
+            }
+        }
+
+        auto fill_drain = duration_cast<microseconds>(steady_clock::now() - start);
+
+        // Steady state, half full, where each popped item is moved straight back in.
+        for (int i = 0; i < std::max(queue_size / 2, 1); ++i)
+        {
+            queue.push(sample);
+        }
+
+        start = steady_clock::now();
+
+        for (int i = 0; i < items_per_run; ++i)
+        {
+            queue.pop(target);
+            queue.push(std::move(target));
+        }
+
+        auto steady = duration_cast<microseconds>(steady_clock::now() - start);
+
+        auto rate = [](int items, microseconds us) {
+                        return us.count() > 0 ? static_cast<double>(items) * 1e6 / static_cast<double>(us.count()) : 0.0;
+                    };
+
+        Log::info(tag, "{:>16} queue size {:>5}: fill/drain {:>12.0f} items/s, copy-free cycle {:>12.0f} items/s",
+                  payload_name,
+                  queue_size,
+                  rate(count, fill_drain),
+                  rate(items_per_run, steady));
+    }
+}
@@ -0,0 +1,45 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <chrono>
+#include "smooth/core/Application.h"
+
+namespace queue_benchmark
+{
+    /// Measures push/pop throughput of smooth::core::ipc::Queue<T> at a set of
+    /// queue sizes and payload sizes. Each run fills the queue and then drains it
+    /// completely, which is the worst case for a queue that shifts its contents on pop.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            void init() override;
+
+            void tick() override;
+
+        private:
+            template<typename T>
+            void run(const char* payload_name, int queue_size, const T& sample);
+
+            bool done = false;
+    };
+}
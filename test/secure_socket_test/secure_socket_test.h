@@ -61,6 +61,9 @@ namespace secure_socket_test
             void reply_error(std::unique_ptr<smooth::application::network::http::IResponseOperation> ) override
             {}
 
+            void disconnect() override
+            {}
+
             smooth::core::Task& get_task() override
             {
                 return *this;
@@ -0,0 +1,136 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "task_event_queue_benchmark.h"
+
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::ipc;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace task_event_queue_benchmark
+{
+    static constexpr const char* tag = "EventQueueBenchmark";
+    static constexpr int events_per_producer = 100000;
+    static constexpr int queue_size = 256;
+
+    static const char* type_name(EventQueueType type)
+    {
+        const char* res = "Locking";
+
+        if (type == EventQueueType::LockFreeMultiProducer)
+        {
+            res = "LockFreeMultiProducer";
+        }
+        else if (type == EventQueueType::LockFreeSingleProducer)
+        {
+            res = "LockFreeSingleProducer";
+        }
+
+        return res;
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, milliseconds(100)),
+              runs{ { EventQueueType::Locking, 1 },
+                    { EventQueueType::LockFreeSingleProducer, 1 },
+                    { EventQueueType::LockFreeMultiProducer, 1 },
+                    { EventQueueType::Locking, 2 },
+                    { EventQueueType::LockFreeMultiProducer, 2 },
+                    { EventQueueType::Locking, 8 },
+                    { EventQueueType::LockFreeMultiProducer, 8 } }
+    {
+    }
+
+    void App::tick()
+    {
+        if (!queue && current_run < runs.size())
+        {
+            start_run(runs[current_run]);
+        }
+    }
+
+    void App::start_run(const Run& run)
+    {
+        queue = Queue::create(queue_size, *this, *this, run.type);
+        expected = run.producers * events_per_producer;
+        received = 0;
+        full_count = 0;
+        go = false;
+
+        for (int p = 0; p < run.producers; ++p)
+        {
+            producers.emplace_back([this, p]() {
+                                       while (!go)
+                                       {
+                                           std::this_thread::yield();
+                                       }
+
+                                       for (int i = 0; i < events_per_producer; ++i)
+                                       {
+                                           while (!queue->push(BenchmarkEvent{ p, i }))
+                                           {
+                                               ++full_count;
+                                               std::this_thread::yield();
+                                           }
+                                       }
+                                   });
+        }
+
+        run_start = steady_clock::now();
+        go = true;
+    }
+
+    void App::event(const BenchmarkEvent& /*event*/)
+    {
+        if (++received == expected)
+        {
+            end_run();
+        }
+    }
+
+    void App::end_run()
+    {
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - run_start);
+
+        for (auto& t : producers)
+        {
+            t.join();
+        }
+
+        producers.clear();
+
+        const auto& run = runs[current_run];
+        auto rate = elapsed.count() > 0
+                    ? static_cast<double>(received) * 1e6 / static_cast<double>(elapsed.count()) : 0.0;
+
+        Log::info(tag, "{:>22}, {} producer(s): {:>10.0f} events/s, {} pushes rejected on full queue",
+                  type_name(run.type), run.producers, rate, full_count.load());
+
+        queue.reset();
+        ++current_run;
+
+        if (current_run == runs.size())
+        {
+            Log::info(tag, "Benchmark complete");
+        }
+    }
+}
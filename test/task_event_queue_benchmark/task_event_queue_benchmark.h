@@ -0,0 +1,73 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/core/ipc/IEventListener.h"
+#include "smooth/core/ipc/TaskEventQueue.h"
+
+namespace task_event_queue_benchmark
+{
+    struct BenchmarkEvent
+    {
+        int producer = 0;
+        int sequence = 0;
+    };
+
+    /// Measures the throughput of the different TaskEventQueue types when events
+    /// are pushed from 1, 2 and 8 producer threads at full speed.
+    class App
+        : public smooth::core::Application,
+        public smooth::core::ipc::IEventListener<BenchmarkEvent>
+    {
+        public:
+            App();
+
+            void tick() override;
+
+            void event(const BenchmarkEvent& event) override;
+
+        private:
+            struct Run
+            {
+                smooth::core::ipc::EventQueueType type;
+                int producers;
+            };
+
+            void start_run(const Run& run);
+
+            void end_run();
+
+            using Queue = smooth::core::ipc::TaskEventQueue<BenchmarkEvent>;
+            std::vector<Run> runs;
+            size_t current_run = 0;
+            std::shared_ptr<Queue> queue{};
+            std::vector<std::thread> producers{};
+            std::atomic_bool go{ false };
+            std::atomic<int> full_count{ 0 };
+            int expected = 0;
+            int received = 0;
+            std::chrono::steady_clock::time_point run_start{};
+    };
+}
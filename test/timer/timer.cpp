@@ -47,6 +47,15 @@ namespace timer
         create_timer(milliseconds(5000));
         create_timer(milliseconds(10000));
 
+        // Same intervals as above, but at a fixed rate so that they don't drift.
+        create_timer(milliseconds(100), true);
+        create_timer(milliseconds(1000), true);
+
+        // Timers with overlapping slack windows that the timer service may expire together.
+        create_timer(milliseconds(900), false, milliseconds(200));
+        create_timer(milliseconds(1000), false, milliseconds(200));
+        create_timer(milliseconds(1100), false, milliseconds(200));
+
         for (auto& t : timers)
         {
             t.timer->start();
@@ -62,19 +71,23 @@ namespace timer
         milliseconds duration = duration_cast<milliseconds>(steady_clock::now() - info.last);
         info.last = steady_clock::now();
         info.count++;
+        info.skipped += event.get_skipped_periods();
         info.total += duration;
 
-        Log::verbose("Interval", "{} ({}ms): {}ms, avg: {}",
+        Log::verbose("Interval", "{} ({}ms): {}ms, avg: {}, skipped: {}",
                      event.get_id(),
                      info.interval.count(),
                      duration.count(),
-                     static_cast<double>(info.total.count()) / info.count);
+                     static_cast<double>(info.total.count()) / info.count,
+                     info.skipped);
     }
 
-    void App::create_timer(std::chrono::milliseconds interval)
+    void App::create_timer(std::chrono::milliseconds interval, bool fixed_rate, std::chrono::milliseconds slack)
     {
         TimerInfo t;
         t.timer = Timer::create(static_cast<int32_t>(timers.size()), queue, true, interval);
+        t.timer->set_fixed_rate(fixed_rate);
+        t.timer->set_slack(slack);
         t.interval = interval;
         timers.push_back(t);
     }
@@ -37,7 +37,8 @@ namespace timer
             void event(const smooth::core::timer::TimerExpiredEvent& event) override;
 
         private:
-            void create_timer(std::chrono::milliseconds interval);
+            void create_timer(std::chrono::milliseconds interval, bool fixed_rate = false,
+                              std::chrono::milliseconds slack = std::chrono::milliseconds{ 0 });
 
             struct TimerInfo
             {
@@ -45,6 +46,7 @@ namespace timer
                 std::chrono::milliseconds interval;
                 std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
                 int count = 0;
+                uint32_t skipped = 0;
                 std::chrono::milliseconds total = std::chrono::milliseconds(0);
             };
 
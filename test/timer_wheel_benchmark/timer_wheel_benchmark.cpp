@@ -0,0 +1,155 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "timer_wheel_benchmark.h"
+
+#include <algorithm>
+#include <random>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::timer;
+using namespace smooth::core::logging;
+using namespace std::chrono;
+
+namespace timer_wheel_benchmark
+{
+    static constexpr const char* tag = "TimerWheelBenchmark";
+    static constexpr int timer_count = 10000;
+    static constexpr int churn_operations = 200000;
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1)),
+              queue(ExpiredQueue::create(timer_count, *this, *this))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        timers.reserve(timer_count);
+        expected.resize(timer_count);
+
+        for (int i = 0; i < timer_count; ++i)
+        {
+            timers.emplace_back(i, queue, false, seconds(30));
+        }
+
+        churn();
+        start_accuracy_run();
+    }
+
+    void App::churn()
+    {
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<int> which(0, timer_count - 1);
+        std::uniform_int_distribution<int> operation(0, 2);
+
+        // Half of the timers running, as a typical server with many idle connection timeouts would have.
+        for (int i = 0; i < timer_count; i += 2)
+        {
+            timers[static_cast<size_t>(i)]->start();
+        }
+
+        auto start = steady_clock::now();
+
+        for (int i = 0; i < churn_operations; ++i)
+        {
+            auto& timer = timers[static_cast<size_t>(which(rng))];
+            auto op = operation(rng);
+
+            if (op == 0)
+            {
+                timer->start();
+            }
+            else if (op == 1)
+            {
+                timer->stop();
+            }
+            else
+            {
+                timer->reset();
+            }
+        }
+
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+
+        for (auto& t : timers)
+        {
+            t->stop();
+        }
+
+        Log::info(tag, "{} start/stop/reset operations on {} timers: {:.0f} ops/s",
+                  churn_operations,
+                  timer_count,
+                  static_cast<double>(churn_operations) * 1e6 / static_cast<double>(std::max(elapsed.count(),
+                                                                                             int64_t{ 1 })));
+    }
+
+    void App::start_accuracy_run()
+    {
+        std::mt19937 rng(5678);
+        std::uniform_int_distribution<int> interval(10, 5000);
+
+        for (int i = 0; i < timer_count; ++i)
+        {
+            auto ms = milliseconds(interval(rng));
+            expected[static_cast<size_t>(i)] = steady_clock::now() + ms;
+            timers[static_cast<size_t>(i)]->start(ms);
+        }
+
+        Log::info(tag, "Started {} timers with intervals between 10ms and 5s", timer_count);
+    }
+
+    void App::event(const TimerExpiredEvent& event)
+    {
+        auto late = duration_cast<microseconds>(steady_clock::now() - expected[static_cast<size_t>(event.get_id())]);
+
+        if (late.count() < 0)
+        {
+            ++early;
+        }
+        else
+        {
+            total_late += late;
+            max_late = std::max(max_late, late);
+        }
+
+        ++received;
+    }
+
+    void App::tick()
+    {
+        if (!reported && received == timer_count)
+        {
+            reported = true;
+            Log::info(tag, "All {} timers fired, {} early, lateness avg {:.0f}us max {}us",
+                      received,
+                      early,
+                      static_cast<double>(total_late.count()) / received,
+                      max_late.count());
+            Log::info(tag, "Benchmark complete");
+        }
+        else if (!reported)
+        {
+            Log::info(tag, "{} of {} timers fired", received, timer_count);
+        }
+    }
+}
@@ -0,0 +1,236 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "websocket_broadcast_benchmark.h"
+#include <chrono>
+#include "smooth/application/network/http/websocket/WebsocketGroup.h"
+#include "smooth/application/network/http/websocket/frame_utils.h"
+#include "smooth/application/network/http/websocket/responses/WSResponse.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http;
+using namespace smooth::application::network::http::websocket;
+using namespace smooth::application::network::http::websocket::responses;
+using namespace std::chrono;
+
+namespace websocket_broadcast_benchmark
+{
+    static constexpr const char* tag = "WebsocketBroadcastBenchmark";
+
+    // The content chunk size used by the HTTP server examples.
+    static constexpr std::size_t chunk_size = 4096;
+
+    // Number of messages sent to all clients in each run.
+    static constexpr std::size_t message_count = 1000;
+
+    void Connection::reply(std::unique_ptr<IResponseOperation> response, bool /*place_first*/)
+    {
+        queued.emplace_back(std::move(response));
+    }
+
+    void Connection::reply_error(std::unique_ptr<IResponseOperation> response)
+    {
+        queued.clear();
+        queued.emplace_back(std::move(response));
+    }
+
+    void Connection::send_all()
+    {
+        // The buffer stands in for the socket, which copies what is sent regardless of where it comes from.
+        sent.clear();
+        std::vector<uint8_t> part{};
+
+        for (auto& op : queued)
+        {
+            auto res = ResponseStatus::HasMoreData;
+
+            while (res == ResponseStatus::HasMoreData)
+            {
+                if (op->has_shared_data())
+                {
+                    SharedContent shared{};
+                    res = op->get_shared_data(chunk_size, shared);
+                    sent.insert(sent.end(), shared.data, shared.data + shared.length);
+                }
+                else
+                {
+                    part.clear();
+                    res = op->get_data(chunk_size, part);
+                    sent.insert(sent.end(), part.begin(), part.end());
+                }
+            }
+        }
+
+        queued.clear();
+    }
+
+    std::size_t Connection::get_buffered_size() const
+    {
+        std::size_t size = 0;
+
+        for (const auto& op : queued)
+        {
+            size += op->get_buffered_size();
+        }
+
+        return size;
+    }
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        if (verify())
+        {
+            for (auto client_count : { 4U, 16U, 64U })
+            {
+                for (auto message_size : { 128U, 1024U, 16384U })
+                {
+                    run(client_count, message_size);
+                }
+            }
+
+            Log::info(tag, "Benchmark complete");
+        }
+    }
+
+    void App::setup(std::size_t client_count)
+    {
+        listeners.clear();
+        connections.clear();
+        group = std::make_shared<WebsocketGroup>(SlowConsumerPolicy::Drop, message_count);
+
+        for (std::size_t i = 0; i < client_count; ++i)
+        {
+            connections.emplace_back(std::make_unique<Connection>(*this));
+            listeners.emplace_back(std::make_unique<Listener>(*connections.back(), *this));
+            listeners.back()->join(group);
+        }
+    }
+
+    bool App::verify()
+    {
+        setup(2);
+        auto res = true;
+
+        for (std::size_t size : { 0U, 125U, 126U, 65535U, 65536U, 100000U })
+        {
+            std::vector<uint8_t> message(size, 'a');
+
+            reply_to_each(message);
+            connections[0]->send_all();
+            auto expected = connections[0]->sent;
+
+            group->broadcast(message, true);
+            connections[0]->send_all();
+            res = res && expected == connections[0]->sent;
+        }
+
+        if (!res)
+        {
+            Log::error(tag, "Broadcast frames differ from those sent to each client");
+        }
+
+        return res;
+    }
+
+    void App::reply_to_each(const std::vector<uint8_t>& message)
+    {
+        for (auto& c : connections)
+        {
+            c->reply(std::make_unique<WSResponse>(message, true, true, true), false);
+        }
+    }
+
+    std::size_t App::buffered() const
+    {
+        std::size_t size = 0;
+
+        for (const auto& c : connections)
+        {
+            size += c->get_buffered_size();
+        }
+
+        return size;
+    }
+
+    void App::run(std::size_t client_count, std::size_t message_size)
+    {
+        setup(client_count);
+        const std::vector<uint8_t> message(message_size, 'a');
+
+        auto start = steady_clock::now();
+
+        for (std::size_t i = 0; i < message_count; ++i)
+        {
+            reply_to_each(message);
+
+            for (auto& c : connections)
+            {
+                c->send_all();
+            }
+        }
+
+        const auto each_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+        // The memory held while a message waits to be sent to all clients.
+        reply_to_each(message);
+        const auto each_held = buffered();
+
+        for (auto& c : connections)
+        {
+            c->send_all();
+        }
+
+        start = steady_clock::now();
+
+        for (std::size_t i = 0; i < message_count; ++i)
+        {
+            group->broadcast(message, true);
+
+            for (auto& c : connections)
+            {
+                c->send_all();
+            }
+        }
+
+        const auto broadcast_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+        // The frame is held once, shared by all clients.
+        const auto broadcast_held = buffered() + message_size + write_frame_header(
+            std::vector<uint8_t>(MaxFrameHeaderSize).data(), OpCode::Text, true, message_size);
+
+        auto deliveries = static_cast<double>(message_count * client_count);
+        auto each_rate = deliveries / (static_cast<double>(each_time.count()) / 1e6);
+        auto broadcast_rate = deliveries / (static_cast<double>(broadcast_time.count()) / 1e6);
+
+        Log::info(tag,
+                  "{} clients, {} byte messages: per client {:.0f} msg/s holding {} bytes, "
+                  "broadcast {:.0f} msg/s holding {} bytes ({:.1f}x)",
+                  client_count, message_size, each_rate, each_held, broadcast_rate, broadcast_held,
+                  broadcast_rate / each_rate);
+    }
+}
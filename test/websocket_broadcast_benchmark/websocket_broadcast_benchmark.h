@@ -0,0 +1,113 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "smooth/core/Application.h"
+#include "smooth/application/network/http/IServerResponse.h"
+#include "smooth/application/network/http/websocket/WebsocketServer.h"
+
+namespace websocket_broadcast_benchmark
+{
+    /// Stands in for the connection of a client, sending the queued responses into a buffer.
+    class Connection
+        : public smooth::application::network::http::IServerResponse
+    {
+        public:
+            explicit Connection(smooth::core::Task& task)
+                    : task(task)
+            {
+            }
+
+            void reply(std::unique_ptr<smooth::application::network::http::IResponseOperation> response,
+                       bool place_first) override;
+
+            void reply_error(std::unique_ptr<smooth::application::network::http::IResponseOperation> response) override;
+
+            void disconnect() override
+            {
+                queued.clear();
+            }
+
+            /// Sends all queued responses, in chunks like the HTTP server does.
+            void send_all();
+
+            /// Gets the number of bytes held by the queued responses, not counting shared data.
+            [[nodiscard]] std::size_t get_buffered_size() const;
+
+            std::vector<uint8_t> sent{};
+
+        protected:
+            smooth::core::Task& get_task() override
+            {
+                return task;
+            }
+
+            void upgrade_to_websocket_internal() override
+            {}
+
+        private:
+            smooth::core::Task& task;
+            std::deque<std::unique_ptr<smooth::application::network::http::IResponseOperation>> queued{};
+    };
+
+    class Listener
+        : public smooth::application::network::http::websocket::WebsocketServer
+    {
+        public:
+            Listener(smooth::application::network::http::IServerResponse& response, smooth::core::Task& task)
+                    : WebsocketServer(response, task)
+            {
+            }
+
+            void data_received(bool /*first_part*/, bool /*last_part*/, bool /*is_text*/,
+                               const std::vector<uint8_t>& /*data*/) override
+            {}
+    };
+
+    /// Compares sending a message to many websocket clients by replying to each of them, framing and copying the
+    /// message once per client, to broadcasting it to a WebsocketGroup, framing it once for all of them.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            void init() override;
+
+        private:
+            bool verify();
+
+            void run(std::size_t client_count, std::size_t message_size);
+
+            void reply_to_each(const std::vector<uint8_t>& message);
+
+            void setup(std::size_t client_count);
+
+            std::size_t buffered() const;
+
+            std::vector<std::unique_ptr<Connection>> connections{};
+            std::vector<std::unique_ptr<Listener>> listeners{};
+            std::shared_ptr<smooth::application::network::http::websocket::WebsocketGroup> group{};
+    };
+}
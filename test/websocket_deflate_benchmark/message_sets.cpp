@@ -0,0 +1,94 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "message_sets.h"
+
+namespace websocket_deflate_benchmark
+{
+    const std::vector<MessageSet>& message_sets()
+    {
+        static const std::vector<MessageSet> sets{
+            {
+                "telemetry",
+                {
+                    R"({"device":"env-sensor-04","ts":1573920001,"seq":8812,"temperature":21.43,"humidity":38.2,)"
+                    R"("pressure":1012.61,"co2":612,"battery":{"voltage":3.71,"level":82},"rssi":-61,"status":"ok"})",
+                    R"({"device":"env-sensor-04","ts":1573920006,"seq":8813,"temperature":21.44,"humidity":38.1,)"
+                    R"("pressure":1012.60,"co2":615,"battery":{"voltage":3.71,"level":82},"rssi":-60,"status":"ok"})",
+                    R"({"device":"env-sensor-04","ts":1573920011,"seq":8814,"temperature":21.44,"humidity":38.3,)"
+                    R"("pressure":1012.62,"co2":618,"battery":{"voltage":3.70,"level":82},"rssi":-62,"status":"ok"})",
+                    R"({"device":"env-sensor-04","ts":1573920016,"seq":8815,"temperature":21.46,"humidity":38.3,)"
+                    R"("pressure":1012.59,"co2":621,"battery":{"voltage":3.70,"level":81},"rssi":-61,"status":"ok"})",
+                    R"({"device":"env-sensor-04","ts":1573920021,"seq":8816,"temperature":21.47,"humidity":38.4,)"
+                    R"("pressure":1012.58,"co2":619,"battery":{"voltage":3.70,"level":81},"rssi":-63,)"
+                    R"("status":"warning","warnings":["co2 rising"]})",
+                    R"({"device":"env-sensor-04","ts":1573920026,"seq":8817,"temperature":21.49,"humidity":38.6,)"
+                    R"("pressure":1012.58,"co2":624,"battery":{"voltage":3.70,"level":81},"rssi":-61,"status":"ok"})",
+                    R"({"device":"env-sensor-04","ts":1573920031,"seq":8818,"temperature":21.50,"humidity":38.5,)"
+                    R"("pressure":1012.57,"co2":627,"battery":{"voltage":3.69,"level":81},"rssi":-60,"status":"ok"})",
+                    R"({"device":"env-sensor-04","ts":1573920036,"seq":8819,"temperature":21.52,"humidity":38.7,)"
+                    R"("pressure":1012.55,"co2":631,"battery":{"voltage":3.69,"level":81},"rssi":-62,"status":"ok"})",
+                }
+            },
+            {
+                "status",
+                {
+                    R"({"device":"gateway-01","firmware":{"version":"2.4.1","build":"2019-11-14T09:12:44Z",)"
+                    R"("partition":"ota_1"},"uptime":86412,"heap":{"free":143880,"min_free":98112,)"
+                    R"("largest_block":110592},"wifi":{"ssid":"plant-floor","channel":6,"rssi":-58,)"
+                    R"("ip":"192.168.10.200","reconnects":2},"tasks":[{"name":"SocketDispatcher",)"
+                    R"("stack_free":11840,"priority":20},{"name":"TimerService","stack_free":1904,"priority":19},)"
+                    R"({"name":"MainApp","stack_free":5120,"priority":5},{"name":"http","stack_free":7436,)"
+                    R"("priority":10},{"name":"mqtt","stack_free":3012,"priority":8}],"sensors":[)"
+                    R"({"id":"env-sensor-01","online":true,"last_seen":1573920011,"battery":91},)"
+                    R"({"id":"env-sensor-02","online":true,"last_seen":1573920009,"battery":77},)"
+                    R"({"id":"env-sensor-03","online":false,"last_seen":1573901276,"battery":12},)"
+                    R"({"id":"env-sensor-04","online":true,"last_seen":1573920036,"battery":81}],)"
+                    R"("clients":{"http":3,"websocket":2,"mqtt":1}})",
+                    R"({"device":"gateway-01","firmware":{"version":"2.4.1","build":"2019-11-14T09:12:44Z",)"
+                    R"("partition":"ota_1"},"uptime":86472,"heap":{"free":142316,"min_free":98112,)"
+                    R"("largest_block":110592},"wifi":{"ssid":"plant-floor","channel":6,"rssi":-60,)"
+                    R"("ip":"192.168.10.200","reconnects":2},"tasks":[{"name":"SocketDispatcher",)"
+                    R"("stack_free":11840,"priority":20},{"name":"TimerService","stack_free":1904,"priority":19},)"
+                    R"({"name":"MainApp","stack_free":5108,"priority":5},{"name":"http","stack_free":7436,)"
+                    R"("priority":10},{"name":"mqtt","stack_free":3012,"priority":8}],"sensors":[)"
+                    R"({"id":"env-sensor-01","online":true,"last_seen":1573920071,"battery":91},)"
+                    R"({"id":"env-sensor-02","online":true,"last_seen":1573920069,"battery":77},)"
+                    R"({"id":"env-sensor-03","online":false,"last_seen":1573901276,"battery":12},)"
+                    R"({"id":"env-sensor-04","online":true,"last_seen":1573920066,"battery":81}],)"
+                    R"("clients":{"http":2,"websocket":2,"mqtt":1}})",
+                }
+            },
+            {
+                "log",
+                {
+                    "I (86412) SocketDispatcher: Socket 54 connected to 192.168.10.41:52114",
+                    "I (86415) HTTPServer: GET /api/status from 192.168.10.41 - 200 OK, 1204 bytes in 3 ms",
+                    "W (86501) Wifi: RSSI dropped to -71 dBm on channel 6, considering roaming",
+                    "I (86533) MQTT: Published 'plant/gateway-01/telemetry' (QoS 1, 148 bytes)",
+                    "I (86533) MQTT: Received PUBACK for packet id 4412",
+                    "E (86702) Sensor: env-sensor-03 did not respond within 5000 ms, marking offline",
+                    "I (86810) HTTPServer: GET /index.html from 192.168.10.57 - 304 Not Modified in 1 ms",
+                    "I (86811) SocketDispatcher: Socket 55 closed by peer 192.168.10.57:49920",
+                }
+            }
+        };
+
+        return sets;
+    }
+}
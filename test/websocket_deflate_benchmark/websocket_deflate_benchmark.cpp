@@ -0,0 +1,139 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "websocket_deflate_benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http::websocket;
+using namespace std::chrono;
+
+namespace websocket_deflate_benchmark
+{
+    static constexpr const char* tag = "WebsocketDeflateBenchmark";
+
+    static constexpr std::size_t message_count = 20000;
+
+    // Browsers allow the window they compress with to be limited.
+    static constexpr const char* offer = "permessage-deflate; client_max_window_bits";
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        for (const auto& set : message_sets())
+        {
+            run(set, "defaults", PerMessageDeflateConfig{});
+            run(set, "no context takeover", PerMessageDeflateConfig{ 10, 10, true, true });
+            run(set, "window 15, memory level 8", PerMessageDeflateConfig{ 15, 15, false, false, 8, 0 });
+        }
+
+        Log::info(tag, "Benchmark complete");
+    }
+
+    void App::run(const MessageSet& set, const std::string& settings, const PerMessageDeflateConfig& config)
+    {
+        // The receiving side is given the largest window, so that it can decompress whatever is sent.
+        const PerMessageDeflateConfig receive_config{ 15, 15, false, false, 8, 0 };
+
+        PerMessageDeflate sender{ *PerMessageDeflate::negotiate(offer, config), config };
+        std::vector<std::vector<uint8_t>> sent{};
+        std::vector<bool> compressed{};
+        sent.reserve(message_count);
+        std::size_t original_size = 0;
+        std::size_t sent_size = 0;
+
+        auto start = steady_clock::now();
+
+        for (std::size_t i = 0; i < message_count; ++i)
+        {
+            const auto& message = set.messages[i % set.messages.size()];
+            std::vector<uint8_t> data{ message.begin(), message.end() };
+            original_size += data.size();
+
+            compressed.push_back(sender.compress(data, true, true));
+            sent_size += data.size();
+            sent.emplace_back(std::move(data));
+        }
+
+        auto compress_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+        PerMessageDeflate receiver{ *PerMessageDeflate::negotiate(offer, receive_config), receive_config };
+        std::size_t received_size = 0;
+        auto count = [&received_size](bool, bool, const std::vector<uint8_t>& part) { received_size += part.size(); };
+
+        start = steady_clock::now();
+
+        for (std::size_t i = 0; i < sent.size(); ++i)
+        {
+            if (compressed[i])
+            {
+                receiver.decompress(sent[i], true, 4096, count);
+            }
+        }
+
+        auto decompress_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+        auto ok = true;
+        PerMessageDeflate verifier{ *PerMessageDeflate::negotiate(offer, receive_config), receive_config };
+
+        for (std::size_t i = 0; ok && i < sent.size(); ++i)
+        {
+            const auto& message = set.messages[i % set.messages.size()];
+            std::string result{ sent[i].begin(), sent[i].end() };
+
+            if (compressed[i])
+            {
+                result.clear();
+                ok = verifier.decompress(sent[i], true, 4096, [&result](bool, bool, const std::vector<uint8_t>& part) {
+                                             result.append(part.begin(), part.end());
+                                         });
+            }
+
+            ok = ok && result == message;
+        }
+
+        if (!ok)
+        {
+            Log::error(tag, "{}, {}: messages did not survive compression", set.name, settings);
+
+            return;
+        }
+
+        auto megabytes = static_cast<double>(original_size) / (1024.0 * 1024.0);
+
+        Log::info(tag, "{}, {}: {} messages of {} bytes, {} compressed, to {:.1f}% in total, compress {:.1f} MB/s, "
+                       "decompress {:.1f} MB/s, {} bytes of compression state",
+                  set.name, settings, message_count, original_size / message_count,
+                  std::count(compressed.begin(), compressed.end(), true),
+                  100.0 * static_cast<double>(sent_size) / static_cast<double>(original_size),
+                  megabytes / (static_cast<double>(compress_time.count()) / 1e6),
+                  megabytes / (static_cast<double>(decompress_time.count()) / 1e6),
+                  sender.get_deflate_memory());
+    }
+}
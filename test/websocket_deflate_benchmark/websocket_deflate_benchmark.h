@@ -0,0 +1,42 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <string>
+#include "smooth/core/Application.h"
+#include "smooth/application/network/http/websocket/PerMessageDeflate.h"
+#include "message_sets.h"
+
+namespace websocket_deflate_benchmark
+{
+    /// Measures the compression ratio and throughput of permessage-deflate for different settings,
+    /// replaying sets of typical messages.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            void init() override;
+
+        private:
+            void run(const MessageSet& set, const std::string& settings,
+                     const smooth::application::network::http::websocket::PerMessageDeflateConfig& config);
+    };
+}
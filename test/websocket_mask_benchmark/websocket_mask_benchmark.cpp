@@ -0,0 +1,154 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "websocket_mask_benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include "smooth/application/network/http/websocket/frame_utils.h"
+#include "smooth/core/logging/log.h"
+#include "smooth/core/task_priorities.h"
+
+using namespace smooth::core;
+using namespace smooth::core::logging;
+using namespace smooth::application::network::http::websocket;
+using namespace std::chrono;
+
+namespace websocket_mask_benchmark
+{
+    static constexpr const char* tag = "WebsocketMaskBenchmark";
+
+    static constexpr std::size_t payload_size = 256 * 1024;
+    static constexpr std::size_t iterations = 200;
+
+    // Room to start the payload at any offset within a 16 byte block.
+    static constexpr std::size_t max_offset = 16;
+
+    static constexpr uint8_t mask_key[4] = { 0x37, 0xFA, 0x21, 0x3D };
+
+    App::App()
+            : Application(APPLICATION_BASE_PRIO, seconds(1))
+    {
+    }
+
+    void App::init()
+    {
+        Application::init();
+
+        payload.resize(payload_size + max_offset);
+        uint32_t seed = 1;
+
+        for (auto& b : payload)
+        {
+            seed = seed * 1664525 + 1013904223;
+            b = static_cast<uint8_t>(seed >> 24);
+        }
+
+        if (verify())
+        {
+            // 1460 is a typical TCP segment, 4096 the content chunk size used by the HTTP server examples.
+            for (auto chunk_size : { 125U, 1460U, 4096U })
+            {
+                run(chunk_size, 0);
+                run(chunk_size, 3);
+            }
+
+            Log::info(tag, "Benchmark complete");
+        }
+    }
+
+    bool App::verify()
+    {
+        auto res = true;
+
+        for (std::size_t offset = 0; res && offset < max_offset; ++offset)
+        {
+            auto legacy = payload;
+            auto current = payload;
+            legacy_unmask(legacy.data() + offset, 1460);
+            unmask(current.data() + offset, 1460);
+            res = legacy == current;
+        }
+
+        if (!res)
+        {
+            Log::error(tag, "Unmasked data differs from that of the byte at a time loop");
+        }
+
+        return res;
+    }
+
+    void App::run(std::size_t chunk_size, std::size_t offset)
+    {
+        auto data = payload.data() + offset;
+
+        auto start = steady_clock::now();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            legacy_unmask(data, chunk_size);
+        }
+
+        auto legacy_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+        start = steady_clock::now();
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            unmask(data, chunk_size);
+        }
+
+        auto new_time = duration_cast<microseconds>(steady_clock::now() - start);
+
+        auto megabytes = static_cast<double>(payload_size * iterations) / (1024.0 * 1024.0);
+        auto legacy_rate = megabytes / (static_cast<double>(legacy_time.count()) / 1e6);
+        auto new_rate = megabytes / (static_cast<double>(new_time.count()) / 1e6);
+
+        Log::info(tag, "Chunk size {}, offset {}: legacy {:.1f} MB/s, apply_mask {:.1f} MB/s ({:.1f}x)",
+                  chunk_size, offset, legacy_rate, new_rate, new_rate / legacy_rate);
+    }
+
+    void App::legacy_unmask(uint8_t* data, std::size_t chunk_size)
+    {
+        // As previously done in WebsocketProtocol::data_received(), one received chunk at a time.
+        int demask_ix = 0;
+
+        for (std::size_t pos = 0; pos < payload_size; pos += chunk_size)
+        {
+            auto amount = std::min(chunk_size, payload_size - pos);
+
+            for (std::size_t i = 0; i < amount; ++i, ++demask_ix)
+            {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+                data[pos + i] = data[pos + i] ^ mask_key[demask_ix % 4];
+#pragma GCC diagnostic pop
+            }
+        }
+    }
+
+    void App::unmask(uint8_t* data, std::size_t chunk_size)
+    {
+        std::size_t phase = 0;
+
+        for (std::size_t pos = 0; pos < payload_size; pos += chunk_size)
+        {
+            auto amount = std::min(chunk_size, payload_size - pos);
+            phase = apply_mask(data + pos, amount, mask_key, phase);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+/*
+Smooth - A C++ framework for embedded programming on top of Espressif's ESP-IDF
+Copyright 2019 Per Malmberg (https://gitbub.com/PerMalmberg)
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "smooth/core/Application.h"
+
+namespace websocket_mask_benchmark
+{
+    /// Measures the throughput of websocket payload unmasking, comparing the byte at a time loop previously used by
+    /// WebsocketProtocol to apply_mask(), for different chunk sizes and buffer alignments.
+    class App
+        : public smooth::core::Application
+    {
+        public:
+            App();
+
+            void init() override;
+
+        private:
+            bool verify();
+
+            void run(std::size_t chunk_size, std::size_t offset);
+
+            void legacy_unmask(uint8_t* data, std::size_t chunk_size);
+
+            void unmask(uint8_t* data, std::size_t chunk_size);
+
+            std::vector<uint8_t> payload{};
+    };
+}